@@ -46,6 +46,7 @@ struct agent_controller_connector
   gchar *host;     /**< Agent controller hostname or IP. */
   gint port;       /**< Port number of agent controller (default 8080?). */
   gchar *protocol; /**< "http" or "https". */
+  gvm_http_client_t *http_client; /**< Reused for all requests. */
 };
 
 /**
@@ -119,8 +120,13 @@ agent_controller_send_request (agent_controller_connector_t conn,
 
   gvm_http_headers_t *headers = init_custom_header (bearer_token, TRUE);
 
-  gvm_http_response_t *http_response = gvm_http_request (
-    url, method, payload, headers, conn->ca_cert, conn->cert, conn->key,
+  // Keep the connection open for the next request of the connector
+  if (!conn->http_client)
+    conn->http_client =
+      gvm_http_client_new (conn->ca_cert, conn->cert, conn->key);
+
+  gvm_http_response_t *http_response = gvm_http_client_request (
+    conn->http_client, url, method, payload, headers,
     NULL // No manual stream allocation
   );
 
@@ -358,6 +364,7 @@ agent_controller_connector_free (agent_controller_connector_t connector)
   g_free (connector->host);
   g_free (connector->apikey);
   g_free (connector->protocol);
+  gvm_http_client_free (connector->http_client);
 
   g_free (connector);
 }
@@ -383,12 +390,15 @@ agent_controller_connector_builder (agent_controller_connector_t conn,
     {
     case AGENT_CONTROLLER_CA_CERT:
       conn->ca_cert = g_strdup ((const gchar *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case AGENT_CONTROLLER_CERT:
       conn->cert = g_strdup ((const gchar *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case AGENT_CONTROLLER_KEY:
       conn->key = g_strdup ((const gchar *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case AGENT_CONTROLLER_API_KEY:
       conn->apikey = g_strdup ((const gchar *) val);
@@ -55,12 +55,12 @@ gvm_http_add_header (gvm_http_headers_t *headers, const gchar *header)
 }
 
 gvm_http_response_t *
-gvm_http_request (const gchar *url, gvm_http_method_t method,
-                  const gchar *payload, gvm_http_headers_t *headers,
-                  const gchar *ca_cert, const gchar *cert,
-                  const gchar *key, gvm_http_response_stream_t stream)
+gvm_http_client_request (gvm_http_client_t *client, const gchar *url,
+                         gvm_http_method_t method, const gchar *payload,
+                         gvm_http_headers_t *headers,
+                         gvm_http_response_stream_t stream)
 {
-  (void)headers; (void)ca_cert; (void)cert; (void)key; (void)stream; (void)method;
+  (void)client; (void)headers; (void)stream; (void)method;
 
   last_sent_url = g_strdup (url);
   last_sent_payload = g_strdup (payload);
@@ -482,6 +482,39 @@ Ensure (agent_controller, send_request_works_without_bearer_token)
   agent_controller_connector_free (conn);
 }
 
+Ensure (agent_controller, send_request_reuses_http_client)
+{
+  agent_controller_connector_t conn = agent_controller_connector_new ();
+  conn->protocol = g_strdup ("https");
+  conn->host = g_strdup ("localhost");
+  conn->port = 8080;
+
+  gvm_http_response_t *resp = agent_controller_send_request (conn, GET, "/test", NULL, NULL);
+  assert_that (resp, is_not_null);
+  g_free (resp->data);
+  g_free (resp);
+
+  gvm_http_client_t *client = conn->http_client;
+  assert_that (client, is_not_null);
+
+  g_clear_pointer (&last_sent_url, g_free);
+  g_clear_pointer (&last_sent_payload, g_free);
+  resp = agent_controller_send_request (conn, GET, "/test", NULL, NULL);
+  assert_that (resp, is_not_null);
+  assert_that (conn->http_client, is_equal_to (client));
+  g_free (resp->data);
+  g_free (resp);
+
+  // New credentials need a new client
+  int port = 8081;
+  agent_controller_connector_builder (conn, AGENT_CONTROLLER_PORT, &port);
+  assert_that (conn->http_client, is_equal_to (client));
+  agent_controller_connector_builder (conn, AGENT_CONTROLLER_CA_CERT, "ca");
+  assert_that (conn->http_client, is_null);
+
+  agent_controller_connector_free (conn);
+}
+
 Ensure (agent_controller, parse_datetime_parses_valid_datetime)
 {
   const char *datetime_str = "2025-04-29T13:06:00.34994Z";
@@ -1099,6 +1132,7 @@ main (int argc, char **argv)
   add_test_with_context (suite, agent_controller, send_request_returns_null_if_protocol_missing);
   add_test_with_context (suite, agent_controller, send_request_returns_null_if_host_missing);
   add_test_with_context (suite, agent_controller, send_request_works_without_bearer_token);
+  add_test_with_context (suite, agent_controller, send_request_reuses_http_client);
   add_test_with_context (suite, agent_controller, parse_datetime_parses_valid_datetime);
   add_test_with_context (suite, agent_controller, parse_datetime_returns_zero_for_invalid_format);
   add_test_with_context (suite, agent_controller, parse_datetime_handles_missing_fractional_seconds);
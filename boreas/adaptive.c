@@ -0,0 +1,295 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Round trip time tracking and re-probing for the alive detection.
+ */
+
+#include "adaptive.h"
+
+#include "hostset.h"
+
+#include <string.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/**
+ * @brief Get the network of an address used for grouping round trip times.
+ *
+ * @param addr  IPv6 or IPv4-mapped address.
+ *
+ * @return The /24 of IPv4 and the /64 of IPv6 addresses.
+ */
+static guint64
+network_of (const struct in6_addr *addr)
+{
+  guint64 network;
+
+  memcpy (&network, addr->s6_addr, sizeof (network));
+  if (IN6_IS_ADDR_V4MAPPED (addr))
+    /* Mark IPv4 networks, as ::ffff:0:0/96 is not a /64 in use. */
+    network = ((guint64) 1 << 63) | (addr->s6_addr32[3] & htonl (0xffffff00));
+
+  return network;
+}
+
+/**
+ * @brief Add a round trip time sample to an estimator.
+ *
+ * @param estimator  Estimator.
+ * @param rtt        Round trip time in microseconds.
+ */
+static void
+rtt_estimator_add (struct rtt_estimator *estimator, gint64 rtt)
+{
+  if (estimator->samples == 0)
+    {
+      estimator->srtt = rtt;
+      estimator->rttvar = rtt / 2;
+    }
+  else
+    {
+      gint64 delta = estimator->srtt - rtt;
+
+      if (delta < 0)
+        delta = -delta;
+      estimator->rttvar = (3 * estimator->rttvar + delta) / 4;
+      estimator->srtt = (7 * estimator->srtt + rtt) / 8;
+    }
+  estimator->samples++;
+}
+
+/**
+ * @brief Get the timeout derived from an estimator.
+ *
+ * @param estimator  Estimator.
+ *
+ * @return Timeout in microseconds, ADAPTIVE_INITIAL_TIMEOUT if there was no
+ *         sample yet.
+ */
+static gint64
+rtt_estimator_timeout (const struct rtt_estimator *estimator)
+{
+  if (estimator->samples == 0)
+    return ADAPTIVE_INITIAL_TIMEOUT;
+
+  return estimator->srtt + 4 * estimator->rttvar;
+}
+
+/**
+ * @brief Create the state of the adaptive alive detection.
+ *
+ * @param targets      Target hosts (gvm_host_t). The hosts must outlive the
+ *                     returned state, the array may not.
+ * @param max_retries  Maximum number of times a host is probed again.
+ *
+ * @return New state. Free with adaptive_free().
+ */
+adaptive_t *
+adaptive_new (GPtrArray *targets, unsigned int max_retries)
+{
+  adaptive_t *adaptive;
+
+  adaptive = g_malloc0 (sizeof (adaptive_t));
+  adaptive->max_retries = MIN (max_retries, MAX_ALIVE_TEST_RETRIES);
+  adaptive->send_times = g_malloc0_n (targets->len + 1, sizeof (gint64));
+  adaptive->replied = g_malloc0_n (targets->len + 1, sizeof (gint));
+  adaptive->targets =
+    g_hash_table_new_full (in6_addr_hash, in6_addr_equal, g_free, NULL);
+  adaptive->hosts = g_hash_table_new (g_direct_hash, g_direct_equal);
+  for (guint i = 0; i < targets->len; i++)
+    {
+      gvm_host_t *host = g_ptr_array_index (targets, i);
+      struct in6_addr *addr = g_malloc (sizeof (struct in6_addr));
+
+      /* Duplicates are tracked by their first slot only. */
+      if (gvm_host_get_addr6 (host, addr) < 0
+          || g_hash_table_contains (adaptive->targets, addr))
+        {
+          adaptive->replied[i] = 1;
+          g_free (addr);
+          continue;
+        }
+      g_hash_table_insert (adaptive->targets, addr, &adaptive->send_times[i]);
+      g_hash_table_insert (adaptive->hosts, host, &adaptive->send_times[i]);
+    }
+  adaptive->networks =
+    g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, g_free);
+  pthread_mutex_init (&adaptive->lock, NULL);
+
+  return adaptive;
+}
+
+/**
+ * @brief Free the state of the adaptive alive detection.
+ *
+ * @param adaptive  State to free.
+ */
+void
+adaptive_free (adaptive_t *adaptive)
+{
+  if (adaptive == NULL)
+    return;
+
+  pthread_mutex_destroy (&adaptive->lock);
+  g_hash_table_destroy (adaptive->networks);
+  g_hash_table_destroy (adaptive->targets);
+  g_hash_table_destroy (adaptive->hosts);
+  g_free (adaptive->send_times);
+  g_free (adaptive->replied);
+  g_free (adaptive);
+}
+
+/**
+ * @brief Note that probes are about to be sent to a host.
+ *
+ * Called by the sender threads right before the first probe of a host is
+ * sent or queued. In the first round only the first call for a host is
+ * recorded, so that the round trip time is measured from the first probe.
+ *
+ * @param adaptive  State of the adaptive alive detection. May be NULL.
+ * @param host      Host the probes are sent to. One of the targets given to
+ *                  adaptive_new().
+ */
+void
+adaptive_probe_sent (adaptive_t *adaptive, gvm_host_t *host)
+{
+  gint64 *send_time, unsent = 0;
+
+  if (adaptive == NULL)
+    return;
+  send_time = g_hash_table_lookup (adaptive->hosts, host);
+  if (send_time == NULL)
+    return;
+
+  /* 64 bit values are not accessed atomically by the g_atomic_* functions. */
+  if (g_atomic_int_get (&adaptive->round) == 0)
+    __atomic_compare_exchange_n (send_time, &unsent, g_get_real_time (), FALSE,
+                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+  else
+    __atomic_store_n (send_time, -1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Note the first reply of a host.
+ *
+ * Called by the sniffer thread.
+ *
+ * @param adaptive  State of the adaptive alive detection. May be NULL.
+ * @param addr      Address of the host. IPv4 as IPv4-mapped address.
+ * @param ts        Time the reply was captured.
+ */
+void
+adaptive_reply (adaptive_t *adaptive, const struct in6_addr *addr,
+                const struct timeval *ts)
+{
+  struct rtt_estimator *estimator;
+  gint64 *send_time_p, send_time, rtt;
+  guint64 network;
+
+  if (adaptive == NULL)
+    return;
+  send_time_p = g_hash_table_lookup (adaptive->targets, addr);
+  if (send_time_p == NULL)
+    return;
+
+  g_atomic_int_set (&adaptive->replied[send_time_p - adaptive->send_times], 1);
+  send_time = __atomic_load_n (send_time_p, __ATOMIC_RELAXED);
+  if (send_time < 0)
+    {
+      pthread_mutex_lock (&adaptive->lock);
+      adaptive->found_by_retries++;
+      pthread_mutex_unlock (&adaptive->lock);
+      return;
+    }
+  rtt = (gint64) ts->tv_sec * G_USEC_PER_SEC + ts->tv_usec - send_time;
+  if (send_time == 0 || rtt <= 0)
+    return;
+
+  network = network_of (addr);
+  pthread_mutex_lock (&adaptive->lock);
+  estimator = g_hash_table_lookup (adaptive->networks, &network);
+  if (estimator == NULL)
+    {
+      guint64 *key = g_malloc (sizeof (guint64));
+
+      *key = network;
+      estimator = g_malloc0 (sizeof (struct rtt_estimator));
+      g_hash_table_insert (adaptive->networks, key, estimator);
+    }
+  rtt_estimator_add (estimator, rtt);
+  rtt_estimator_add (&adaptive->global, rtt);
+  pthread_mutex_unlock (&adaptive->lock);
+}
+
+/**
+ * @brief Get the targets which did not reply yet.
+ *
+ * @param adaptive  State of the adaptive alive detection.
+ * @param targets   Target hosts (gvm_host_t) given to adaptive_new().
+ *
+ * @return Array of the remaining hosts. Free with g_ptr_array_free().
+ */
+GPtrArray *
+adaptive_remaining (adaptive_t *adaptive, GPtrArray *targets)
+{
+  GPtrArray *remaining;
+
+  remaining = g_ptr_array_new ();
+  for (guint i = 0; i < targets->len; i++)
+    if (!g_atomic_int_get (&adaptive->replied[i]))
+      g_ptr_array_add (remaining, g_ptr_array_index (targets, i));
+
+  return remaining;
+}
+
+/**
+ * @brief Get how long to wait for the replies of the remaining hosts.
+ *
+ * The timeout of the slowest network among the remaining hosts is used.
+ * Networks without replies use the timeout of all networks, or
+ * ADAPTIVE_INITIAL_TIMEOUT if there was no reply at all. The timeout is
+ * doubled for every round.
+ *
+ * @param adaptive   State of the adaptive alive detection.
+ * @param remaining  Hosts (gvm_host_t) which did not reply yet.
+ * @param round      Number of times the remaining hosts were probed again.
+ *
+ * @return Timeout in microseconds, at least ADAPTIVE_MIN_TIMEOUT.
+ */
+gint64
+adaptive_timeout (adaptive_t *adaptive, GPtrArray *remaining,
+                  unsigned int round)
+{
+  gint64 fallback, timeout = 0;
+
+  pthread_mutex_lock (&adaptive->lock);
+  fallback = rtt_estimator_timeout (&adaptive->global);
+  for (guint i = 0; i < remaining->len; i++)
+    {
+      struct rtt_estimator *estimator = NULL;
+      struct in6_addr addr;
+
+      if (gvm_host_get_addr6 (g_ptr_array_index (remaining, i), &addr) == 0)
+        {
+          guint64 network = network_of (&addr);
+
+          estimator = g_hash_table_lookup (adaptive->networks, &network);
+        }
+      timeout = MAX (timeout, estimator ? rtt_estimator_timeout (estimator)
+                                        : fallback);
+    }
+  pthread_mutex_unlock (&adaptive->lock);
+
+  timeout = MAX (timeout, ADAPTIVE_MIN_TIMEOUT) << MIN (round, 16);
+  adaptive->last_timeout = timeout;
+
+  return timeout;
+}
@@ -0,0 +1,94 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_ADAPTIVE_H
+#define BOREAS_ADAPTIVE_H
+
+#include "../base/hosts.h"
+
+#include <glib.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+/* Upper limit for the number of re-probes of a host. */
+#define MAX_ALIVE_TEST_RETRIES 10
+/* Timeout (in microseconds) used before the first reply was seen. */
+#define ADAPTIVE_INITIAL_TIMEOUT 1000000
+/* Lower bound of the timeout (in microseconds) to wait for replies. */
+#define ADAPTIVE_MIN_TIMEOUT 50000
+
+/**
+ * @brief Round trip time estimator as used for TCP (RFC 6298).
+ */
+struct rtt_estimator
+{
+  /* Smoothed round trip time in microseconds. 0 if there was no sample. */
+  gint64 srtt;
+  /* Round trip time variation in microseconds. */
+  gint64 rttvar;
+  guint samples;
+};
+
+/**
+ * @brief State of the adaptive alive detection.
+ *
+ * Replies are matched with the time the first probe was sent to the host.
+ * The round trip times are tracked per /24 (IPv4) or /64 (IPv6) network and
+ * used to derive how long to wait for the replies of the remaining hosts
+ * before they are probed again with exponential backoff.
+ *
+ * The send times are written by the sender threads, one slot per target, and
+ * the samples are added by the sniffer thread. The estimators are protected
+ * by a mutex.
+ */
+struct adaptive
+{
+  /* Maximum number of times a non responding host is probed again. */
+  unsigned int max_retries;
+  /* Current round. 0 for the first probes. Accessed atomically. */
+  gint round;
+  /* struct in6_addr of a target -> pointer into send_times. Read only. */
+  GHashTable *targets;
+  /* gvm_host_t of a target -> pointer into send_times. Read only. */
+  GHashTable *hosts;
+  /* Realtime in microseconds just before the first probe was sent to a
+   * target. 0 if not sent yet, -1 if the target was probed again, as replies
+   * can not be matched to a probe then (Karn's algorithm). */
+  gint64 *send_times;
+  /* 1 if a target replied or can not be probed. Accessed atomically. */
+  gint *replied;
+  pthread_mutex_t lock;
+  /* Network (guint64 *) -> struct rtt_estimator *. */
+  GHashTable *networks;
+  struct rtt_estimator global;
+  /* Statistics. */
+  unsigned int rounds;
+  guint64 retries;
+  guint found_by_retries;
+  gint64 last_timeout;
+};
+
+typedef struct adaptive adaptive_t;
+
+adaptive_t *
+adaptive_new (GPtrArray *, unsigned int);
+
+void
+adaptive_free (adaptive_t *);
+
+void
+adaptive_probe_sent (adaptive_t *, gvm_host_t *);
+
+void
+adaptive_reply (adaptive_t *, const struct in6_addr *, const struct timeval *);
+
+GPtrArray *
+adaptive_remaining (adaptive_t *, GPtrArray *);
+
+gint64
+adaptive_timeout (adaptive_t *, GPtrArray *, unsigned int);
+
+#endif /* not BOREAS_ADAPTIVE_H */
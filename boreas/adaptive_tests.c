@@ -0,0 +1,244 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "adaptive.c"
+
+#include "../base/networking.h"
+
+#include <arpa/inet.h>
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+static GPtrArray *targets;
+
+static void
+add_target (const char *str)
+{
+  g_ptr_array_add (targets, gvm_host_from_str (str));
+}
+
+static void
+mapped_addr (const char *str, struct in6_addr *addr)
+{
+  struct in_addr addr4;
+
+  inet_pton (AF_INET, str, &addr4);
+  ipv4_as_ipv6 (&addr4, addr);
+}
+
+static void
+reply_after (adaptive_t *adaptive, const struct in6_addr *addr, gint64 rtt)
+{
+  gint64 *send_time = g_hash_table_lookup (adaptive->targets, addr);
+  gint64 reply_time = *send_time + rtt;
+  struct timeval ts;
+
+  ts.tv_sec = reply_time / G_USEC_PER_SEC;
+  ts.tv_usec = reply_time % G_USEC_PER_SEC;
+  adaptive_reply (adaptive, addr, &ts);
+}
+
+Describe (adaptive);
+BeforeEach (adaptive)
+{
+  targets = g_ptr_array_new_with_free_func ((GDestroyNotify) gvm_host_free);
+}
+AfterEach (adaptive)
+{
+  g_ptr_array_free (targets, TRUE);
+}
+
+Ensure (adaptive, estimator_follows_rfc6298)
+{
+  struct rtt_estimator estimator = {0};
+
+  assert_that (rtt_estimator_timeout (&estimator),
+               is_equal_to (ADAPTIVE_INITIAL_TIMEOUT));
+
+  rtt_estimator_add (&estimator, 8000);
+  assert_that (estimator.srtt, is_equal_to (8000));
+  assert_that (estimator.rttvar, is_equal_to (4000));
+  assert_that (rtt_estimator_timeout (&estimator), is_equal_to (24000));
+
+  rtt_estimator_add (&estimator, 16000);
+  assert_that (estimator.srtt, is_equal_to (9000));
+  assert_that (estimator.rttvar, is_equal_to (5000));
+  assert_that (estimator.samples, is_equal_to (2));
+}
+
+Ensure (adaptive, networks_are_slash24_and_slash64)
+{
+  struct in6_addr a, b, c;
+
+  mapped_addr ("192.168.1.1", &a);
+  mapped_addr ("192.168.1.254", &b);
+  mapped_addr ("192.168.2.1", &c);
+  assert_that (network_of (&a), is_equal_to (network_of (&b)));
+  assert_that (network_of (&a), is_not_equal_to (network_of (&c)));
+
+  inet_pton (AF_INET6, "2001:db8::1", &a);
+  inet_pton (AF_INET6, "2001:db8::ffff:1", &b);
+  inet_pton (AF_INET6, "2001:db8:0:1::1", &c);
+  assert_that (network_of (&a), is_equal_to (network_of (&b)));
+  assert_that (network_of (&a), is_not_equal_to (network_of (&c)));
+
+  /* IPv4 networks never collide with IPv6 ones. */
+  mapped_addr ("0.0.0.1", &a);
+  inet_pton (AF_INET6, "::1", &b);
+  assert_that (network_of (&a), is_not_equal_to (network_of (&b)));
+}
+
+Ensure (adaptive, reply_adds_rtt_sample_of_network)
+{
+  adaptive_t *adaptive;
+  struct in6_addr addr;
+  GPtrArray *remaining;
+
+  add_target ("192.168.1.1");
+  add_target ("192.168.1.2");
+  add_target ("10.0.0.1");
+  adaptive = adaptive_new (targets, 3);
+  for (guint i = 0; i < targets->len; i++)
+    adaptive_probe_sent (adaptive, g_ptr_array_index (targets, i));
+
+  mapped_addr ("192.168.1.1", &addr);
+  reply_after (adaptive, &addr, 40000);
+  assert_that (g_hash_table_size (adaptive->networks), is_equal_to (1));
+  assert_that (adaptive->global.srtt, is_equal_to (40000));
+
+  remaining = adaptive_remaining (adaptive, targets);
+  assert_that (remaining->len, is_equal_to (2));
+  assert_that (g_ptr_array_index (remaining, 0),
+               is_equal_to (g_ptr_array_index (targets, 1)));
+  assert_that (g_ptr_array_index (remaining, 1),
+               is_equal_to (g_ptr_array_index (targets, 2)));
+
+  assert_that (adaptive_timeout (adaptive, remaining, 0), is_equal_to (120000));
+  assert_that (adaptive_timeout (adaptive, remaining, 1), is_equal_to (240000));
+
+  /* 10.0.0.0/24 has no sample, so the global estimate is used for it. */
+  g_ptr_array_remove_index (remaining, 0);
+  assert_that (adaptive_timeout (adaptive, remaining, 0), is_equal_to (120000));
+
+  g_ptr_array_free (remaining, TRUE);
+  adaptive_free (adaptive);
+}
+
+Ensure (adaptive, timeout_without_replies_backs_off)
+{
+  adaptive_t *adaptive;
+  GPtrArray *remaining;
+
+  add_target ("2001:db8::1");
+  adaptive = adaptive_new (targets, 3);
+  remaining = adaptive_remaining (adaptive, targets);
+
+  assert_that (adaptive_timeout (adaptive, remaining, 0),
+               is_equal_to (ADAPTIVE_INITIAL_TIMEOUT));
+  assert_that (adaptive_timeout (adaptive, remaining, 2),
+               is_equal_to (4 * ADAPTIVE_INITIAL_TIMEOUT));
+  assert_that (adaptive->last_timeout,
+               is_equal_to (4 * ADAPTIVE_INITIAL_TIMEOUT));
+
+  g_ptr_array_free (remaining, TRUE);
+  adaptive_free (adaptive);
+}
+
+Ensure (adaptive, replies_to_retries_are_not_sampled)
+{
+  adaptive_t *adaptive;
+  struct in6_addr addr;
+  struct timeval ts = {0};
+  GPtrArray *remaining;
+
+  add_target ("192.168.1.1");
+  adaptive = adaptive_new (targets, 3);
+  adaptive_probe_sent (adaptive, g_ptr_array_index (targets, 0));
+  g_atomic_int_set (&adaptive->round, 1);
+  adaptive_probe_sent (adaptive, g_ptr_array_index (targets, 0));
+
+  mapped_addr ("192.168.1.1", &addr);
+  adaptive_reply (adaptive, &addr, &ts);
+  assert_that (adaptive->found_by_retries, is_equal_to (1));
+  assert_that (adaptive->global.samples, is_equal_to (0));
+  assert_that (g_hash_table_size (adaptive->networks), is_equal_to (0));
+
+  remaining = adaptive_remaining (adaptive, targets);
+  assert_that (remaining->len, is_equal_to (0));
+
+  g_ptr_array_free (remaining, TRUE);
+  adaptive_free (adaptive);
+}
+
+Ensure (adaptive, rtt_is_measured_from_the_first_probe)
+{
+  adaptive_t *adaptive;
+  gint64 first;
+
+  add_target ("192.168.1.1");
+  adaptive = adaptive_new (targets, 3);
+  adaptive_probe_sent (adaptive, g_ptr_array_index (targets, 0));
+  first = adaptive->send_times[0];
+  assert_that (first, is_greater_than (0));
+
+  /* Another probe method for the same host. */
+  g_usleep (2000);
+  adaptive_probe_sent (adaptive, g_ptr_array_index (targets, 0));
+  assert_that (adaptive->send_times[0], is_equal_to (first));
+
+  adaptive_free (adaptive);
+}
+
+Ensure (adaptive, duplicate_targets_are_probed_once)
+{
+  adaptive_t *adaptive;
+  GPtrArray *remaining;
+
+  add_target ("192.168.1.1");
+  add_target ("192.168.1.1");
+  adaptive = adaptive_new (targets, MAX_ALIVE_TEST_RETRIES + 5);
+  assert_that (adaptive->max_retries, is_equal_to (MAX_ALIVE_TEST_RETRIES));
+
+  remaining = adaptive_remaining (adaptive, targets);
+  assert_that (remaining->len, is_equal_to (1));
+
+  g_ptr_array_free (remaining, TRUE);
+  adaptive_free (adaptive);
+}
+
+Ensure (adaptive, null_state_is_ignored)
+{
+  struct in6_addr addr;
+  struct timeval ts = {0};
+
+  add_target ("192.168.1.1");
+  mapped_addr ("192.168.1.1", &addr);
+  adaptive_probe_sent (NULL, g_ptr_array_index (targets, 0));
+  adaptive_reply (NULL, &addr, &ts);
+  adaptive_free (NULL);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, adaptive, estimator_follows_rfc6298);
+  add_test_with_context (suite, adaptive, networks_are_slash24_and_slash64);
+  add_test_with_context (suite, adaptive, reply_adds_rtt_sample_of_network);
+  add_test_with_context (suite, adaptive, timeout_without_replies_backs_off);
+  add_test_with_context (suite, adaptive, replies_to_retries_are_not_sampled);
+  add_test_with_context (suite, adaptive,
+                         rtt_is_measured_from_the_first_probe);
+  add_test_with_context (suite, adaptive, duplicate_targets_are_probed_once);
+  add_test_with_context (suite, adaptive, null_state_is_ignored);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -11,6 +11,7 @@
 #include "boreas_error.h"
 #include "boreas_io.h"
 #include "ping.h"
+#include "sender.h"
 #include "sniffer.h"
 #include "util.h"
 
@@ -42,6 +43,272 @@
 
 scanner_t scanner;
 
+/* Called with the statistics at the end of every alive scan. */
+static alive_stats_func_t stats_callback = NULL;
+static gpointer stats_callback_data = NULL;
+
+/**
+ * @brief Set the function called with the statistics of every alive scan.
+ *
+ * The function is called from the alive detection thread after all alive
+ * hosts were put on the queue and before the finish signal.
+ *
+ * @param func       Function to call. NULL to not call any.
+ * @param user_data  User data for func.
+ */
+void
+set_alive_detection_stats_callback (alive_stats_func_t func,
+                                    gpointer user_data)
+{
+  stats_callback = func;
+  stats_callback_data = user_data;
+}
+
+/**
+ * @brief Mark all target hosts as alive.
+ *
+ * Hosts which were already detected as alive are skipped, all others are
+ * published like hosts detected by a reply.
+ */
+static void
+consider_all_targets_alive (void)
+{
+  GPtrArray *targets = scanner.hosts_data->targets;
+
+  for (guint i = 0; i < targets->len; i++)
+    {
+      gvm_host_t *host = g_ptr_array_index (targets, i);
+      gchar *addr_str;
+
+      if (!hosts_set_add_host (scanner.hosts_data->alivehosts, host))
+        continue;
+      addr_str = gvm_host_value_str (host);
+      handle_scan_restrictions (&scanner, addr_str);
+      g_free (addr_str);
+    }
+}
+
+/**
+ * @brief Progress of an ICMP only scan.
+ *
+ * If only ICMP was chosen dead hosts are sent to ospd in batches while the
+ * pings are sent, for displaying a progressbar that increases gradually.
+ */
+struct icmp_progress
+{
+  /* Number of hosts in a batch. */
+  int batch;
+  /* Number of hosts handled after which the next batch is reported. */
+  int next_batch;
+  int number_of_targets;
+  /* Number of hosts in last batch. Depending on the total number of hosts
+   * the last batch size maybe be double the normal size. Info about the
+   * last batch is send after all hosts were checked and we waited for last
+   * packets to arrive.*/
+  int remaining_batch;
+  /* Number of alive hosts when the last batch was reported. */
+  int prev_alive;
+  /* Scan restrictions related. */
+  gboolean limit_reached_handled;
+  /* Coalesces the updates sent to ospd-openvas. */
+  dead_hosts_reporter_t *dead_hosts;
+};
+
+/**
+ * @brief Send dead hosts updates for all completed batches of an ICMP only
+ * scan.
+ *
+ * @param hosts_sent  Number of hosts pinged so far.
+ * @param progress_p  Pointer to struct icmp_progress.
+ */
+static void
+report_icmp_progress (guint hosts_sent, gpointer progress_p)
+{
+  struct icmp_progress *progress = progress_p;
+  int batch = progress->batch;
+  int number_of_dead_hosts;
+  int curr_alive;
+
+  /* Send dead hosts update after batch number of packets were send and
+   * we still have more than batch size packets remaining. */
+  while ((int) hosts_sent >= progress->next_batch
+         && (progress->number_of_targets - progress->next_batch) > batch)
+    {
+      /* The number of dead hosts we have to send to ospd is the batch
+       * size minus the newly found alive hosts. The newly found alive
+       * hosts is the diff between the current total of alive hosts and
+       * the total of the last batch. */
+      curr_alive = hosts_set_size (scanner.hosts_data->alivehosts);
+      number_of_dead_hosts = batch - (curr_alive - progress->prev_alive);
+
+      /* If the max_scan_hosts limit was reached we can not tell ospd
+       * the true number of dead hosts. The number of alive hosts which
+       * are above the max_scan_hosts limit are not to be subtracted
+       * form the dead hosts to send. They are considered as dead hosts
+       * for the progress bar.*/
+      if (scanner.scan_restrictions->max_scan_hosts_reached)
+        {
+          /* Handle the case where we reach the max_scan_hosts for the
+           * first time. We may have to consider some of the new alive
+           * hosts as dead because of the restriction. E.g
+           * curr_alive=110 prev_alive=90 max_scan_hosts=100 batch=100.
+           * Normally we would send 80 as dead in this batch (20 new
+           * alive hosts) but because of the restriction we send 90 as
+           * dead. The 10 hosts which are over the limit are considered
+           * as dead.
+           * After this limit case was handled we just always send the
+           * complete batch as dead hosts.*/
+          if (!progress->limit_reached_handled)
+            {
+              /* Number of alive hosts until limit was reached. */
+              int last_hosts_considered_as_alive =
+                scanner.scan_restrictions->max_scan_hosts
+                - progress->prev_alive;
+              number_of_dead_hosts = batch - last_hosts_considered_as_alive;
+              dead_hosts_reporter_add (progress->dead_hosts,
+                                       number_of_dead_hosts);
+              progress->limit_reached_handled = TRUE;
+            }
+          else
+            dead_hosts_reporter_add (progress->dead_hosts, batch);
+        }
+      else
+        dead_hosts_reporter_add (progress->dead_hosts, number_of_dead_hosts);
+
+      progress->remaining_batch -= batch;
+      progress->prev_alive = curr_alive;
+      progress->next_batch += batch;
+    }
+}
+
+/**
+ * @brief Send ARP pings to the given hosts from the calling thread.
+ *
+ * @param hosts  Hosts (gvm_host_t) to ping.
+ */
+static void
+send_arp_to_hosts (GPtrArray *hosts)
+{
+  for (guint i = 0; i < hosts->len; i++)
+    {
+      adaptive_probe_sent (scanner.adaptive, g_ptr_array_index (hosts, i));
+      send_arp (g_ptr_array_index (hosts, i), &scanner);
+    }
+  arpsweep_flush (scanner.arpsweep);
+  ndsweep_flush (scanner.ndsweep);
+  wait_until_so_sndbuf_empty (scanner.arpv4soc, 10);
+  wait_until_so_sndbuf_empty (scanner.arpv6soc, 10);
+}
+
+/**
+ * @brief Wait until all targets replied or the timeout expired.
+ *
+ * @param timeout  Timeout in microseconds.
+ */
+static void
+wait_for_replies (gint64 timeout)
+{
+  gint64 deadline = g_get_monotonic_time () + timeout;
+  guint number_of_targets = scanner.hosts_data->targets->len;
+
+  while (g_get_monotonic_time () < deadline
+         && hosts_set_size (scanner.hosts_data->alivehosts)
+              < number_of_targets)
+    usleep (10000);
+}
+
+/**
+ * @brief Wait for replies based on the round trip times and probe the hosts
+ * without reply again.
+ *
+ * The hosts which did not reply are probed again with all chosen methods up to
+ * max_retries times. Before every round the time to wait is derived from the
+ * round trip times of the networks of the remaining hosts and doubled for
+ * every round. It is capped at the alive_test_wait_timeout.
+ *
+ * @param senders     Senders for ICMP and TCP pings.
+ * @param alive_test  Methods of alive detection to use.
+ */
+static void
+adaptive_wait_and_retry (senders_t *senders, alive_test_t alive_test)
+{
+  adaptive_t *adaptive = scanner.adaptive;
+  gint64 max_timeout;
+  GPtrArray *remaining;
+  unsigned int round = 0;
+
+  max_timeout = (gint64) get_alive_test_wait_timeout () * G_USEC_PER_SEC;
+  remaining = adaptive_remaining (adaptive, scanner.hosts_data->targets);
+  while (remaining->len > 0)
+    {
+      gint64 timeout;
+
+      timeout = adaptive_timeout (adaptive, remaining, round);
+      timeout = MIN (timeout, max_timeout);
+      g_debug ("%s: Waiting %" G_GINT64_FORMAT " ms for replies of %u hosts.",
+               __func__, timeout / 1000, remaining->len);
+      wait_for_replies (timeout);
+
+      g_ptr_array_free (remaining, TRUE);
+      remaining = adaptive_remaining (adaptive, scanner.hosts_data->targets);
+      if (remaining->len == 0 || round == adaptive->max_retries
+          || scanner.scan_restrictions->max_scan_hosts_reached)
+        break;
+
+      /* Probe the remaining hosts again. */
+      round++;
+      g_atomic_int_set (&adaptive->round, round);
+      adaptive->rounds = round;
+      adaptive->retries += remaining->len;
+      if (alive_test & ALIVE_TEST_ICMP)
+        senders_run_hosts (senders, remaining, send_icmp, NULL, NULL);
+      if (alive_test & ALIVE_TEST_TCP_SYN_SERVICE)
+        {
+          scanner.tcp_flag = TH_SYN;
+          senders_run_hosts (senders, remaining, send_tcp, NULL, NULL);
+        }
+      if (alive_test & ALIVE_TEST_TCP_ACK_SERVICE)
+        {
+          scanner.tcp_flag = TH_ACK;
+          senders_run_hosts (senders, remaining, send_tcp, NULL, NULL);
+        }
+      if (alive_test & ALIVE_TEST_ARP)
+        send_arp_to_hosts (remaining);
+    }
+  g_ptr_array_free (remaining, TRUE);
+}
+
+/**
+ * @brief Complete the statistics of the scan and publish them.
+ *
+ * The statistics are stored as JSON in the ALIVE_DETECTION_STATS item of the
+ * main kb and handed to the stats callback if one was set.
+ *
+ * @param scan_id  Scan ID for logging.
+ */
+static void
+publish_alive_stats (const char *scan_id)
+{
+  alive_stats_t *stats = scanner.stats;
+  gchar *json;
+
+  stats->end = g_get_real_time ();
+  stats->throttle_stalls = scanner.ratelimit->stalls;
+  stats->pcap_received = scanner.pcap_stats.ps_recv;
+  stats->pcap_dropped = scanner.pcap_stats.ps_drop;
+  stats->pcap_ifdropped = scanner.pcap_stats.ps_ifdrop;
+
+  json = alive_stats_to_json (stats);
+  g_debug ("%s: Alive scan %s statistics: %s", __func__, scan_id, json);
+  if (kb_item_set_str (scanner.main_kb, ALIVE_DETECTION_STATS, json, 0) != 0)
+    g_warning ("%s: Could not store the statistics of alive scan %s.",
+               __func__, scan_id);
+  g_free (json);
+
+  if (stats_callback)
+    stats_callback (stats, stats_callback_data);
+}
+
 /**
  * @brief Scan function starts a sniffing thread which waits for packets to
  * arrive and sends pings to hosts we want to test. Blocks until Scan is
@@ -58,23 +325,26 @@ scan (alive_test_t alive_test)
   int number_of_targets;
   int number_of_dead_hosts;
   pthread_t sniffer_thread_id;
-  GHashTableIter target_hosts_iter;
-  gpointer key, value;
   struct timeval start_time, end_time;
   int scandb_id;
   gchar *scan_id;
-  /* Following variables are only relevant if only ICMP was chosen. */
-  int remaining_batch = 0;
-  int prev_alive = 0;
-  gboolean limit_reached_handled = FALSE; /* Scan restrictions related. */
+  /* Only relevant if only ICMP was chosen. */
+  struct icmp_progress progress = {0};
+  dead_hosts_reporter_t *dead_hosts;
+  senders_t *senders = NULL;
+  boreas_error_t senders_err;
 
   gettimeofday (&start_time, NULL);
-  number_of_targets = g_hash_table_size (scanner.hosts_data->targethosts);
+  number_of_targets = scanner.hosts_data->targets->len;
 
   scandb_id = atoi (prefs_get ("ov_maindbid"));
   scan_id = get_openvas_scan_id (prefs_get ("db_address"), scandb_id);
   g_message ("Alive scan %s started: Target has %d hosts", scan_id,
              number_of_targets);
+  /* One connection for all dead hosts updates of this scan. */
+  dead_hosts = dead_hosts_reporter_new (
+    kb_direct_conn (prefs_get ("db_address"), scandb_id));
+  progress.dead_hosts = dead_hosts;
 
   /* Check first if consider alive test method is set. In case that
    * there is no scan restrictions, no other test will be performed, because
@@ -89,13 +359,7 @@ scan (alive_test_t alive_test)
       && scanner.scan_restrictions->max_scan_hosts == 0)
     {
       g_debug ("%s: Consider Alive", __func__);
-      for (g_hash_table_iter_init (&target_hosts_iter,
-                                   scanner.hosts_data->targethosts);
-           g_hash_table_iter_next (&target_hosts_iter, &key, &value);)
-        {
-          g_hash_table_add (scanner.hosts_data->alivehosts, g_strdup (key));
-          handle_scan_restrictions (&scanner, key);
-        }
+      consider_all_targets_alive ();
       goto finish_alive_test;
     }
 
@@ -107,128 +371,66 @@ scan (alive_test_t alive_test)
       start_sniffer_thread (&scanner, &sniffer_thread_id);
     }
 
+  /* Senders for ICMP and TCP pings. */
+  senders = senders_new (&scanner, alive_test, get_alive_test_sender_threads (),
+                         &senders_err);
+  if (senders == NULL)
+    {
+      g_warning ("%s: %s. Using a single sender.", __func__,
+                 str_boreas_error (senders_err));
+      senders = senders_new (&scanner, alive_test, 1, &senders_err);
+    }
+
   /* Continuously send dead hosts to ospd if only ICMP was chosen instead of
    * sending all at once at the end. This is done for displaying a progressbar
    * that increases gradually. */
   if (alive_test == ALIVE_TEST_ICMP)
     {
-      g_hash_table_iter_init (&target_hosts_iter,
-                              scanner.hosts_data->targethosts);
-      int batch = 1000;
-      int curr_alive = 0;
-      prev_alive = 0;
-      /* Number of hosts in last batch. Depending on the total number of hosts
-       * the last batch size maybe be double the normal size. Info about the
-       * last batch is send after all hosts were checked and we waited for last
-       * packets to arrive.*/
-      remaining_batch = number_of_targets;
-      for (int packets_send = 0;
-           g_hash_table_iter_next (&target_hosts_iter, &key, &value);)
-        {
-          send_icmp (key, value, &scanner);
-          packets_send++;
-          /* Send dead hosts update after batch number of packets were send and
-           * we still have more than batch size packets remaining. */
-          if (packets_send % batch == 0
-              && (number_of_targets - packets_send) > batch)
-            {
-              /* The number of dead hosts we have to send to ospd is the batch
-               * size minus the newly found alive hosts. The newly found alive
-               * hosts is the diff between the current total of alive hosts and
-               * the total of the last batch. */
-              curr_alive = g_hash_table_size (scanner.hosts_data->alivehosts);
-              number_of_dead_hosts = batch - (curr_alive - prev_alive);
-
-              /* If the max_scan_hosts limit was reached we can not tell ospd
-               * the true number of dead hosts. The number of alive hosts which
-               * are above the max_scan_hosts limit are not to be subtracted
-               * form the dead hosts to send. They are considered as dead hosts
-               * for the progress bar.*/
-              if (scanner.scan_restrictions->max_scan_hosts_reached)
-                {
-                  /* Handle the case where we reach the max_scan_hosts for the
-                   * first time. We may have to consider some of the new alive
-                   * hosts as dead because of the restriction. E.g
-                   * curr_alive=110 prev_alive=90 max_scan_hosts=100 batch=100.
-                   * Normally we would send 80 as dead in this batch (20 new
-                   * alive hosts) but because of the restriction we send 90 as
-                   * dead. The 10 hosts which are over the limit are considered
-                   * as dead.
-                   * After this limit case was handled we just always send the
-                   * complete batch as dead hosts.*/
-                  if (!limit_reached_handled)
-                    {
-                      /* Number of alive hosts until limit was reached. */
-                      int last_hosts_considered_as_alive =
-                        scanner.scan_restrictions->max_scan_hosts - prev_alive;
-                      number_of_dead_hosts =
-                        batch - last_hosts_considered_as_alive;
-                      send_dead_hosts_to_ospd_openvas (number_of_dead_hosts);
-                      remaining_batch -= batch;
-                      limit_reached_handled = TRUE;
-                    }
-                  else
-                    {
-                      send_dead_hosts_to_ospd_openvas (batch);
-                      remaining_batch -= batch;
-                    }
-                }
-              else
-                {
-                  send_dead_hosts_to_ospd_openvas (number_of_dead_hosts);
-                  remaining_batch -= batch;
-                }
-              prev_alive = curr_alive;
-            }
-        }
+      progress.batch = 1000;
+      progress.next_batch = progress.batch;
+      progress.number_of_targets = number_of_targets;
+      progress.remaining_batch = number_of_targets;
+      senders_run (senders, send_icmp, report_icmp_progress, &progress);
     }
   else if (alive_test & ALIVE_TEST_ICMP)
     {
       g_debug ("%s: ICMP Ping", __func__);
-      g_hash_table_foreach (scanner.hosts_data->targethosts, send_icmp,
-                            &scanner);
+      senders_run (senders, send_icmp, NULL, NULL);
       wait_until_so_sndbuf_empty (scanner.icmpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner.icmpv6soc, 10);
-      usleep (500000);
+      /* In adaptive mode the replies are waited for based on the RTT. */
+      if (!scanner.adaptive)
+        usleep (500000);
     }
   if (alive_test & ALIVE_TEST_TCP_SYN_SERVICE)
     {
       g_debug ("%s: TCP-SYN Service Ping", __func__);
       scanner.tcp_flag = TH_SYN; /* SYN */
-      g_hash_table_foreach (scanner.hosts_data->targethosts, send_tcp,
-                            &scanner);
+      senders_run (senders, send_tcp, NULL, NULL);
       wait_until_so_sndbuf_empty (scanner.tcpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner.tcpv6soc, 10);
-      usleep (500000);
+      if (!scanner.adaptive)
+        usleep (500000);
     }
   if (alive_test & ALIVE_TEST_TCP_ACK_SERVICE)
     {
       g_debug ("%s: TCP-ACK Service Ping", __func__);
       scanner.tcp_flag = TH_ACK; /* ACK */
-      g_hash_table_foreach (scanner.hosts_data->targethosts, send_tcp,
-                            &scanner);
+      senders_run (senders, send_tcp, NULL, NULL);
       wait_until_so_sndbuf_empty (scanner.tcpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner.tcpv6soc, 10);
-      usleep (500000);
+      if (!scanner.adaptive)
+        usleep (500000);
     }
   if (alive_test & ALIVE_TEST_ARP)
     {
       g_debug ("%s: ARP Ping", __func__);
-      g_hash_table_foreach (scanner.hosts_data->targethosts, send_arp,
-                            &scanner);
-      wait_until_so_sndbuf_empty (scanner.arpv4soc, 10);
-      wait_until_so_sndbuf_empty (scanner.arpv6soc, 10);
+      send_arp_to_hosts (scanner.hosts_data->targets);
     }
   if (alive_test & ALIVE_TEST_CONSIDER_ALIVE)
     {
       g_debug ("%s: Consider Alive", __func__);
-      for (g_hash_table_iter_init (&target_hosts_iter,
-                                   scanner.hosts_data->targethosts);
-           g_hash_table_iter_next (&target_hosts_iter, &key, &value);)
-        {
-          g_hash_table_add (scanner.hosts_data->alivehosts, g_strdup (key));
-          handle_scan_restrictions (&scanner, key);
-        }
+      consider_all_targets_alive ();
     }
 
   /* Stop sniffer thread if any alive test besides ALIVE_TEST_CONSIDER_ALIVE was
@@ -239,17 +441,25 @@ scan (alive_test_t alive_test)
         "%s: all ping packets have been sent, wait a bit for rest of replies.",
         __func__);
 
-      for (unsigned int i = 0; i < get_alive_test_wait_timeout (); i++)
-        {
-          if (number_of_targets
-              == (int) g_hash_table_size (scanner.hosts_data->alivehosts))
-            break;
-          sleep (1); // 1 second is the minimum wait time
-        }
+      if (scanner.adaptive)
+        adaptive_wait_and_retry (senders, alive_test);
+      else
+        for (unsigned int i = 0; i < get_alive_test_wait_timeout (); i++)
+          {
+            if (number_of_targets
+                == (int) hosts_set_size (scanner.hosts_data->alivehosts))
+              break;
+            sleep (1); // 1 second is the minimum wait time
+          }
       stop_sniffer_thread (&scanner, sniffer_thread_id);
     }
+  senders_free (senders);
 
 finish_alive_test:
+  /* All alive hosts must be on the queue before the finish signal. */
+  publisher_free (scanner.publisher);
+  scanner.publisher = NULL;
+
   /* If only ICMP was specified we continuously send updates about dead hosts to
    * ospd while checking the hosts. We now only have to send the dead hosts of
    * the last batch. This is done here to catch the last alive hosts which may
@@ -262,52 +472,74 @@ finish_alive_test:
           /* We reached the max_scan_host limit in the last batch. For detailed
            * description look at the first time where limit_reached_handled is
            * used.*/
-          if (!limit_reached_handled)
+          if (!progress.limit_reached_handled)
             {
               /* Number of alive hosts until limit was reached. */
               int last_hosts_considered_as_alive =
-                scanner.scan_restrictions->max_scan_hosts - prev_alive;
+                scanner.scan_restrictions->max_scan_hosts
+                - progress.prev_alive;
               number_of_dead_hosts =
-                remaining_batch - last_hosts_considered_as_alive;
-              send_dead_hosts_to_ospd_openvas (number_of_dead_hosts);
+                progress.remaining_batch - last_hosts_considered_as_alive;
+              dead_hosts_reporter_add (dead_hosts, number_of_dead_hosts);
             }
           else
             {
-              send_dead_hosts_to_ospd_openvas (remaining_batch);
+              dead_hosts_reporter_add (dead_hosts, progress.remaining_batch);
             }
         }
       else
         {
-          int curr_alive = g_hash_table_size (scanner.hosts_data->alivehosts);
-          number_of_dead_hosts = remaining_batch - (curr_alive - prev_alive);
-          send_dead_hosts_to_ospd_openvas (number_of_dead_hosts);
+          int curr_alive = hosts_set_size (scanner.hosts_data->alivehosts);
+          number_of_dead_hosts =
+            progress.remaining_batch - (curr_alive - progress.prev_alive);
+          dead_hosts_reporter_add (dead_hosts, number_of_dead_hosts);
         }
     }
   else
     {
       number_of_dead_hosts =
-        number_of_targets - g_hash_table_size (scanner.hosts_data->alivehosts);
+        number_of_targets - hosts_set_size (scanner.hosts_data->alivehosts);
 
       /* Send number of dead hosts to ospd-openvas. We need to consider the scan
        * restrictions.*/
       if (scanner.scan_restrictions->max_scan_hosts_reached)
-        send_dead_hosts_to_ospd_openvas (
+        dead_hosts_reporter_add (
+          dead_hosts,
           number_of_targets - scanner.scan_restrictions->max_scan_hosts);
       else
-        send_dead_hosts_to_ospd_openvas (number_of_dead_hosts);
+        dead_hosts_reporter_add (dead_hosts, number_of_dead_hosts);
     }
 
+  dead_hosts_reporter_free (dead_hosts);
+
   gettimeofday (&end_time, NULL);
 
   g_message ("Alive scan %s finished in %ld seconds: %d alive hosts of %d.",
              scan_id, end_time.tv_sec - start_time.tv_sec,
-             g_hash_table_size (scanner.hosts_data->alivehosts),
+             hosts_set_size (scanner.hosts_data->alivehosts),
              number_of_targets);
+  if (scanner.ratelimit->sent > 0)
+    g_message ("Alive scan %s sent %" G_GUINT64_FORMAT " packets at %.0f pps "
+               "(limit %u pps, %" G_GUINT64_FORMAT " stalls).",
+               scan_id, scanner.ratelimit->sent,
+               ratelimit_achieved_rate (scanner.ratelimit),
+               get_alive_test_max_pps (), scanner.ratelimit->stalls);
+  if (scanner.adaptive)
+    g_message ("Alive scan %s probed %" G_GUINT64_FORMAT " hosts again in %u "
+               "rounds, %u of them replied. Last wait was %" G_GINT64_FORMAT
+               " ms.",
+               scan_id, scanner.adaptive->retries, scanner.adaptive->rounds,
+               scanner.adaptive->found_by_retries,
+               scanner.adaptive->last_timeout / 1000);
+  publish_alive_stats (scan_id);
   g_free (scan_id);
 
   return 0;
 }
 
+static void
+alive_detection_free (void *);
+
 /**
  * @brief Initialise the alive detection scanner.
  *
@@ -338,32 +570,62 @@ alive_detection_init (gvm_hosts_t *hosts, alive_test_t alive_test)
   /* Do not print results in stdout. Only set for command line clients*/
   scanner.print_results = 0;
 
+  /* Token bucket shared by all send functions. */
+  scanner.ratelimit =
+    ratelimit_new (get_alive_test_max_pps (), get_alive_test_burst ());
+  scanner.srccache = srccache_new ();
+  scanner.stats = alive_stats_new ();
+  /* Send ARP requests, neighbor solicitations and ICMPv6 echo requests in
+   * batches. */
+  if (alive_test & ALIVE_TEST_ARP)
+    {
+      scanner.arpsweep = arpsweep_new (scanner.arpv4soc, scanner.stats,
+                                       scanner.srccache);
+      scanner.ndsweep =
+        ndsweep_new (scanner.arpv6soc, ND_NEIGHBOR_SOLICIT, scanner.stats,
+                     scanner.srccache);
+    }
+  if (alive_test & ALIVE_TEST_ICMP)
+    scanner.icmpv6sweep =
+      ndsweep_new (scanner.icmpv6soc, ICMP6_ECHO_REQUEST, scanner.stats, NULL);
+
   /* kb_t redis connection */
   int scandb_id = atoi (prefs_get ("ov_maindbid"));
   scanner.main_kb = kb_direct_conn (prefs_get ("db_address"), scandb_id);
   if (scanner.main_kb == NULL)
-    return -7;
+    {
+      boreas_error_t free_err;
+
+      /* Release the sockets, sweeps and caches set up so far. */
+      alive_detection_free (&free_err);
+      return -7;
+    }
+  /* Push alive hosts from a separate thread in batches. */
+  scanner.publisher = publisher_new (scanner.main_kb);
   /* TODO: pcap handle */
   // scanner.pcap_handle = open_live (NULL, FILTER_STR); //
   scanner.pcap_handle = NULL; /* is set in ping function */
 
   /* Results data */
-  /* hashtables */
   scanner.hosts_data = g_malloc0 (sizeof (hosts_data_t));
-  scanner.hosts_data->alivehosts =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-  scanner.hosts_data->targethosts =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  scanner.hosts_data->alivehosts = hosts_set_new ();
+  scanner.hosts_data->targethosts = hosts_set_new ();
+  scanner.hosts_data->targets = g_ptr_array_sized_new (gvm_hosts_count (hosts));
 
-  /* put all hosts we want to check in hashtable */
+  /* All hosts we want to check. Host lists are deduplicated when they are
+   * parsed, so only the pointers are taken here. The set for matching the
+   * replies is filled by another thread while the first probes go out. */
   gvm_host_t *host;
   for (host = gvm_hosts_next (hosts); host; host = gvm_hosts_next (hosts))
-    {
-      g_hash_table_insert (scanner.hosts_data->targethosts,
-                           gvm_host_value_str (host), host);
-    }
+    g_ptr_array_add (scanner.hosts_data->targets, host);
   /* reset hosts iter */
   hosts->current = 0;
+  fill_target_set_async (scanner.hosts_data);
+
+  /* Wait for replies based on RTTs and probe hosts again if enabled. */
+  if (get_alive_test_max_retries () > 0)
+    scanner.adaptive = adaptive_new (scanner.hosts_data->targets,
+                                     get_alive_test_max_retries ());
 
   /* Init ports used for scanning. */
   scanner.ports = NULL;
@@ -432,6 +694,13 @@ alive_detection_free (void *error)
   alive_test_t alive_test;
 
   error_out = NO_ERROR;
+  /* Sends the remaining requests, so free it before the sockets are closed. */
+  arpsweep_free (scanner.arpsweep);
+  scanner.arpsweep = NULL;
+  ndsweep_free (scanner.ndsweep);
+  scanner.ndsweep = NULL;
+  ndsweep_free (scanner.icmpv6sweep);
+  scanner.icmpv6sweep = NULL;
   alive_test_err = get_alive_test_methods (&alive_test);
   if (alive_test_err)
     {
@@ -446,22 +715,44 @@ alive_detection_free (void *error)
         error_out = BOREAS_CLEANUP_ERROR;
     }
 
+  /* Only still running if the scan was canceled. */
+  publisher_free (scanner.publisher);
+  scanner.publisher = NULL;
+
   /*pcap_close (scanner.pcap_handle); //pcap_handle is closed in ping/scan
    * function for now */
-  if ((kb_lnk_reset (scanner.main_kb)) != 0)
+  if (scanner.main_kb && (kb_lnk_reset (scanner.main_kb)) != 0)
     {
       g_warning ("%s: error in kb_lnk_reset()", __func__);
       error_out = BOREAS_CLEANUP_ERROR;
     }
 
   /* Ports array. */
-  g_array_free (scanner.ports, TRUE);
+  if (scanner.ports)
+    g_array_free (scanner.ports, TRUE);
+  scanner.ports = NULL;
 
-  g_hash_table_destroy (scanner.hosts_data->alivehosts);
-  /* targethosts: (ipstr, gvm_host_t *)
-   * gvm_host_t are freed by caller of start_alive_detection()! */
-  g_hash_table_destroy (scanner.hosts_data->targethosts);
-  g_free (scanner.hosts_data);
+  ratelimit_free (scanner.ratelimit);
+  scanner.ratelimit = NULL;
+  srccache_free (scanner.srccache);
+  scanner.srccache = NULL;
+  adaptive_free (scanner.adaptive);
+  scanner.adaptive = NULL;
+  alive_stats_free (scanner.stats);
+  scanner.stats = NULL;
+
+  /* Not set yet if the initialisation failed. */
+  if (scanner.hosts_data)
+    {
+      /* Still running if the sniffer was never started. */
+      wait_for_target_set (scanner.hosts_data);
+      hosts_set_free (scanner.hosts_data->alivehosts);
+      hosts_set_free (scanner.hosts_data->targethosts);
+      /* gvm_host_t are freed by caller of start_alive_detection()! */
+      g_ptr_array_free (scanner.hosts_data->targets, TRUE);
+      g_free (scanner.hosts_data);
+      scanner.hosts_data = NULL;
+    }
 
   /* Set error. */
   *(boreas_error_t *) error = error_out;
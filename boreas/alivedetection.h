@@ -8,14 +8,28 @@
 
 #include "../base/hosts.h"
 #include "../util/kb.h"
+#include "adaptive.h"
+#include "alivestats.h"
+#include "arpsweep.h"
+#include "hostset.h"
+#include "ndsweep.h"
+#include "publisher.h"
+#include "ratelimit.h"
+#include "srccache.h"
 
 #include <pcap.h>
+#include <pthread.h>
 
-/* to how many hosts are packets send to at a time. value <= 0 for no rate limit
- */
+/* Default size of the token bucket, i.e. how many packets may be sent back to
+ * back before the senders are paced to the maximum packets per second. Can be
+ * overwritten with the alive_test_burst preference. */
 #define BURST 100
-/* how long (in microseconds) to wait until new BURST of packets is send */
-#define BURST_TIMEOUT 100000
+/* Default maximum of packets per second sent by all senders together. Can be
+ * overwritten with the alive_test_max_pps preference, 0 for no limit. */
+#define DEFAULT_MAX_PPS 10000
+/* Default size (in bytes) of the capture ring of the sniffer. Can be
+ * overwritten with the alive_test_pcap_buffer_size preference. */
+#define DEFAULT_PCAP_BUFFER_SIZE (16 * 1024 * 1024)
 /* Src port of outgoing TCP pings. Used for filtering incoming packets. */
 #define FILTER_PORT 9910
 
@@ -30,10 +44,15 @@
 #define ALIVE_DETECTION_QUEUE "alive_detection"
 /* Signal to put on ALIVE_DETECTION_QUEUE if alive detection finished. */
 #define ALIVE_DETECTION_FINISHED "alive_detection_finished"
+/* KB item holding the statistics (JSON) of the finished alive detection. */
+#define ALIVE_DETECTION_STATS "alive_detection_stats"
 
 void *
 start_alive_detection (void *);
 
+void
+set_alive_detection_stats_callback (alive_stats_func_t, gpointer);
+
 typedef struct hosts_data hosts_data_t;
 typedef struct scan_restrictions scan_restrictions_t;
 
@@ -59,10 +78,28 @@ struct scanner
   GArray *ports;
   /* redis connection */
   kb_t main_kb;
+  /* publishes alive hosts on main_kb, NULL to push them directly */
+  publisher_t *publisher;
   /* pcap handle */
   pcap_t *pcap_handle;
+  /* capture statistics of the pcap handle, set when the sniffer stops */
+  struct pcap_stat pcap_stats;
   hosts_data_t *hosts_data;
   scan_restrictions_t *scan_restrictions;
+  /* token bucket shared by all send functions */
+  ratelimit_t *ratelimit;
+  /* source addresses of the TCP pings, NULL to always look them up */
+  srccache_t *srccache;
+  /* round trip times and re-probing, NULL if not enabled */
+  adaptive_t *adaptive;
+  /* statistics of this scanner, NULL to not count anything */
+  alive_stats_t *stats;
+  /* batched ARP requests on arpv4soc, NULL to send them with libnet */
+  arpsweep_t *arpsweep;
+  /* batched neighbor solicitations on arpv6soc, NULL to send one by one */
+  ndsweep_t *ndsweep;
+  /* batched ICMPv6 echo requests on icmpv6soc, NULL to send one by one */
+  ndsweep_t *icmpv6sweep;
   /* 0 do not print in stdout, 1 print in stdout used for cmd line cli. */
   int print_results;
 };
@@ -70,17 +107,23 @@ struct scanner
 typedef struct scanner scanner_t;
 
 /**
- * @brief The hosts_data struct holds the alive hosts and target hosts in
- * separate hashtables.
+ * @brief The hosts_data struct holds the alive hosts and target hosts.
+ *
+ * Alive and target hosts are kept in binary address sets, so replies can be
+ * classified without converting their source address into a string.
  */
 struct hosts_data
 {
-  /* Set of the form (ip_str, ip_str).
-   * Target hosts which were detected as alive. */
-  GHashTable *alivehosts;
-  /* Hashtable of the form (ip_str, gvm_host_t *). The gvm_host_t pointers point
-   * to hosts which are to be freed by the caller of start_alive_detection(). */
-  GHashTable *targethosts;
+  /* Target hosts which were detected as alive. */
+  hosts_set_t *alivehosts;
+  /* Set of all target hosts. Only complete after wait_for_target_set(). */
+  hosts_set_t *targethosts;
+  /* Array of unique target hosts (gvm_host_t *) in the order of the host list.
+   * The gvm_host_t pointers point to hosts which are to be freed by the caller
+   * of start_alive_detection(). */
+  GPtrArray *targets;
+  /* Thread filling targethosts, 0 if it is complete. */
+  pthread_t targethosts_thread;
 };
 
 /* Max_scan_hosts related struct. */
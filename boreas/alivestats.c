@@ -0,0 +1,220 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Statistics of the alive detection.
+ */
+
+#include "alivestats.h"
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/**
+ * @brief Get the name of a method as used in the statistics.
+ *
+ * @param method  Method.
+ *
+ * @return Static name of the method.
+ */
+const char *
+alive_method_name (alive_method_t method)
+{
+  switch (method)
+    {
+    case ALIVE_METHOD_ICMP:
+      return "icmp";
+    case ALIVE_METHOD_TCP_SYN:
+      return "tcp_syn";
+    case ALIVE_METHOD_TCP_ACK:
+      return "tcp_ack";
+    case ALIVE_METHOD_ARP:
+      return "arp";
+    default:
+      return "unknown";
+    }
+}
+
+/**
+ * @brief Create new statistics.
+ *
+ * @return New statistics with the start set to now. Free with
+ *         alive_stats_free().
+ */
+alive_stats_t *
+alive_stats_new (void)
+{
+  alive_stats_t *stats;
+
+  stats = g_malloc0 (sizeof (alive_stats_t));
+  stats->start = g_get_real_time ();
+
+  return stats;
+}
+
+/**
+ * @brief Free statistics.
+ *
+ * @param stats  Statistics to free.
+ */
+void
+alive_stats_free (alive_stats_t *stats)
+{
+  g_free (stats);
+}
+
+/**
+ * @brief Count a sent packet.
+ *
+ * @param stats   Statistics. If NULL nothing is counted.
+ * @param method  Method the packet was sent for.
+ * @param err     Result of the send function, <0 if the packet was not sent.
+ */
+void
+alive_stats_sent (alive_stats_t *stats, alive_method_t method, int err)
+{
+  if (stats == NULL || method >= ALIVE_METHOD_MAX)
+    return;
+
+  if (err < 0)
+    stats->send_errors[method]++;
+  else
+    stats->packets_sent[method]++;
+}
+
+/**
+ * @brief Count a reply of a target host.
+ *
+ * @param stats     Statistics. If NULL nothing is counted.
+ * @param method    Method the reply belongs to. ALIVE_METHOD_MAX if unknown.
+ * @param ts        Time the reply was captured.
+ * @param new_host  TRUE if this is the first reply of the host.
+ */
+void
+alive_stats_reply (alive_stats_t *stats, alive_method_t method,
+                   const struct timeval *ts, gboolean new_host)
+{
+  if (stats == NULL)
+    return;
+
+  if (method < ALIVE_METHOD_MAX)
+    {
+      stats->replies[method]++;
+      if (new_host)
+        stats->alive_hosts[method]++;
+    }
+  if (new_host)
+    {
+      gint64 time = (gint64) ts->tv_sec * G_USEC_PER_SEC + ts->tv_usec;
+
+      if (stats->first_reply == 0)
+        stats->first_reply = time;
+      stats->last_reply = time;
+    }
+}
+
+/**
+ * @brief Add the counters of one statistics to another.
+ *
+ * Used to get the statistics of all senders. Times are taken from dst.
+ *
+ * @param dst  Statistics to add the counters to.
+ * @param src  Statistics to take the counters from.
+ */
+void
+alive_stats_merge (alive_stats_t *dst, const alive_stats_t *src)
+{
+  if (dst == NULL || src == NULL)
+    return;
+
+  for (int i = 0; i < ALIVE_METHOD_MAX; i++)
+    {
+      dst->packets_sent[i] += src->packets_sent[i];
+      dst->send_errors[i] += src->send_errors[i];
+      dst->replies[i] += src->replies[i];
+      dst->alive_hosts[i] += src->alive_hosts[i];
+    }
+  dst->throttle_stalls += src->throttle_stalls;
+  dst->pcap_received += src->pcap_received;
+  dst->pcap_dropped += src->pcap_dropped;
+  dst->pcap_ifdropped += src->pcap_ifdropped;
+}
+
+/**
+ * @brief Add a per method counter as JSON object member.
+ *
+ * @param json      String to append to.
+ * @param name      Name of the member.
+ * @param counters  Counters indexed by alive_method_t.
+ */
+static void
+append_method_counters (GString *json, const char *name,
+                        const guint64 *counters)
+{
+  g_string_append_printf (json, "\"%s\":{", name);
+  for (int i = 0; i < ALIVE_METHOD_MAX; i++)
+    g_string_append_printf (json, "%s\"%s\":%" G_GUINT64_FORMAT,
+                            i ? "," : "", alive_method_name (i), counters[i]);
+  g_string_append (json, "},");
+}
+
+/**
+ * @brief Add a time relative to the start as JSON object member.
+ *
+ * @param json   String to append to.
+ * @param name   Name of the member.
+ * @param stats  Statistics.
+ * @param time   Realtime in microseconds. 0 for null.
+ */
+static void
+append_time (GString *json, const char *name, const alive_stats_t *stats,
+             gint64 time)
+{
+  if (time == 0 || stats->start == 0)
+    g_string_append_printf (json, "\"%s\":null", name);
+  else
+    g_string_append_printf (json, "\"%s\":%" G_GINT64_FORMAT, name,
+                            (time - stats->start) / 1000);
+}
+
+/**
+ * @brief Get the statistics as JSON object.
+ *
+ * Times are in milliseconds since the start of the scan.
+ *
+ * @param stats  Statistics.
+ *
+ * @return JSON string. Free with g_free().
+ */
+gchar *
+alive_stats_to_json (const alive_stats_t *stats)
+{
+  GString *json;
+
+  json = g_string_new ("{");
+  append_method_counters (json, "packets_sent", stats->packets_sent);
+  append_method_counters (json, "send_errors", stats->send_errors);
+  append_method_counters (json, "replies", stats->replies);
+  append_method_counters (json, "alive_hosts", stats->alive_hosts);
+  g_string_append_printf (json,
+                          "\"throttle_stalls\":%" G_GUINT64_FORMAT ","
+                          "\"pcap_received\":%" G_GUINT64_FORMAT ","
+                          "\"pcap_dropped\":%" G_GUINT64_FORMAT ","
+                          "\"pcap_ifdropped\":%" G_GUINT64_FORMAT ",",
+                          stats->throttle_stalls, stats->pcap_received,
+                          stats->pcap_dropped, stats->pcap_ifdropped);
+  append_time (json, "duration_ms", stats, stats->end);
+  g_string_append_c (json, ',');
+  append_time (json, "first_reply_ms", stats, stats->first_reply);
+  g_string_append_c (json, ',');
+  append_time (json, "last_reply_ms", stats, stats->last_reply);
+  g_string_append_c (json, '}');
+
+  return g_string_free (json, FALSE);
+}
@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_ALIVESTATS_H
+#define BOREAS_ALIVESTATS_H
+
+#include <glib.h>
+#include <sys/time.h>
+
+/**
+ * @brief Methods the statistics are kept for.
+ */
+typedef enum
+{
+  ALIVE_METHOD_ICMP,
+  ALIVE_METHOD_TCP_SYN,
+  ALIVE_METHOD_TCP_ACK,
+  ALIVE_METHOD_ARP,
+  /* Number of methods. Also used for replies which can not be classified. */
+  ALIVE_METHOD_MAX
+} alive_method_t;
+
+/**
+ * @brief Statistics of an alive scan.
+ *
+ * An alive_stats_t is not thread safe. Every sender thread owns its own and
+ * they are merged at the end. The sniffer thread only updates the reply
+ * related fields of the main one, the send functions only the packet related
+ * ones.
+ */
+struct alive_stats
+{
+  /* Packets handed to the kernel or libnet. */
+  guint64 packets_sent[ALIVE_METHOD_MAX];
+  /* Packets which could not be sent. */
+  guint64 send_errors[ALIVE_METHOD_MAX];
+  /* Replies captured from target hosts, including repeated ones. */
+  guint64 replies[ALIVE_METHOD_MAX];
+  /* Hosts detected as alive by the first reply, per method of that reply. */
+  guint64 alive_hosts[ALIVE_METHOD_MAX];
+  /* Times the senders were put to sleep by the token bucket. */
+  guint64 throttle_stalls;
+  /* Capture statistics of the sniffer. */
+  guint64 pcap_received;
+  guint64 pcap_dropped;
+  guint64 pcap_ifdropped;
+  /* Realtime in microseconds. 0 if not set. */
+  gint64 start;
+  gint64 end;
+  gint64 first_reply;
+  gint64 last_reply;
+};
+
+typedef struct alive_stats alive_stats_t;
+
+/**
+ * @brief Called with the statistics at the end of an alive scan.
+ *
+ * @param stats      Statistics. Only valid during the call.
+ * @param user_data  User data given when the callback was set.
+ */
+typedef void (*alive_stats_func_t) (const alive_stats_t *stats,
+                                    gpointer user_data);
+
+const char *
+alive_method_name (alive_method_t);
+
+alive_stats_t *
+alive_stats_new (void);
+
+void
+alive_stats_free (alive_stats_t *);
+
+void
+alive_stats_sent (alive_stats_t *, alive_method_t, int);
+
+void
+alive_stats_reply (alive_stats_t *, alive_method_t, const struct timeval *,
+                   gboolean);
+
+void
+alive_stats_merge (alive_stats_t *, const alive_stats_t *);
+
+gchar *
+alive_stats_to_json (const alive_stats_t *);
+
+#endif /* not BOREAS_ALIVESTATS_H */
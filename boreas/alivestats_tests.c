@@ -0,0 +1,129 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "alivestats.c"
+
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+Describe (alivestats);
+BeforeEach (alivestats)
+{
+}
+AfterEach (alivestats)
+{
+}
+
+Ensure (alivestats, sent_counts_packets_and_errors)
+{
+  alive_stats_t *stats;
+
+  stats = alive_stats_new ();
+  assert_that (stats->start, is_not_equal_to (0));
+
+  alive_stats_sent (stats, ALIVE_METHOD_ICMP, 0);
+  alive_stats_sent (stats, ALIVE_METHOD_ICMP, 0);
+  alive_stats_sent (stats, ALIVE_METHOD_ICMP, -1);
+  alive_stats_sent (stats, ALIVE_METHOD_TCP_ACK, 0);
+  alive_stats_sent (stats, ALIVE_METHOD_MAX, 0);
+  alive_stats_sent (NULL, ALIVE_METHOD_ICMP, 0);
+
+  assert_that (stats->packets_sent[ALIVE_METHOD_ICMP], is_equal_to (2));
+  assert_that (stats->send_errors[ALIVE_METHOD_ICMP], is_equal_to (1));
+  assert_that (stats->packets_sent[ALIVE_METHOD_TCP_ACK], is_equal_to (1));
+  assert_that (stats->packets_sent[ALIVE_METHOD_TCP_SYN], is_equal_to (0));
+
+  alive_stats_free (stats);
+}
+
+Ensure (alivestats, reply_tracks_first_and_last_alive_host)
+{
+  alive_stats_t *stats;
+  struct timeval first = {.tv_sec = 100, .tv_usec = 5};
+  struct timeval repeated = {.tv_sec = 101, .tv_usec = 0};
+  struct timeval last = {.tv_sec = 102, .tv_usec = 0};
+
+  stats = alive_stats_new ();
+  alive_stats_reply (stats, ALIVE_METHOD_TCP_SYN, &first, TRUE);
+  alive_stats_reply (stats, ALIVE_METHOD_TCP_SYN, &repeated, FALSE);
+  alive_stats_reply (stats, ALIVE_METHOD_MAX, &last, TRUE);
+
+  assert_that (stats->replies[ALIVE_METHOD_TCP_SYN], is_equal_to (2));
+  assert_that (stats->alive_hosts[ALIVE_METHOD_TCP_SYN], is_equal_to (1));
+  assert_that (stats->first_reply, is_equal_to (100000005));
+  assert_that (stats->last_reply, is_equal_to (102000000));
+
+  alive_stats_free (stats);
+}
+
+Ensure (alivestats, merge_adds_counters)
+{
+  alive_stats_t *dst, *src;
+
+  dst = alive_stats_new ();
+  src = alive_stats_new ();
+  alive_stats_sent (dst, ALIVE_METHOD_ARP, 0);
+  alive_stats_sent (src, ALIVE_METHOD_ARP, 0);
+  alive_stats_sent (src, ALIVE_METHOD_ARP, -1);
+  src->throttle_stalls = 3;
+
+  alive_stats_merge (dst, src);
+  alive_stats_merge (dst, NULL);
+  assert_that (dst->packets_sent[ALIVE_METHOD_ARP], is_equal_to (2));
+  assert_that (dst->send_errors[ALIVE_METHOD_ARP], is_equal_to (1));
+  assert_that (dst->throttle_stalls, is_equal_to (3));
+
+  alive_stats_free (src);
+  alive_stats_free (dst);
+}
+
+Ensure (alivestats, to_json_has_all_counters)
+{
+  alive_stats_t stats = {0};
+  gchar *json;
+
+  stats.packets_sent[ALIVE_METHOD_ICMP] = 10;
+  stats.replies[ALIVE_METHOD_ARP] = 2;
+  stats.pcap_dropped = 1;
+  stats.start = 1000000;
+  stats.end = 3000000;
+  stats.first_reply = 1500000;
+
+  json = alive_stats_to_json (&stats);
+  assert_that (json,
+               is_equal_to_string (
+                 "{\"packets_sent\":{\"icmp\":10,\"tcp_syn\":0,\"tcp_ack\":0,"
+                 "\"arp\":0},"
+                 "\"send_errors\":{\"icmp\":0,\"tcp_syn\":0,\"tcp_ack\":0,"
+                 "\"arp\":0},"
+                 "\"replies\":{\"icmp\":0,\"tcp_syn\":0,\"tcp_ack\":0,"
+                 "\"arp\":2},"
+                 "\"alive_hosts\":{\"icmp\":0,\"tcp_syn\":0,\"tcp_ack\":0,"
+                 "\"arp\":0},"
+                 "\"throttle_stalls\":0,\"pcap_received\":0,"
+                 "\"pcap_dropped\":1,\"pcap_ifdropped\":0,"
+                 "\"duration_ms\":2000,\"first_reply_ms\":500,"
+                 "\"last_reply_ms\":null}"));
+  g_free (json);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, alivestats, sent_counts_packets_and_errors);
+  add_test_with_context (suite, alivestats,
+                         reply_tracks_first_and_last_alive_host);
+  add_test_with_context (suite, alivestats, merge_adds_counters);
+  add_test_with_context (suite, alivestats, to_json_has_all_counters);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -172,8 +172,10 @@ format_mac (const unsigned char *mac, char *buf, size_t bufsize)
 
 /**
  * @brief  Send ARP who-has.
+ *
+ * @return 0 on success, -1 if the packet could not be sent.
  */
-static void
+static int
 pingip_send ()
 {
   libnet_ptag_t arp = 0, eth = 0;
@@ -206,7 +208,9 @@ pingip_send ()
   if (-1 == libnet_write (libnet))
     {
       g_warning ("%s: libnet_write(): %s", __func__, libnet_geterror (libnet));
+      return -1;
     }
+  return 0;
 }
 
 /**
@@ -214,10 +218,12 @@ pingip_send ()
  *
  * @param dst Destination address as string.
  *
+ * @return 0 on success, -1 if no ARP ping was sent.
  */
-void
+int
 send_arp_v4 (const char *dst_str)
 {
+  int err;
   char ebuf[LIBNET_ERRBUF_SIZE + PCAP_ERRBUF_SIZE];
   char *cp;
   char *ifname = NULL;
@@ -264,7 +270,7 @@ send_arp_v4 (const char *dst_str)
     {
       g_warning ("%s: Can't resolve %s. No ARP ping done for this addr.",
                  __func__, dst_str);
-      return;
+      return -1;
     }
   target = g_strdup (libnet_addr2name4 (dstip, 0));
 
@@ -296,7 +302,7 @@ send_arp_v4 (const char *dst_str)
                      " to use: %s. Address '%s' will be skipped.",
                      __func__, ebuf, target);
           g_free (target);
-          return;
+          return -1;
         }
       /* check for other probably-not interfaces */
       if (!strcmp (ifname, "ipsec") || !strcmp (ifname, "lo"))
@@ -323,7 +329,7 @@ send_arp_v4 (const char *dst_str)
                  __func__, libnet_geterror (libnet), target);
       g_free (target);
       g_free (ifname);
-      return;
+      return -1;
     }
   memcpy (srcmac, cp, ETH_ALEN);
 
@@ -337,7 +343,7 @@ send_arp_v4 (const char *dst_str)
                      __func__, ifname, libnet_geterror (libnet), target);
           g_free (target);
           g_free (ifname);
-          return;
+          return -1;
         }
     }
 
@@ -345,9 +351,11 @@ send_arp_v4 (const char *dst_str)
            dst_str, ifname, libnet_addr2name4 (libnet_get_ipaddr4 (libnet), 0),
            format_mac (srcmac, mac_debug_buf, sizeof (mac_debug_buf)));
 
-  pingip_send ();
+  err = pingip_send ();
   libnet_clear_packet (libnet);
 
   g_free (target);
   g_free (ifname);
+
+  return err;
 }
@@ -6,7 +6,7 @@
 #ifndef ARP_H
 #define ARP_H
 
-void
+int
 send_arp_v4 (const char *);
 
 #endif /* not ARP_H */
@@ -0,0 +1,383 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Batched ARP requests over a raw AF_PACKET socket.
+ *
+ * The outgoing interface is looked up once per /24 network of the targets,
+ * unless the source address cache of the scanner finds that the hosts of the
+ * network may be routed differently. Then it is looked up per host.
+ * For every interface one broadcast ARP request frame is prepared, only the
+ * target IP is rewritten per host. Requests are queued and sent in batches of
+ * ARPSWEEP_BATCH with sendmmsg().
+ *
+ * Interfaces without an Ethernet address or an IPv4 address can not be used.
+ * arpsweep_add() fails for their targets and the caller falls back to the
+ * libnet based send_arp_v4().
+ *
+ * An arpsweep_t is not thread safe.
+ */
+
+/* for struct mmsghdr and sendmmsg() */
+#define _GNU_SOURCE
+
+#include "arpsweep.h"
+
+#include "../base/networking.h" /* for gvm_source_addr() */
+#include "util.h"
+
+#include <errno.h>
+#include <glib.h>
+#include <ifaddrs.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/* Ethernet header and ARP request for IPv4, padded to the minimal frame. */
+#define ARP_FRAME_LEN 60
+/* Offset of the target IP address in the frame. */
+#define ARP_FRAME_TPA 38
+
+/**
+ * @brief Interface used for ARP requests.
+ */
+struct arp_iface
+{
+  /* Link layer broadcast destination on the interface. */
+  struct sockaddr_ll addr;
+  /* Request with the target IP address set to 0. */
+  uint8_t frame[ARP_FRAME_LEN];
+};
+
+/**
+ * @brief ARP sweep state.
+ */
+struct arpsweep
+{
+  /* Raw AF_PACKET socket. */
+  int soc;
+  /* Statistics to count the sent requests in. May be NULL. */
+  alive_stats_t *stats;
+  /* Interface name -> struct arp_iface *, NULL if not usable. */
+  GHashTable *ifaces;
+  /* Source address cache deciding which networks are routed alike. May be
+   * NULL. */
+  srccache_t *srccache;
+  /* Generation of srccache the networks were looked up in. */
+  guint generation;
+  /* /24 network from srccache_network_v4() -> struct arp_iface *, NULL if
+   * none. */
+  GHashTable *networks;
+  /* Queued requests. */
+  unsigned int count;
+  uint8_t frames[ARPSWEEP_BATCH][ARP_FRAME_LEN];
+  struct iovec iov[ARPSWEEP_BATCH];
+  struct mmsghdr msgs[ARPSWEEP_BATCH];
+};
+
+/**
+ * @brief Build a broadcast ARP request frame.
+ *
+ * @param[out] frame  Frame of ARP_FRAME_LEN bytes.
+ * @param[in]  mac    Ethernet address of the sender.
+ * @param[in]  srcip  IPv4 address of the sender.
+ */
+static void
+arp_frame_init (uint8_t *frame, const uint8_t *mac, const struct in_addr *srcip)
+{
+  struct ether_header *eth = (struct ether_header *) frame;
+  struct arphdr *arp = (struct arphdr *) (frame + ETHER_HDR_LEN);
+  uint8_t *payload = (uint8_t *) (arp + 1);
+
+  memset (frame, 0, ARP_FRAME_LEN);
+  memset (eth->ether_dhost, 0xff, ETH_ALEN);
+  memcpy (eth->ether_shost, mac, ETH_ALEN);
+  eth->ether_type = htons (ETHERTYPE_ARP);
+
+  arp->ar_hrd = htons (ARPHRD_ETHER);
+  arp->ar_pro = htons (ETHERTYPE_IP);
+  arp->ar_hln = ETH_ALEN;
+  arp->ar_pln = 4;
+  arp->ar_op = htons (ARPOP_REQUEST);
+  /* Sender hardware and protocol address. Target ones stay 0. */
+  memcpy (payload, mac, ETH_ALEN);
+  memcpy (payload + ETH_ALEN, &srcip->s_addr, 4);
+}
+
+/**
+ * @brief Get the first IPv4 address of an interface.
+ *
+ * @param[in]  name  Interface name.
+ * @param[out] addr  IPv4 address.
+ *
+ * @return 0 on success, -1 if the interface has no IPv4 address.
+ */
+static int
+iface_addr4 (const char *name, struct in_addr *addr)
+{
+  struct ifaddrs *ifaddr, *ifa;
+  int ret = -1;
+
+  if (getifaddrs (&ifaddr) == -1)
+    return -1;
+  for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next)
+    if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET
+        && g_strcmp0 (ifa->ifa_name, name) == 0)
+      {
+        *addr = ((struct sockaddr_in *) ifa->ifa_addr)->sin_addr;
+        ret = 0;
+        break;
+      }
+  freeifaddrs (ifaddr);
+
+  return ret;
+}
+
+/**
+ * @brief Prepare an interface for ARP requests.
+ *
+ * The source address of openvas is used if set, like by send_arp_v4().
+ *
+ * @param name  Interface name.
+ *
+ * @return New interface, NULL if it can not be used.
+ */
+static struct arp_iface *
+arp_iface_new (const char *name)
+{
+  static const uint8_t ethnull[ETH_ALEN] = {0};
+  struct arp_iface *iface;
+  uint8_t mac[ETH_ALEN] = {0};
+  struct in_addr srcip = {0};
+  unsigned int ifindex;
+
+  ifindex = if_nametoindex (name);
+  if (ifindex == 0 || get_source_mac_addr ((char *) name, mac) != 0
+      || memcmp (mac, ethnull, ETH_ALEN) == 0)
+    {
+      g_debug ("%s: No Ethernet address for %s. Using libnet for ARP.",
+               __func__, name);
+      return NULL;
+    }
+  gvm_source_addr (&srcip);
+  if (srcip.s_addr == INADDR_ANY && iface_addr4 (name, &srcip) != 0)
+    {
+      g_debug ("%s: No IPv4 address for %s. Using libnet for ARP.", __func__,
+               name);
+      return NULL;
+    }
+
+  iface = g_malloc0 (sizeof (struct arp_iface));
+  iface->addr.sll_family = AF_PACKET;
+  iface->addr.sll_protocol = htons (ETH_P_ARP);
+  iface->addr.sll_ifindex = ifindex;
+  iface->addr.sll_halen = ETH_ALEN;
+  memset (iface->addr.sll_addr, 0xff, ETH_ALEN);
+  arp_frame_init (iface->frame, mac, &srcip);
+
+  return iface;
+}
+
+/**
+ * @brief Get the interface to send ARP requests for a target on.
+ *
+ * @param sweep  ARP sweep.
+ * @param dst    Target address.
+ *
+ * @return Interface, NULL if none can be used.
+ */
+static struct arp_iface *
+arpsweep_iface (arpsweep_t *sweep, const struct in_addr *dst)
+{
+  struct sockaddr_storage target;
+  struct sockaddr_in *sin = (struct sockaddr_in *) &target;
+  struct arp_iface *iface = NULL;
+  gboolean cacheable;
+  guint32 network;
+  gpointer value;
+  char *name;
+
+  cacheable = srccache_network_v4 (sweep->srccache, dst, &network);
+  if (srccache_generation (sweep->srccache) != sweep->generation)
+    {
+      /* Routes changed. */
+      g_hash_table_remove_all (sweep->networks);
+      sweep->generation = srccache_generation (sweep->srccache);
+    }
+  if (cacheable
+      && g_hash_table_lookup_extended (
+        sweep->networks, GUINT_TO_POINTER (network), NULL, &value))
+    return value;
+
+  memset (&target, 0, sizeof (target));
+  sin->sin_family = AF_INET;
+  sin->sin_addr = *dst;
+  name = gvm_get_outgoing_iface (&target);
+  if (name)
+    {
+      if (g_hash_table_lookup_extended (sweep->ifaces, name, NULL, &value))
+        {
+          iface = value;
+          g_free (name);
+        }
+      else
+        {
+          iface = arp_iface_new (name);
+          g_hash_table_insert (sweep->ifaces, name, iface);
+        }
+    }
+  if (cacheable)
+    g_hash_table_insert (sweep->networks, GUINT_TO_POINTER (network), iface);
+
+  return iface;
+}
+
+/**
+ * @brief Queue an ARP request.
+ *
+ * @param sweep  ARP sweep.
+ * @param iface  Interface to send the request on.
+ * @param dst    Target address.
+ */
+static void
+arpsweep_queue (arpsweep_t *sweep, struct arp_iface *iface,
+                const struct in_addr *dst)
+{
+  unsigned int i = sweep->count;
+
+  memcpy (sweep->frames[i], iface->frame, ARP_FRAME_LEN);
+  memcpy (sweep->frames[i] + ARP_FRAME_TPA, &dst->s_addr, 4);
+  sweep->msgs[i].msg_hdr.msg_name = &iface->addr;
+  sweep->msgs[i].msg_hdr.msg_namelen = sizeof (iface->addr);
+  sweep->count++;
+}
+
+/**
+ * @brief Create an ARP sweep.
+ *
+ * @param soc       Raw AF_PACKET socket to send the requests with. Not closed
+ *                  by arpsweep_free().
+ * @param stats     Statistics to count the requests in. May be NULL.
+ * @param srccache  Source address cache of the scanner. Must outlive the
+ *                  sweep. If NULL the interface is looked up for every target.
+ *
+ * @return New ARP sweep. Free with arpsweep_free().
+ */
+arpsweep_t *
+arpsweep_new (int soc, alive_stats_t *stats, srccache_t *srccache)
+{
+  arpsweep_t *sweep;
+
+  sweep = g_malloc0 (sizeof (arpsweep_t));
+  sweep->soc = soc;
+  sweep->stats = stats;
+  sweep->srccache = srccache;
+  sweep->generation = srccache_generation (srccache);
+  sweep->ifaces = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                         g_free);
+  sweep->networks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  for (int i = 0; i < ARPSWEEP_BATCH; i++)
+    {
+      sweep->iov[i].iov_base = sweep->frames[i];
+      sweep->iov[i].iov_len = ARP_FRAME_LEN;
+      sweep->msgs[i].msg_hdr.msg_iov = &sweep->iov[i];
+      sweep->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  return sweep;
+}
+
+/**
+ * @brief Send all queued requests and free an ARP sweep.
+ *
+ * @param sweep  ARP sweep to free.
+ */
+void
+arpsweep_free (arpsweep_t *sweep)
+{
+  if (sweep == NULL)
+    return;
+
+  arpsweep_flush (sweep);
+  g_hash_table_destroy (sweep->networks);
+  g_hash_table_destroy (sweep->ifaces);
+  g_free (sweep);
+}
+
+/**
+ * @brief Queue an ARP request for a target.
+ *
+ * The queue is sent when it is full. Call arpsweep_flush() after the last
+ * target.
+ *
+ * @param sweep  ARP sweep. May be NULL.
+ * @param dst    Target address.
+ *
+ * @return 0 if the request was queued, -1 if the target can not be reached
+ *         over an interface usable for the sweep.
+ */
+int
+arpsweep_add (arpsweep_t *sweep, const struct in_addr *dst)
+{
+  struct arp_iface *iface;
+
+  if (sweep == NULL)
+    return -1;
+  iface = arpsweep_iface (sweep, dst);
+  if (iface == NULL)
+    return -1;
+
+  arpsweep_queue (sweep, iface, dst);
+  if (sweep->count == ARPSWEEP_BATCH)
+    arpsweep_flush (sweep);
+
+  return 0;
+}
+
+/**
+ * @brief Send all queued ARP requests.
+ *
+ * @param sweep  ARP sweep. May be NULL.
+ */
+void
+arpsweep_flush (arpsweep_t *sweep)
+{
+  unsigned int sent = 0;
+
+  if (sweep == NULL || sweep->count == 0)
+    return;
+
+  while (sent < sweep->count)
+    {
+      int ret;
+
+      ret = sendmmsg (sweep->soc, sweep->msgs + sent, sweep->count - sent, 0);
+      if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          g_warning ("%s: sendmmsg(): %s", __func__, strerror (errno));
+          break;
+        }
+      sent += ret;
+    }
+
+  if (sweep->stats)
+    {
+      sweep->stats->packets_sent[ALIVE_METHOD_ARP] += sent;
+      sweep->stats->send_errors[ALIVE_METHOD_ARP] += sweep->count - sent;
+    }
+  sweep->count = 0;
+}
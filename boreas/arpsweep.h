@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_ARPSWEEP_H
+#define BOREAS_ARPSWEEP_H
+
+#include "alivestats.h"
+#include "srccache.h"
+
+#include <netinet/in.h>
+
+/* Number of ARP requests sent with one sendmmsg() call. */
+#define ARPSWEEP_BATCH 64
+
+typedef struct arpsweep arpsweep_t;
+
+arpsweep_t *
+arpsweep_new (int, alive_stats_t *, srccache_t *);
+
+void
+arpsweep_free (arpsweep_t *);
+
+int
+arpsweep_add (arpsweep_t *, const struct in_addr *);
+
+void
+arpsweep_flush (arpsweep_t *);
+
+#endif /* not BOREAS_ARPSWEEP_H */
@@ -0,0 +1,219 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "arpsweep.c"
+#include "srccache.c"
+
+#include <arpa/inet.h>
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+Describe (arpsweep);
+BeforeEach (arpsweep)
+{
+}
+AfterEach (arpsweep)
+{
+}
+
+static const uint8_t test_mac[ETH_ALEN] = {0x02, 0x00, 0x00, 0xaa, 0xbb, 0xcc};
+
+/* Source address cache which knows no route more specific than /24. */
+static srccache_t *
+test_srccache_new (void)
+{
+  srccache_t *cache = srccache_new ();
+
+  cache->routes_loaded = TRUE;
+  return cache;
+}
+
+/* Add an usable interface for a /24 without looking it up. */
+static struct arp_iface *
+add_test_iface (arpsweep_t *sweep, const char *network)
+{
+  struct arp_iface *iface;
+  struct in_addr addr, srcip;
+
+  inet_pton (AF_INET, network, &addr);
+  inet_pton (AF_INET, "192.0.2.1", &srcip);
+  iface = g_malloc0 (sizeof (struct arp_iface));
+  iface->addr.sll_family = AF_PACKET;
+  arp_frame_init (iface->frame, test_mac, &srcip);
+  g_hash_table_insert (sweep->ifaces, g_strdup ("test0"), iface);
+  g_hash_table_insert (sweep->networks,
+                       GUINT_TO_POINTER (ntohl (addr.s_addr) >> 8), iface);
+
+  return iface;
+}
+
+Ensure (arpsweep, frame_template_is_broadcast_request)
+{
+  static const uint8_t broadcast[ETH_ALEN] = {0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff};
+  uint8_t frame[ARP_FRAME_LEN];
+  struct in_addr srcip;
+
+  inet_pton (AF_INET, "192.0.2.1", &srcip);
+  arp_frame_init (frame, test_mac, &srcip);
+
+  assert_that (memcmp (frame, broadcast, ETH_ALEN), is_equal_to (0));
+  assert_that (memcmp (frame + 6, test_mac, ETH_ALEN), is_equal_to (0));
+  assert_that (frame[12], is_equal_to (0x08));
+  assert_that (frame[13], is_equal_to (0x06));
+  /* Ethernet, IPv4, request. */
+  assert_that (frame[15], is_equal_to (1));
+  assert_that (frame[16], is_equal_to (0x08));
+  assert_that (frame[18], is_equal_to (6));
+  assert_that (frame[19], is_equal_to (4));
+  assert_that (frame[21], is_equal_to (ARPOP_REQUEST));
+  assert_that (memcmp (frame + 22, test_mac, ETH_ALEN), is_equal_to (0));
+  assert_that (memcmp (frame + 28, &srcip.s_addr, 4), is_equal_to (0));
+  for (int i = 32; i < ARP_FRAME_LEN; i++)
+    assert_that (frame[i], is_equal_to (0));
+}
+
+Ensure (arpsweep, add_rewrites_only_target_ip)
+{
+  arpsweep_t *sweep;
+  srccache_t *srccache;
+  struct arp_iface *iface;
+  struct in_addr dst;
+
+  srccache = test_srccache_new ();
+  sweep = arpsweep_new (-1, NULL, srccache);
+  iface = add_test_iface (sweep, "198.51.100.0");
+
+  inet_pton (AF_INET, "198.51.100.7", &dst);
+  assert_that (arpsweep_add (sweep, &dst), is_equal_to (0));
+  inet_pton (AF_INET, "198.51.100.8", &dst);
+  assert_that (arpsweep_add (sweep, &dst), is_equal_to (0));
+  assert_that (sweep->count, is_equal_to (2));
+
+  assert_that (memcmp (sweep->frames[1], iface->frame, ARP_FRAME_TPA),
+               is_equal_to (0));
+  assert_that (memcmp (sweep->frames[1] + ARP_FRAME_TPA, &dst.s_addr, 4),
+               is_equal_to (0));
+  assert_that (sweep->msgs[1].msg_hdr.msg_name, is_equal_to (&iface->addr));
+
+  /* Dropped on the invalid socket. */
+  sweep->count = 0;
+  arpsweep_free (sweep);
+  srccache_free (srccache);
+}
+
+Ensure (arpsweep, full_batch_is_flushed)
+{
+  arpsweep_t *sweep;
+  srccache_t *srccache;
+  alive_stats_t *stats;
+  struct in_addr dst;
+
+  stats = alive_stats_new ();
+  srccache = test_srccache_new ();
+  sweep = arpsweep_new (-1, stats, srccache);
+  add_test_iface (sweep, "198.51.100.0");
+
+  for (int i = 0; i < ARPSWEEP_BATCH + 2; i++)
+    {
+      dst.s_addr = htonl (0xc6336400 | i);
+      assert_that (arpsweep_add (sweep, &dst), is_equal_to (0));
+    }
+  /* The invalid socket fails the whole batch. */
+  assert_that (sweep->count, is_equal_to (2));
+  assert_that (stats->send_errors[ALIVE_METHOD_ARP],
+               is_equal_to (ARPSWEEP_BATCH));
+  assert_that (stats->packets_sent[ALIVE_METHOD_ARP], is_equal_to (0));
+
+  arpsweep_flush (sweep);
+  assert_that (sweep->count, is_equal_to (0));
+  assert_that (stats->send_errors[ALIVE_METHOD_ARP],
+               is_equal_to (ARPSWEEP_BATCH + 2));
+
+  arpsweep_free (sweep);
+  srccache_free (srccache);
+  alive_stats_free (stats);
+}
+
+Ensure (arpsweep, unusable_interface_is_cached_per_24)
+{
+  arpsweep_t *sweep;
+  srccache_t *srccache;
+  struct in_addr dst;
+
+  srccache = test_srccache_new ();
+  sweep = arpsweep_new (-1, NULL, srccache);
+
+  /* Loopback has no Ethernet address. */
+  inet_pton (AF_INET, "127.0.0.1", &dst);
+  assert_that (arpsweep_add (sweep, &dst), is_equal_to (-1));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (1));
+  inet_pton (AF_INET, "127.0.0.2", &dst);
+  assert_that (arpsweep_add (sweep, &dst), is_equal_to (-1));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (1));
+  assert_that (sweep->count, is_equal_to (0));
+
+  /* Forgotten when the routes change. */
+  srccache_flush (srccache);
+  srccache->routes_loaded = TRUE;
+  assert_that (arpsweep_add (sweep, &dst), is_equal_to (-1));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (1));
+  assert_that (sweep->generation, is_equal_to (1));
+
+  arpsweep_free (sweep);
+  srccache_free (srccache);
+
+  assert_that (arpsweep_add (NULL, &dst), is_equal_to (-1));
+}
+
+Ensure (arpsweep, hosts_of_more_specific_routes_are_looked_up_per_host)
+{
+  arpsweep_t *sweep;
+  srccache_t *srccache;
+  struct arp_iface *iface;
+  struct in_addr dst;
+
+  srccache = test_srccache_new ();
+  sweep = arpsweep_new (-1, NULL, srccache);
+  iface = add_test_iface (sweep, "198.51.100.0");
+  inet_pton (AF_INET, "198.51.100.128", &dst);
+  srccache_add_route (srccache, AF_INET, &dst, 25);
+
+  /* Not routed like the rest of the /24, so not taken from the network. */
+  inet_pton (AF_INET, "198.51.100.200", &dst);
+  assert_that (arpsweep_iface (sweep, &dst), is_not_equal_to (iface));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (1));
+  inet_pton (AF_INET, "198.51.100.7", &dst);
+  assert_that (arpsweep_iface (sweep, &dst), is_equal_to (iface));
+
+  /* Without a source address cache every host is looked up. */
+  arpsweep_free (sweep);
+  sweep = arpsweep_new (-1, NULL, NULL);
+  iface = add_test_iface (sweep, "198.51.100.0");
+  assert_that (arpsweep_iface (sweep, &dst), is_not_equal_to (iface));
+
+  arpsweep_free (sweep);
+  srccache_free (srccache);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, arpsweep, frame_template_is_broadcast_request);
+  add_test_with_context (suite, arpsweep, add_rewrites_only_target_ip);
+  add_test_with_context (suite, arpsweep, full_batch_is_flushed);
+  add_test_with_context (suite, arpsweep, unusable_interface_is_cached_per_24);
+  add_test_with_context (suite, arpsweep,
+                         hosts_of_more_specific_routes_are_looked_up_per_host);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
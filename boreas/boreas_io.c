@@ -7,10 +7,13 @@
 
 #include "../base/prefs.h" /* for prefs_get() */
 #include "alivedetection.h"
+#include "sender.h"
 #include "util.h"
 
+#include <errno.h>
 #include <glib/gprintf.h>
 #include <stdlib.h>
+#include <string.h>
 
 #undef G_LOG_DOMAIN
 /**
@@ -123,6 +126,29 @@ send_limit_msg (int num_not_scanned_hosts)
   return err;
 }
 
+/**
+ * @brief Handle the finish signal taken from the alive detection queue.
+ *
+ * Send an error message if max_scan_hosts was reached.
+ */
+static void
+handle_finish_signal (void)
+{
+  if (max_scan_hosts_reached ())
+    {
+      int num_not_scanned_hosts;
+
+      num_not_scanned_hosts = get_alive_hosts_count () - get_max_scan_hosts ();
+      if (0 != num_not_scanned_hosts)
+        {
+          send_limit_msg (num_not_scanned_hosts);
+        }
+    }
+  g_debug ("%s: Boreas already finished scanning and we reached the "
+           "end of the Queue of alive hosts.",
+           __func__);
+}
+
 /**
  * @brief Get new host from alive detection scanner.
  *
@@ -168,21 +194,7 @@ get_host_from_queue (kb_t alive_hosts_kb, gboolean *alive_deteciton_finished)
       /* check for finish signal/string */
       if (g_strcmp0 (host_str, ALIVE_DETECTION_FINISHED) == 0)
         {
-          /* Send Error message if max_scan_hosts was reached. */
-          if (max_scan_hosts_reached ())
-            {
-              int num_not_scanned_hosts;
-
-              num_not_scanned_hosts =
-                get_alive_hosts_count () - get_max_scan_hosts ();
-              if (0 != num_not_scanned_hosts)
-                {
-                  send_limit_msg (num_not_scanned_hosts);
-                }
-            }
-          g_debug ("%s: Boreas already finished scanning and we reached the "
-                   "end of the Queue of alive hosts.",
-                   __func__);
+          handle_finish_signal ();
           g_free (host_str);
           *alive_deteciton_finished = TRUE;
           return NULL;
@@ -209,6 +221,101 @@ get_host_from_queue (kb_t alive_hosts_kb, gboolean *alive_deteciton_finished)
     }
 }
 
+/**
+ * @brief Turn strings taken from the alive detection queue into hosts.
+ *
+ * @param[in]  host_strs  Strings taken from the queue. Freed.
+ * @param[in]  count      Number of strings.
+ * @param[out] hosts      Array to store the hosts in.
+ * @param[out] alive_detection_finished  Set to TRUE if the finish signal was
+ *                                       among the strings.
+ *
+ * @return Number of hosts stored in hosts.
+ */
+static int
+hosts_from_queue_strs (char **host_strs, int count, gvm_host_t **hosts,
+                       gboolean *alive_detection_finished)
+{
+  int num_hosts = 0;
+
+  for (int i = 0; i < count; i++)
+    {
+      if (g_strcmp0 (host_strs[i], ALIVE_DETECTION_FINISHED) == 0)
+        {
+          handle_finish_signal ();
+          *alive_detection_finished = TRUE;
+        }
+      else
+        {
+          gvm_host_t *host = gvm_host_from_str (host_strs[i]);
+
+          if (host)
+            hosts[num_hosts++] = host;
+          else
+            g_warning ("%s: Could not transform IP string \"%s\" into "
+                       "internal representation.",
+                       __func__, host_strs[i]);
+        }
+      g_free (host_strs[i]);
+    }
+
+  return num_hosts;
+}
+
+/**
+ * @brief Get several new hosts from alive detection scanner at once.
+ *
+ * Like get_host_from_queue(), but takes up to max hosts from the queue with a
+ * single round trip. If the queue is empty and a timeout is given, block until
+ * the alive detection scanner puts a host or the finish signal on the queue,
+ * instead of polling.
+ *
+ * @param[in]  alive_hosts_kb  Redis connection for accessing the queue on
+ *                             which the alive detection scanner puts found
+ *                             hosts.
+ * @param[out] hosts           Array of at least max elements to store the
+ *                             hosts in. The hosts are to be freed by the
+ *                             caller.
+ * @param[in]  max             Maximum number of hosts to get.
+ * @param[in]  timeout         Seconds to wait if the queue is empty. 0 to
+ *                             return at once.
+ * @param[out] alive_detection_finished  Set to TRUE if alive detection
+ *                                       finished and the queue is drained.
+ *
+ * @return Number of hosts stored in hosts. 0 if no host was found, on timeout
+ * or on error.
+ */
+int
+get_hosts_from_queue (kb_t alive_hosts_kb, gvm_host_t **hosts, int max,
+                      int timeout, gboolean *alive_detection_finished)
+{
+  char **host_strs;
+  int count, num_hosts;
+
+  if (!alive_hosts_kb)
+    {
+      g_debug ("%s: connection to redis is not valid", __func__);
+      return 0;
+    }
+  if (max <= 0)
+    return 0;
+
+  host_strs = g_malloc_n (max, sizeof (char *));
+  count = kb_item_pop_str_multi_timeout (alive_hosts_kb, ALIVE_DETECTION_QUEUE,
+                                         host_strs, max, timeout);
+  if (count <= 0)
+    {
+      g_free (host_strs);
+      return 0;
+    }
+
+  num_hosts =
+    hosts_from_queue_strs (host_strs, count, hosts, alive_detection_finished);
+  g_free (host_strs);
+
+  return num_hosts;
+}
+
 /**
  * @brief Put host value string on queue of hosts to be considered as alive.
  *
@@ -374,7 +481,9 @@ handle_scan_restrictions (scanner_t *scanner, gchar *addr_str)
     {
       /* Print host on command line if no kb is available. No kb available could
        * mean that boreas is used as commandline tool.*/
-      if (kb != NULL)
+      if (scanner->publisher != NULL)
+        publisher_push (scanner->publisher, addr_str);
+      else if (kb != NULL)
         put_host_on_queue (kb, addr_str);
       else
         {
@@ -392,6 +501,109 @@ handle_scan_restrictions (scanner_t *scanner, gchar *addr_str)
     }
 }
 
+/**
+ * @brief Add all targets to the target set.
+ *
+ * @param hosts_data_p  Pointer to hosts_data_t.
+ *
+ * @return NULL.
+ */
+static void *
+fill_target_set (void *hosts_data_p)
+{
+  hosts_data_t *hosts_data = hosts_data_p;
+  GPtrArray *targets = hosts_data->targets;
+  gint64 start = g_get_monotonic_time ();
+  guint duplicates = 0;
+
+  for (guint i = 0; i < targets->len; i++)
+    if (!hosts_set_add_host (hosts_data->targethosts,
+                             g_ptr_array_index (targets, i)))
+      duplicates++;
+
+  g_debug ("%s: Added %u targets in %" G_GINT64_FORMAT " ms, %u duplicates.",
+           __func__, targets->len, (g_get_monotonic_time () - start) / 1000,
+           duplicates);
+  return NULL;
+}
+
+/**
+ * @brief Start filling the target set from the targets array.
+ *
+ * Probes can be sent while the set is filled. Replies are only matched
+ * against it after wait_for_target_set(), until then they stay in the capture
+ * buffer. Falls back to filling the set right away if no thread can be
+ * started.
+ *
+ * @param hosts_data  Hosts data with the targets array and an empty target
+ *                    set.
+ */
+void
+fill_target_set_async (hosts_data_t *hosts_data)
+{
+  int err;
+
+  err = pthread_create (&hosts_data->targethosts_thread, NULL,
+                        fill_target_set, hosts_data);
+  if (err)
+    {
+      g_warning ("%s: pthread_create() failed: %s. Filling the target set "
+                 "first.",
+                 __func__, strerror (err));
+      hosts_data->targethosts_thread = 0;
+      fill_target_set (hosts_data);
+    }
+}
+
+/**
+ * @brief Wait until the target set is complete.
+ *
+ * Must not be called from two threads at the same time.
+ *
+ * @param hosts_data  Hosts data.
+ */
+void
+wait_for_target_set (hosts_data_t *hosts_data)
+{
+  if (hosts_data->targethosts_thread == 0)
+    return;
+
+  pthread_join (hosts_data->targethosts_thread, NULL);
+  hosts_data->targethosts_thread = 0;
+}
+
+/**
+ * @brief Reports dead hosts to ospd-openvas over one connection.
+ */
+struct dead_hosts_reporter
+{
+  /* Connection to the main kb, NULL if it could not be opened. */
+  kb_t main_kb;
+  /* Dead hosts not reported yet. */
+  int pending;
+  /* Monotonic time of the last report. */
+  gint64 last;
+  /* Number of messages pushed. */
+  unsigned int reports;
+};
+
+/**
+ * @brief Push a dead hosts message for ospd-openvas.
+ *
+ * @param main_kb           Connection to the main kb.
+ * @param count_dead_hosts  Number of dead hosts.
+ */
+static void
+push_dead_hosts (kb_t main_kb, int count_dead_hosts)
+{
+  char dead_host_msg_to_ospd_openvas[2048];
+
+  snprintf (dead_host_msg_to_ospd_openvas,
+            sizeof (dead_host_msg_to_ospd_openvas),
+            "DEADHOST||| ||| ||| ||| |||%d", count_dead_hosts);
+  kb_item_push_str (main_kb, "internal/results", dead_host_msg_to_ospd_openvas);
+}
+
 /**
  * @brief Send the number of dead hosts to ospd-openvas.
  *
@@ -409,7 +621,6 @@ send_dead_hosts_to_ospd_openvas (int count_dead_hosts)
 {
   kb_t main_kb;
   int maindbid;
-  char dead_host_msg_to_ospd_openvas[2048];
 
   maindbid = atoi (prefs_get ("ov_maindbid"));
   main_kb = kb_direct_conn (prefs_get ("db_address"), maindbid);
@@ -421,14 +632,96 @@ send_dead_hosts_to_ospd_openvas (int count_dead_hosts)
                __func__);
     }
 
-  snprintf (dead_host_msg_to_ospd_openvas,
-            sizeof (dead_host_msg_to_ospd_openvas),
-            "DEADHOST||| ||| ||| ||| |||%d", count_dead_hosts);
-  kb_item_push_str (main_kb, "internal/results", dead_host_msg_to_ospd_openvas);
+  push_dead_hosts (main_kb, count_dead_hosts);
 
   kb_lnk_reset (main_kb);
 }
 
+/**
+ * @brief Create a reporter of dead hosts.
+ *
+ * Unlike send_dead_hosts_to_ospd_openvas() the connection is kept for the
+ * whole alive scan and updates are coalesced, so frequent progress updates do
+ * not cause a message and a reconnect each.
+ *
+ * @param main_kb  Connection to the main kb. Reset by
+ *                 dead_hosts_reporter_free(). NULL to drop all reports.
+ *
+ * @return New reporter. Free with dead_hosts_reporter_free().
+ */
+dead_hosts_reporter_t *
+dead_hosts_reporter_new (kb_t main_kb)
+{
+  dead_hosts_reporter_t *reporter;
+
+  if (main_kb == NULL)
+    g_debug ("%s: Could not connect to main_kb for sending dead hosts to "
+             "ospd-openvas.",
+             __func__);
+  reporter = g_malloc0 (sizeof (dead_hosts_reporter_t));
+  reporter->main_kb = main_kb;
+  reporter->last = g_get_monotonic_time ();
+
+  return reporter;
+}
+
+/**
+ * @brief Add dead hosts to report.
+ *
+ * They are sent together with the pending ones if DEAD_HOSTS_REPORT_INTERVAL
+ * passed since the last report or DEAD_HOSTS_REPORT_COUNT are pending.
+ *
+ * @param reporter          Reporter.
+ * @param count_dead_hosts  Number of dead hosts.
+ */
+void
+dead_hosts_reporter_add (dead_hosts_reporter_t *reporter,
+                         int count_dead_hosts)
+{
+  reporter->pending += count_dead_hosts;
+  if (reporter->pending >= DEAD_HOSTS_REPORT_COUNT
+      || g_get_monotonic_time () - reporter->last
+           >= DEAD_HOSTS_REPORT_INTERVAL * 1000)
+    dead_hosts_reporter_flush (reporter);
+}
+
+/**
+ * @brief Send the pending dead hosts to ospd-openvas.
+ *
+ * @param reporter  Reporter.
+ */
+void
+dead_hosts_reporter_flush (dead_hosts_reporter_t *reporter)
+{
+  reporter->last = g_get_monotonic_time ();
+  if (reporter->pending == 0)
+    return;
+
+  if (reporter->main_kb)
+    {
+      push_dead_hosts (reporter->main_kb, reporter->pending);
+      reporter->reports++;
+    }
+  reporter->pending = 0;
+}
+
+/**
+ * @brief Send the pending dead hosts and free a reporter.
+ *
+ * @param reporter  Reporter to free.
+ */
+void
+dead_hosts_reporter_free (dead_hosts_reporter_t *reporter)
+{
+  if (reporter == NULL)
+    return;
+
+  dead_hosts_reporter_flush (reporter);
+  if (reporter->main_kb)
+    kb_lnk_reset (reporter->main_kb);
+  g_free (reporter);
+}
+
 /**
  * @brief Get the openvas scan id of the current task.
  *
@@ -517,3 +810,155 @@ get_alive_test_wait_timeout (void)
 
   return WAIT_FOR_REPLIES_TIMEOUT;
 }
+
+/**
+ * @brief Get the maximum number of packets per second boreas may send.
+ *
+ * A value of 0 disables the rate limit. If the preference is not set or is
+ * invalid, DEFAULT_MAX_PPS is used.
+ *
+ * @return Maximum packets per second, 0 for no limit.
+ */
+unsigned int
+get_alive_test_max_pps (void)
+{
+  const gchar *str_pps = NULL;
+  int pps;
+
+  str_pps = prefs_get ("alive_test_max_pps");
+  if (str_pps == NULL)
+    return DEFAULT_MAX_PPS;
+
+  pps = atoi (str_pps);
+  if (pps < 0)
+    {
+      g_debug ("%s: Invalid alive_test_max_pps value. It must be an integer "
+               "greater than or equal to zero.",
+               __func__);
+      return DEFAULT_MAX_PPS;
+    }
+
+  return pps;
+}
+
+/**
+ * @brief Get the number of packets boreas may send back to back before the
+ * rate limit sets in.
+ *
+ * If the preference is not set or is invalid, BURST is used.
+ *
+ * @return Burst size.
+ */
+unsigned int
+get_alive_test_burst (void)
+{
+  const gchar *str_burst = NULL;
+  int burst;
+
+  str_burst = prefs_get ("alive_test_burst");
+  if (str_burst == NULL)
+    return BURST;
+
+  burst = atoi (str_burst);
+  if (burst <= 0)
+    {
+      g_debug ("%s: Invalid alive_test_burst value. It must be an integer "
+               "greater than zero.",
+               __func__);
+      return BURST;
+    }
+
+  return burst;
+}
+
+/**
+ * @brief Get the size of the capture ring used by the sniffer.
+ *
+ * If the preference is not set or is invalid, DEFAULT_PCAP_BUFFER_SIZE is used.
+ *
+ * @return Buffer size in bytes.
+ */
+int
+get_alive_test_pcap_buffer_size (void)
+{
+  const gchar *str_size = NULL;
+  int size;
+
+  str_size = prefs_get ("alive_test_pcap_buffer_size");
+  if (str_size == NULL)
+    return DEFAULT_PCAP_BUFFER_SIZE;
+
+  size = atoi (str_size);
+  if (size <= 0)
+    {
+      g_debug ("%s: Invalid alive_test_pcap_buffer_size value. It must be an "
+               "integer greater than zero.",
+               __func__);
+      return DEFAULT_PCAP_BUFFER_SIZE;
+    }
+
+  return size;
+}
+
+/**
+ * @brief Get the maximum number of times a host without reply is probed again.
+ *
+ * If the preference is set to a value greater than 0 the alive detection
+ * waits for replies based on the measured round trip times instead of the
+ * fixed alive_test_wait_timeout, and probes the hosts which did not reply
+ * again. If the preference is not set or is invalid, 0 is returned. The value
+ * is capped at MAX_ALIVE_TEST_RETRIES.
+ *
+ * @return Maximum number of retries.
+ */
+unsigned int
+get_alive_test_max_retries (void)
+{
+  const gchar *str_retries = NULL;
+  int retries;
+
+  str_retries = prefs_get ("alive_test_max_retries");
+  if (str_retries == NULL)
+    return 0;
+
+  retries = atoi (str_retries);
+  if (retries < 0)
+    {
+      g_debug ("%s: Invalid alive_test_max_retries value. It must be an "
+               "integer greater than or equal to zero.",
+               __func__);
+      return 0;
+    }
+
+  return MIN (retries, MAX_ALIVE_TEST_RETRIES);
+}
+
+/**
+ * @brief Get the number of threads sending ICMP and TCP pings.
+ *
+ * If the preference is not set or is invalid, a single sender is used. The
+ * value is capped at MAX_SENDER_THREADS.
+ *
+ * @return Number of sender threads.
+ */
+unsigned int
+get_alive_test_sender_threads (void)
+{
+  const gchar *str_threads = NULL;
+  int threads;
+
+  str_threads = prefs_get ("alive_test_sender_threads");
+  if (str_threads == NULL)
+    return 1;
+
+  threads = atoi (str_threads);
+  if (threads <= 0)
+    {
+      g_debug ("%s: Invalid alive_test_sender_threads value. It must be an "
+               "integer greater than zero.",
+               __func__);
+      return 1;
+    }
+
+  return MIN (threads, MAX_SENDER_THREADS);
+}
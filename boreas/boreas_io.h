@@ -14,6 +14,9 @@
 gvm_host_t *
 get_host_from_queue (kb_t, gboolean *);
 
+int
+get_hosts_from_queue (kb_t, gvm_host_t **, int, int, gboolean *);
+
 void
 put_host_on_queue (kb_t, char *);
 
@@ -27,6 +30,31 @@ int finish_signal_on_queue (kb_t);
 void
 send_dead_hosts_to_ospd_openvas (int);
 
+/* Dead hosts are reported at most every DEAD_HOSTS_REPORT_INTERVAL ms, unless
+ * DEAD_HOSTS_REPORT_COUNT of them are pending. */
+#define DEAD_HOSTS_REPORT_INTERVAL 250
+#define DEAD_HOSTS_REPORT_COUNT 10000
+
+typedef struct dead_hosts_reporter dead_hosts_reporter_t;
+
+dead_hosts_reporter_t *
+dead_hosts_reporter_new (kb_t);
+
+void
+dead_hosts_reporter_add (dead_hosts_reporter_t *, int);
+
+void
+dead_hosts_reporter_flush (dead_hosts_reporter_t *);
+
+void
+dead_hosts_reporter_free (dead_hosts_reporter_t *);
+
+void
+fill_target_set_async (hosts_data_t *);
+
+void
+wait_for_target_set (hosts_data_t *);
+
 void
 init_scan_restrictions (scanner_t *, int);
 
@@ -45,6 +73,21 @@ get_alive_test_ports (void);
 unsigned int
 get_alive_test_wait_timeout (void);
 
+unsigned int
+get_alive_test_max_pps (void);
+
+unsigned int
+get_alive_test_burst (void);
+
+int
+get_alive_test_pcap_buffer_size (void);
+
+unsigned int
+get_alive_test_sender_threads (void);
+
+unsigned int
+get_alive_test_max_retries (void);
+
 int
 get_alive_hosts_count (void);
 
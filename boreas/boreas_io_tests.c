@@ -5,9 +5,59 @@
 
 #include "boreas_io.c"
 
+#include <arpa/inet.h>
 #include <cgreen/cgreen.h>
 #include <cgreen/mocks.h>
 
+/* Fake alive detection queue. Items are popped from the end. */
+static GPtrArray *fake_queue;
+
+static int fake_pop_timeout;
+
+static int
+fake_pop_str_multi_timeout (kb_t kb, const char *name, char **values,
+                            size_t max, int timeout)
+{
+  size_t count = 0;
+
+  (void) kb;
+  (void) name;
+  fake_pop_timeout = timeout;
+  while (count < max && fake_queue->len > 0)
+    values[count++] =
+      g_ptr_array_remove_index (fake_queue, fake_queue->len - 1);
+  return count;
+}
+
+/* Values pushed to the fake kb. */
+static GPtrArray *fake_pushed;
+
+static int fake_lnk_resets;
+
+static int
+fake_push_str (kb_t kb, const char *name, const char *value)
+{
+  (void) kb;
+  (void) name;
+  g_ptr_array_add (fake_pushed, g_strdup (value));
+  return 0;
+}
+
+static int
+fake_lnk_reset (kb_t kb)
+{
+  (void) kb;
+  fake_lnk_resets++;
+  return 0;
+}
+
+static struct kb_operations fake_kb_ops = {
+  .kb_pop_str_multi_timeout = fake_pop_str_multi_timeout,
+  .kb_push_str = fake_push_str,
+  .kb_lnk_reset = fake_lnk_reset,
+};
+static struct kb fake_kb = {.kb_ops = &fake_kb_ops};
+
 Describe (boreas_io);
 BeforeEach (boreas_io)
 {
@@ -21,6 +71,148 @@ Ensure (boreas_io, dummy_test)
   assert_that (0, is_equal_to (0));
 }
 
+Ensure (boreas_io, get_alive_test_pcap_buffer_size_uses_pref)
+{
+  prefs_set ("alive_test_pcap_buffer_size", "4194304");
+  assert_that (get_alive_test_pcap_buffer_size (), is_equal_to (4194304));
+}
+
+Ensure (boreas_io, get_alive_test_pcap_buffer_size_rejects_invalid)
+{
+  prefs_set ("alive_test_pcap_buffer_size", "0");
+  assert_that (get_alive_test_pcap_buffer_size (),
+               is_equal_to (DEFAULT_PCAP_BUFFER_SIZE));
+  prefs_set ("alive_test_pcap_buffer_size", "-1");
+  assert_that (get_alive_test_pcap_buffer_size (),
+               is_equal_to (DEFAULT_PCAP_BUFFER_SIZE));
+}
+
+Ensure (boreas_io, get_hosts_from_queue_gets_batches)
+{
+  gvm_host_t *hosts[2];
+  gboolean finished = FALSE;
+  gchar *host_str;
+
+  fake_queue = g_ptr_array_new ();
+  g_ptr_array_add (fake_queue, g_strdup (ALIVE_DETECTION_FINISHED));
+  g_ptr_array_add (fake_queue, g_strdup ("192.168.0.3"));
+  g_ptr_array_add (fake_queue, g_strdup ("not a host"));
+  g_ptr_array_add (fake_queue, g_strdup ("192.168.0.2"));
+  g_ptr_array_add (fake_queue, g_strdup ("192.168.0.1"));
+
+  assert_that (get_hosts_from_queue (&fake_kb, hosts, 2, 0, &finished),
+               is_equal_to (2));
+  assert_that (finished, is_false);
+  host_str = gvm_host_value_str (hosts[0]);
+  assert_that (host_str, is_equal_to_string ("192.168.0.1"));
+  g_free (host_str);
+  host_str = gvm_host_value_str (hosts[1]);
+  assert_that (host_str, is_equal_to_string ("192.168.0.2"));
+  g_free (host_str);
+  gvm_host_free (hosts[0]);
+  gvm_host_free (hosts[1]);
+
+  /* Invalid host strings are skipped. */
+  assert_that (get_hosts_from_queue (&fake_kb, hosts, 2, 0, &finished),
+               is_equal_to (1));
+  assert_that (finished, is_false);
+  gvm_host_free (hosts[0]);
+
+  assert_that (get_hosts_from_queue (&fake_kb, hosts, 2, 0, &finished),
+               is_equal_to (0));
+  assert_that (finished, is_true);
+  assert_that (fake_queue->len, is_equal_to (0));
+
+  g_ptr_array_free (fake_queue, TRUE);
+}
+
+Ensure (boreas_io, get_hosts_from_queue_passes_timeout)
+{
+  gvm_host_t *hosts[8];
+  gboolean finished = FALSE;
+
+  fake_queue = g_ptr_array_new ();
+  assert_that (get_hosts_from_queue (&fake_kb, hosts, 8, 5, &finished),
+               is_equal_to (0));
+  assert_that (fake_pop_timeout, is_equal_to (5));
+  assert_that (finished, is_false);
+
+  /* No round trip without a kb or room for hosts. */
+  fake_pop_timeout = -1;
+  assert_that (get_hosts_from_queue (NULL, hosts, 8, 5, &finished),
+               is_equal_to (0));
+  assert_that (get_hosts_from_queue (&fake_kb, hosts, 0, 5, &finished),
+               is_equal_to (0));
+  assert_that (fake_pop_timeout, is_equal_to (-1));
+
+  g_ptr_array_free (fake_queue, TRUE);
+}
+
+Ensure (boreas_io, fill_target_set_async_fills_set)
+{
+  hosts_data_t hosts_data = {0};
+  gvm_hosts_t *hosts;
+  gvm_host_t *host;
+  struct in_addr addr;
+
+  hosts = gvm_hosts_new ("192.168.0.0/24");
+  hosts_data.targethosts = hosts_set_new ();
+  hosts_data.targets = g_ptr_array_new ();
+  while ((host = gvm_hosts_next (hosts)))
+    g_ptr_array_add (hosts_data.targets, host);
+
+  fill_target_set_async (&hosts_data);
+  wait_for_target_set (&hosts_data);
+  assert_that (hosts_data.targethosts_thread, is_equal_to (0));
+  assert_that (hosts_set_size (hosts_data.targethosts),
+               is_equal_to (hosts_data.targets->len));
+  inet_pton (AF_INET, "192.168.0.77", &addr);
+  assert_that (hosts_set_contains_addr4 (hosts_data.targethosts, &addr),
+               is_true);
+
+  /* Nothing to wait for anymore. */
+  wait_for_target_set (&hosts_data);
+
+  hosts_set_free (hosts_data.targethosts);
+  g_ptr_array_free (hosts_data.targets, TRUE);
+  gvm_hosts_free (hosts);
+}
+
+Ensure (boreas_io, dead_hosts_reporter_coalesces_updates)
+{
+  dead_hosts_reporter_t *reporter;
+
+  fake_pushed = g_ptr_array_new_with_free_func (g_free);
+  fake_lnk_resets = 0;
+  reporter = dead_hosts_reporter_new (&fake_kb);
+
+  /* Reported once enough hosts are pending. */
+  for (int i = 0; i < 10; i++)
+    dead_hosts_reporter_add (reporter, DEAD_HOSTS_REPORT_COUNT / 10);
+  assert_that (fake_pushed->len, is_equal_to (1));
+  assert_that (g_ptr_array_index (fake_pushed, 0),
+               is_equal_to_string ("DEADHOST||| ||| ||| ||| |||10000"));
+
+  /* Reported once the interval passed. */
+  dead_hosts_reporter_add (reporter, 5);
+  assert_that (fake_pushed->len, is_equal_to (1));
+  reporter->last -= (DEAD_HOSTS_REPORT_INTERVAL + 1) * 1000;
+  dead_hosts_reporter_add (reporter, 1);
+  assert_that (fake_pushed->len, is_equal_to (2));
+  assert_that (g_ptr_array_index (fake_pushed, 1),
+               is_equal_to_string ("DEADHOST||| ||| ||| ||| |||6"));
+
+  /* The rest is reported when freed, over the same connection. */
+  dead_hosts_reporter_add (reporter, 3);
+  dead_hosts_reporter_free (reporter);
+  assert_that (fake_pushed->len, is_equal_to (3));
+  assert_that (g_ptr_array_index (fake_pushed, 2),
+               is_equal_to_string ("DEADHOST||| ||| ||| ||| |||3"));
+  assert_that (fake_lnk_resets, is_equal_to (1));
+
+  g_ptr_array_free (fake_pushed, TRUE);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -29,6 +221,15 @@ main (int argc, char **argv)
   suite = create_test_suite ();
 
   add_test_with_context (suite, boreas_io, dummy_test);
+  add_test_with_context (suite, boreas_io,
+                         get_alive_test_pcap_buffer_size_uses_pref);
+  add_test_with_context (suite, boreas_io,
+                         get_alive_test_pcap_buffer_size_rejects_invalid);
+  add_test_with_context (suite, boreas_io, get_hosts_from_queue_gets_batches);
+  add_test_with_context (suite, boreas_io, get_hosts_from_queue_passes_timeout);
+  add_test_with_context (suite, boreas_io, fill_target_set_async_fills_set);
+  add_test_with_context (suite, boreas_io,
+                         dead_hosts_reporter_coalesces_updates);
 
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
@@ -39,20 +39,34 @@ init_cli (scanner_t *scanner, gvm_hosts_t *hosts, alive_test_t alive_test,
   scanner->main_kb = NULL;
   scanner->print_results = print_results;
 
+  scanner->ratelimit =
+    ratelimit_new (get_alive_test_max_pps (), get_alive_test_burst ());
+  scanner->srccache = srccache_new ();
+
   /* hosts_data */
   scanner->hosts_data = g_malloc0 (sizeof (hosts_data_t));
-  scanner->hosts_data->alivehosts =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-  scanner->hosts_data->targethosts =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  scanner->hosts_data->alivehosts = hosts_set_new ();
+  scanner->hosts_data->targethosts = hosts_set_new ();
+  scanner->hosts_data->targets = g_ptr_array_new ();
   for (host = gvm_hosts_next (hosts); host; host = gvm_hosts_next (hosts))
-    g_hash_table_insert (scanner->hosts_data->targethosts,
-                         gvm_host_value_str (host), host);
+    if (hosts_set_add_host (scanner->hosts_data->targethosts, host))
+      g_ptr_array_add (scanner->hosts_data->targets, host);
 
   /* Sockets. */
   error = set_all_needed_sockets (scanner, alive_test);
   if (error != 0)
     return error;
+  if (alive_test & ALIVE_TEST_ARP)
+    {
+      scanner->arpsweep =
+        arpsweep_new (scanner->arpv4soc, NULL, scanner->srccache);
+      scanner->ndsweep =
+        ndsweep_new (scanner->arpv6soc, ND_NEIGHBOR_SOLICIT, NULL,
+                     scanner->srccache);
+    }
+  if (alive_test & ALIVE_TEST_ICMP)
+    scanner->icmpv6sweep =
+      ndsweep_new (scanner->icmpv6soc, ICMP6_ECHO_REQUEST, NULL, NULL);
 
   /* Only init portlist if either TCP-ACK or TCP-SYN ping is used. */
   if (alive_test & ALIVE_TEST_TCP_SYN_SERVICE
@@ -76,15 +90,21 @@ free_cli (scanner_t *scanner, alive_test_t alive_test)
 {
   int close_err;
 
+  arpsweep_free (scanner->arpsweep);
+  ndsweep_free (scanner->ndsweep);
+  ndsweep_free (scanner->icmpv6sweep);
   close_err = close_all_needed_sockets (scanner, alive_test);
   if (alive_test & ALIVE_TEST_TCP_SYN_SERVICE
       || alive_test & ALIVE_TEST_TCP_ACK_SERVICE)
     {
       g_array_free (scanner->ports, TRUE);
     }
-  g_hash_table_destroy (scanner->hosts_data->alivehosts);
-  g_hash_table_destroy (scanner->hosts_data->targethosts);
+  hosts_set_free (scanner->hosts_data->alivehosts);
+  hosts_set_free (scanner->hosts_data->targethosts);
+  g_ptr_array_free (scanner->hosts_data->targets, TRUE);
   g_free (scanner->hosts_data);
+  ratelimit_free (scanner->ratelimit);
+  srccache_free (scanner->srccache);
 
   return close_err;
 }
@@ -99,7 +119,7 @@ run_cli_scan (scanner_t *scanner, alive_test_t alive_test)
   struct timeval start_time, end_time;
 
   gettimeofday (&start_time, NULL);
-  number_of_targets = g_hash_table_size (scanner->hosts_data->targethosts);
+  number_of_targets = scanner->hosts_data->targets->len;
 
   if (scanner->print_results == 1)
     printf ("Alive scan started: Target has %d hosts.\n", number_of_targets);
@@ -110,8 +130,8 @@ run_cli_scan (scanner_t *scanner, alive_test_t alive_test)
 
   if (alive_test & (ALIVE_TEST_ICMP))
     {
-      g_hash_table_foreach (scanner->hosts_data->targethosts, send_icmp,
-                            scanner);
+      g_ptr_array_foreach (scanner->hosts_data->targets, send_icmp, scanner);
+      ndsweep_flush (scanner->icmpv6sweep);
       wait_until_so_sndbuf_empty (scanner->icmpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner->icmpv6soc, 10);
       usleep (500000);
@@ -119,8 +139,7 @@ run_cli_scan (scanner_t *scanner, alive_test_t alive_test)
   if (alive_test & (ALIVE_TEST_TCP_SYN_SERVICE))
     {
       scanner->tcp_flag = 0x02; /* SYN */
-      g_hash_table_foreach (scanner->hosts_data->targethosts, send_tcp,
-                            scanner);
+      g_ptr_array_foreach (scanner->hosts_data->targets, send_tcp, scanner);
       wait_until_so_sndbuf_empty (scanner->tcpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner->tcpv6soc, 10);
       usleep (500000);
@@ -128,16 +147,16 @@ run_cli_scan (scanner_t *scanner, alive_test_t alive_test)
   if (alive_test & (ALIVE_TEST_TCP_ACK_SERVICE))
     {
       scanner->tcp_flag = 0x10; /* ACK */
-      g_hash_table_foreach (scanner->hosts_data->targethosts, send_tcp,
-                            scanner);
+      g_ptr_array_foreach (scanner->hosts_data->targets, send_tcp, scanner);
       wait_until_so_sndbuf_empty (scanner->tcpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner->tcpv6soc, 10);
       usleep (500000);
     }
   if (alive_test & (ALIVE_TEST_ARP))
     {
-      g_hash_table_foreach (scanner->hosts_data->targethosts, send_arp,
-                            scanner);
+      g_ptr_array_foreach (scanner->hosts_data->targets, send_arp, scanner);
+      arpsweep_flush (scanner->arpsweep);
+      ndsweep_flush (scanner->ndsweep);
       wait_until_so_sndbuf_empty (scanner->arpv4soc, 10);
       wait_until_so_sndbuf_empty (scanner->arpv6soc, 10);
       usleep (500000);
@@ -150,13 +169,21 @@ run_cli_scan (scanner_t *scanner, alive_test_t alive_test)
 
   stop_sniffer_thread (scanner, sniffer_thread_id);
 
-  number_of_dead_hosts = count_difference (scanner->hosts_data->targethosts,
-                                           scanner->hosts_data->alivehosts);
+  /* Only target hosts are added to the alive hosts set. */
+  number_of_dead_hosts =
+    number_of_targets - hosts_set_size (scanner->hosts_data->alivehosts);
   gettimeofday (&end_time, NULL);
   if (scanner->print_results == 1)
     printf ("Alive scan finished in %ld seconds: %d alive hosts of %d.\n",
             end_time.tv_sec - start_time.tv_sec,
             number_of_targets - number_of_dead_hosts, number_of_targets);
+  if (scanner->print_results == 1 && scanner->ratelimit->sent > 0)
+    printf ("Sent %" G_GUINT64_FORMAT " packets at %.0f packets per second.\n",
+            scanner->ratelimit->sent,
+            ratelimit_achieved_rate (scanner->ratelimit));
+  if (scanner->print_results == 1 && scanner->pcap_stats.ps_drop > 0)
+    printf ("Sniffer dropped %u of %u captured packets.\n",
+            scanner->pcap_stats.ps_drop, scanner->pcap_stats.ps_recv);
 
   return error;
 }
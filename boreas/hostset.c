@@ -0,0 +1,361 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Sets of host addresses used for classifying alive test replies.
+ *
+ * IPv4 addresses are kept in a two level bitmap. The upper 16 bits of the
+ * address select a leaf which holds one bit for each of the 65536 addresses
+ * sharing that prefix. Leaves are only allocated for prefixes in use, so a
+ * /16 target costs 8 KiB plus the top level table. IPv6 addresses are kept in
+ * a hash table with the binary address as key. Hostnames, which can not be
+ * matched against replies, are kept by name so that they can still be tracked
+ * like before.
+ *
+ * Lookups and insertions of addresses do not allocate memory, apart from the
+ * first insertion into a new leaf or into the IPv6 table.
+ *
+ * A set may be changed by one thread while others look hosts up in it, e.g.
+ * the sniffer adds alive hosts while the senders skip them. Leaves are
+ * published with an atomic compare and swap and bits set atomically, so
+ * IPv4 lookups do not take a lock. The IPv6 and hostname tables are guarded
+ * by a reader-writer lock.
+ */
+
+#include "hostset.h"
+
+#include <arpa/inet.h>
+#include <string.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/* Number of IPv4 addresses covered by one leaf of the bitmap. */
+#define V4_LEAF_ADDRS 65536
+/* Number of leaves needed for the whole IPv4 address space. */
+#define V4_LEAVES 65536
+/* Number of 64 bit words in one leaf. */
+#define V4_LEAF_WORDS (V4_LEAF_ADDRS / 64)
+
+/**
+ * @brief Set of IPv4 and IPv6 addresses and hostnames.
+ */
+struct hosts_set
+{
+  /* V4_LEAVES pointers to bitmaps of V4_LEAF_WORDS words. Allocated on first
+   * insertion of an IPv4 address. */
+  guint64 **v4_leaves;
+  /* Set of struct in6_addr. */
+  GHashTable *v6;
+  /* Set of hostname strings. */
+  GHashTable *names;
+  /* Lock of v6 and names. */
+  GRWLock lock;
+  /* Number of elements in the set. */
+  guint size;
+};
+
+/**
+ * @brief Get a pointer allocated on first use, allocating it if needed.
+ *
+ * If several threads allocate it at the same time, only one allocation is
+ * published and the others are freed again.
+ *
+ * @param slot  Location of the pointer.
+ * @param size  Size of the zeroed allocation.
+ *
+ * @return The pointer.
+ */
+static gpointer
+get_or_alloc (gpointer *slot, gsize size)
+{
+  gpointer expected = NULL, allocated;
+
+  if ((expected = __atomic_load_n (slot, __ATOMIC_ACQUIRE)) != NULL)
+    return expected;
+
+  allocated = g_malloc0 (size);
+  if (__atomic_compare_exchange_n (slot, &expected, allocated, FALSE,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    return allocated;
+
+  g_free (allocated);
+  return expected;
+}
+
+/**
+ * @brief Hash function for struct in6_addr keys.
+ *
+ * @param key  Pointer to struct in6_addr.
+ *
+ * @return Hash value.
+ */
+guint
+in6_addr_hash (gconstpointer key)
+{
+  const struct in6_addr *addr = key;
+  guint32 words[4];
+
+  memcpy (words, addr, sizeof (words));
+  /* Host bits are at the end, put most weight on them. */
+  return words[3] ^ (words[2] * 31) ^ (words[1] * 961) ^ (words[0] * 29791);
+}
+
+/**
+ * @brief Equal function for struct in6_addr keys.
+ *
+ * @param a  Pointer to struct in6_addr.
+ * @param b  Pointer to struct in6_addr.
+ *
+ * @return TRUE if both addresses are the same, FALSE otherwise.
+ */
+gboolean
+in6_addr_equal (gconstpointer a, gconstpointer b)
+{
+  return memcmp (a, b, sizeof (struct in6_addr)) == 0;
+}
+
+/**
+ * @brief Create a new empty set.
+ *
+ * @return New set. Free with hosts_set_free().
+ */
+hosts_set_t *
+hosts_set_new (void)
+{
+  hosts_set_t *set;
+
+  set = g_malloc0 (sizeof (hosts_set_t));
+  set->v6 = g_hash_table_new_full (in6_addr_hash, in6_addr_equal, g_free, NULL);
+  set->names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  g_rw_lock_init (&set->lock);
+
+  return set;
+}
+
+/**
+ * @brief Free a set.
+ *
+ * @param set  Set to free.
+ */
+void
+hosts_set_free (hosts_set_t *set)
+{
+  if (set == NULL)
+    return;
+
+  if (set->v4_leaves)
+    {
+      for (int i = 0; i < V4_LEAVES; i++)
+        g_free (set->v4_leaves[i]);
+      g_free (set->v4_leaves);
+    }
+  g_hash_table_destroy (set->v6);
+  g_hash_table_destroy (set->names);
+  g_rw_lock_clear (&set->lock);
+  g_free (set);
+}
+
+/**
+ * @brief Add an IPv4 address to the set.
+ *
+ * @param set   Set to add the address to.
+ * @param addr  Address to add.
+ *
+ * @return TRUE if the address was added, FALSE if it was already in the set.
+ */
+gboolean
+hosts_set_add_addr4 (hosts_set_t *set, const struct in_addr *addr)
+{
+  guint32 ip = ntohl (addr->s_addr);
+  guint32 bit = ip & (V4_LEAF_ADDRS - 1);
+  guint64 **leaves, *leaf;
+  guint64 mask;
+
+  leaves = get_or_alloc ((gpointer *) &set->v4_leaves,
+                         V4_LEAVES * sizeof (guint64 *));
+  leaf = get_or_alloc ((gpointer *) &leaves[ip >> 16],
+                       V4_LEAF_WORDS * sizeof (guint64));
+
+  mask = (guint64) 1 << (bit % 64);
+  if (__atomic_fetch_or (&leaf[bit / 64], mask, __ATOMIC_RELEASE) & mask)
+    return FALSE;
+
+  __atomic_fetch_add (&set->size, 1, __ATOMIC_RELAXED);
+  return TRUE;
+}
+
+/**
+ * @brief Check if an IPv4 address is in the set.
+ *
+ * @param set   Set to check.
+ * @param addr  Address to look for.
+ *
+ * @return TRUE if the address is in the set, FALSE otherwise.
+ */
+gboolean
+hosts_set_contains_addr4 (const hosts_set_t *set, const struct in_addr *addr)
+{
+  guint32 ip = ntohl (addr->s_addr);
+  guint32 bit = ip & (V4_LEAF_ADDRS - 1);
+  guint64 **leaves, *leaf;
+
+  if ((leaves = __atomic_load_n (&set->v4_leaves, __ATOMIC_ACQUIRE)) == NULL)
+    return FALSE;
+
+  if ((leaf = __atomic_load_n (&leaves[ip >> 16], __ATOMIC_ACQUIRE)) == NULL)
+    return FALSE;
+
+  return (__atomic_load_n (&leaf[bit / 64], __ATOMIC_ACQUIRE) >> (bit % 64))
+         & 1;
+}
+
+/**
+ * @brief Add an IPv6 address to the set.
+ *
+ * @param set   Set to add the address to.
+ * @param addr  Address to add.
+ *
+ * @return TRUE if the address was added, FALSE if it was already in the set.
+ */
+gboolean
+hosts_set_add_addr6 (hosts_set_t *set, const struct in6_addr *addr)
+{
+  struct in6_addr *key;
+  gboolean added = FALSE;
+
+  g_rw_lock_writer_lock (&set->lock);
+  if (!g_hash_table_contains (set->v6, addr))
+    {
+      key = g_malloc (sizeof (struct in6_addr));
+      memcpy (key, addr, sizeof (struct in6_addr));
+      g_hash_table_add (set->v6, key);
+      __atomic_fetch_add (&set->size, 1, __ATOMIC_RELAXED);
+      added = TRUE;
+    }
+  g_rw_lock_writer_unlock (&set->lock);
+
+  return added;
+}
+
+/**
+ * @brief Check if an IPv6 address is in the set.
+ *
+ * @param set   Set to check.
+ * @param addr  Address to look for.
+ *
+ * @return TRUE if the address is in the set, FALSE otherwise.
+ */
+gboolean
+hosts_set_contains_addr6 (const hosts_set_t *set, const struct in6_addr *addr)
+{
+  GRWLock *lock = (GRWLock *) &set->lock;
+  gboolean found;
+
+  g_rw_lock_reader_lock (lock);
+  found = g_hash_table_contains (set->v6, addr);
+  g_rw_lock_reader_unlock (lock);
+
+  return found;
+}
+
+/**
+ * @brief Add a host to the set.
+ *
+ * IPv4 hosts are added as IPv4 address, IPv6 hosts as IPv6 address, even if
+ * it is an IPv4 mapped one. Hostnames are added by name.
+ *
+ * @param set   Set to add the host to.
+ * @param host  Host to add.
+ *
+ * @return TRUE if the host was added, FALSE if it was already in the set or
+ *         is of an unsupported type.
+ */
+gboolean
+hosts_set_add_host (hosts_set_t *set, const gvm_host_t *host)
+{
+  struct in6_addr addr6;
+  struct in_addr addr4;
+  gboolean added;
+
+  switch (gvm_host_type (host))
+    {
+    case HOST_TYPE_IPV4:
+      if (gvm_host_get_addr6 (host, &addr6) < 0)
+        return FALSE;
+      addr4.s_addr = addr6.s6_addr32[3];
+      return hosts_set_add_addr4 (set, &addr4);
+    case HOST_TYPE_IPV6:
+      if (gvm_host_get_addr6 (host, &addr6) < 0)
+        return FALSE;
+      return hosts_set_add_addr6 (set, &addr6);
+    case HOST_TYPE_NAME:
+      g_rw_lock_writer_lock (&set->lock);
+      added = g_hash_table_add (set->names, gvm_host_value_str (host));
+      if (added)
+        __atomic_fetch_add (&set->size, 1, __ATOMIC_RELAXED);
+      g_rw_lock_writer_unlock (&set->lock);
+      return added;
+    default:
+      return FALSE;
+    }
+}
+
+/**
+ * @brief Check if a host is in the set.
+ *
+ * @param set   Set to check.
+ * @param host  Host to look for.
+ *
+ * @return TRUE if the host is in the set, FALSE otherwise.
+ */
+gboolean
+hosts_set_contains_host (const hosts_set_t *set, const gvm_host_t *host)
+{
+  struct in6_addr addr6;
+  struct in_addr addr4;
+  GRWLock *lock = (GRWLock *) &set->lock;
+  gchar *name;
+  gboolean found;
+
+  switch (gvm_host_type (host))
+    {
+    case HOST_TYPE_IPV4:
+      if (gvm_host_get_addr6 (host, &addr6) < 0)
+        return FALSE;
+      addr4.s_addr = addr6.s6_addr32[3];
+      return hosts_set_contains_addr4 (set, &addr4);
+    case HOST_TYPE_IPV6:
+      if (gvm_host_get_addr6 (host, &addr6) < 0)
+        return FALSE;
+      return hosts_set_contains_addr6 (set, &addr6);
+    case HOST_TYPE_NAME:
+      name = gvm_host_value_str (host);
+      g_rw_lock_reader_lock (lock);
+      found = g_hash_table_contains (set->names, name);
+      g_rw_lock_reader_unlock (lock);
+      g_free (name);
+      return found;
+    default:
+      return FALSE;
+    }
+}
+
+/**
+ * @brief Get the number of elements in the set.
+ *
+ * @param set  Set.
+ *
+ * @return Number of elements.
+ */
+guint
+hosts_set_size (const hosts_set_t *set)
+{
+  return __atomic_load_n (&set->size, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_HOSTSET_H
+#define BOREAS_HOSTSET_H
+
+#include "../base/hosts.h"
+
+#include <glib.h>
+#include <netinet/in.h>
+
+typedef struct hosts_set hosts_set_t;
+
+hosts_set_t *
+hosts_set_new (void);
+
+void
+hosts_set_free (hosts_set_t *);
+
+gboolean
+hosts_set_add_addr4 (hosts_set_t *, const struct in_addr *);
+
+gboolean
+hosts_set_contains_addr4 (const hosts_set_t *, const struct in_addr *);
+
+gboolean
+hosts_set_add_addr6 (hosts_set_t *, const struct in6_addr *);
+
+gboolean
+hosts_set_contains_addr6 (const hosts_set_t *, const struct in6_addr *);
+
+gboolean
+hosts_set_add_host (hosts_set_t *, const gvm_host_t *);
+
+gboolean
+hosts_set_contains_host (const hosts_set_t *, const gvm_host_t *);
+
+guint
+hosts_set_size (const hosts_set_t *);
+
+guint
+in6_addr_hash (gconstpointer);
+
+gboolean
+in6_addr_equal (gconstpointer, gconstpointer);
+
+#endif /* not BOREAS_HOSTSET_H */
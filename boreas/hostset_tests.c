@@ -0,0 +1,182 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "hostset.c"
+
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+#include <pthread.h>
+
+Describe (hostset);
+BeforeEach (hostset)
+{
+}
+AfterEach (hostset)
+{
+}
+
+Ensure (hostset, add_and_contains_addr4)
+{
+  hosts_set_t *set;
+  struct in_addr addr, other;
+
+  set = hosts_set_new ();
+  inet_pton (AF_INET, "192.168.0.1", &addr);
+  inet_pton (AF_INET, "192.168.0.2", &other);
+
+  assert_that (hosts_set_contains_addr4 (set, &addr), is_false);
+  assert_that (hosts_set_add_addr4 (set, &addr), is_true);
+  assert_that (hosts_set_add_addr4 (set, &addr), is_false);
+  assert_that (hosts_set_contains_addr4 (set, &addr), is_true);
+  assert_that (hosts_set_contains_addr4 (set, &other), is_false);
+  assert_that (hosts_set_size (set), is_equal_to (1));
+
+  hosts_set_free (set);
+}
+
+Ensure (hostset, addr4_leaf_boundaries)
+{
+  hosts_set_t *set;
+  const char *addrs[] = {"0.0.0.0",     "10.0.255.255", "10.1.0.0",
+                         "10.1.0.63",   "10.1.0.64",    "255.255.255.255"};
+  struct in_addr addr;
+
+  set = hosts_set_new ();
+  for (size_t i = 0; i < G_N_ELEMENTS (addrs); i++)
+    {
+      inet_pton (AF_INET, addrs[i], &addr);
+      assert_that (hosts_set_add_addr4 (set, &addr), is_true);
+    }
+  for (size_t i = 0; i < G_N_ELEMENTS (addrs); i++)
+    {
+      inet_pton (AF_INET, addrs[i], &addr);
+      assert_that (hosts_set_contains_addr4 (set, &addr), is_true);
+    }
+  inet_pton (AF_INET, "10.1.0.65", &addr);
+  assert_that (hosts_set_contains_addr4 (set, &addr), is_false);
+  assert_that (hosts_set_size (set), is_equal_to (G_N_ELEMENTS (addrs)));
+
+  hosts_set_free (set);
+}
+
+Ensure (hostset, add_and_contains_addr6)
+{
+  hosts_set_t *set;
+  struct in6_addr addr, other;
+
+  set = hosts_set_new ();
+  inet_pton (AF_INET6, "2001:db8::1", &addr);
+  inet_pton (AF_INET6, "2001:db8::2", &other);
+
+  assert_that (hosts_set_contains_addr6 (set, &addr), is_false);
+  assert_that (hosts_set_add_addr6 (set, &addr), is_true);
+  assert_that (hosts_set_add_addr6 (set, &addr), is_false);
+  assert_that (hosts_set_contains_addr6 (set, &addr), is_true);
+  assert_that (hosts_set_contains_addr6 (set, &other), is_false);
+  assert_that (hosts_set_size (set), is_equal_to (1));
+
+  hosts_set_free (set);
+}
+
+/* Number of addresses each thread of the concurrency test adds. */
+#define CONCURRENT_ADDRS 20000
+
+/**
+ * @brief Add IPv4 and IPv6 addresses to a set, looking them up again.
+ */
+static void *
+add_addrs (void *set)
+{
+  struct in6_addr addr6;
+  struct in_addr addr4;
+
+  memset (&addr6, 0, sizeof (addr6));
+  addr6.s6_addr[0] = 0x20;
+  for (guint32 i = 0; i < CONCURRENT_ADDRS; i++)
+    {
+      /* Spread over 256 leaves, which the threads allocate concurrently. */
+      addr4.s_addr = htonl ((i % 256) << 16 | i);
+      hosts_set_add_addr4 (set, &addr4);
+      if (!hosts_set_contains_addr4 (set, &addr4))
+        return set;
+      addr6.s6_addr32[3] = htonl (i);
+      hosts_set_add_addr6 (set, &addr6);
+      if (!hosts_set_contains_addr6 (set, &addr6))
+        return set;
+    }
+
+  return NULL;
+}
+
+Ensure (hostset, concurrent_adds_and_lookups)
+{
+  hosts_set_t *set;
+  pthread_t threads[4];
+  void *failed;
+
+  set = hosts_set_new ();
+  for (size_t i = 0; i < G_N_ELEMENTS (threads); i++)
+    pthread_create (&threads[i], NULL, add_addrs, set);
+  for (size_t i = 0; i < G_N_ELEMENTS (threads); i++)
+    {
+      pthread_join (threads[i], &failed);
+      assert_that (failed, is_null);
+    }
+  /* Every thread added the same addresses. */
+  assert_that (hosts_set_size (set), is_equal_to (2 * CONCURRENT_ADDRS));
+
+  hosts_set_free (set);
+}
+
+Ensure (hostset, add_and_contains_host)
+{
+  hosts_set_t *set;
+  gvm_host_t *host4, *host6, *other;
+  struct in_addr addr4;
+  struct in6_addr addr6;
+
+  set = hosts_set_new ();
+  host4 = gvm_host_from_str ("192.168.10.20");
+  host6 = gvm_host_from_str ("2001:db8::20");
+  other = gvm_host_from_str ("192.168.10.21");
+
+  assert_that (hosts_set_add_host (set, host4), is_true);
+  assert_that (hosts_set_add_host (set, host4), is_false);
+  assert_that (hosts_set_add_host (set, host6), is_true);
+  assert_that (hosts_set_contains_host (set, host4), is_true);
+  assert_that (hosts_set_contains_host (set, host6), is_true);
+  assert_that (hosts_set_contains_host (set, other), is_false);
+  assert_that (hosts_set_size (set), is_equal_to (2));
+
+  /* Hosts are found by the addresses seen in replies. */
+  inet_pton (AF_INET, "192.168.10.20", &addr4);
+  inet_pton (AF_INET6, "2001:db8::20", &addr6);
+  assert_that (hosts_set_contains_addr4 (set, &addr4), is_true);
+  assert_that (hosts_set_contains_addr6 (set, &addr6), is_true);
+
+  gvm_host_free (host4);
+  gvm_host_free (host6);
+  gvm_host_free (other);
+  hosts_set_free (set);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, hostset, add_and_contains_addr4);
+  add_test_with_context (suite, hostset, addr4_leaf_boundaries);
+  add_test_with_context (suite, hostset, add_and_contains_addr6);
+  add_test_with_context (suite, hostset, add_and_contains_host);
+  add_test_with_context (suite, hostset, concurrent_adds_and_lookups);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
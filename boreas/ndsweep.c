@@ -0,0 +1,406 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Batched IPv6 neighbor solicitations and echo requests.
+ *
+ * Neighbor solicitations are sent to the solicited-node multicast address of
+ * the target on the outgoing interface. The interface is looked up once per
+ * /64 network of the targets, unless the source address cache of the scanner
+ * finds that the hosts of the network may be routed differently. Then it is
+ * looked up per host. For every interface the multicast destination
+ * and the solicitation with the source link-layer address option are prepared
+ * once, only the target address and the low 24 bits of the destination are
+ * set per host.
+ *
+ * Echo requests all carry the same payload and only differ in their
+ * destination.
+ *
+ * Packets are queued and sent in batches of NDSWEEP_BATCH with sendmmsg(). The
+ * ICMPv6 checksum is computed by the kernel.
+ *
+ * An ndsweep_t is not thread safe.
+ */
+
+/* for struct mmsghdr and sendmmsg() */
+#define _GNU_SOURCE
+
+#include "ndsweep.h"
+
+#include "../base/networking.h" /* for gvm_get_outgoing_iface() */
+#include "util.h"
+
+#include <errno.h>
+#include <glib.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <netinet/icmp6.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/* Neighbor solicitation with the source link-layer address option. */
+#define ND_NS_LEN (sizeof (struct nd_neighbor_solicit) + 8)
+/* Echo request with the same payload size as send_icmp_v6(). */
+#define ECHO6_LEN (sizeof (struct icmp6_hdr) + 56)
+
+/**
+ * @brief Interface used for neighbor solicitations.
+ */
+struct nd_iface
+{
+  /* Solicited-node multicast prefix ff02::1:ff00:0/104 on the interface. */
+  struct sockaddr_in6 mcast;
+  /* Solicitation with the target address set to ::. */
+  uint8_t packet[ND_NS_LEN];
+  /* Length of packet, without the option if the interface has no MAC. */
+  size_t len;
+};
+
+/**
+ * @brief IPv6 sweep state.
+ */
+struct ndsweep
+{
+  /* Raw ICMPv6 socket. */
+  int soc;
+  /* ND_NEIGHBOR_SOLICIT or ICMP6_ECHO_REQUEST. */
+  int type;
+  /* Statistics to count the sent packets in. May be NULL. */
+  alive_stats_t *stats;
+  /* Interface name -> struct nd_iface *. */
+  GHashTable *ifaces;
+  /* Source address cache deciding which networks are routed alike. May be
+   * NULL. */
+  srccache_t *srccache;
+  /* Generation of srccache the networks were looked up in. */
+  guint generation;
+  /* /64 network from srccache_network_v6() -> struct nd_iface *, NULL if
+   * none. */
+  GHashTable *networks;
+  /* Echo request sent to every target. */
+  uint8_t echo[ECHO6_LEN];
+  /* Queued packets. */
+  unsigned int count;
+  uint8_t packets[NDSWEEP_BATCH][ND_NS_LEN];
+  struct sockaddr_in6 dsts[NDSWEEP_BATCH];
+  struct iovec iov[NDSWEEP_BATCH];
+  struct mmsghdr msgs[NDSWEEP_BATCH];
+};
+
+/**
+ * @brief Build a neighbor solicitation.
+ *
+ * @param[out] packet  Packet of ND_NS_LEN bytes.
+ * @param[in]  mac     Ethernet address of the sender, NULL to leave out the
+ *                     source link-layer address option.
+ *
+ * @return Length of the packet.
+ */
+static size_t
+nd_solicit_init (uint8_t *packet, const uint8_t *mac)
+{
+  struct nd_neighbor_solicit *ns = (struct nd_neighbor_solicit *) packet;
+  struct nd_opt_hdr *opt = (struct nd_opt_hdr *) (ns + 1);
+
+  memset (packet, 0, ND_NS_LEN);
+  ns->nd_ns_type = ND_NEIGHBOR_SOLICIT;
+  ns->nd_ns_code = 0;
+  if (mac == NULL)
+    return sizeof (struct nd_neighbor_solicit);
+
+  opt->nd_opt_type = ND_OPT_SOURCE_LINKADDR;
+  opt->nd_opt_len = 1; /* in units of 8 bytes */
+  memcpy (opt + 1, mac, ETH_ALEN);
+
+  return ND_NS_LEN;
+}
+
+/**
+ * @brief Set the solicited-node multicast address of a target.
+ *
+ * @param[in,out] mcast  Solicited-node multicast prefix.
+ * @param[in]     dst    Target address.
+ */
+static void
+nd_solicited_node (struct in6_addr *mcast, const struct in6_addr *dst)
+{
+  memcpy (&mcast->s6_addr[13], &dst->s6_addr[13], 3);
+}
+
+/**
+ * @brief Prepare an interface for neighbor solicitations.
+ *
+ * @param name  Interface name.
+ *
+ * @return New interface, NULL if it can not be used.
+ */
+static struct nd_iface *
+nd_iface_new (const char *name)
+{
+  static const uint8_t ethnull[ETH_ALEN] = {0};
+  struct nd_iface *iface;
+  uint8_t mac[ETH_ALEN] = {0};
+  unsigned int ifindex;
+
+  ifindex = if_nametoindex (name);
+  if (ifindex == 0)
+    return NULL;
+
+  iface = g_malloc0 (sizeof (struct nd_iface));
+  iface->mcast.sin6_family = AF_INET6;
+  iface->mcast.sin6_scope_id = ifindex;
+  iface->mcast.sin6_addr.s6_addr[0] = 0xff;
+  iface->mcast.sin6_addr.s6_addr[1] = 0x02;
+  iface->mcast.sin6_addr.s6_addr[11] = 0x01;
+  iface->mcast.sin6_addr.s6_addr[12] = 0xff;
+  if (get_source_mac_addr ((char *) name, mac) != 0
+      || memcmp (mac, ethnull, ETH_ALEN) == 0)
+    iface->len = nd_solicit_init (iface->packet, NULL);
+  else
+    iface->len = nd_solicit_init (iface->packet, mac);
+
+  return iface;
+}
+
+/**
+ * @brief Get the interface to send neighbor solicitations for a target on.
+ *
+ * @param sweep  IPv6 sweep.
+ * @param dst    Target address.
+ *
+ * @return Interface, NULL if none can be used.
+ */
+static struct nd_iface *
+ndsweep_iface (ndsweep_t *sweep, const struct in6_addr *dst)
+{
+  struct sockaddr_storage target;
+  struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *) &target;
+  struct nd_iface *iface = NULL;
+  gboolean cacheable;
+  guint64 network;
+  gpointer value;
+  char *name;
+
+  cacheable = srccache_network_v6 (sweep->srccache, dst, &network);
+  if (srccache_generation (sweep->srccache) != sweep->generation)
+    {
+      /* Routes changed. */
+      g_hash_table_remove_all (sweep->networks);
+      sweep->generation = srccache_generation (sweep->srccache);
+    }
+  if (cacheable
+      && g_hash_table_lookup_extended (sweep->networks, &network, NULL, &value))
+    return value;
+
+  memset (&target, 0, sizeof (target));
+  sin6->sin6_family = AF_INET6;
+  sin6->sin6_addr = *dst;
+  name = gvm_get_outgoing_iface (&target);
+  if (name)
+    {
+      if (g_hash_table_lookup_extended (sweep->ifaces, name, NULL, &value))
+        {
+          iface = value;
+          g_free (name);
+        }
+      else if ((iface = nd_iface_new (name)))
+        g_hash_table_insert (sweep->ifaces, name, iface);
+      else
+        g_free (name);
+    }
+  if (cacheable)
+    {
+      guint64 *key = g_malloc (sizeof (guint64));
+
+      *key = network;
+      g_hash_table_insert (sweep->networks, key, iface);
+    }
+
+  return iface;
+}
+
+/**
+ * @brief Create an IPv6 sweep.
+ *
+ * @param soc       Raw ICMPv6 socket to send the packets with. Not closed by
+ *                  ndsweep_free().
+ * @param type      ND_NEIGHBOR_SOLICIT or ICMP6_ECHO_REQUEST.
+ * @param stats     Statistics to count the packets in. May be NULL.
+ * @param srccache  Source address cache of the scanner. Must outlive the
+ *                  sweep. If NULL the interface is looked up for every target.
+ *                  Not used for echo requests.
+ *
+ * @return New IPv6 sweep. Free with ndsweep_free().
+ */
+ndsweep_t *
+ndsweep_new (int soc, int type, alive_stats_t *stats, srccache_t *srccache)
+{
+  ndsweep_t *sweep;
+  struct icmp6_hdr *icmp6;
+
+  sweep = g_malloc0 (sizeof (ndsweep_t));
+  sweep->soc = soc;
+  sweep->type = type;
+  sweep->stats = stats;
+  sweep->srccache = srccache;
+  sweep->generation = srccache_generation (srccache);
+  sweep->ifaces =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  sweep->networks =
+    g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+
+  icmp6 = (struct icmp6_hdr *) sweep->echo;
+  icmp6->icmp6_type = ICMP6_ECHO_REQUEST;
+  icmp6->icmp6_code = 0;
+  icmp6->icmp6_id = g_random_int_range (1, 65535);
+  icmp6->icmp6_seq = 0x0100;
+  memset (icmp6 + 1, 0xa5, ECHO6_LEN - sizeof (struct icmp6_hdr));
+
+  for (int i = 0; i < NDSWEEP_BATCH; i++)
+    {
+      if (type == ND_NEIGHBOR_SOLICIT)
+        sweep->iov[i].iov_base = sweep->packets[i];
+      else
+        {
+          sweep->iov[i].iov_base = sweep->echo;
+          sweep->iov[i].iov_len = ECHO6_LEN;
+        }
+      sweep->msgs[i].msg_hdr.msg_name = &sweep->dsts[i];
+      sweep->msgs[i].msg_hdr.msg_namelen = sizeof (struct sockaddr_in6);
+      sweep->msgs[i].msg_hdr.msg_iov = &sweep->iov[i];
+      sweep->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  /* Neighbors discard solicitations with another hop limit. */
+  if (type == ND_NEIGHBOR_SOLICIT && soc >= 0)
+    {
+      int hops = 255;
+
+      if (setsockopt (soc, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops,
+                      sizeof (hops))
+          < 0)
+        g_warning ("%s: setsockopt(IPV6_MULTICAST_HOPS): %s", __func__,
+                   strerror (errno));
+    }
+
+  return sweep;
+}
+
+/**
+ * @brief Send all queued packets and free an IPv6 sweep.
+ *
+ * @param sweep  IPv6 sweep to free.
+ */
+void
+ndsweep_free (ndsweep_t *sweep)
+{
+  if (sweep == NULL)
+    return;
+
+  ndsweep_flush (sweep);
+  g_hash_table_destroy (sweep->networks);
+  g_hash_table_destroy (sweep->ifaces);
+  g_free (sweep);
+}
+
+/**
+ * @brief Queue a neighbor solicitation or echo request for a target.
+ *
+ * The queue is sent when it is full. Call ndsweep_flush() after the last
+ * target.
+ *
+ * @param sweep  IPv6 sweep. May be NULL.
+ * @param dst    Target address.
+ *
+ * @return 0 if the packet was queued, -1 if no outgoing interface was found
+ *         for a solicitation.
+ */
+int
+ndsweep_add (ndsweep_t *sweep, const struct in6_addr *dst)
+{
+  unsigned int i;
+
+  if (sweep == NULL)
+    return -1;
+
+  i = sweep->count;
+  if (sweep->type == ND_NEIGHBOR_SOLICIT)
+    {
+      struct nd_iface *iface;
+      struct nd_neighbor_solicit *ns;
+
+      iface = ndsweep_iface (sweep, dst);
+      if (iface == NULL)
+        return -1;
+      memcpy (sweep->packets[i], iface->packet, iface->len);
+      ns = (struct nd_neighbor_solicit *) sweep->packets[i];
+      ns->nd_ns_target = *dst;
+      sweep->iov[i].iov_len = iface->len;
+      sweep->dsts[i] = iface->mcast;
+      nd_solicited_node (&sweep->dsts[i].sin6_addr, dst);
+    }
+  else
+    {
+      memset (&sweep->dsts[i], 0, sizeof (struct sockaddr_in6));
+      sweep->dsts[i].sin6_family = AF_INET6;
+      sweep->dsts[i].sin6_addr = *dst;
+    }
+  sweep->count++;
+  if (sweep->count == NDSWEEP_BATCH)
+    ndsweep_flush (sweep);
+
+  return 0;
+}
+
+/**
+ * @brief Send all queued packets.
+ *
+ * A packet which can not be sent is skipped, the rest of the batch is still
+ * sent.
+ *
+ * @param sweep  IPv6 sweep. May be NULL.
+ */
+void
+ndsweep_flush (ndsweep_t *sweep)
+{
+  unsigned int done = 0, errors = 0;
+  alive_method_t method;
+
+  if (sweep == NULL || sweep->count == 0)
+    return;
+
+  while (done < sweep->count)
+    {
+      int ret;
+
+      ret = sendmmsg (sweep->soc, sweep->msgs + done, sweep->count - done,
+                      MSG_NOSIGNAL);
+      if (ret < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          g_warning ("%s: sendmmsg(): %s", __func__, strerror (errno));
+          ret = 1;
+          errors++;
+        }
+      done += ret;
+    }
+
+  if (sweep->stats)
+    {
+      method = sweep->type == ND_NEIGHBOR_SOLICIT ? ALIVE_METHOD_ARP
+                                                  : ALIVE_METHOD_ICMP;
+      sweep->stats->packets_sent[method] += sweep->count - errors;
+      sweep->stats->send_errors[method] += errors;
+    }
+  sweep->count = 0;
+}
@@ -0,0 +1,32 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_NDSWEEP_H
+#define BOREAS_NDSWEEP_H
+
+#include "alivestats.h"
+#include "srccache.h"
+
+#include <netinet/icmp6.h> /* for ND_NEIGHBOR_SOLICIT, ICMP6_ECHO_REQUEST */
+#include <netinet/in.h>
+
+/* Number of ICMPv6 packets sent with one sendmmsg() call. */
+#define NDSWEEP_BATCH 64
+
+typedef struct ndsweep ndsweep_t;
+
+ndsweep_t *
+ndsweep_new (int, int, alive_stats_t *, srccache_t *);
+
+void
+ndsweep_free (ndsweep_t *);
+
+int
+ndsweep_add (ndsweep_t *, const struct in6_addr *);
+
+void
+ndsweep_flush (ndsweep_t *);
+
+#endif /* not BOREAS_NDSWEEP_H */
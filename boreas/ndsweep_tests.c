@@ -0,0 +1,212 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "ndsweep.c"
+#include "srccache.c"
+
+#include <arpa/inet.h>
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+Describe (ndsweep);
+BeforeEach (ndsweep)
+{
+}
+AfterEach (ndsweep)
+{
+}
+
+static const uint8_t test_mac[ETH_ALEN] = {0x02, 0x00, 0x00, 0xaa, 0xbb, 0xcc};
+
+/* Source address cache which knows no route more specific than /64. */
+static srccache_t *
+test_srccache_new (void)
+{
+  srccache_t *cache = srccache_new ();
+
+  cache->routes_loaded = TRUE;
+  return cache;
+}
+
+/* Add an interface for a /64 without looking it up. */
+static struct nd_iface *
+add_test_iface (ndsweep_t *sweep, const char *network)
+{
+  struct nd_iface *iface;
+  struct in6_addr addr;
+  gint64 *key;
+
+  inet_pton (AF_INET6, network, &addr);
+  iface = g_malloc0 (sizeof (struct nd_iface));
+  iface->mcast.sin6_family = AF_INET6;
+  iface->mcast.sin6_scope_id = 1;
+  inet_pton (AF_INET6, "ff02::1:ff00:0", &iface->mcast.sin6_addr);
+  iface->len = nd_solicit_init (iface->packet, test_mac);
+  g_hash_table_insert (sweep->ifaces, g_strdup ("test0"), iface);
+  key = g_malloc (sizeof (gint64));
+  memcpy (key, addr.s6_addr, sizeof (gint64));
+  g_hash_table_insert (sweep->networks, key, iface);
+
+  return iface;
+}
+
+Ensure (ndsweep, solicitation_has_source_link_layer_option)
+{
+  uint8_t packet[ND_NS_LEN];
+  struct nd_neighbor_solicit *ns = (struct nd_neighbor_solicit *) packet;
+
+  assert_that (nd_solicit_init (packet, test_mac), is_equal_to (32));
+  assert_that (ns->nd_ns_type, is_equal_to (ND_NEIGHBOR_SOLICIT));
+  assert_that (ns->nd_ns_code, is_equal_to (0));
+  assert_that (packet[24], is_equal_to (ND_OPT_SOURCE_LINKADDR));
+  assert_that (packet[25], is_equal_to (1));
+  assert_that (memcmp (packet + 26, test_mac, ETH_ALEN), is_equal_to (0));
+
+  assert_that (nd_solicit_init (packet, NULL), is_equal_to (24));
+  assert_that (packet[24], is_equal_to (0));
+}
+
+Ensure (ndsweep, solicitations_go_to_solicited_node_address)
+{
+  ndsweep_t *sweep;
+  srccache_t *srccache;
+  struct nd_iface *iface;
+  struct nd_neighbor_solicit *ns;
+  struct in6_addr dst, expected;
+
+  srccache = test_srccache_new ();
+  sweep = ndsweep_new (-1, ND_NEIGHBOR_SOLICIT, NULL, srccache);
+  iface = add_test_iface (sweep, "2001:db8::");
+
+  inet_pton (AF_INET6, "2001:db8::1:2345:6789", &dst);
+  assert_that (ndsweep_add (sweep, &dst), is_equal_to (0));
+  inet_pton (AF_INET6, "2001:db8::ab:cdef", &dst);
+  assert_that (ndsweep_add (sweep, &dst), is_equal_to (0));
+  assert_that (sweep->count, is_equal_to (2));
+
+  inet_pton (AF_INET6, "ff02::1:ffab:cdef", &expected);
+  assert_that (memcmp (&sweep->dsts[1].sin6_addr, &expected, 16),
+               is_equal_to (0));
+  assert_that (sweep->dsts[1].sin6_scope_id, is_equal_to (1));
+  ns = (struct nd_neighbor_solicit *) sweep->packets[1];
+  assert_that (memcmp (&ns->nd_ns_target, &dst, 16), is_equal_to (0));
+  assert_that (memcmp (sweep->packets[1] + 24, iface->packet + 24, 8),
+               is_equal_to (0));
+  assert_that (sweep->iov[1].iov_len, is_equal_to (iface->len));
+
+  /* Dropped on the invalid socket. */
+  sweep->count = 0;
+  ndsweep_free (sweep);
+  srccache_free (srccache);
+}
+
+Ensure (ndsweep, echo_requests_share_payload)
+{
+  ndsweep_t *sweep;
+  struct in6_addr dst;
+  struct icmp6_hdr *icmp6;
+
+  sweep = ndsweep_new (-1, ICMP6_ECHO_REQUEST, NULL, NULL);
+  icmp6 = (struct icmp6_hdr *) sweep->echo;
+  assert_that (icmp6->icmp6_type, is_equal_to (ICMP6_ECHO_REQUEST));
+  assert_that (icmp6->icmp6_id, is_not_equal_to (0));
+
+  /* No interface lookup needed. */
+  inet_pton (AF_INET6, "2001:db8:1::1", &dst);
+  assert_that (ndsweep_add (sweep, &dst), is_equal_to (0));
+  inet_pton (AF_INET6, "2001:db8:2::1", &dst);
+  assert_that (ndsweep_add (sweep, &dst), is_equal_to (0));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (0));
+  assert_that (sweep->iov[0].iov_base, is_equal_to (sweep->iov[1].iov_base));
+  assert_that (memcmp (&sweep->dsts[1].sin6_addr, &dst, 16), is_equal_to (0));
+  assert_that (sweep->dsts[1].sin6_scope_id, is_equal_to (0));
+
+  sweep->count = 0;
+  ndsweep_free (sweep);
+}
+
+Ensure (ndsweep, failed_packets_are_counted)
+{
+  ndsweep_t *sweep;
+  srccache_t *srccache;
+  alive_stats_t *stats;
+  struct in6_addr dst;
+
+  stats = alive_stats_new ();
+  srccache = test_srccache_new ();
+  sweep = ndsweep_new (-1, ND_NEIGHBOR_SOLICIT, stats, srccache);
+  add_test_iface (sweep, "2001:db8::");
+
+  inet_pton (AF_INET6, "2001:db8::", &dst);
+  for (int i = 0; i < NDSWEEP_BATCH + 3; i++)
+    {
+      dst.s6_addr[15] = i;
+      assert_that (ndsweep_add (sweep, &dst), is_equal_to (0));
+    }
+  assert_that (sweep->count, is_equal_to (3));
+  assert_that (stats->send_errors[ALIVE_METHOD_ARP],
+               is_equal_to (NDSWEEP_BATCH));
+
+  ndsweep_free (sweep);
+  assert_that (stats->send_errors[ALIVE_METHOD_ARP],
+               is_equal_to (NDSWEEP_BATCH + 3));
+  assert_that (stats->packets_sent[ALIVE_METHOD_ARP], is_equal_to (0));
+  assert_that (stats->send_errors[ALIVE_METHOD_ICMP], is_equal_to (0));
+
+  srccache_free (srccache);
+  alive_stats_free (stats);
+  assert_that (ndsweep_add (NULL, &dst), is_equal_to (-1));
+}
+
+Ensure (ndsweep, hosts_of_more_specific_routes_are_looked_up_per_host)
+{
+  ndsweep_t *sweep;
+  srccache_t *srccache;
+  struct nd_iface *iface;
+  struct in6_addr dst;
+
+  srccache = test_srccache_new ();
+  sweep = ndsweep_new (-1, ND_NEIGHBOR_SOLICIT, NULL, srccache);
+  iface = add_test_iface (sweep, "2001:db8::");
+  inet_pton (AF_INET6, "2001:db8::", &dst);
+  srccache_add_route (srccache, AF_INET6, &dst, 120);
+
+  /* Not routed like the rest of the /64, so not taken from the network. */
+  inet_pton (AF_INET6, "2001:db8::7", &dst);
+  assert_that (ndsweep_iface (sweep, &dst), is_not_equal_to (iface));
+  assert_that (g_hash_table_size (sweep->networks), is_equal_to (1));
+  inet_pton (AF_INET6, "2001:db8::1:7", &dst);
+  assert_that (ndsweep_iface (sweep, &dst), is_equal_to (iface));
+
+  /* Forgotten when the routes change. */
+  srccache_flush (srccache);
+  srccache->routes_loaded = TRUE;
+  assert_that (ndsweep_iface (sweep, &dst), is_not_equal_to (iface));
+
+  ndsweep_free (sweep);
+  srccache_free (srccache);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, ndsweep,
+                         solicitation_has_source_link_layer_option);
+  add_test_with_context (suite, ndsweep,
+                         solicitations_go_to_solicited_node_address);
+  add_test_with_context (suite, ndsweep, echo_requests_share_payload);
+  add_test_with_context (suite, ndsweep, failed_packets_are_counted);
+  add_test_with_context (suite, ndsweep,
+                         hosts_of_more_specific_routes_are_looked_up_per_host);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -7,6 +7,7 @@
 
 #include "../base/prefs.h" /* for prefs_get() */
 #include "arp.h"
+#include "srccache.h"
 #include "util.h"
 
 #include <arpa/inet.h>
@@ -24,6 +25,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #undef G_LOG_DOMAIN
@@ -32,6 +34,10 @@
  */
 #define G_LOG_DOMAIN "libgvm boreas"
 
+/* How long (in nanoseconds) to wait before checking the output queue again
+ * while it is full. */
+#define THROTTLE_POLL_NS 1000000
+
 struct v6pseudohdr
 {
   struct in6_addr s6addr;
@@ -54,6 +60,48 @@ struct pseudohdr
   struct tcphdr tcpheader;
 };
 
+/**
+ * @brief IPv4 TCP ping for one destination, reused for all ports.
+ */
+struct tcp_v4_template
+{
+  u_char packet[sizeof (struct ip) + sizeof (struct tcphdr)];
+  /* TCP checksum with th_dport and th_seq set to 0. */
+  uint16_t base_sum;
+};
+
+/**
+ * @brief IPv6 TCP ping for one destination, reused for all ports.
+ */
+struct tcp_v6_template
+{
+  u_char packet[sizeof (struct ip6_hdr) + sizeof (struct tcphdr)];
+  /* TCP checksum with th_dport set to 0. */
+  uint16_t base_sum;
+};
+
+/**
+ * @brief Get a random number.
+ *
+ * rand() serializes all threads on a global lock. Every sender thread has
+ * its own rand_r() state instead, seeded on first use.
+ *
+ * @return Random number between 0 and RAND_MAX.
+ */
+static int
+get_random (void)
+{
+  static _Thread_local unsigned int seed;
+  static _Thread_local int seeded = 0;
+
+  if (!seeded)
+    {
+      seed = g_random_int ();
+      seeded = 1;
+    }
+  return rand_r (&seed);
+}
+
 // Return a random uint16 avoiding the 0.
 static uint16_t
 get_echo_id (void)
@@ -61,7 +109,7 @@ get_echo_id (void)
   uint16_t upper_bound = 65534;
   uint16_t lower_bound = 1;
 
-  return rand () % (upper_bound - lower_bound + 1) + lower_bound;
+  return get_random () % (upper_bound - lower_bound + 1) + lower_bound;
 }
 
 /**
@@ -100,6 +148,7 @@ throttle (int soc, int so_sndbuf)
 {
   // g_warning ("%s: so_sndbuf %d", __func__, so_sndbuf);
   int cur_so_sendbuf = -1;
+  const struct timespec poll_interval = {0, THROTTLE_POLL_NS};
 
   /* Get the current size of the output queue size */
   if (ioctl (soc, SIOCOUTQ, &cur_so_sendbuf) == -1)
@@ -117,7 +166,7 @@ throttle (int soc, int so_sndbuf)
       /* Wait until output queue is empty enough. */
       while (cur_so_sendbuf >= so_sndbuf)
         {
-          usleep (100000);
+          clock_nanosleep (CLOCK_MONOTONIC, 0, &poll_interval, NULL);
           if (ioctl (soc, SIOCOUTQ, &cur_so_sendbuf) == -1)
             {
               g_warning ("%s: ioctl error: %s", __func__, strerror (errno));
@@ -137,8 +186,10 @@ throttle (int soc, int so_sndbuf)
  * @param soc Socket to use for sending.
  * @param dst Destination address to send to.
  * @param type  Type of imcp. e.g. ND_NEIGHBOR_SOLICIT or ICMP6_ECHO_REQUEST.
+ *
+ * @return 0 on success, -1 if the packet could not be sent.
  */
-static void
+static int
 send_icmp_v6 (int soc, struct in6_addr *dst, int type)
 {
   struct sockaddr_in6 soca;
@@ -147,9 +198,10 @@ send_icmp_v6 (int soc, struct in6_addr *dst, int type)
   int datalen = 56;
   struct icmp6_hdr *icmp6;
 
-  /* Throttling related variables */
-  static int so_sndbuf = -1; // socket send buffer
-  static int init = -1;
+  /* Throttling related variables. Thread local, as every sender thread uses
+   * its own sockets. */
+  static _Thread_local int so_sndbuf = -1; // socket send buffer
+  static _Thread_local int init = -1;
 
   icmp6 = (struct icmp6_hdr *) sendbuf;
   icmp6->icmp6_type = type; /* ND_NEIGHBOR_SOLICIT or ICMP6_ECHO_REQUEST */
@@ -180,7 +232,9 @@ send_icmp_v6 (int soc, struct in6_addr *dst, int type)
       < 0)
     {
       g_warning ("%s: sendto(): %s", __func__, strerror (errno));
+      return -1;
     }
+  return 0;
 }
 
 /**
@@ -188,8 +242,10 @@ send_icmp_v6 (int soc, struct in6_addr *dst, int type)
  *
  * @param soc Socket to use for sending.
  * @param dst Destination address to send to.
+ *
+ * @return 0 on success, -1 if the packet could not be sent.
  */
-static void
+static int
 send_icmp_v4 (int soc, struct in_addr *dst)
 {
   /* datalen + MAXIPLEN + MAXICMPLEN */
@@ -200,9 +256,10 @@ send_icmp_v4 (int soc, struct in_addr *dst)
   int datalen = 56;
   struct icmphdr *icmp;
 
-  /* Throttling related variables */
-  static int so_sndbuf = -1; // socket send buffer
-  static int init = -1;
+  /* Throttling related variables. Thread local, as every sender thread uses
+   * its own sockets. */
+  static _Thread_local int so_sndbuf = -1; // socket send buffer
+  static _Thread_local int init = -1;
 
   icmp = (struct icmphdr *) sendbuf;
   icmp->type = ICMP_ECHO;
@@ -232,27 +289,27 @@ send_icmp_v4 (int soc, struct in_addr *dst)
       < 0)
     {
       g_warning ("%s: sendto(): %s", __func__, strerror (errno));
+      return -1;
     }
+  return 0;
 }
 
 /**
- * @brief Is called in g_hash_table_foreach(). Check if ipv6 or ipv4, get
+ * @brief Is called in g_ptr_array_foreach(). Check if ipv6 or ipv4, get
  * correct socket and start appropriate ping function.
  *
- * @param key Ip string.
- * @param value Pointer to gvm_host_t.
+ * @param host Pointer to gvm_host_t.
  * @param scanner_p Pointer to scanner struct.
  */
 void
-send_icmp (gpointer key, gpointer value, gpointer scanner_p)
+send_icmp (gpointer host, gpointer scanner_p)
 {
   scanner_t *scanner;
   struct in6_addr dst6;
   struct in6_addr *dst6_p = &dst6;
   struct in_addr dst4;
   struct in_addr *dst4_p = &dst4;
-  static int count = 0;
-  int icmp_retries, grace_period = 0;
+  int icmp_retries, grace_period = 0, err;
   const char *tmp;
   if ((icmp_retries =
          (tmp = prefs_get ("icmp_retries")) != NULL ? atoi (tmp) : 1)
@@ -267,12 +324,11 @@ send_icmp (gpointer key, gpointer value, gpointer scanner_p)
   // we may send multiple icmp message to reduce to chance of unwanted drops
   for (int i = 0; i < icmp_retries; i++)
     {
-      if (g_hash_table_contains (scanner->hosts_data->alivehosts, key))
+      if (hosts_set_contains_host (scanner->hosts_data->alivehosts, host))
         return;
-      if (++count % BURST == 0)
-        usleep (BURST_TIMEOUT);
+      ratelimit_acquire (scanner->ratelimit, 1);
 
-      if (gvm_host_get_addr6 ((gvm_host_t *) value, dst6_p) < 0)
+      if (gvm_host_get_addr6 ((gvm_host_t *) host, dst6_p) < 0)
         g_warning ("%s: could not get addr6 from gvm_host_t", __func__);
       if (dst6_p == NULL)
         {
@@ -281,24 +337,197 @@ send_icmp (gpointer key, gpointer value, gpointer scanner_p)
         }
       if (IN6_IS_ADDR_V4MAPPED (dst6_p) != 1)
         {
-          send_icmp_v6 (scanner->icmpv6soc, dst6_p, ICMP6_ECHO_REQUEST);
+          /* Counted by the sweep when sent. Retries are sent right away to
+           * keep the grace period between them. */
+          if (ndsweep_add (scanner->icmpv6sweep, dst6_p) == 0)
+            {
+              if (grace_period > 0)
+                {
+                  ndsweep_flush (scanner->icmpv6sweep);
+                  usleep (grace_period);
+                }
+              continue;
+            }
+          err = send_icmp_v6 (scanner->icmpv6soc, dst6_p, ICMP6_ECHO_REQUEST);
         }
       else
         {
           dst4.s_addr = dst6_p->s6_addr32[3];
-          send_icmp_v4 (scanner->icmpv4soc, dst4_p);
+          err = send_icmp_v4 (scanner->icmpv4soc, dst4_p);
         }
+      alive_stats_sent (scanner->stats, ALIVE_METHOD_ICMP, err);
       if (grace_period > 0)
         usleep (grace_period);
     }
 }
 
+/**
+ * @brief Build the IPv6 TCP ping template for a destination.
+ *
+ * All header fields which are the same for every port are set and the TCP
+ * checksum is computed once with th_dport set to 0.
+ *
+ * @param[out] template  Template to fill.
+ * @param[in]  src       Source address.
+ * @param[in]  dst       Destination address.
+ * @param[in]  tcp_flag  TH_SYN or TH_ACK.
+ */
+static void
+tcp_v6_template_init (struct tcp_v6_template *template,
+                      const struct in6_addr *src, const struct in6_addr *dst,
+                      uint8_t tcp_flag)
+{
+  struct ip6_hdr *ip = (struct ip6_hdr *) template->packet;
+  struct tcphdr *tcp =
+    (struct tcphdr *) (template->packet + sizeof (struct ip6_hdr));
+  struct v6pseudohdr pseudoheader;
+
+  memset (template->packet, 0, sizeof (template->packet));
+  /* IPv6 */
+  ip->ip6_flow = htonl ((6 << 28) | (0 << 20) | 0);
+  ip->ip6_plen = htons (20); // TCP_HDRLEN
+  ip->ip6_nxt = IPPROTO_TCP;
+  ip->ip6_hops = 255; // max value
+
+  ip->ip6_src = *src;
+  ip->ip6_dst = *dst;
+
+  /* TCP */
+  tcp->th_sport = htons (FILTER_PORT);
+  tcp->th_dport = 0;
+  tcp->th_seq = htonl (0);
+  tcp->th_ack = htonl (0);
+  tcp->th_x2 = 0;
+  tcp->th_off = 20 / 4; // TCP_HDRLEN / 4 (size of tcphdr in 32 bit words)
+  tcp->th_flags = tcp_flag; // TH_SYN or TH_ACK
+  tcp->th_win = htons (65535);
+  tcp->th_urp = htons (0);
+  tcp->th_sum = 0;
+
+  /* CKsum */
+  memset (&pseudoheader, 0, 38 + sizeof (struct tcphdr));
+  memcpy (&pseudoheader.s6addr, &ip->ip6_src, sizeof (struct in6_addr));
+  memcpy (&pseudoheader.d6addr, &ip->ip6_dst, sizeof (struct in6_addr));
+
+  pseudoheader.protocol = IPPROTO_TCP;
+  pseudoheader.length = htons (sizeof (struct tcphdr));
+  memcpy ((char *) &pseudoheader.tcpheader, (char *) tcp,
+          sizeof (struct tcphdr));
+  template->base_sum = in_cksum ((unsigned short *) &pseudoheader,
+                                 38 + sizeof (struct tcphdr));
+  tcp->th_sum = template->base_sum;
+}
+
+/**
+ * @brief Set the destination port of an IPv6 TCP ping template.
+ *
+ * @param template  Template initialised with tcp_v6_template_init().
+ * @param port      Destination port in host byte order.
+ */
+static void
+tcp_v6_template_set_port (struct tcp_v6_template *template, uint16_t port)
+{
+  struct tcphdr *tcp =
+    (struct tcphdr *) (template->packet + sizeof (struct ip6_hdr));
+
+  tcp->th_dport = htons (port);
+  tcp->th_sum = in_cksum_update (template->base_sum, 0, tcp->th_dport);
+}
+
+/**
+ * @brief Build the IPv4 TCP ping template for a destination.
+ *
+ * All header fields which are the same for every port are set and the TCP
+ * checksum is computed once with th_dport and th_seq set to 0.
+ *
+ * @param[out] template  Template to fill.
+ * @param[in]  src       Source address.
+ * @param[in]  dst       Destination address.
+ * @param[in]  tcp_flag  TH_SYN or TH_ACK.
+ */
+static void
+tcp_v4_template_init (struct tcp_v4_template *template,
+                      const struct in_addr *src, const struct in_addr *dst,
+                      uint8_t tcp_flag)
+{
+  struct ip *ip = (struct ip *) template->packet;
+  struct tcphdr *tcp =
+    (struct tcphdr *) (template->packet + sizeof (struct ip));
+  struct pseudohdr pseudoheader;
+
+  memset (template->packet, 0, sizeof (template->packet));
+  /* IP */
+  ip->ip_hl = 5;
+  ip->ip_off = htons (0);
+  ip->ip_v = 4;
+  ip->ip_tos = 0;
+  ip->ip_p = IPPROTO_TCP;
+  ip->ip_id = 0;
+  ip->ip_ttl = 0x40;
+  ip->ip_src = *src;
+  ip->ip_dst = *dst;
+  ip->ip_sum = 0;
+
+  /* TCP */
+  tcp->th_sport = htons (FILTER_PORT);
+  tcp->th_flags = tcp_flag; // TH_SYN TH_ACK;
+  tcp->th_dport = 0;
+  tcp->th_seq = 0;
+  tcp->th_ack = 0;
+  tcp->th_x2 = 0;
+  tcp->th_off = 5;
+  tcp->th_win = 2048;
+  tcp->th_urp = 0;
+  tcp->th_sum = 0;
+
+  /* CKsum */
+  memset (&pseudoheader, 0, 12 + sizeof (struct tcphdr));
+  pseudoheader.saddr.s_addr = ip->ip_src.s_addr;
+  pseudoheader.daddr.s_addr = ip->ip_dst.s_addr;
+
+  pseudoheader.protocol = IPPROTO_TCP;
+  pseudoheader.length = htons (sizeof (struct tcphdr));
+  memcpy ((char *) &pseudoheader.tcpheader, (char *) tcp,
+          sizeof (struct tcphdr));
+  template->base_sum = in_cksum ((unsigned short *) &pseudoheader,
+                                 12 + sizeof (struct tcphdr));
+  tcp->th_sum = template->base_sum;
+}
+
+/**
+ * @brief Set the destination port of an IPv4 TCP ping template.
+ *
+ * A new random IP ID and TCP sequence number are set as well. The TCP
+ * checksum is patched for the changed words instead of being recomputed. The
+ * IP header checksum is always filled in by the kernel.
+ *
+ * @param template  Template initialised with tcp_v4_template_init().
+ * @param port      Destination port in host byte order.
+ */
+static void
+tcp_v4_template_set_port (struct tcp_v4_template *template, uint16_t port)
+{
+  struct ip *ip = (struct ip *) template->packet;
+  struct tcphdr *tcp =
+    (struct tcphdr *) (template->packet + sizeof (struct ip));
+  uint16_t seq_words[2];
+  uint16_t sum;
+
+  ip->ip_id = get_random ();
+  tcp->th_dport = htons (port);
+  tcp->th_seq = get_random ();
+
+  memcpy (seq_words, &tcp->th_seq, sizeof (seq_words));
+  sum = in_cksum_update (template->base_sum, 0, tcp->th_dport);
+  sum = in_cksum_update (sum, 0, seq_words[0]);
+  tcp->th_sum = in_cksum_update (sum, 0, seq_words[1]);
+}
+
 /**
  * @brief Send tcp ping.
  *
- * @param soc Socket to use for sending.
- * @param dst Destination address to send to.
- * @param tcp_flag  TH_SYN or TH_ACK.
+ * @param scanner Scanner struct which includes all needed data for tcp_v6 ping.
+ * @param dst_p Destination address to send to.
  */
 static void
 send_tcp_v6 (scanner_t *scanner, struct in6_addr *dst_p)
@@ -306,22 +535,22 @@ send_tcp_v6 (scanner_t *scanner, struct in6_addr *dst_p)
   boreas_error_t error;
   struct sockaddr_in6 soca;
   struct in6_addr src;
+  struct tcp_v6_template template;
+  alive_method_t method =
+    scanner->tcp_flag == TH_SYN ? ALIVE_METHOD_TCP_SYN : ALIVE_METHOD_TCP_ACK;
+  int err;
 
-  /* Throttling related variables */
-  static int so_sndbuf = -1; // socket send buffer
-  static int init = -1;
+  /* Throttling related variables. Thread local, as every sender thread uses
+   * its own sockets. */
+  static _Thread_local int so_sndbuf = -1; // socket send buffer
+  static _Thread_local int init = -1;
 
   GArray *ports = scanner->ports;
   int *udpv6soc = &(scanner->udpv6soc);
   int soc = scanner->tcpv6soc;
-  uint8_t tcp_flag = scanner->tcp_flag;
-
-  u_char packet[sizeof (struct ip6_hdr) + sizeof (struct tcphdr)];
-  struct ip6_hdr *ip = (struct ip6_hdr *) packet;
-  struct tcphdr *tcp = (struct tcphdr *) (packet + sizeof (struct ip6_hdr));
 
   /* Get source address for TCP header. */
-  error = get_source_addr_v6 (udpv6soc, dst_p, &src);
+  error = srccache_get_v6 (scanner->srccache, udpv6soc, dst_p, &src);
   if (error)
     {
       char destination_str[INET_ADDRSTRLEN];
@@ -336,67 +565,39 @@ send_tcp_v6 (scanner_t *scanner, struct in6_addr *dst_p)
   if (ports->len == 0)
     return;
 
+  tcp_v6_template_init (&template, &src, dst_p, scanner->tcp_flag);
+
+  memset (&soca, 0, sizeof (soca));
+  soca.sin6_family = AF_INET6;
+  soca.sin6_addr = *dst_p;
+
+  /* Get size of empty SO_SNDBUF */
+  if (init == -1)
+    {
+      if (get_so_sndbuf (soc, &so_sndbuf) == 0)
+        init = 1;
+    }
+
   /* For ports in ports array send packet. */
   for (guint i = 0; i < ports->len; i++)
     {
-      memset (packet, 0, sizeof (packet));
-      /* IPv6 */
-      ip->ip6_flow = htonl ((6 << 28) | (0 << 20) | 0);
-      ip->ip6_plen = htons (20); // TCP_HDRLEN
-      ip->ip6_nxt = IPPROTO_TCP;
-      ip->ip6_hops = 255; // max value
-
-      ip->ip6_src = src;
-      ip->ip6_dst = *dst_p;
-
-      /* TCP */
-      tcp->th_sport = htons (FILTER_PORT);
-      tcp->th_dport = htons (g_array_index (ports, uint16_t, i));
-      tcp->th_seq = htonl (0);
-      tcp->th_ack = htonl (0);
-      tcp->th_x2 = 0;
-      tcp->th_off = 20 / 4; // TCP_HDRLEN / 4 (size of tcphdr in 32 bit words)
-      tcp->th_flags = tcp_flag; // TH_SYN or TH_ACK
-      tcp->th_win = htons (65535);
-      tcp->th_urp = htons (0);
-      tcp->th_sum = 0;
-
-      /* CKsum */
-      {
-        struct v6pseudohdr pseudoheader;
-
-        memset (&pseudoheader, 0, 38 + sizeof (struct tcphdr));
-        memcpy (&pseudoheader.s6addr, &ip->ip6_src, sizeof (struct in6_addr));
-        memcpy (&pseudoheader.d6addr, &ip->ip6_dst, sizeof (struct in6_addr));
-
-        pseudoheader.protocol = IPPROTO_TCP;
-        pseudoheader.length = htons (sizeof (struct tcphdr));
-        memcpy ((char *) &pseudoheader.tcpheader, (char *) tcp,
-                sizeof (struct tcphdr));
-        tcp->th_sum = in_cksum ((unsigned short *) &pseudoheader,
-                                38 + sizeof (struct tcphdr));
-      }
-
-      memset (&soca, 0, sizeof (soca));
-      soca.sin6_family = AF_INET6;
-      soca.sin6_addr = ip->ip6_dst;
-
-      /* Get size of empty SO_SNDBUF */
-      if (init == -1)
-        {
-          if (get_so_sndbuf (soc, &so_sndbuf) == 0)
-            init = 1;
-        }
+      tcp_v6_template_set_port (&template,
+                                g_array_index (ports, uint16_t, i));
+
       /* Throttle speed if needed */
+      ratelimit_acquire (scanner->ratelimit, 1);
       throttle (soc, so_sndbuf);
 
       /*  TCP_HDRLEN(20) IP6_HDRLEN(40) */
-      if (sendto (soc, (const void *) ip, 40 + 20, MSG_NOSIGNAL,
+      err = 0;
+      if (sendto (soc, (const void *) template.packet, 40 + 20, MSG_NOSIGNAL,
                   (struct sockaddr *) &soca, sizeof (struct sockaddr_in6))
           < 0)
         {
+          err = -1;
           g_warning ("%s: sendto():  %s", __func__, strerror (errno));
         }
+      alive_stats_sent (scanner->stats, method, err);
     }
 }
 
@@ -412,26 +613,26 @@ send_tcp_v4 (scanner_t *scanner, struct in_addr *dst_p)
   boreas_error_t error;
   struct sockaddr_in soca;
   struct in_addr src;
+  struct tcp_v4_template template;
+  alive_method_t method =
+    scanner->tcp_flag == TH_SYN ? ALIVE_METHOD_TCP_SYN : ALIVE_METHOD_TCP_ACK;
+  int err;
 
-  /* Throttling related variables */
-  static int so_sndbuf = -1; // socket send buffer
-  static int init = -1;
+  /* Throttling related variables. Thread local, as every sender thread uses
+   * its own sockets. */
+  static _Thread_local int so_sndbuf = -1; // socket send buffer
+  static _Thread_local int init = -1;
 
   int soc = scanner->tcpv4soc;          /* Socket used for sending. */
   GArray *ports = scanner->ports;       /* Ports to ping. */
   int *udpv4soc = &(scanner->udpv4soc); /* Socket used for getting src addr */
-  uint8_t tcp_flag = scanner->tcp_flag; /* SYN or ACK tcp flag. */
-
-  u_char packet[sizeof (struct ip) + sizeof (struct tcphdr)];
-  struct ip *ip = (struct ip *) packet;
-  struct tcphdr *tcp = (struct tcphdr *) (packet + sizeof (struct ip));
 
   /* No ports in portlist. */
   if (ports->len == 0)
     return;
 
   /* Get source address for TCP header. */
-  error = get_source_addr_v4 (udpv4soc, dst_p, &src);
+  error = srccache_get_v4 (scanner->srccache, udpv4soc, dst_p, &src);
   if (error)
     {
       char destination_str[INET_ADDRSTRLEN];
@@ -441,103 +642,64 @@ send_tcp_v4 (scanner_t *scanner, struct in_addr *dst_p)
       return;
     }
 
+  /* Only destination port, sequence number and IP ID change per port. */
+  tcp_v4_template_init (&template, &src, dst_p, scanner->tcp_flag);
+
+  memset (&soca, 0, sizeof (soca));
+  soca.sin_family = AF_INET;
+  soca.sin_addr = *dst_p;
+
+  /* Get size of empty SO_SNDBUF */
+  if (init == -1)
+    {
+      if (get_so_sndbuf (soc, &so_sndbuf) == 0)
+        init = 1;
+    }
+
   /* For ports in ports array send packet. */
   for (guint i = 0; i < ports->len; i++)
     {
-      memset (packet, 0, sizeof (packet));
-      /* IP */
-      ip->ip_hl = 5;
-      ip->ip_off = htons (0);
-      ip->ip_v = 4;
-      ip->ip_tos = 0;
-      ip->ip_p = IPPROTO_TCP;
-      ip->ip_id = rand ();
-      ip->ip_ttl = 0x40;
-      ip->ip_src = src;
-      ip->ip_dst = *dst_p;
-      ip->ip_sum = 0;
-
-      /* TCP */
-      tcp->th_sport = htons (FILTER_PORT);
-      tcp->th_flags = tcp_flag; // TH_SYN TH_ACK;
-      tcp->th_dport = htons (g_array_index (ports, uint16_t, i));
-      tcp->th_seq = rand ();
-      tcp->th_ack = 0;
-      tcp->th_x2 = 0;
-      tcp->th_off = 5;
-      tcp->th_win = 2048;
-      tcp->th_urp = 0;
-      tcp->th_sum = 0;
-
-      /* CKsum */
-      {
-        struct in_addr source, dest;
-        struct pseudohdr pseudoheader;
-        source.s_addr = ip->ip_src.s_addr;
-        dest.s_addr = ip->ip_dst.s_addr;
-
-        memset (&pseudoheader, 0, 12 + sizeof (struct tcphdr));
-        pseudoheader.saddr.s_addr = source.s_addr;
-        pseudoheader.daddr.s_addr = dest.s_addr;
-
-        pseudoheader.protocol = IPPROTO_TCP;
-        pseudoheader.length = htons (sizeof (struct tcphdr));
-        memcpy ((char *) &pseudoheader.tcpheader, (char *) tcp,
-                sizeof (struct tcphdr));
-        tcp->th_sum = in_cksum ((unsigned short *) &pseudoheader,
-                                12 + sizeof (struct tcphdr));
-      }
-
-      memset (&soca, 0, sizeof (soca));
-      soca.sin_family = AF_INET;
-      soca.sin_addr = ip->ip_dst;
-
-      /* Get size of empty SO_SNDBUF */
-      if (init == -1)
-        {
-          if (get_so_sndbuf (soc, &so_sndbuf) == 0)
-            init = 1;
-        }
+      tcp_v4_template_set_port (&template,
+                                g_array_index (ports, uint16_t, i));
+
       /* Throttle speed if needed */
+      ratelimit_acquire (scanner->ratelimit, 1);
       throttle (soc, so_sndbuf);
 
-      if (sendto (soc, (const void *) ip, 40, MSG_NOSIGNAL,
+      err = 0;
+      if (sendto (soc, (const void *) template.packet, 40, MSG_NOSIGNAL,
                   (struct sockaddr *) &soca, sizeof (soca))
           < 0)
         {
+          err = -1;
           g_warning ("%s: sendto(): %s", __func__, strerror (errno));
         }
+      alive_stats_sent (scanner->stats, method, err);
     }
 }
 
 /**
- * @brief Is called in g_hash_table_foreach(). Check if ipv6 or ipv4, get
+ * @brief Is called in g_ptr_array_foreach(). Check if ipv6 or ipv4, get
  * correct socket and start appropriate ping function.
  *
- * @param key Ip string.
- * @param value Pointer to gvm_host_t.
+ * @param host Pointer to gvm_host_t.
  * @param scanner_p Pointer to scanner struct.
  */
 void
-send_tcp (gpointer key, gpointer value, gpointer scanner_p)
+send_tcp (gpointer host, gpointer scanner_p)
 {
   scanner_t *scanner;
   struct in6_addr dst6;
   struct in6_addr *dst6_p = &dst6;
   struct in_addr dst4;
   struct in_addr *dst4_p = &dst4;
-  static int count = 0;
 
   scanner = (scanner_t *) scanner_p;
 
-  if (g_hash_table_contains (scanner->hosts_data->alivehosts, key))
+  if (hosts_set_contains_host (scanner->hosts_data->alivehosts, host))
     return;
 
-  count++;
-  if (count % BURST == 0)
-    usleep (BURST_TIMEOUT);
-
-  if (gvm_host_get_addr6 ((gvm_host_t *) value, dst6_p) < 0)
+  if (gvm_host_get_addr6 ((gvm_host_t *) host, dst6_p) < 0)
     g_warning ("%s: could not get addr6 from gvm_host_t", __func__);
   if (dst6_p == NULL)
     {
@@ -556,31 +718,28 @@ send_tcp (gpointer key, gpointer value, gpointer scanner_p)
 }
 
 /**
- * @brief Is called in g_hash_table_foreach(). Check if ipv6 or ipv4, get
+ * @brief Is called in g_ptr_array_foreach(). Check if ipv6 or ipv4, get
  * correct socket and start appropriate ping function.
  *
- * @param host_value_str Ip string.
- * @param value Pointer to gvm_host_t.
+ * @param host Pointer to gvm_host_t.
  * @param scanner_p Pointer to scanner struct.
  */
 void
-send_arp (gpointer host_value_str, gpointer value, gpointer scanner_p)
+send_arp (gpointer host, gpointer scanner_p)
 {
   scanner_t *scanner;
   struct in6_addr dst6;
   struct in6_addr *dst6_p = &dst6;
-  static int count = 0;
+  int err;
 
   scanner = (scanner_t *) scanner_p;
 
-  if (g_hash_table_contains (scanner->hosts_data->alivehosts, host_value_str))
+  if (hosts_set_contains_host (scanner->hosts_data->alivehosts, host))
     return;
 
-  count++;
-  if (count % BURST == 0)
-    usleep (BURST_TIMEOUT);
+  ratelimit_acquire (scanner->ratelimit, 1);
 
-  if (gvm_host_get_addr6 ((gvm_host_t *) value, dst6_p) < 0)
+  if (gvm_host_get_addr6 ((gvm_host_t *) host, dst6_p) < 0)
     g_warning ("%s: could not get addr6 from gvm_host_t", __func__);
   if (dst6_p == NULL)
     {
@@ -590,23 +749,35 @@ send_arp (gpointer host_value_str, gpointer value, gpointer scanner_p)
   if (IN6_IS_ADDR_V4MAPPED (dst6_p) != 1)
     {
       /* IPv6 does simulate ARP by using the Neighbor Discovery Protocol with
-       * ICMPv6. */
-      send_icmp_v6 (scanner->arpv6soc, dst6_p, ND_NEIGHBOR_SOLICIT);
+       * ICMPv6. Solicitations are counted by the sweep when sent. */
+      if (ndsweep_add (scanner->ndsweep, dst6_p) == 0)
+        return;
+      err = send_icmp_v6 (scanner->arpv6soc, dst6_p, ND_NEIGHBOR_SOLICIT);
     }
   else
     {
       char ipv4_str[INET_ADDRSTRLEN];
+      struct in_addr dst4;
+
+      /* Queue the request if the interface is usable for the raw socket. The
+       * sweep counts it when it is sent. */
+      dst4.s_addr = dst6_p->s6_addr32[3];
+      if (arpsweep_add (scanner->arpsweep, &dst4) == 0)
+        return;
 
       /* Need to transform the IPv6 mapped IPv4 address back to an IPv4 string.
-       * We can not just use the host_value_str as it might be an IPv4 mapped
-       * IPv6 string. */
+       * We can not just use the host value string as it might be an IPv4
+       * mapped IPv6 string. */
       if (inet_ntop (AF_INET, &(dst6_p->s6_addr32[3]), ipv4_str,
                      sizeof (ipv4_str))
           == NULL)
         {
-          g_warning ("%s: Error: %s. Skipping ARP ping for '%s'", __func__,
-                     strerror (errno), (char *) host_value_str);
+          g_warning ("%s: Error: %s. Skipping ARP ping.", __func__,
+                     strerror (errno));
+          alive_stats_sent (scanner->stats, ALIVE_METHOD_ARP, -1);
+          return;
         }
-      send_arp_v4 (ipv4_str);
+      err = send_arp_v4 (ipv4_str);
     }
+  alive_stats_sent (scanner->stats, ALIVE_METHOD_ARP, err);
 }
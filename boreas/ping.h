@@ -8,10 +8,10 @@
 
 #include <glib.h>
 
-void send_icmp (gpointer, gpointer, gpointer);
+void send_icmp (gpointer, gpointer);
 
-void send_tcp (gpointer, gpointer, gpointer);
+void send_tcp (gpointer, gpointer);
 
-void send_arp (gpointer, gpointer, gpointer);
+void send_arp (gpointer, gpointer);
 
 #endif /* not BOREAS_PING_H */
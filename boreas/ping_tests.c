@@ -21,6 +21,68 @@ Ensure (ping, dummy_test)
   assert_that (0, is_equal_to (0));
 }
 
+Ensure (ping, tcp_v4_template_checksum_is_valid)
+{
+  struct tcp_v4_template template;
+  struct in_addr src, dst;
+  struct pseudohdr pseudoheader;
+  struct ip *ip;
+  uint16_t ports[] = {1, 22, 80, 443, 8080, 65535};
+
+  inet_pton (AF_INET, "192.168.0.1", &src);
+  inet_pton (AF_INET, "10.0.0.200", &dst);
+  tcp_v4_template_init (&template, &src, &dst, TH_SYN);
+  ip = (struct ip *) template.packet;
+
+  for (size_t i = 0; i < G_N_ELEMENTS (ports); i++)
+    {
+      tcp_v4_template_set_port (&template, ports[i]);
+
+      /* Checksum over the pseudo header including th_sum must be 0. */
+      memset (&pseudoheader, 0, sizeof (pseudoheader));
+      pseudoheader.saddr = ip->ip_src;
+      pseudoheader.daddr = ip->ip_dst;
+      pseudoheader.protocol = IPPROTO_TCP;
+      pseudoheader.length = htons (sizeof (struct tcphdr));
+      memcpy (&pseudoheader.tcpheader, template.packet + sizeof (struct ip),
+              sizeof (struct tcphdr));
+      assert_that (in_cksum ((unsigned short *) &pseudoheader,
+                             12 + sizeof (struct tcphdr)),
+                   is_equal_to (0));
+      assert_that (ntohs (pseudoheader.tcpheader.th_dport),
+                   is_equal_to (ports[i]));
+    }
+}
+
+Ensure (ping, tcp_v6_template_checksum_is_valid)
+{
+  struct tcp_v6_template template;
+  struct in6_addr src, dst;
+  struct v6pseudohdr pseudoheader;
+  uint16_t ports[] = {1, 22, 80, 443, 8080, 65535};
+
+  inet_pton (AF_INET6, "2001:db8::1", &src);
+  inet_pton (AF_INET6, "2001:db8:ffff::abcd", &dst);
+  tcp_v6_template_init (&template, &src, &dst, TH_ACK);
+
+  for (size_t i = 0; i < G_N_ELEMENTS (ports); i++)
+    {
+      tcp_v6_template_set_port (&template, ports[i]);
+
+      memset (&pseudoheader, 0, sizeof (pseudoheader));
+      memcpy (&pseudoheader.s6addr, &src, sizeof (struct in6_addr));
+      memcpy (&pseudoheader.d6addr, &dst, sizeof (struct in6_addr));
+      pseudoheader.protocol = IPPROTO_TCP;
+      pseudoheader.length = htons (sizeof (struct tcphdr));
+      memcpy (&pseudoheader.tcpheader,
+              template.packet + sizeof (struct ip6_hdr),
+              sizeof (struct tcphdr));
+      assert_that (in_cksum ((unsigned short *) &pseudoheader,
+                             38 + sizeof (struct tcphdr)),
+                   is_equal_to (0));
+    }
+}
+
 int
 main (int argc, char **argv)
 {
@@ -29,6 +91,8 @@ main (int argc, char **argv)
   suite = create_test_suite ();
 
   add_test_with_context (suite, ping, dummy_test);
+  add_test_with_context (suite, ping, tcp_v4_template_checksum_is_valid);
+  add_test_with_context (suite, ping, tcp_v6_template_checksum_is_valid);
 
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
@@ -0,0 +1,288 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Thread publishing alive hosts on the alive detection queue.
+ *
+ * Hosts found alive are handed over to the publisher through a bounded lock
+ * free queue. The publisher thread takes them from the queue and pushes them
+ * on the alive detection queue in the kb with a single LPUSH per batch. A
+ * batch is pushed when it is full or when its first host waited
+ * PUBLISHER_MAX_DELAY, so a slow Redis no longer stalls the sniffer and a
+ * burst of replies costs a few round trips instead of one per host.
+ *
+ * The queue allows several producers (the sniffer thread and the main thread
+ * when considering hosts alive) and a single consumer. Every slot carries a
+ * sequence number telling whether it is free or filled for the current lap.
+ */
+
+#include "publisher.h"
+
+#include "alivedetection.h"
+
+#include <arpa/inet.h>
+#include <glib.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/* How long (in microseconds) to sleep if the queue is empty or full. */
+#define PUBLISHER_POLL_INTERVAL 1000
+
+/**
+ * @brief Slot of the queue.
+ */
+struct publisher_slot
+{
+  /* Position the slot may be written at, or position + 1 once written. */
+  gint seq;
+  char addr_str[INET6_ADDRSTRLEN];
+};
+
+/**
+ * @brief Publisher of alive hosts.
+ */
+struct publisher
+{
+  kb_t kb;
+  pthread_t thread;
+  struct publisher_slot *slots;
+  /* Next position to write. Shared by the producers, accessed atomically. */
+  gint head;
+  /* Next position to read. Only used by the publisher thread. */
+  guint tail;
+  /* Set to stop the publisher thread after the queue was drained. */
+  gint stop;
+  /* Batch which is pushed next. */
+  char (*batch)[INET6_ADDRSTRLEN];
+  const char **batch_ptrs;
+  guint batch_len;
+  /* Monotonic time in microseconds the first host of the batch was taken. */
+  gint64 batch_start;
+  /* Statistics. */
+  guint64 published;
+  guint flushes;
+  gint queue_full;
+};
+
+/**
+ * @brief Get the monotonic time in microseconds.
+ *
+ * @return Monotonic time in microseconds.
+ */
+static gint64
+monotonic_us (void)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (gint64) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/**
+ * @brief Take the next host from the queue and add it to the batch.
+ *
+ * @param publisher  Publisher.
+ *
+ * @return TRUE if a host was taken, FALSE if the queue is empty.
+ */
+static gboolean
+publisher_dequeue (publisher_t *publisher)
+{
+  struct publisher_slot *slot;
+  guint seq;
+
+  slot = &publisher->slots[publisher->tail & (PUBLISHER_QUEUE_SIZE - 1)];
+  seq = (guint) g_atomic_int_get (&slot->seq);
+  if ((gint) (seq - (publisher->tail + 1)) < 0)
+    return FALSE;
+
+  if (publisher->batch_len == 0)
+    publisher->batch_start = monotonic_us ();
+  memcpy (publisher->batch[publisher->batch_len], slot->addr_str,
+          INET6_ADDRSTRLEN);
+  publisher->batch_len++;
+
+  /* Free the slot for the next lap. */
+  g_atomic_int_set (&slot->seq,
+                    (gint) (publisher->tail + PUBLISHER_QUEUE_SIZE));
+  publisher->tail++;
+
+  return TRUE;
+}
+
+/**
+ * @brief Push the batch on the alive detection queue.
+ *
+ * @param publisher  Publisher.
+ */
+static void
+publisher_flush (publisher_t *publisher)
+{
+  if (publisher->batch_len == 0)
+    return;
+
+  if (kb_item_push_str_multi (publisher->kb, ALIVE_DETECTION_QUEUE,
+                              publisher->batch_ptrs, publisher->batch_len)
+      != 0)
+    g_debug ("%s: kb_item_push_str_multi() failed. Could not push %u hosts on "
+             "queue of hosts to be considered as alive.",
+             __func__, publisher->batch_len);
+  else
+    publisher->published += publisher->batch_len;
+
+  publisher->flushes++;
+  publisher->batch_len = 0;
+}
+
+/**
+ * @brief Publisher thread.
+ *
+ * @param publisher_p  Pointer to publisher_t.
+ *
+ * @return NULL.
+ */
+static void *
+publisher_thread (void *publisher_p)
+{
+  publisher_t *publisher = publisher_p;
+
+  for (;;)
+    {
+      gboolean stopping, empty = FALSE;
+
+      stopping = g_atomic_int_get (&publisher->stop);
+      while (publisher->batch_len < PUBLISHER_BATCH_SIZE && !empty)
+        empty = !publisher_dequeue (publisher);
+
+      if (publisher->batch_len == PUBLISHER_BATCH_SIZE || stopping
+          || (publisher->batch_len > 0
+              && monotonic_us () - publisher->batch_start
+                   >= PUBLISHER_MAX_DELAY))
+        publisher_flush (publisher);
+
+      if (stopping && empty)
+        break;
+      if (empty)
+        usleep (PUBLISHER_POLL_INTERVAL);
+    }
+
+  return NULL;
+}
+
+/**
+ * @brief Create a publisher and start its thread.
+ *
+ * @param kb  KB with the alive detection queue. Only used by the publisher
+ *            thread until the publisher is freed.
+ *
+ * @return New publisher, NULL if the thread could not be started.
+ */
+publisher_t *
+publisher_new (kb_t kb)
+{
+  publisher_t *publisher;
+  int err;
+
+  publisher = g_malloc0 (sizeof (publisher_t));
+  publisher->kb = kb;
+  publisher->slots =
+    g_malloc0_n (PUBLISHER_QUEUE_SIZE, sizeof (struct publisher_slot));
+  for (guint i = 0; i < PUBLISHER_QUEUE_SIZE; i++)
+    publisher->slots[i].seq = i;
+  publisher->batch = g_malloc0_n (PUBLISHER_BATCH_SIZE, INET6_ADDRSTRLEN);
+  publisher->batch_ptrs = g_malloc0_n (PUBLISHER_BATCH_SIZE, sizeof (char *));
+  for (guint i = 0; i < PUBLISHER_BATCH_SIZE; i++)
+    publisher->batch_ptrs[i] = publisher->batch[i];
+
+  err = pthread_create (&publisher->thread, NULL, publisher_thread, publisher);
+  if (err)
+    {
+      g_warning ("%s: pthread_create() failed: %s", __func__, strerror (err));
+      g_free (publisher->batch_ptrs);
+      g_free (publisher->batch);
+      g_free (publisher->slots);
+      g_free (publisher);
+      return NULL;
+    }
+
+  return publisher;
+}
+
+/**
+ * @brief Hand a host over to the publisher.
+ *
+ * Never drops a host. If the queue is full the caller waits until the
+ * publisher thread made room.
+ *
+ * @param publisher  Publisher.
+ * @param addr_str   IP address in string representation.
+ */
+void
+publisher_push (publisher_t *publisher, const char *addr_str)
+{
+  struct publisher_slot *slot;
+  guint pos, seq;
+
+  for (;;)
+    {
+      gint diff;
+
+      pos = (guint) g_atomic_int_get (&publisher->head);
+      slot = &publisher->slots[pos & (PUBLISHER_QUEUE_SIZE - 1)];
+      seq = (guint) g_atomic_int_get (&slot->seq);
+      diff = (gint) (seq - pos);
+      if (diff == 0)
+        {
+          if (g_atomic_int_compare_and_exchange (&publisher->head, (gint) pos,
+                                                 (gint) (pos + 1)))
+            break;
+        }
+      else if (diff < 0)
+        {
+          /* Queue is full. */
+          g_atomic_int_inc (&publisher->queue_full);
+          usleep (PUBLISHER_POLL_INTERVAL);
+        }
+    }
+
+  g_strlcpy (slot->addr_str, addr_str, sizeof (slot->addr_str));
+  g_atomic_int_set (&slot->seq, (gint) (pos + 1));
+}
+
+/**
+ * @brief Publish all remaining hosts, stop the publisher thread and free the
+ * publisher.
+ *
+ * No host may be pushed anymore when this function is called.
+ *
+ * @param publisher  Publisher to free.
+ */
+void
+publisher_free (publisher_t *publisher)
+{
+  if (publisher == NULL)
+    return;
+
+  g_atomic_int_set (&publisher->stop, 1);
+  pthread_join (publisher->thread, NULL);
+  g_debug ("%s: Published %" G_GUINT64_FORMAT " hosts in %u batches. Queue "
+           "was full %d times.",
+           __func__, publisher->published, publisher->flushes,
+           publisher->queue_full);
+
+  g_free (publisher->batch_ptrs);
+  g_free (publisher->batch);
+  g_free (publisher->slots);
+  g_free (publisher);
+}
@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_PUBLISHER_H
+#define BOREAS_PUBLISHER_H
+
+#include "../util/kb.h"
+
+/* Number of hosts which can wait for publication. Must be a power of two. */
+#define PUBLISHER_QUEUE_SIZE 16384
+/* Maximum number of hosts pushed with one command. */
+#define PUBLISHER_BATCH_SIZE 1024
+/* Maximum time (in microseconds) a host waits before it is pushed. */
+#define PUBLISHER_MAX_DELAY 5000
+
+typedef struct publisher publisher_t;
+
+publisher_t *
+publisher_new (kb_t);
+
+void
+publisher_push (publisher_t *, const char *);
+
+void
+publisher_free (publisher_t *);
+
+#endif /* not BOREAS_PUBLISHER_H */
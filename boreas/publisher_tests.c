@@ -0,0 +1,139 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "publisher.c"
+
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+#define HOSTS_PER_PRODUCER 20000
+
+/* Hosts pushed on the fake kb. Only written by the publisher thread. */
+static GPtrArray *pushed;
+static gint pushes;
+
+static int
+fake_push_str_multi (kb_t kb, const char *name, const char **values,
+                     size_t count)
+{
+  (void) kb;
+  assert_that (name, is_equal_to_string (ALIVE_DETECTION_QUEUE));
+  assert_that (count, is_greater_than (0));
+  assert_that (count, is_less_than (PUBLISHER_BATCH_SIZE + 1));
+  for (size_t i = 0; i < count; i++)
+    g_ptr_array_add (pushed, g_strdup (values[i]));
+  g_atomic_int_inc (&pushes);
+  return 0;
+}
+
+static struct kb_operations fake_kb_ops = {
+  .kb_push_str_multi = fake_push_str_multi,
+};
+static struct kb fake_kb = {.kb_ops = &fake_kb_ops};
+
+struct producer
+{
+  publisher_t *publisher;
+  int id;
+};
+
+static void *
+produce (void *producer_p)
+{
+  struct producer *producer = producer_p;
+  char addr_str[INET6_ADDRSTRLEN];
+
+  for (int i = 0; i < HOSTS_PER_PRODUCER; i++)
+    {
+      g_snprintf (addr_str, sizeof (addr_str), "10.%d.%d.%d", producer->id,
+                  i >> 8, i & 0xff);
+      publisher_push (producer->publisher, addr_str);
+    }
+  return NULL;
+}
+
+Describe (publisher);
+BeforeEach (publisher)
+{
+  pushed = g_ptr_array_new_with_free_func (g_free);
+  pushes = 0;
+}
+AfterEach (publisher)
+{
+  g_ptr_array_free (pushed, TRUE);
+}
+
+Ensure (publisher, publishes_hosts_of_all_producers_in_order)
+{
+  publisher_t *publisher;
+  struct producer producers[2];
+  pthread_t threads[2];
+  int next[2] = {0, 0};
+
+  publisher = publisher_new (&fake_kb);
+  assert_that (publisher, is_not_null);
+
+  for (int i = 0; i < 2; i++)
+    {
+      producers[i].publisher = publisher;
+      producers[i].id = i;
+      pthread_create (&threads[i], NULL, produce, &producers[i]);
+    }
+  for (int i = 0; i < 2; i++)
+    pthread_join (threads[i], NULL);
+  publisher_free (publisher);
+
+  assert_that (pushed->len, is_equal_to (2 * HOSTS_PER_PRODUCER));
+  assert_that (pushes, is_less_than (2 * HOSTS_PER_PRODUCER));
+  /* Hosts of one producer keep their order. */
+  for (guint i = 0; i < pushed->len; i++)
+    {
+      int id, a, b;
+      char expected[INET6_ADDRSTRLEN];
+
+      assert_that (sscanf (g_ptr_array_index (pushed, i), "10.%d.%d.%d", &id,
+                           &a, &b),
+                   is_equal_to (3));
+      g_snprintf (expected, sizeof (expected), "10.%d.%d.%d", id,
+                  next[id] >> 8, next[id] & 0xff);
+      assert_that (g_ptr_array_index (pushed, i),
+                   is_equal_to_string (expected));
+      next[id]++;
+    }
+}
+
+Ensure (publisher, publishes_single_host_within_delay)
+{
+  publisher_t *publisher;
+
+  publisher = publisher_new (&fake_kb);
+  publisher_push (publisher, "192.168.0.1");
+  /* Well above PUBLISHER_MAX_DELAY. */
+  for (int i = 0; i < 100 && g_atomic_int_get (&pushes) == 0; i++)
+    usleep (PUBLISHER_MAX_DELAY);
+  assert_that (g_atomic_int_get (&pushes), is_equal_to (1));
+  publisher_free (publisher);
+
+  assert_that (pushed->len, is_equal_to (1));
+  assert_that (g_ptr_array_index (pushed, 0),
+               is_equal_to_string ("192.168.0.1"));
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, publisher,
+                         publishes_hosts_of_all_producers_in_order);
+  add_test_with_context (suite, publisher, publishes_single_host_within_delay);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -0,0 +1,192 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Token bucket rate limiter for the alive test packet senders.
+ */
+
+#include "ratelimit.h"
+
+#include <errno.h>
+#include <glib.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+#define NSEC_PER_SEC 1000000000ULL
+
+/**
+ * @brief Convert a timespec to nanoseconds.
+ *
+ * @param ts  Timespec to convert.
+ *
+ * @return Nanoseconds.
+ */
+static uint64_t
+timespec_to_ns (const struct timespec *ts)
+{
+  return (uint64_t) ts->tv_sec * NSEC_PER_SEC + (uint64_t) ts->tv_nsec;
+}
+
+/**
+ * @brief Convert nanoseconds to a timespec.
+ *
+ * @param[in]   ns  Nanoseconds to convert.
+ * @param[out]  ts  Timespec to fill.
+ */
+static void
+ns_to_timespec (uint64_t ns, struct timespec *ts)
+{
+  ts->tv_sec = ns / NSEC_PER_SEC;
+  ts->tv_nsec = ns % NSEC_PER_SEC;
+}
+
+/**
+ * @brief Create a new token bucket.
+ *
+ * @param pps    Maximum number of packets per second. 0 for no limit.
+ * @param burst  Maximum number of packets which may be sent back to back.
+ *               Values smaller than 1 are treated as 1.
+ *
+ * @return New token bucket. Free with ratelimit_free().
+ */
+ratelimit_t *
+ratelimit_new (unsigned int pps, unsigned int burst)
+{
+  ratelimit_t *ratelimit;
+
+  ratelimit = g_malloc0 (sizeof (ratelimit_t));
+  if (pps == 0)
+    return ratelimit;
+
+  if (burst == 0)
+    burst = 1;
+  ratelimit->interval_ns = NSEC_PER_SEC / pps;
+  if (ratelimit->interval_ns == 0)
+    ratelimit->interval_ns = 1;
+  ratelimit->capacity_ns = ratelimit->interval_ns * burst;
+  /* Start with a full bucket. */
+  ratelimit->credit_ns = ratelimit->capacity_ns;
+
+  return ratelimit;
+}
+
+/**
+ * @brief Free a token bucket.
+ *
+ * @param ratelimit  Token bucket to free.
+ */
+void
+ratelimit_free (ratelimit_t *ratelimit)
+{
+  g_free (ratelimit);
+}
+
+/**
+ * @brief Take tokens from the bucket, sleeping until they are available.
+ *
+ * The sleep uses clock_nanosleep() with an absolute CLOCK_MONOTONIC deadline,
+ * so oversleeping is credited to the next call instead of accumulating.
+ *
+ * @param ratelimit  Token bucket. If NULL the call returns immediately.
+ * @param n          Number of packets about to be sent.
+ */
+void
+ratelimit_acquire (ratelimit_t *ratelimit, unsigned int n)
+{
+  struct timespec now;
+  uint64_t now_ns, cost_ns;
+
+  if (ratelimit == NULL || n == 0)
+    return;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  if (ratelimit->sent == 0)
+    ratelimit->first = now;
+  ratelimit->sent += n;
+
+  if (ratelimit->interval_ns == 0)
+    {
+      ratelimit->last = now;
+      return;
+    }
+
+  /* Refill. */
+  now_ns = timespec_to_ns (&now);
+  if (ratelimit->sent != n)
+    ratelimit->credit_ns += now_ns - timespec_to_ns (&ratelimit->last);
+  if (ratelimit->credit_ns > ratelimit->capacity_ns)
+    ratelimit->credit_ns = ratelimit->capacity_ns;
+  ratelimit->last = now;
+
+  cost_ns = ratelimit->interval_ns * n;
+  if (ratelimit->credit_ns >= cost_ns)
+    {
+      ratelimit->credit_ns -= cost_ns;
+      return;
+    }
+
+  /* Not enough tokens. Sleep until the missing ones have been earned. */
+  ns_to_timespec (now_ns + cost_ns - ratelimit->credit_ns, &ratelimit->last);
+  ratelimit->credit_ns = 0;
+  ratelimit->stalls++;
+  while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ratelimit->last,
+                          NULL)
+         == EINTR)
+    ;
+}
+
+/**
+ * @brief Get the packet rate achieved so far.
+ *
+ * @param ratelimit  Token bucket.
+ *
+ * @return Packets per second between the first and the last acquire, 0 if
+ *         not enough packets were sent to tell.
+ */
+double
+ratelimit_achieved_rate (const ratelimit_t *ratelimit)
+{
+  uint64_t elapsed_ns;
+
+  if (ratelimit == NULL || ratelimit->sent < 2)
+    return 0;
+
+  elapsed_ns =
+    timespec_to_ns (&ratelimit->last) - timespec_to_ns (&ratelimit->first);
+  if (elapsed_ns == 0)
+    return 0;
+
+  return (double) ratelimit->sent * NSEC_PER_SEC / elapsed_ns;
+}
+
+/**
+ * @brief Add the statistics of one token bucket to another.
+ *
+ * Used to get the overall rate of several senders. The send window of dst is
+ * extended to cover the one of src.
+ *
+ * @param dst  Token bucket to add the statistics to.
+ * @param src  Token bucket to take the statistics from.
+ */
+void
+ratelimit_merge (ratelimit_t *dst, const ratelimit_t *src)
+{
+  if (dst == NULL || src == NULL || src->sent == 0)
+    return;
+
+  if (dst->sent == 0
+      || timespec_to_ns (&src->first) < timespec_to_ns (&dst->first))
+    dst->first = src->first;
+  if (dst->sent == 0
+      || timespec_to_ns (&src->last) > timespec_to_ns (&dst->last))
+    dst->last = src->last;
+  dst->sent += src->sent;
+  dst->stalls += src->stalls;
+}
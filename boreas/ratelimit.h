@@ -0,0 +1,56 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_RATELIMIT_H
+#define BOREAS_RATELIMIT_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Token bucket used to limit the rate of outgoing alive test packets.
+ *
+ * The bucket holds at most burst tokens and is refilled with pps tokens per
+ * second. Sending a packet takes one token. Tokens are kept as nanoseconds of
+ * accumulated send credit, so no floating point is needed on the fast path.
+ *
+ * A ratelimit_t is not thread safe. Every sending thread owns its own bucket.
+ */
+struct ratelimit
+{
+  /* Nanoseconds needed to earn one token. 0 for no rate limit. */
+  uint64_t interval_ns;
+  /* Upper bound of credit_ns, i.e. burst * interval_ns. */
+  uint64_t capacity_ns;
+  /* Currently available send credit. */
+  uint64_t credit_ns;
+  /* Monotonic time of the last refill. */
+  struct timespec last;
+  /* Monotonic time of the first acquired token. */
+  struct timespec first;
+  /* Number of tokens handed out since the first acquire. */
+  uint64_t sent;
+  /* Number of times the caller had to be put to sleep. */
+  uint64_t stalls;
+};
+
+typedef struct ratelimit ratelimit_t;
+
+ratelimit_t *
+ratelimit_new (unsigned int, unsigned int);
+
+void
+ratelimit_free (ratelimit_t *);
+
+void
+ratelimit_acquire (ratelimit_t *, unsigned int);
+
+double
+ratelimit_achieved_rate (const ratelimit_t *);
+
+void
+ratelimit_merge (ratelimit_t *, const ratelimit_t *);
+
+#endif /* not BOREAS_RATELIMIT_H */
@@ -0,0 +1,153 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "ratelimit.c"
+
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+Describe (ratelimit);
+BeforeEach (ratelimit)
+{
+}
+AfterEach (ratelimit)
+{
+}
+
+static uint64_t
+elapsed_ns (const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return timespec_to_ns (&now) - timespec_to_ns (start);
+}
+
+Ensure (ratelimit, no_limit_never_sleeps)
+{
+  ratelimit_t *ratelimit;
+  struct timespec start;
+
+  ratelimit = ratelimit_new (0, 0);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < 100000; i++)
+    ratelimit_acquire (ratelimit, 1);
+
+  assert_that (elapsed_ns (&start) < NSEC_PER_SEC / 10);
+  assert_that (ratelimit->sent, is_equal_to (100000));
+  assert_that (ratelimit->stalls, is_equal_to (0));
+  ratelimit_free (ratelimit);
+}
+
+Ensure (ratelimit, burst_is_sent_without_delay)
+{
+  ratelimit_t *ratelimit;
+  struct timespec start;
+
+  /* One token per second, so anything beyond the burst would take seconds. */
+  ratelimit = ratelimit_new (1, 50);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < 50; i++)
+    ratelimit_acquire (ratelimit, 1);
+
+  assert_that (elapsed_ns (&start) < NSEC_PER_SEC / 10);
+  assert_that (ratelimit->stalls, is_equal_to (0));
+  ratelimit_free (ratelimit);
+}
+
+Ensure (ratelimit, limits_rate)
+{
+  ratelimit_t *ratelimit;
+  struct timespec start;
+  double rate;
+
+  /* 1 packet burst and 1000 pps: 201 packets need at least 200 ms. */
+  ratelimit = ratelimit_new (1000, 1);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < 201; i++)
+    ratelimit_acquire (ratelimit, 1);
+
+  assert_that (elapsed_ns (&start) >= 200 * 1000000ULL);
+  assert_that (ratelimit->stalls, is_greater_than (0));
+
+  rate = ratelimit_achieved_rate (ratelimit);
+  assert_that_double (rate, is_less_than_double (1010));
+  assert_that_double (rate, is_greater_than_double (500));
+  ratelimit_free (ratelimit);
+}
+
+Ensure (ratelimit, acquire_charges_multiple_tokens)
+{
+  ratelimit_t *ratelimit;
+  struct timespec start;
+
+  /* 10 tokens at 100 pps take 100 ms once the bucket is empty. The refill
+   * started with the first acquire, so allow for the time in between. */
+  ratelimit = ratelimit_new (100, 10);
+  ratelimit_acquire (ratelimit, 10);
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  ratelimit_acquire (ratelimit, 10);
+
+  assert_that (elapsed_ns (&start) >= 99 * 1000000ULL);
+  assert_that (ratelimit->sent, is_equal_to (20));
+  ratelimit_free (ratelimit);
+}
+
+Ensure (ratelimit, achieved_rate_needs_packets)
+{
+  ratelimit_t *ratelimit;
+
+  ratelimit = ratelimit_new (1000, 1);
+  assert_that_double (ratelimit_achieved_rate (ratelimit),
+                      is_equal_to_double (0));
+  ratelimit_acquire (ratelimit, 1);
+  assert_that_double (ratelimit_achieved_rate (ratelimit),
+                      is_equal_to_double (0));
+  assert_that_double (ratelimit_achieved_rate (NULL), is_equal_to_double (0));
+  ratelimit_free (ratelimit);
+}
+
+Ensure (ratelimit, merge_adds_up_senders)
+{
+  ratelimit_t *total, *sender;
+
+  total = ratelimit_new (0, 0);
+  sender = ratelimit_new (0, 0);
+  ratelimit_merge (total, sender);
+  assert_that (total->sent, is_equal_to (0));
+
+  for (int i = 0; i < 10; i++)
+    ratelimit_acquire (sender, 1);
+  ratelimit_merge (total, sender);
+  ratelimit_merge (total, sender);
+
+  assert_that (total->sent, is_equal_to (20));
+  assert_that (timespec_to_ns (&total->first),
+               is_equal_to (timespec_to_ns (&sender->first)));
+  assert_that (timespec_to_ns (&total->last),
+               is_equal_to (timespec_to_ns (&sender->last)));
+  ratelimit_free (sender);
+  ratelimit_free (total);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, ratelimit, no_limit_never_sleeps);
+  add_test_with_context (suite, ratelimit, burst_is_sent_without_delay);
+  add_test_with_context (suite, ratelimit, limits_rate);
+  add_test_with_context (suite, ratelimit, acquire_charges_multiple_tokens);
+  add_test_with_context (suite, ratelimit, achieved_rate_needs_packets);
+  add_test_with_context (suite, ratelimit, merge_adds_up_senders);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -0,0 +1,370 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Threads sending the alive test probes.
+ *
+ * The target hosts are split into contiguous shards, one per sender thread.
+ * Every sender works on a shallow copy of the scanner struct with its own raw
+ * sockets, its own UDP sockets and cache for source address lookups and its
+ * own token bucket holding an equal share of the global rate limit. The port
+ * list is shared read only. The alive host set is shared as well, while the
+ * sniffer thread adds to it. hosts_set_t supports such concurrent use.
+ *
+ * With a single sender no thread is started and the probes are sent from the
+ * calling thread with the main scanner, like before.
+ */
+
+#include "sender.h"
+
+#include "boreas_io.h"
+#include "util.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+/* How long (in microseconds) to wait between two progress reports. */
+#define PROGRESS_INTERVAL 10000
+
+/**
+ * @brief A single sender thread.
+ */
+struct sender
+{
+  pthread_t thread;
+  /* Shallow copy of the main scanner with own sockets and rate limit. */
+  scanner_t scanner;
+  /* Back pointer to the pool. */
+  senders_t *senders;
+  /* Shard of the targets array [start, end) handled by this sender. */
+  guint start;
+  guint end;
+};
+
+/**
+ * @brief Pool of sender threads.
+ */
+struct senders
+{
+  /* Main scanner owning the shared data. */
+  scanner_t *scanner;
+  /* Methods the sockets of the senders were opened for. */
+  alive_test_t alive_test;
+  /* Sender threads. NULL if the probes are sent from the calling thread. */
+  struct sender *threads;
+  unsigned int count;
+  /* Hosts and send function of the current run. */
+  GPtrArray *hosts;
+  GFunc send_func;
+  /* Target hosts handled in the current run. Accessed atomically. */
+  gint hosts_sent;
+  /* Number of senders still working on their shard. Accessed atomically. */
+  gint running;
+};
+
+/**
+ * @brief Split hosts into contiguous shards, one per sender.
+ *
+ * @param senders  Pool of senders.
+ * @param len      Number of hosts.
+ */
+static void
+senders_shard (senders_t *senders, guint len)
+{
+  for (unsigned int i = 0; i < senders->count; i++)
+    {
+      senders->threads[i].start = (guint64) len * i / senders->count;
+      senders->threads[i].end = (guint64) len * (i + 1) / senders->count;
+    }
+}
+
+/**
+ * @brief Get the locations of the sockets of a scanner.
+ *
+ * @param scanner  Scanner.
+ * @param[out] socs  The locations.
+ */
+static void
+scanner_sockets (scanner_t *scanner, int *socs[8])
+{
+  socs[0] = &scanner->tcpv4soc;
+  socs[1] = &scanner->tcpv6soc;
+  socs[2] = &scanner->icmpv4soc;
+  socs[3] = &scanner->icmpv6soc;
+  socs[4] = &scanner->arpv4soc;
+  socs[5] = &scanner->arpv6soc;
+  socs[6] = &scanner->udpv4soc;
+  socs[7] = &scanner->udpv6soc;
+}
+
+/**
+ * @brief Create a pool of senders.
+ *
+ * ARP is not handled by the sender threads, as the libnet state used for it
+ * is global. Use the main scanner for ARP pings.
+ *
+ * @param[in]  scanner     Main scanner. Must outlive the pool.
+ * @param[in]  alive_test  Methods of alive detection which will be used.
+ * @param[in]  count       Number of sender threads. 0 or 1 for none. Fewer
+ *                         are used if the maximum packets per second are
+ *                         lower.
+ * @param[out] error       Set to 0 on success, boreas_error_t on error.
+ *
+ * @return Pool of senders, NULL on error.
+ */
+senders_t *
+senders_new (scanner_t *scanner, alive_test_t alive_test, unsigned int count,
+             boreas_error_t *error)
+{
+  senders_t *senders;
+  unsigned int pps, burst;
+
+  *error = NO_ERROR;
+  senders = g_malloc0 (sizeof (senders_t));
+  senders->scanner = scanner;
+  senders->alive_test = alive_test
+                        & (ALIVE_TEST_ICMP | ALIVE_TEST_TCP_ACK_SERVICE
+                           | ALIVE_TEST_TCP_SYN_SERVICE);
+  if (count > MAX_SENDER_THREADS)
+    count = MAX_SENDER_THREADS;
+  /* Every sender gets an equal share of the global rate limit. A sender
+   * sends at least one packet per second, so use fewer senders if the limit
+   * is too low to be shared by all of them. */
+  pps = get_alive_test_max_pps ();
+  if (pps > 0 && count > pps)
+    count = pps;
+  if (count <= 1)
+    return senders;
+  if (pps > 0)
+    pps /= count;
+  burst = MAX (get_alive_test_burst () / count, 1);
+
+  senders->threads = g_malloc0_n (count, sizeof (struct sender));
+  for (unsigned int i = 0; i < count; i++)
+    {
+      struct sender *sender = &senders->threads[i];
+      int *socs[8];
+
+      sender->scanner = *scanner;
+      /* Not the sockets of the main scanner, so that only the ones opened
+       * for this sender are closed if opening another one fails. */
+      scanner_sockets (&sender->scanner, socs);
+      for (guint j = 0; j < G_N_ELEMENTS (socs); j++)
+        *socs[j] = -1;
+      sender->scanner.ratelimit = NULL;
+      sender->scanner.srccache = NULL;
+      sender->scanner.stats = NULL;
+      /* ARP pings are sent by the main scanner only. */
+      sender->scanner.arpsweep = NULL;
+      sender->scanner.ndsweep = NULL;
+      sender->scanner.icmpv6sweep = NULL;
+      sender->senders = senders;
+
+      *error = set_all_needed_sockets (&sender->scanner, senders->alive_test);
+      if (*error)
+        {
+          g_warning ("%s: Could not open sockets for sender %u. %s", __func__,
+                     i, str_boreas_error (*error));
+          for (guint j = 0; j < G_N_ELEMENTS (socs); j++)
+            if (*socs[j] >= 0)
+              close (*socs[j]);
+          senders->count = i;
+          senders_free (senders);
+          return NULL;
+        }
+      sender->scanner.ratelimit = ratelimit_new (pps, burst);
+      if (scanner->stats)
+        sender->scanner.stats = alive_stats_new ();
+      if (senders->alive_test
+          & (ALIVE_TEST_TCP_ACK_SERVICE | ALIVE_TEST_TCP_SYN_SERVICE))
+        sender->scanner.srccache = srccache_new ();
+      if (scanner->icmpv6sweep)
+        sender->scanner.icmpv6sweep =
+          ndsweep_new (sender->scanner.icmpv6soc, ICMP6_ECHO_REQUEST,
+                       sender->scanner.stats, NULL);
+      senders->count++;
+    }
+  senders_shard (senders, scanner->hosts_data->targets->len);
+  g_debug ("%s: Started %u senders with %u pps each.", __func__,
+           senders->count, pps);
+
+  return senders;
+}
+
+/**
+ * @brief Send probes to all hosts of the shard of a sender.
+ *
+ * @param sender_p  Pointer to struct sender.
+ *
+ * @return NULL.
+ */
+static void *
+sender_thread (void *sender_p)
+{
+  struct sender *sender = sender_p;
+  senders_t *senders = sender->senders;
+  GPtrArray *hosts = senders->hosts;
+
+  for (guint i = sender->start; i < sender->end; i++)
+    {
+      gvm_host_t *host = g_ptr_array_index (hosts, i);
+
+      adaptive_probe_sent (sender->scanner.adaptive, host);
+      senders->send_func (host, &sender->scanner);
+      g_atomic_int_inc (&senders->hosts_sent);
+    }
+
+  if (senders->alive_test & ALIVE_TEST_ICMP)
+    {
+      ndsweep_flush (sender->scanner.icmpv6sweep);
+      wait_until_so_sndbuf_empty (sender->scanner.icmpv4soc, 10);
+      wait_until_so_sndbuf_empty (sender->scanner.icmpv6soc, 10);
+    }
+  if (senders->alive_test
+      & (ALIVE_TEST_TCP_ACK_SERVICE | ALIVE_TEST_TCP_SYN_SERVICE))
+    {
+      wait_until_so_sndbuf_empty (sender->scanner.tcpv4soc, 10);
+      wait_until_so_sndbuf_empty (sender->scanner.tcpv6soc, 10);
+    }
+
+  (void) g_atomic_int_dec_and_test (&senders->running);
+  return NULL;
+}
+
+/**
+ * @brief Send probes to the given hosts and wait until all are sent.
+ *
+ * @param senders    Pool of senders.
+ * @param hosts      Hosts (gvm_host_t) to send the probes to.
+ * @param send_func  Function sending the probes to one host, called with the
+ *                   gvm_host_t and the scanner of the sender.
+ * @param progress   Function called periodically with the number of hosts
+ *                   handled so far and once more after all hosts were handled.
+ *                   May be NULL.
+ * @param user_data  User data for progress.
+ */
+void
+senders_run_hosts (senders_t *senders, GPtrArray *hosts, GFunc send_func,
+                   senders_progress_func_t progress, gpointer user_data)
+{
+  unsigned int started = 0;
+
+  senders->hosts = hosts;
+  senders->send_func = send_func;
+  g_atomic_int_set (&senders->hosts_sent, 0);
+
+  if (senders->count == 0)
+    {
+      for (guint i = 0; i < hosts->len; i++)
+        {
+          gvm_host_t *host = g_ptr_array_index (hosts, i);
+
+          adaptive_probe_sent (senders->scanner->adaptive, host);
+          send_func (host, senders->scanner);
+          g_atomic_int_inc (&senders->hosts_sent);
+          if (progress)
+            progress (i + 1, user_data);
+        }
+      ndsweep_flush (senders->scanner->icmpv6sweep);
+      return;
+    }
+
+  senders_shard (senders, hosts->len);
+  g_atomic_int_set (&senders->running, senders->count);
+  for (unsigned int i = 0; i < senders->count; i++)
+    {
+      struct sender *sender = &senders->threads[i];
+      int err;
+
+      sender->scanner.tcp_flag = senders->scanner->tcp_flag;
+      err = pthread_create (&sender->thread, NULL, sender_thread, sender);
+      if (err)
+        {
+          /* Send the shard from this thread instead of losing it. */
+          g_warning ("%s: pthread_create() failed: %s. Sending from the "
+                     "calling thread.",
+                     __func__, strerror (err));
+          sender->thread = 0;
+          sender_thread (sender);
+          continue;
+        }
+      started++;
+    }
+
+  while (g_atomic_int_get (&senders->running) > 0)
+    {
+      if (progress)
+        progress (g_atomic_int_get (&senders->hosts_sent), user_data);
+      usleep (PROGRESS_INTERVAL);
+    }
+
+  for (unsigned int i = 0; i < senders->count && started > 0; i++)
+    if (senders->threads[i].thread)
+      {
+        pthread_join (senders->threads[i].thread, NULL);
+        senders->threads[i].thread = 0;
+        started--;
+      }
+
+  if (progress)
+    progress (g_atomic_int_get (&senders->hosts_sent), user_data);
+}
+
+/**
+ * @brief Send probes to all target hosts and wait until all are sent.
+ *
+ * @param senders    Pool of senders.
+ * @param send_func  Function sending the probes to one host, called with the
+ *                   gvm_host_t and the scanner of the sender.
+ * @param progress   Function called periodically with the number of hosts
+ *                   handled so far and once more after all hosts were handled.
+ *                   May be NULL.
+ * @param user_data  User data for progress.
+ */
+void
+senders_run (senders_t *senders, GFunc send_func,
+             senders_progress_func_t progress, gpointer user_data)
+{
+  senders_run_hosts (senders, senders->scanner->hosts_data->targets,
+                     send_func, progress, user_data);
+}
+
+/**
+ * @brief Free a pool of senders.
+ *
+ * The sockets of the senders are closed and their statistics and the ones of
+ * their token buckets are merged into the ones of the main scanner.
+ *
+ * @param senders  Pool of senders.
+ */
+void
+senders_free (senders_t *senders)
+{
+  if (senders == NULL)
+    return;
+
+  for (unsigned int i = 0; i < senders->count; i++)
+    {
+      struct sender *sender = &senders->threads[i];
+
+      ndsweep_free (sender->scanner.icmpv6sweep);
+      close_all_needed_sockets (&sender->scanner, senders->alive_test);
+      ratelimit_merge (senders->scanner->ratelimit, sender->scanner.ratelimit);
+      ratelimit_free (sender->scanner.ratelimit);
+      srccache_free (sender->scanner.srccache);
+      alive_stats_merge (senders->scanner->stats, sender->scanner.stats);
+      alive_stats_free (sender->scanner.stats);
+    }
+  g_free (senders->threads);
+  g_free (senders);
+}
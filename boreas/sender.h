@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_SENDER_H
+#define BOREAS_SENDER_H
+
+#include "alivedetection.h"
+#include "boreas_error.h"
+
+#include <glib.h>
+
+/* Upper limit for the number of sender threads. */
+#define MAX_SENDER_THREADS 64
+
+typedef struct senders senders_t;
+
+/**
+ * @brief Called periodically while the senders are running.
+ *
+ * @param hosts_sent  Number of target hosts handled so far by all senders.
+ * @param user_data   User data given to senders_run().
+ */
+typedef void (*senders_progress_func_t) (guint hosts_sent, gpointer user_data);
+
+senders_t *
+senders_new (scanner_t *, alive_test_t, unsigned int, boreas_error_t *);
+
+void
+senders_run (senders_t *, GFunc, senders_progress_func_t, gpointer);
+
+void
+senders_run_hosts (senders_t *, GPtrArray *, GFunc, senders_progress_func_t,
+                   gpointer);
+
+void
+senders_free (senders_t *);
+
+#endif /* not BOREAS_SENDER_H */
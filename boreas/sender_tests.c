@@ -0,0 +1,150 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "sender.c"
+
+#include "../base/prefs.h"
+
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+#define TARGETS 1000
+
+static scanner_t test_scanner;
+static gint visits[TARGETS];
+static guint last_progress;
+
+static void
+count_visit (gpointer host, gpointer scanner_p)
+{
+  (void) scanner_p;
+  g_atomic_int_inc (&visits[GPOINTER_TO_UINT (host) - 1]);
+}
+
+static void
+record_progress (guint hosts_sent, gpointer user_data)
+{
+  (void) user_data;
+  last_progress = hosts_sent;
+}
+
+Describe (sender);
+BeforeEach (sender)
+{
+  memset (&test_scanner, 0, sizeof (test_scanner));
+  memset (visits, 0, sizeof (visits));
+  last_progress = 0;
+  test_scanner.hosts_data = g_malloc0 (sizeof (hosts_data_t));
+  test_scanner.hosts_data->targets = g_ptr_array_new ();
+  for (guint i = 1; i <= TARGETS; i++)
+    g_ptr_array_add (test_scanner.hosts_data->targets, GUINT_TO_POINTER (i));
+  test_scanner.ratelimit = ratelimit_new (0, 0);
+}
+AfterEach (sender)
+{
+  g_ptr_array_free (test_scanner.hosts_data->targets, TRUE);
+  g_free (test_scanner.hosts_data);
+  ratelimit_free (test_scanner.ratelimit);
+}
+
+Ensure (sender, single_sender_visits_all_targets)
+{
+  senders_t *senders;
+  boreas_error_t error;
+
+  /* ARP only, so no sockets are opened. */
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP, 1, &error);
+  assert_that (senders, is_not_null);
+  assert_that (error, is_equal_to (NO_ERROR));
+  assert_that (senders->count, is_equal_to (0));
+
+  senders_run (senders, count_visit, record_progress, NULL);
+  for (int i = 0; i < TARGETS; i++)
+    assert_that (visits[i], is_equal_to (1));
+  assert_that (last_progress, is_equal_to (TARGETS));
+
+  senders_free (senders);
+}
+
+Ensure (sender, sharded_senders_visit_all_targets_once)
+{
+  senders_t *senders;
+  boreas_error_t error;
+
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP, 7, &error);
+  assert_that (senders, is_not_null);
+  assert_that (senders->count, is_equal_to (7));
+  assert_that (senders->threads[0].start, is_equal_to (0));
+  assert_that (senders->threads[6].end, is_equal_to (TARGETS));
+
+  senders_run (senders, count_visit, record_progress, NULL);
+  for (int i = 0; i < TARGETS; i++)
+    assert_that (visits[i], is_equal_to (1));
+  assert_that (last_progress, is_equal_to (TARGETS));
+
+  /* A second run, e.g. TCP ACK after TCP SYN, works the same way. */
+  senders_run (senders, count_visit, NULL, NULL);
+  for (int i = 0; i < TARGETS; i++)
+    assert_that (visits[i], is_equal_to (2));
+
+  senders_free (senders);
+}
+
+Ensure (sender, number_of_senders_is_capped)
+{
+  senders_t *senders;
+  boreas_error_t error;
+
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP,
+                         MAX_SENDER_THREADS + 10, &error);
+  assert_that (senders->count, is_equal_to (MAX_SENDER_THREADS));
+  senders_free (senders);
+}
+
+Ensure (sender, senders_do_not_exceed_the_global_rate)
+{
+  senders_t *senders;
+  boreas_error_t error;
+  guint64 interval_ns;
+
+  /* 3 pps cannot be shared by 7 senders sending at least 1 pps each. */
+  prefs_set ("alive_test_max_pps", "3");
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP, 7, &error);
+  assert_that (senders->count, is_equal_to (3));
+  interval_ns = senders->threads[0].scanner.ratelimit->interval_ns;
+  assert_that (interval_ns, is_equal_to (1000000000));
+  senders_free (senders);
+
+  /* With a single sender left the main scanner sends alone. */
+  prefs_set ("alive_test_max_pps", "1");
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP, 7, &error);
+  assert_that (senders->count, is_equal_to (0));
+  senders_free (senders);
+
+  prefs_set ("alive_test_max_pps", "0");
+  senders = senders_new (&test_scanner, ALIVE_TEST_ARP, 7, &error);
+  assert_that (senders->count, is_equal_to (7));
+  senders_free (senders);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, sender, single_sender_visits_all_targets);
+  add_test_with_context (suite, sender,
+                         sharded_senders_visit_all_targets_once);
+  add_test_with_context (suite, sender, number_of_senders_is_capped);
+  add_test_with_context (suite, sender,
+                         senders_do_not_exceed_the_global_rate);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
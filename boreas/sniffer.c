@@ -12,7 +12,10 @@
 #include <errno.h>
 #include <glib.h>
 #include <net/if_arp.h>
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
 #include <netinet/ip.h>
+#include <netinet/tcp.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -27,9 +30,17 @@
 #define STR(X) #X
 #define ASSTR(X) STR (X)
 #define FILTER_STR                                                           \
-  "(ip6 or ip or arp) and (ip6[40]=129 or icmp[icmptype] == icmp-echoreply " \
+  "(ip6 or ip or arp) and (ip6[40]=129 or ip6[40]=136 "                      \
+  "or icmp[icmptype] == icmp-echoreply "                                     \
   "or dst port " ASSTR (FILTER_PORT) " or arp[6:2]=2)"
 
+/* Replies are classified from their headers only. 16 bytes Linux cooked
+ * header plus the largest header we look at (IPv6) fits easily. */
+#define SNIFFER_SNAPLEN 128
+/* Timeout (ms) after which the kernel hands over a partially filled ring block.
+ * Keeps the latency of batched delivery low when only few replies arrive. */
+#define SNIFFER_BLOCK_TIMEOUT 10
+
 /* Conditional variable and mutex to make sure sniffer thread already started
  * before sending out pings. */
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -47,7 +58,7 @@ static pcap_t *
 open_live (char *iface, char *filter)
 {
   /* iface considerations:
-   * pcap_open_live(iface, ...) sniffs on all interfaces(linux) if iface
+   * pcap_create(iface, ...) sniffs on all interfaces(linux) if iface
    * argument is NULL pcap_lookupnet(iface, ...) is used to set ipv4 network
    * number and mask associated with iface pcap_compile(..., mask) netmask
    * specifies the IPv4 netmask of the network on which packets are being
@@ -61,21 +72,45 @@ open_live (char *iface, char *filter)
   char errbuf[PCAP_ERRBUF_SIZE];
   pcap_t *pcap_handle;
   struct bpf_program filter_prog;
+  int ret;
 
-  /* iface, snapshot length of handle, promiscuous mode, packet buffer timeout
-   * (ms), errbuff */
   errbuf[0] = '\0';
-  pcap_handle = pcap_open_live (iface, 1500, 0, 100, errbuf);
+  pcap_handle = pcap_create (iface, errbuf);
   if (pcap_handle == NULL)
     {
       g_warning ("%s: %s", __func__, errbuf);
       return NULL;
     }
-  if (g_utf8_strlen (errbuf, -1) != 0)
+
+  /* Immediate mode is left off on purpose. On Linux pcap then captures into a
+   * TPACKET_V3 memory mapped ring and hands over whole blocks of packets, which
+   * sniffer_thread() processes in one go. The block timeout bounds the delay
+   * for blocks which do not fill up. The buffer size is the size of the ring
+   * and therefore the amount of replies we can queue before dropping. */
+  if (pcap_set_snaplen (pcap_handle, SNIFFER_SNAPLEN) != 0
+      || pcap_set_promisc (pcap_handle, 0) != 0
+      || pcap_set_timeout (pcap_handle, SNIFFER_BLOCK_TIMEOUT) != 0
+      || pcap_set_buffer_size (pcap_handle,
+                               get_alive_test_pcap_buffer_size ())
+           != 0)
     {
-      g_warning ("%s: %s", __func__, errbuf);
+      g_warning ("%s: Unable to set pcap options.", __func__);
+      pcap_close (pcap_handle);
+      return NULL;
     }
 
+  ret = pcap_activate (pcap_handle);
+  if (ret < 0)
+    {
+      g_warning ("%s: %s: %s", __func__, pcap_statustostr (ret),
+                 pcap_geterr (pcap_handle));
+      pcap_close (pcap_handle);
+      return NULL;
+    }
+  else if (ret > 0)
+    g_warning ("%s: %s: %s", __func__, pcap_statustostr (ret),
+               pcap_geterr (pcap_handle));
+
   /* handle, struct bpf_program *fp, int optimize, bpf_u_int32 netmask */
   if (pcap_compile (pcap_handle, &filter_prog, filter, 1, PCAP_NETMASK_UNKNOWN)
       < 0)
@@ -98,12 +133,98 @@ open_live (char *iface, char *filter)
   return pcap_handle;
 }
 
+/**
+ * @brief Publish a target host which was detected as alive.
+ *
+ * The address is only converted into a string here, i.e. once per alive host
+ * and not for every captured packet.
+ *
+ * @param scanner Pointer to scanner struct.
+ * @param header  Header of the reply.
+ * @param af      Address family of addr.
+ * @param addr    Pointer to struct in_addr or struct in6_addr.
+ */
+static void
+publish_alive_host (scanner_t *scanner, const struct pcap_pkthdr *header,
+                    int af, const void *addr)
+{
+  char addr_str[INET6_ADDRSTRLEN];
+
+  if (scanner->adaptive)
+    {
+      struct in6_addr addr6;
+
+      if (af == AF_INET)
+        {
+          memset (&addr6, 0, sizeof (addr6));
+          addr6.s6_addr[10] = 0xff;
+          addr6.s6_addr[11] = 0xff;
+          memcpy (&addr6.s6_addr[12], addr, sizeof (struct in_addr));
+        }
+      else
+        memcpy (&addr6, addr, sizeof (addr6));
+      adaptive_reply (scanner->adaptive, &addr6, &header->ts);
+    }
+
+  if (inet_ntop (af, addr, addr_str, sizeof (addr_str)) == NULL)
+    {
+      g_debug ("%s: Failed to transform IP into string representation: %s",
+               __func__, strerror (errno));
+      return;
+    }
+  /* handle max_scan_hosts related restrictions. */
+  handle_scan_restrictions (scanner, addr_str);
+}
+
+/**
+ * @brief Get the alive test method a reply belongs to.
+ *
+ * SYN-ACKs and RSTs with ACK flag answer TCP SYN pings. RSTs without ACK flag
+ * answer TCP ACK pings (RFC 793, reset generation).
+ *
+ * @param packet   Captured packet with Linux cooked header.
+ * @param caplen   Captured length of the packet.
+ * @param version  IP version of the packet, anything else for ARP.
+ *
+ * @return Method of the reply, ALIVE_METHOD_MAX if unknown.
+ */
+static alive_method_t
+reply_method (const u_char *packet, bpf_u_int32 caplen, unsigned int version)
+{
+  const u_char *ip = packet + 16;
+  unsigned int hdr_len, proto;
+
+  if (version == 6)
+    {
+      hdr_len = 40;
+      proto = ip[6];
+      if (proto == IPPROTO_ICMPV6 && caplen > 16 + hdr_len)
+        return ip[hdr_len] == ND_NEIGHBOR_ADVERT ? ALIVE_METHOD_ARP
+                                                 : ALIVE_METHOD_ICMP;
+    }
+  else if (version == 4)
+    {
+      hdr_len = (ip[0] & 0x0f) * 4;
+      proto = ip[9];
+      if (proto == IPPROTO_ICMP)
+        return ALIVE_METHOD_ICMP;
+    }
+  else
+    return ALIVE_METHOD_ARP;
+
+  if (proto != IPPROTO_TCP || caplen <= 16 + hdr_len + 13)
+    return ALIVE_METHOD_MAX;
+  return ip[hdr_len + 13] & TH_ACK ? ALIVE_METHOD_TCP_SYN
+                                   : ALIVE_METHOD_TCP_ACK;
+}
+
 /**
  * @brief Processes single packets captured by pcap. Is a callback function.
  *
  * For every packet we check if it is ipv4 ipv6 or arp and extract the sender ip
- * address. This ip address is then inserted into the alive_hosts table if not
- * already present and if in the target table.
+ * address. This ip address is then inserted into the alive hosts set if not
+ * already present and if in the target set. No memory is allocated for
+ * packets from hosts which are no targets or are already known to be alive.
  *
  * @param user_data Pointer to scanner.
  * @param header
@@ -112,78 +233,74 @@ open_live (char *iface, char *filter)
  * TODO: simplify and read https://tools.ietf.org/html/rfc826
  */
 static void
-got_packet (u_char *user_data,
-            __attribute__ ((unused)) const struct pcap_pkthdr *header,
+got_packet (u_char *user_data, const struct pcap_pkthdr *header,
             const u_char *packet)
 {
   struct ip *ip;
   unsigned int version;
   scanner_t *scanner;
   hosts_data_t *hosts_data;
-  gchar *addr_str = NULL;
+  gboolean new_host;
 
   ip = (struct ip *) (packet + 16);
   version = ip->ip_v;
   scanner = (scanner_t *) user_data;
   hosts_data = (hosts_data_t *) scanner->hosts_data;
 
-  if (version == 4)
-    {
-      addr_str = g_malloc0 (INET_ADDRSTRLEN);
-      struct in_addr sniffed_addr;
-      /* was +26 (14 ETH + 12 IP) originally but was off by 2 somehow */
-      memcpy (&sniffed_addr.s_addr, packet + 26 + 2, 4);
-      if (inet_ntop (AF_INET, (const char *) &sniffed_addr, addr_str,
-                     INET_ADDRSTRLEN)
-          == NULL)
-        g_debug (
-          "%s: Failed to transform IPv4 address into string representation: %s",
-          __func__, strerror (errno));
-    }
-  else if (version == 6)
+  if (version == 6)
     {
-      addr_str = g_malloc0 (INET6_ADDRSTRLEN);
       struct in6_addr sniffed_addr;
       /* (14 ETH + 8 IP + offset 2)  */
       memcpy (&sniffed_addr.s6_addr, packet + 24, 16);
-      if (inet_ntop (AF_INET6, (const char *) &sniffed_addr, addr_str,
-                     INET6_ADDRSTRLEN)
-          == NULL)
-        g_debug ("%s: Failed to transform IPv6 into string representation: %s",
-                 __func__, strerror (errno));
+      /* Only put unique hosts on queue and in the alive set. Use short circuit
+       * evaluation to not add hosts to the set which are not in our target
+       * list.*/
+      if (!hosts_set_contains_addr6 (hosts_data->targethosts, &sniffed_addr))
+        return;
+      new_host = hosts_set_add_addr6 (hosts_data->alivehosts, &sniffed_addr);
+      alive_stats_reply (scanner->stats,
+                         reply_method (packet, header->caplen, version),
+                         &header->ts, new_host);
+      if (new_host)
+        publish_alive_host (scanner, header, AF_INET6, &sniffed_addr);
+      return;
+    }
+
+  struct in_addr sniffed_addr;
+  if (version == 4)
+    {
+      /* was +26 (14 ETH + 12 IP) originally but was off by 2 somehow */
+      memcpy (&sniffed_addr.s_addr, packet + 26 + 2, 4);
     }
   /* TODO: check collision situations.
    * everything not ipv4/6 is regarded as arp.
    * It may be possible to get other types then arp replies in which case the
-   * ip from inet_ntop should be bogus. */
+   * ip should be bogus. */
   else
     {
       /* TODO: at the moment offset of 6 is set but arp header has variable
        * sized field. */
       /* read rfc https://tools.ietf.org/html/rfc826 for exact length or how
       to get it */
-      struct arphdr *arp =
-        (struct arphdr *) (packet + 14 + 2 + 6 + sizeof (struct arphdr));
-      addr_str = g_malloc0 (INET_ADDRSTRLEN);
-      if (inet_ntop (AF_INET, (const char *) arp, addr_str, INET_ADDRSTRLEN)
-          == NULL)
-        g_debug ("%s: Failed to transform IP into string representation: %s",
-                 __func__, strerror (errno));
-    }
-  /* Only put unique hosts on queue and in hash table. Use short circuit
-   * evaluation to not add hosts to the hash table which are not in our
-   * target list.*/
-  if ((g_hash_table_contains (hosts_data->targethosts, addr_str) == TRUE)
-      && (g_hash_table_add (hosts_data->alivehosts, g_strdup (addr_str))))
-    {
-      /* handle max_scan_hosts related restrictions. */
-      handle_scan_restrictions (scanner, addr_str);
+      memcpy (&sniffed_addr.s_addr,
+              packet + 14 + 2 + 6 + sizeof (struct arphdr), 4);
     }
-  g_free (addr_str);
+  if (!hosts_set_contains_addr4 (hosts_data->targethosts, &sniffed_addr))
+    return;
+  new_host = hosts_set_add_addr4 (hosts_data->alivehosts, &sniffed_addr);
+  alive_stats_reply (scanner->stats,
+                     reply_method (packet, header->caplen, version),
+                     &header->ts, new_host);
+  if (new_host)
+    publish_alive_host (scanner, header, AF_INET, &sniffed_addr);
 }
 
 /**
- * @brief Sniff packets by starting pcap_loop with callback function.
+ * @brief Sniff packets by dispatching captured blocks to got_packet.
+ *
+ * Every call to pcap_dispatch() processes all packets of the ring blocks
+ * which are ready, so replies are handled in batches instead of one wakeup
+ * per packet.
  *
  * @param scanner_p Pointer to scanner struct.
  */
@@ -197,14 +314,18 @@ sniffer_thread (void *scanner_p)
   pthread_cond_signal (&cond);
   pthread_mutex_unlock (&mutex);
 
+  /* Replies to the first probes wait in the capture buffer meanwhile. */
+  wait_for_target_set (scanner->hosts_data);
+
   /* reads packets until error or pcap_breakloop() */
-  if ((ret =
-         pcap_loop (scanner->pcap_handle, -1, got_packet, (u_char *) scanner))
-      == PCAP_ERROR)
-    g_debug ("%s: pcap_loop error %s", __func__,
+  do
+    ret = pcap_dispatch (scanner->pcap_handle, -1, got_packet,
+                         (u_char *) scanner);
+  while (ret >= 0);
+
+  if (ret == PCAP_ERROR)
+    g_debug ("%s: pcap_dispatch error %s", __func__,
              pcap_geterr (scanner->pcap_handle));
-  else if (ret == 0)
-    g_debug ("%s: count of packets is exhausted", __func__);
   else if (ret == PCAP_ERROR_BREAK)
     g_debug ("%s: Loop was successfully broken after call to pcap_breakloop",
              __func__);
@@ -212,6 +333,38 @@ sniffer_thread (void *scanner_p)
   pthread_exit (0);
 }
 
+/**
+ * @brief Get the capture statistics of the sniffer.
+ *
+ * The counters are stored in the scanner struct so they are still available
+ * after the pcap handle was closed.
+ *
+ * @param scanner Pointer to scanner struct.
+ */
+static void
+update_sniffer_stats (scanner_t *scanner)
+{
+  struct pcap_stat stats;
+
+  if (pcap_stats (scanner->pcap_handle, &stats) != 0)
+    {
+      g_debug ("%s: pcap_stats error %s", __func__,
+               pcap_geterr (scanner->pcap_handle));
+      return;
+    }
+  scanner->pcap_stats = stats;
+
+  if (stats.ps_drop > 0 || stats.ps_ifdrop > 0)
+    g_warning ("%s: Sniffer dropped %u of %u captured packets (%u dropped by "
+               "the interface). Some alive hosts may have been reported as "
+               "dead. Consider increasing alive_test_pcap_buffer_size or "
+               "lowering alive_test_max_pps.",
+               __func__, stats.ps_drop, stats.ps_recv, stats.ps_ifdrop);
+  else
+    g_debug ("%s: Sniffer received %u packets without drops.", __func__,
+             stats.ps_recv);
+}
+
 /**
  * @brief Stop the sniffer thread.
  *
@@ -264,6 +417,7 @@ stop_sniffer_thread (scanner_t *scanner, pthread_t sniffer_thread_id)
   /* close handle */
   if (scanner->pcap_handle != NULL)
     {
+      update_sniffer_stats (scanner);
       pcap_close (scanner->pcap_handle);
     }
 
@@ -283,6 +437,7 @@ start_sniffer_thread (scanner_t *scanner, pthread_t *sniffer_thread_id)
 {
   int err;
 
+  memset (&scanner->pcap_stats, 0, sizeof (scanner->pcap_stats));
   scanner->pcap_handle = open_live (NULL, FILTER_STR);
   if (scanner->pcap_handle == NULL)
     {
@@ -307,3 +462,66 @@ start_sniffer_thread (scanner_t *scanner, pthread_t *sniffer_thread_id)
 
   return err;
 }
+
+/**
+ * @brief Process the packets of a capture file like captured replies.
+ *
+ * Lets the reply processing be tested and benchmarked without raw sockets or
+ * a network. The filter of the sniffer is applied, so only packets which
+ * would have been captured are processed. The file must use the Linux cooked
+ * header (DLT_LINUX_SLL) like captures on the "any" device do.
+ *
+ * @param scanner Pointer to scanner struct. No pcap handle is needed.
+ * @param file    Path of the capture file.
+ *
+ * @return Number of processed packets, -1 on error.
+ */
+int
+sniffer_replay_file (scanner_t *scanner, const char *file)
+{
+  char errbuf[PCAP_ERRBUF_SIZE];
+  struct bpf_program filter_prog;
+  pcap_t *handle;
+  int ret, count = 0;
+
+  handle = pcap_open_offline (file, errbuf);
+  if (handle == NULL)
+    {
+      g_warning ("%s: pcap_open_offline(%s): %s", __func__, file, errbuf);
+      return -1;
+    }
+  if (pcap_datalink (handle) != DLT_LINUX_SLL)
+    {
+      g_warning ("%s: %s does not use the Linux cooked header.", __func__,
+                 file);
+      pcap_close (handle);
+      return -1;
+    }
+  if (pcap_compile (handle, &filter_prog, FILTER_STR, 1, PCAP_NETMASK_UNKNOWN)
+      < 0)
+    {
+      g_warning ("%s: %s", __func__, pcap_geterr (handle));
+      pcap_close (handle);
+      return -1;
+    }
+  ret = pcap_setfilter (handle, &filter_prog);
+  pcap_freecode (&filter_prog);
+  if (ret < 0)
+    {
+      g_warning ("%s: %s", __func__, pcap_geterr (handle));
+      pcap_close (handle);
+      return -1;
+    }
+
+  while ((ret = pcap_dispatch (handle, -1, got_packet, (u_char *) scanner))
+         > 0)
+    count += ret;
+  if (ret == PCAP_ERROR)
+    {
+      g_warning ("%s: pcap_dispatch error %s", __func__, pcap_geterr (handle));
+      count = -1;
+    }
+  pcap_close (handle);
+
+  return count;
+}
@@ -16,4 +16,7 @@ start_sniffer_thread (scanner_t *, pthread_t *);
 int
 stop_sniffer_thread (scanner_t *, pthread_t);
 
+int
+sniffer_replay_file (scanner_t *, const char *);
+
 #endif /* not BOREAS_SNIFFER_H */
@@ -7,6 +7,136 @@
 
 #include <cgreen/cgreen.h>
 #include <cgreen/mocks.h>
+#include <glib/gstdio.h> /* for g_unlink */
+#include <limits.h>
+#include <net/ethernet.h>
+#include <netinet/ip_icmp.h>
+
+/* Length of the Linux cooked header. */
+#define SLL_HDR_LEN 16
+
+typedef enum
+{
+  REPLY_ICMP,
+  REPLY_TCP_SYN_ACK,
+  REPLY_TCP_RST,
+  REPLY_ARP,
+  REPLY_ICMP6,
+} reply_kind_t;
+
+/**
+ * @brief Build a reply as captured on the "any" device.
+ *
+ * @param[out] buf   Buffer of at least SLL_HDR_LEN + 60 bytes.
+ * @param[in]  kind  Kind of reply.
+ * @param[in]  src   Source address of the reply.
+ *
+ * @return Length of the packet.
+ */
+static int
+build_reply (u_char *buf, reply_kind_t kind, const char *src)
+{
+  u_char *l3 = buf + SLL_HDR_LEN;
+  uint16_t proto;
+  int len;
+
+  memset (buf, 0, SLL_HDR_LEN + 60);
+  if (kind == REPLY_ICMP6)
+    {
+      proto = ETHERTYPE_IPV6;
+      l3[0] = 0x60;
+      l3[5] = 8;
+      l3[6] = IPPROTO_ICMPV6;
+      l3[7] = 64;
+      inet_pton (AF_INET6, src, l3 + 8);
+      inet_pton (AF_INET6, "2001:db8::ffff", l3 + 24);
+      l3[40] = ICMP6_ECHO_REPLY;
+      len = 40 + 8;
+    }
+  else if (kind == REPLY_ARP)
+    {
+      proto = ETHERTYPE_ARP;
+      l3[1] = ARPHRD_ETHER;
+      l3[2] = 0x08;
+      l3[4] = 6;
+      l3[5] = 4;
+      l3[7] = ARPOP_REPLY;
+      inet_pton (AF_INET, src, l3 + 8 + 6);
+      len = 28;
+    }
+  else
+    {
+      proto = ETHERTYPE_IP;
+      l3[0] = 0x45;
+      l3[8] = 64;
+      inet_pton (AF_INET, src, l3 + 12);
+      inet_pton (AF_INET, "192.168.0.254", l3 + 16);
+      if (kind == REPLY_ICMP)
+        {
+          l3[9] = IPPROTO_ICMP;
+          l3[20] = ICMP_ECHOREPLY;
+          len = 20 + 8;
+        }
+      else
+        {
+          struct tcphdr *tcp = (struct tcphdr *) (l3 + 20);
+
+          l3[9] = IPPROTO_TCP;
+          tcp->th_sport = htons (80);
+          tcp->th_dport = htons (FILTER_PORT);
+          tcp->th_off = 5;
+          tcp->th_flags =
+            kind == REPLY_TCP_SYN_ACK ? TH_SYN | TH_ACK : TH_RST;
+          len = 20 + 20;
+        }
+      l3[2] = len >> 8;
+      l3[3] = len & 0xff;
+    }
+  /* Linux cooked header: packet type, ARPHRD type, address length, address
+   * and protocol. */
+  buf[3] = ARPHRD_ETHER;
+  buf[5] = 6;
+  buf[14] = proto >> 8;
+  buf[15] = proto & 0xff;
+
+  return SLL_HDR_LEN + len;
+}
+
+/**
+ * @brief Write replies into a new capture file.
+ *
+ * @param kinds  Kinds of the replies.
+ * @param srcs   Source addresses of the replies.
+ * @param count  Number of replies.
+ *
+ * @return Path of the file. Free with g_free() after removing the file.
+ */
+static gchar *
+write_capture (const reply_kind_t *kinds, const char **srcs, int count)
+{
+  pcap_t *dead;
+  pcap_dumper_t *dumper;
+  gchar *path;
+  int fd;
+
+  fd = g_file_open_tmp ("boreas-replay-XXXXXX.pcap", &path, NULL);
+  close (fd);
+  dead = pcap_open_dead (DLT_LINUX_SLL, 65535);
+  dumper = pcap_dump_open (dead, path);
+  for (int i = 0; i < count; i++)
+    {
+      u_char buf[SLL_HDR_LEN + 60];
+      struct pcap_pkthdr header = {0};
+
+      header.ts.tv_sec = 1000 + i;
+      header.caplen = header.len = build_reply (buf, kinds[i], srcs[i]);
+      pcap_dump ((u_char *) dumper, &header, buf);
+    }
+  pcap_dump_close (dumper);
+  pcap_close (dead);
+
+  return path;
+}
 
 Describe (sniffer);
 BeforeEach (sniffer)
@@ -21,6 +151,118 @@ Ensure (sniffer, dummy_test)
   assert_that (0, is_equal_to (0));
 }
 
+Ensure (sniffer, reply_method_classifies_replies)
+{
+  u_char packet[16 + 40 + 20] = {0};
+  u_char *ip = packet + 16;
+
+  /* IPv4 */
+  ip[0] = 0x45;
+  ip[9] = IPPROTO_ICMP;
+  assert_that (reply_method (packet, sizeof (packet), 4),
+               is_equal_to (ALIVE_METHOD_ICMP));
+  ip[9] = IPPROTO_TCP;
+  ip[20 + 13] = TH_SYN | TH_ACK;
+  assert_that (reply_method (packet, sizeof (packet), 4),
+               is_equal_to (ALIVE_METHOD_TCP_SYN));
+  ip[20 + 13] = TH_RST | TH_ACK;
+  assert_that (reply_method (packet, sizeof (packet), 4),
+               is_equal_to (ALIVE_METHOD_TCP_SYN));
+  ip[20 + 13] = TH_RST;
+  assert_that (reply_method (packet, sizeof (packet), 4),
+               is_equal_to (ALIVE_METHOD_TCP_ACK));
+  /* Truncated TCP header. */
+  assert_that (reply_method (packet, 16 + 20 + 10, 4),
+               is_equal_to (ALIVE_METHOD_MAX));
+  ip[9] = IPPROTO_UDP;
+  assert_that (reply_method (packet, sizeof (packet), 4),
+               is_equal_to (ALIVE_METHOD_MAX));
+
+  /* IPv6 */
+  memset (packet, 0, sizeof (packet));
+  ip[6] = IPPROTO_ICMPV6;
+  ip[40] = ICMP6_ECHO_REPLY;
+  assert_that (reply_method (packet, sizeof (packet), 6),
+               is_equal_to (ALIVE_METHOD_ICMP));
+  ip[40] = ND_NEIGHBOR_ADVERT;
+  assert_that (reply_method (packet, sizeof (packet), 6),
+               is_equal_to (ALIVE_METHOD_ARP));
+  ip[6] = IPPROTO_TCP;
+  ip[40 + 13] = TH_RST;
+  assert_that (reply_method (packet, sizeof (packet), 6),
+               is_equal_to (ALIVE_METHOD_TCP_ACK));
+
+  /* ARP */
+  assert_that (reply_method (packet, sizeof (packet), 0),
+               is_equal_to (ALIVE_METHOD_ARP));
+}
+
+Ensure (sniffer, replay_file_classifies_replies_of_targets)
+{
+  scanner_t test_scanner = {0};
+  hosts_data_t hosts_data = {0};
+  struct in_addr addr4;
+  struct in6_addr addr6;
+  reply_kind_t kinds[] = {REPLY_ICMP,    REPLY_TCP_RST, REPLY_TCP_SYN_ACK,
+                          REPLY_ICMP,    REPLY_ARP,     REPLY_ICMP6,
+                          REPLY_ICMP6};
+  const char *srcs[] = {"192.168.0.1", "192.168.0.2", "192.168.0.3",
+                        "192.168.0.1", "192.168.0.4", "2001:db8::1",
+                        "2001:db8::2"};
+  const char *targets[] = {"192.168.0.1", "192.168.0.2", "192.168.0.4"};
+  gchar *path;
+
+  hosts_data.alivehosts = hosts_set_new ();
+  hosts_data.targethosts = hosts_set_new ();
+  for (size_t i = 0; i < G_N_ELEMENTS (targets); i++)
+    {
+      inet_pton (AF_INET, targets[i], &addr4);
+      hosts_set_add_addr4 (hosts_data.targethosts, &addr4);
+    }
+  inet_pton (AF_INET6, "2001:db8::1", &addr6);
+  hosts_set_add_addr6 (hosts_data.targethosts, &addr6);
+  test_scanner.hosts_data = &hosts_data;
+  test_scanner.stats = alive_stats_new ();
+  init_scan_restrictions (&test_scanner, INT_MAX);
+
+  path = write_capture (kinds, srcs, G_N_ELEMENTS (kinds));
+  assert_that (sniffer_replay_file (&test_scanner, path),
+               is_equal_to (G_N_ELEMENTS (kinds)));
+
+  /* 192.168.0.3 and 2001:db8::2 are no targets. */
+  assert_that (hosts_set_size (hosts_data.alivehosts), is_equal_to (4));
+  assert_that (test_scanner.scan_restrictions->alive_hosts_count,
+               is_equal_to (4));
+  assert_that (test_scanner.stats->replies[ALIVE_METHOD_ICMP],
+               is_equal_to (3));
+  assert_that (test_scanner.stats->alive_hosts[ALIVE_METHOD_ICMP],
+               is_equal_to (2));
+  assert_that (test_scanner.stats->alive_hosts[ALIVE_METHOD_TCP_ACK],
+               is_equal_to (1));
+  assert_that (test_scanner.stats->alive_hosts[ALIVE_METHOD_TCP_SYN],
+               is_equal_to (0));
+  assert_that (test_scanner.stats->alive_hosts[ALIVE_METHOD_ARP],
+               is_equal_to (1));
+  assert_that (test_scanner.stats->first_reply,
+               is_equal_to (1000 * G_USEC_PER_SEC));
+  assert_that (test_scanner.stats->last_reply,
+               is_equal_to (1005 * G_USEC_PER_SEC));
+
+  g_unlink (path);
+  g_free (path);
+  alive_stats_free (test_scanner.stats);
+  hosts_set_free (hosts_data.alivehosts);
+  hosts_set_free (hosts_data.targethosts);
+}
+
+Ensure (sniffer, replay_file_fails_for_missing_file)
+{
+  scanner_t test_scanner = {0};
+
+  assert_that (sniffer_replay_file (&test_scanner, "/nonexistent.pcap"),
+               is_equal_to (-1));
+}
+
 int
 main (int argc, char **argv)
 {
@@ -29,6 +271,10 @@ main (int argc, char **argv)
   suite = create_test_suite ();
 
   add_test_with_context (suite, sniffer, dummy_test);
+  add_test_with_context (suite, sniffer, reply_method_classifies_replies);
+  add_test_with_context (suite, sniffer,
+                         replay_file_classifies_replies_of_targets);
+  add_test_with_context (suite, sniffer, replay_file_fails_for_missing_file);
 
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
@@ -0,0 +1,694 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Cache of the source addresses used for the TCP pings.
+ *
+ * Looking up the source address of a destination with get_source_addr_v4()
+ * or get_source_addr_v6() takes three syscalls. As all hosts of the same /24
+ * (IPv4) or /64 (IPv6) network are normally reached over the same route, the
+ * source address is looked up once per network and then taken from the
+ * cache.
+ *
+ * To know whether a network is reached over a single route, the routes of the
+ * main, local and default tables are read from the kernel. A host covered by
+ * a route more specific than its network, e.g. a host route or a smaller
+ * subnet, may be routed differently from its neighbours. Such a host is
+ * looked up on its own and not cached. If other routing tables are in use by
+ * policy routing rules, or the routes can not be read, every host is looked
+ * up on its own.
+ *
+ * The cache subscribes to the route and address change notifications of the
+ * kernel on a NETLINK_ROUTE socket. The socket is polled without blocking at
+ * most every SRCCACHE_POLL_INTERVAL and the whole cache is flushed if
+ * anything changed. If no netlink socket can be opened the cache is flushed
+ * on every poll instead.
+ *
+ * A srccache_t is not thread safe. Every sending thread owns its own cache.
+ */
+
+#include "srccache.h"
+
+#include "util.h"
+
+#include <errno.h>
+#include <linux/fib_rules.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib log domain.
+ */
+#define G_LOG_DOMAIN "libgvm boreas"
+
+#define NSEC_PER_SEC 1000000000ULL
+
+/* Minimal time (in nanoseconds) between two polls of the netlink socket. */
+#define SRCCACHE_POLL_INTERVAL (NSEC_PER_SEC / 10)
+
+/* Size of the buffer for the replies of a netlink dump. */
+#define NETLINK_DUMP_BUFSIZE 32768
+
+/**
+ * @brief IPv4 route more specific than /24.
+ */
+struct route4
+{
+  /* Destination network in host byte order. */
+  guint32 network;
+  /* Netmask of the destination in host byte order. */
+  guint32 mask;
+};
+
+/**
+ * @brief IPv6 route more specific than /64.
+ */
+struct route6
+{
+  /* Destination network. */
+  struct in6_addr network;
+  /* Prefix length of the destination. */
+  guint8 len;
+};
+
+/**
+ * @brief Source address cache.
+ */
+struct srccache
+{
+  /* /24 network in host byte order -> source address (s_addr). */
+  GHashTable *v4;
+  /* /64 network (guint64 *) -> source address (struct in6_addr *). */
+  GHashTable *v6;
+  /* /24 network -> GArray of the struct route4 within it. */
+  GHashTable *v4_routes;
+  /* /64 network (guint64 *) -> GArray of the struct route6 within it. */
+  GHashTable *v6_routes;
+  /* Whether the routes were read since the last flush. */
+  gboolean routes_loaded;
+  /* Whether every host has to be looked up on its own. */
+  gboolean per_host;
+  /* Incremented on every flush. */
+  guint generation;
+  /* NETLINK_ROUTE socket for change notifications. -1 if not available. */
+  int nlsoc;
+  /* Monotonic time of the last poll in nanoseconds. */
+  guint64 last_poll;
+  /* Statistics. */
+  guint hits;
+  guint misses;
+  guint flushes;
+};
+
+/**
+ * @brief Open a netlink socket subscribed to route and address changes.
+ *
+ * @return Nonblocking socket, -1 on error.
+ */
+static int
+open_route_notifications (void)
+{
+  struct sockaddr_nl addr;
+  int soc;
+
+  soc = socket (AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                NETLINK_ROUTE);
+  if (soc < 0)
+    {
+      g_debug ("%s: socket(): %s", __func__, strerror (errno));
+      return -1;
+    }
+
+  memset (&addr, 0, sizeof (addr));
+  addr.nl_family = AF_NETLINK;
+  addr.nl_groups = RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE | RTMGRP_IPV4_IFADDR
+                   | RTMGRP_IPV6_IFADDR;
+  if (bind (soc, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+    {
+      g_debug ("%s: bind(): %s", __func__, strerror (errno));
+      close (soc);
+      return -1;
+    }
+
+  return soc;
+}
+
+/**
+ * @brief Create a new source address cache.
+ *
+ * @return New cache. Free with srccache_free().
+ */
+srccache_t *
+srccache_new (void)
+{
+  srccache_t *cache;
+  struct timespec now;
+
+  cache = g_malloc0 (sizeof (srccache_t));
+  cache->v4 = g_hash_table_new (g_direct_hash, g_direct_equal);
+  cache->v6 = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free,
+                                     g_free);
+  cache->v4_routes =
+    g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                           (GDestroyNotify) g_array_unref);
+  cache->v6_routes =
+    g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free,
+                           (GDestroyNotify) g_array_unref);
+  cache->nlsoc = open_route_notifications ();
+  if (cache->nlsoc < 0)
+    g_debug ("%s: No route change notifications. Flushing the source address "
+             "cache periodically.",
+             __func__);
+  clock_gettime (CLOCK_MONOTONIC_COARSE, &now);
+  cache->last_poll = (guint64) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+
+  return cache;
+}
+
+/**
+ * @brief Free a source address cache.
+ *
+ * @param cache  Cache to free.
+ */
+void
+srccache_free (srccache_t *cache)
+{
+  if (cache == NULL)
+    return;
+
+  g_debug ("%s: %u hits, %u misses, %u flushes.", __func__, cache->hits,
+           cache->misses, cache->flushes);
+  if (cache->nlsoc >= 0)
+    close (cache->nlsoc);
+  g_hash_table_destroy (cache->v4);
+  g_hash_table_destroy (cache->v6);
+  g_hash_table_destroy (cache->v4_routes);
+  g_hash_table_destroy (cache->v6_routes);
+  g_free (cache);
+}
+
+/**
+ * @brief Remove all entries from the cache.
+ *
+ * The routes are read again on the next lookup.
+ *
+ * @param cache  Cache to flush.
+ */
+void
+srccache_flush (srccache_t *cache)
+{
+  cache->routes_loaded = FALSE;
+  cache->generation++;
+  if (g_hash_table_size (cache->v4) == 0 && g_hash_table_size (cache->v6) == 0)
+    return;
+
+  g_hash_table_remove_all (cache->v4);
+  g_hash_table_remove_all (cache->v6);
+  cache->flushes++;
+}
+
+/**
+ * @brief Flush the cache if routes or addresses changed since the last poll.
+ *
+ * The notifications are not parsed. Any message, or a lost one, flushes the
+ * cache.
+ *
+ * @param cache  Cache to check.
+ */
+static void
+srccache_check_routes (srccache_t *cache)
+{
+  struct timespec now;
+  guint64 now_ns;
+  char buf[8192];
+  gboolean changed = FALSE;
+
+  clock_gettime (CLOCK_MONOTONIC_COARSE, &now);
+  now_ns = (guint64) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+  if (now_ns - cache->last_poll < SRCCACHE_POLL_INTERVAL)
+    return;
+  cache->last_poll = now_ns;
+
+  if (cache->nlsoc < 0)
+    {
+      srccache_flush (cache);
+      return;
+    }
+
+  for (;;)
+    {
+      ssize_t len = recv (cache->nlsoc, buf, sizeof (buf), MSG_DONTWAIT);
+
+      if (len > 0 || (len < 0 && errno == ENOBUFS))
+        changed = TRUE;
+      else if (len < 0 && errno == EINTR)
+        continue;
+      else
+        break;
+    }
+
+  if (changed)
+    {
+      g_debug ("%s: Routes changed. Flushing source address cache.",
+               __func__);
+      srccache_flush (cache);
+    }
+}
+
+/**
+ * @brief Remember a route if it is more specific than its /24 or /64 network.
+ *
+ * @param cache   Cache to add the route to.
+ * @param family  AF_INET or AF_INET6.
+ * @param dst     Destination network of the route.
+ * @param len     Prefix length of the destination.
+ */
+static void
+srccache_add_route (srccache_t *cache, int family, const void *dst, int len)
+{
+  GArray *routes;
+
+  if (family == AF_INET && len > 24 && len <= 32)
+    {
+      struct route4 route;
+      guint32 addr;
+
+      memcpy (&addr, dst, sizeof (addr));
+      route.mask = len == 32 ? 0xffffffff : ~(0xffffffff >> len);
+      route.network = ntohl (addr) & route.mask;
+      routes = g_hash_table_lookup (cache->v4_routes,
+                                    GUINT_TO_POINTER (route.network >> 8));
+      if (routes == NULL)
+        {
+          routes = g_array_new (FALSE, FALSE, sizeof (struct route4));
+          g_hash_table_insert (cache->v4_routes,
+                               GUINT_TO_POINTER (route.network >> 8), routes);
+        }
+      g_array_append_val (routes, route);
+    }
+  else if (family == AF_INET6 && len > 64 && len <= 128)
+    {
+      struct route6 route;
+      guint64 prefix;
+
+      memcpy (&route.network, dst, sizeof (route.network));
+      route.len = len;
+      memcpy (&prefix, route.network.s6_addr, sizeof (prefix));
+      routes = g_hash_table_lookup (cache->v6_routes, &prefix);
+      if (routes == NULL)
+        {
+          guint64 *key = g_malloc (sizeof (guint64));
+
+          *key = prefix;
+          routes = g_array_new (FALSE, FALSE, sizeof (struct route6));
+          g_hash_table_insert (cache->v6_routes, key, routes);
+        }
+      g_array_append_val (routes, route);
+    }
+}
+
+/**
+ * @brief Check whether a routing table is consulted without policy rules.
+ *
+ * @param table  Routing table.
+ *
+ * @return TRUE for the local, main and default table, else FALSE.
+ */
+static gboolean
+is_default_table (guint32 table)
+{
+  return table == RT_TABLE_LOCAL || table == RT_TABLE_MAIN
+         || table == RT_TABLE_DEFAULT;
+}
+
+/**
+ * @brief Handle a route of a netlink route dump.
+ *
+ * @param cache  Cache to add the route to.
+ * @param nlh    RTM_NEWROUTE message.
+ */
+static void
+srccache_route_msg (srccache_t *cache, struct nlmsghdr *nlh)
+{
+  struct rtmsg *rtm = NLMSG_DATA (nlh);
+  struct rtattr *rta;
+  int len = RTM_PAYLOAD (nlh);
+  guint32 table = rtm->rtm_table;
+  const void *dst = NULL;
+
+  if (nlh->nlmsg_type != RTM_NEWROUTE || (rtm->rtm_flags & RTM_F_CLONED))
+    return;
+
+  for (rta = RTM_RTA (rtm); RTA_OK (rta, len); rta = RTA_NEXT (rta, len))
+    {
+      if (rta->rta_type == RTA_TABLE)
+        memcpy (&table, RTA_DATA (rta), sizeof (table));
+      else if (rta->rta_type == RTA_DST)
+        dst = RTA_DATA (rta);
+    }
+
+  /* Other tables are only used by policy rules, see srccache_rule_msg(). */
+  if (dst && is_default_table (table))
+    srccache_add_route (cache, rtm->rtm_family, dst, rtm->rtm_dst_len);
+}
+
+/**
+ * @brief Handle a rule of a netlink rule dump.
+ *
+ * Any rule besides the ones looking up the local, main and default table for
+ * all destinations makes every host be looked up on its own.
+ *
+ * @param cache  Cache to update.
+ * @param nlh    RTM_NEWRULE message.
+ */
+static void
+srccache_rule_msg (srccache_t *cache, struct nlmsghdr *nlh)
+{
+  struct fib_rule_hdr *frh = NLMSG_DATA (nlh);
+  struct rtattr *rta;
+  int len = nlh->nlmsg_len - NLMSG_LENGTH (sizeof (struct fib_rule_hdr));
+  guint32 table = frh->table;
+
+  if (nlh->nlmsg_type != RTM_NEWRULE)
+    return;
+
+  rta = (struct rtattr *) ((char *) frh + NLMSG_ALIGN (sizeof (*frh)));
+  for (; RTA_OK (rta, len); rta = RTA_NEXT (rta, len))
+    if (rta->rta_type == FRA_TABLE)
+      memcpy (&table, RTA_DATA (rta), sizeof (table));
+
+  if (frh->action != FR_ACT_TO_TBL || frh->dst_len != 0
+      || !is_default_table (table))
+    cache->per_host = TRUE;
+}
+
+/**
+ * @brief Dump a kind of routing objects of the kernel.
+ *
+ * @param cache   Cache to pass to func.
+ * @param type    RTM_GETROUTE or RTM_GETRULE.
+ * @param family  AF_INET or AF_INET6.
+ * @param func    Function called with every received object.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int
+netlink_dump (srccache_t *cache, int type, int family,
+              void (*func) (srccache_t *, struct nlmsghdr *))
+{
+  struct
+  {
+    struct nlmsghdr nlh;
+    struct rtmsg rtm; /* Same layout as struct fib_rule_hdr. */
+  } req;
+  gboolean done = FALSE;
+  char *buf;
+  int soc, ret = -1;
+
+  soc = socket (AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (soc < 0)
+    {
+      g_debug ("%s: socket(): %s", __func__, strerror (errno));
+      return -1;
+    }
+
+  memset (&req, 0, sizeof (req));
+  req.nlh.nlmsg_len = NLMSG_LENGTH (sizeof (struct rtmsg));
+  req.nlh.nlmsg_type = type;
+  req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.nlh.nlmsg_seq = 1;
+  req.rtm.rtm_family = family;
+  if (send (soc, &req, req.nlh.nlmsg_len, 0) < 0)
+    {
+      g_debug ("%s: send(): %s", __func__, strerror (errno));
+      close (soc);
+      return -1;
+    }
+
+  buf = g_malloc (NETLINK_DUMP_BUFSIZE);
+  while (!done)
+    {
+      struct nlmsghdr *nlh;
+      ssize_t received;
+      int len;
+
+      received = recv (soc, buf, NETLINK_DUMP_BUFSIZE, 0);
+      if (received < 0 && errno == EINTR)
+        continue;
+      if (received <= 0)
+        {
+          g_debug ("%s: recv(): %s", __func__,
+                   received ? strerror (errno) : "EOF");
+          break;
+        }
+
+      len = received;
+      for (nlh = (struct nlmsghdr *) buf; NLMSG_OK (nlh, len);
+           nlh = NLMSG_NEXT (nlh, len))
+        {
+          if (nlh->nlmsg_type == NLMSG_DONE)
+            {
+              done = TRUE;
+              ret = 0;
+              break;
+            }
+          if (nlh->nlmsg_type == NLMSG_ERROR)
+            {
+              done = TRUE;
+              break;
+            }
+          func (cache, nlh);
+        }
+    }
+
+  g_free (buf);
+  close (soc);
+  return ret;
+}
+
+/**
+ * @brief Read the routes and rules from the kernel if not done yet.
+ *
+ * @param cache  Cache to update.
+ */
+static void
+srccache_load_routes (srccache_t *cache)
+{
+  if (cache->routes_loaded)
+    return;
+  cache->routes_loaded = TRUE;
+
+  g_hash_table_remove_all (cache->v4_routes);
+  g_hash_table_remove_all (cache->v6_routes);
+  cache->per_host = FALSE;
+  if (netlink_dump (cache, RTM_GETRULE, AF_INET, srccache_rule_msg)
+      || netlink_dump (cache, RTM_GETRULE, AF_INET6, srccache_rule_msg)
+      || netlink_dump (cache, RTM_GETROUTE, AF_INET, srccache_route_msg)
+      || netlink_dump (cache, RTM_GETROUTE, AF_INET6, srccache_route_msg))
+    {
+      g_debug ("%s: Could not read the routes. Not caching source addresses.",
+               __func__);
+      cache->per_host = TRUE;
+    }
+  else if (cache->per_host)
+    g_debug ("%s: Policy routing in use. Not caching source addresses.",
+             __func__);
+}
+
+/**
+ * @brief Get the /24 network under which an IPv4 destination is cached.
+ *
+ * Flushes the cache if the routes changed.
+ *
+ * @param[in]   cache    Cache. May be NULL.
+ * @param[in]   dst      Destination address.
+ * @param[out]  network  /24 network in host byte order.
+ *
+ * @return TRUE if all hosts of the network are routed like dst, FALSE if dst
+ *         has to be looked up on its own.
+ */
+gboolean
+srccache_network_v4 (srccache_t *cache, const struct in_addr *dst,
+                     guint32 *network)
+{
+  guint32 addr = ntohl (dst->s_addr);
+  GArray *routes;
+
+  if (cache == NULL)
+    return FALSE;
+
+  srccache_check_routes (cache);
+  srccache_load_routes (cache);
+  if (cache->per_host)
+    return FALSE;
+
+  *network = addr >> 8;
+  routes = g_hash_table_lookup (cache->v4_routes, GUINT_TO_POINTER (*network));
+  for (guint i = 0; routes && i < routes->len; i++)
+    {
+      struct route4 *route = &g_array_index (routes, struct route4, i);
+
+      if ((addr & route->mask) == route->network)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the /64 network under which an IPv6 destination is cached.
+ *
+ * Flushes the cache if the routes changed.
+ *
+ * @param[in]   cache    Cache. May be NULL.
+ * @param[in]   dst      Destination address.
+ * @param[out]  network  Upper 64 bits of dst.
+ *
+ * @return TRUE if all hosts of the network are routed like dst, FALSE if dst
+ *         has to be looked up on its own.
+ */
+gboolean
+srccache_network_v6 (srccache_t *cache, const struct in6_addr *dst,
+                     guint64 *network)
+{
+  GArray *routes;
+
+  if (cache == NULL)
+    return FALSE;
+
+  srccache_check_routes (cache);
+  srccache_load_routes (cache);
+  if (cache->per_host)
+    return FALSE;
+
+  memcpy (network, dst->s6_addr, sizeof (*network));
+  routes = g_hash_table_lookup (cache->v6_routes, network);
+  for (guint i = 0; routes && i < routes->len; i++)
+    {
+      struct route6 *route = &g_array_index (routes, struct route6, i);
+      int bytes = route->len / 8, bits = route->len % 8;
+
+      if (memcmp (dst->s6_addr, route->network.s6_addr, bytes) == 0
+          && (bits == 0
+              || ((dst->s6_addr[bytes] ^ route->network.s6_addr[bytes])
+                  & (0xff << (8 - bits)))
+                   == 0))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/**
+ * @brief Get the number of flushes of the cache.
+ *
+ * Lets other per network caches notice that routes changed.
+ *
+ * @param cache  Cache. May be NULL.
+ *
+ * @return Number of flushes, also counting flushes of an empty cache.
+ */
+guint
+srccache_generation (const srccache_t *cache)
+{
+  return cache ? cache->generation : 0;
+}
+
+/**
+ * @brief Get the source address for an IPv4 destination.
+ *
+ * @param[in]   cache     Cache to use. If NULL the address is looked up with
+ *                        get_source_addr_v4().
+ * @param[in]   udpv4soc  Location of the socket to use on a cache miss.
+ * @param[in]   dst       Destination address.
+ * @param[out]  src       Source address.
+ *
+ * @return 0 on success, boreas_error_t on failure.
+ */
+boreas_error_t
+srccache_get_v4 (srccache_t *cache, int *udpv4soc, struct in_addr *dst,
+                 struct in_addr *src)
+{
+  gpointer key, value;
+  guint32 network;
+  boreas_error_t error;
+
+  if (!srccache_network_v4 (cache, dst, &network))
+    {
+      if (cache)
+        cache->misses++;
+      return get_source_addr_v4 (udpv4soc, dst, src);
+    }
+
+  key = GUINT_TO_POINTER (network);
+  if (g_hash_table_lookup_extended (cache->v4, key, NULL, &value))
+    {
+      cache->hits++;
+      src->s_addr = GPOINTER_TO_UINT (value);
+      return NO_ERROR;
+    }
+
+  cache->misses++;
+  error = get_source_addr_v4 (udpv4soc, dst, src);
+  if (!error)
+    g_hash_table_insert (cache->v4, key, GUINT_TO_POINTER (src->s_addr));
+
+  return error;
+}
+
+/**
+ * @brief Get the source address for an IPv6 destination.
+ *
+ * @param[in]   cache     Cache to use. If NULL the address is looked up with
+ *                        get_source_addr_v6().
+ * @param[in]   udpv6soc  Location of the socket to use on a cache miss.
+ * @param[in]   dst       Destination address.
+ * @param[out]  src       Source address.
+ *
+ * @return 0 on success, boreas_error_t on failure.
+ */
+boreas_error_t
+srccache_get_v6 (srccache_t *cache, int *udpv6soc, struct in6_addr *dst,
+                 struct in6_addr *src)
+{
+  guint64 prefix;
+  struct in6_addr *value;
+  boreas_error_t error;
+
+  if (!srccache_network_v6 (cache, dst, &prefix))
+    {
+      if (cache)
+        cache->misses++;
+      return get_source_addr_v6 (udpv6soc, dst, src);
+    }
+
+  value = g_hash_table_lookup (cache->v6, &prefix);
+  if (value)
+    {
+      cache->hits++;
+      *src = *value;
+      return NO_ERROR;
+    }
+
+  cache->misses++;
+  error = get_source_addr_v6 (udpv6soc, dst, src);
+  if (!error)
+    {
+      guint64 *key = g_malloc (sizeof (guint64));
+
+      *key = prefix;
+      value = g_malloc (sizeof (struct in6_addr));
+      *value = *src;
+      g_hash_table_insert (cache->v6, key, value);
+    }
+
+  return error;
+}
@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef BOREAS_SRCCACHE_H
+#define BOREAS_SRCCACHE_H
+
+#include "boreas_error.h"
+
+#include <glib.h>
+#include <netinet/in.h>
+
+typedef struct srccache srccache_t;
+
+srccache_t *
+srccache_new (void);
+
+void
+srccache_free (srccache_t *);
+
+void
+srccache_flush (srccache_t *);
+
+gboolean
+srccache_network_v4 (srccache_t *, const struct in_addr *, guint32 *);
+
+gboolean
+srccache_network_v6 (srccache_t *, const struct in6_addr *, guint64 *);
+
+guint
+srccache_generation (const srccache_t *);
+
+boreas_error_t
+srccache_get_v4 (srccache_t *, int *, struct in_addr *, struct in_addr *);
+
+boreas_error_t
+srccache_get_v6 (srccache_t *, int *, struct in6_addr *, struct in6_addr *);
+
+#endif /* not BOREAS_SRCCACHE_H */
@@ -0,0 +1,176 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "srccache.c"
+
+#include <arpa/inet.h>
+#include <cgreen/cgreen.h>
+#include <cgreen/mocks.h>
+
+Describe (srccache);
+BeforeEach (srccache)
+{
+}
+AfterEach (srccache)
+{
+}
+
+Ensure (srccache, v4_lookups_are_cached_per_24)
+{
+  srccache_t *cache;
+  struct in_addr dst, src;
+  int udpv4soc;
+
+  udpv4soc = socket (AF_INET, SOCK_DGRAM, 0);
+  assert_that (udpv4soc, is_not_equal_to (-1));
+  cache = srccache_new ();
+  /* No route more specific than /24, independent of the host. */
+  cache->routes_loaded = TRUE;
+
+  inet_pton (AF_INET, "127.0.0.1", &dst);
+  assert_that (srccache_get_v4 (cache, &udpv4soc, &dst, &src),
+               is_equal_to (NO_ERROR));
+  assert_that (src.s_addr, is_equal_to (htonl (INADDR_LOOPBACK)));
+  assert_that (cache->misses, is_equal_to (1));
+
+  /* Same /24, taken from the cache. */
+  inet_pton (AF_INET, "127.0.0.200", &dst);
+  src.s_addr = 0;
+  assert_that (srccache_get_v4 (cache, &udpv4soc, &dst, &src),
+               is_equal_to (NO_ERROR));
+  assert_that (src.s_addr, is_equal_to (htonl (INADDR_LOOPBACK)));
+  assert_that (cache->hits, is_equal_to (1));
+  assert_that (cache->misses, is_equal_to (1));
+
+  /* Other /24. */
+  inet_pton (AF_INET, "127.0.1.1", &dst);
+  assert_that (srccache_get_v4 (cache, &udpv4soc, &dst, &src),
+               is_equal_to (NO_ERROR));
+  assert_that (cache->misses, is_equal_to (2));
+
+  /* Looked up again after a flush. */
+  srccache_flush (cache);
+  assert_that (cache->flushes, is_equal_to (1));
+  assert_that (srccache_generation (cache), is_equal_to (1));
+  cache->routes_loaded = TRUE;
+  inet_pton (AF_INET, "127.0.0.1", &dst);
+  assert_that (srccache_get_v4 (cache, &udpv4soc, &dst, &src),
+               is_equal_to (NO_ERROR));
+  assert_that (cache->misses, is_equal_to (3));
+
+  srccache_free (cache);
+  close (udpv4soc);
+}
+
+Ensure (srccache, v6_entries_are_keyed_per_64)
+{
+  srccache_t *cache;
+  struct in6_addr dst, src, cached, *value;
+  guint64 *key;
+
+  cache = srccache_new ();
+  cache->routes_loaded = TRUE;
+  inet_pton (AF_INET6, "2001:db8::1", &cached);
+
+  /* Fill the cache by hand, no IPv6 route is needed. */
+  inet_pton (AF_INET6, "2001:db8:0:1::", &dst);
+  key = g_malloc (sizeof (guint64));
+  memcpy (key, dst.s6_addr, sizeof (guint64));
+  value = g_malloc (sizeof (struct in6_addr));
+  *value = cached;
+  g_hash_table_insert (cache->v6, key, value);
+
+  inet_pton (AF_INET6, "2001:db8:0:1:ffff::abcd", &dst);
+  assert_that (srccache_get_v6 (cache, NULL, &dst, &src),
+               is_equal_to (NO_ERROR));
+  assert_that (memcmp (&src, &cached, sizeof (src)), is_equal_to (0));
+  assert_that (cache->hits, is_equal_to (1));
+  assert_that (cache->misses, is_equal_to (0));
+
+  srccache_free (cache);
+}
+
+Ensure (srccache, hosts_of_more_specific_v4_routes_are_not_cached)
+{
+  srccache_t *cache;
+  struct in_addr addr;
+  guint32 network;
+
+  cache = srccache_new ();
+  cache->routes_loaded = TRUE;
+  inet_pton (AF_INET, "192.168.1.128", &addr);
+  srccache_add_route (cache, AF_INET, &addr, 25);
+  inet_pton (AF_INET, "192.168.2.7", &addr);
+  srccache_add_route (cache, AF_INET, &addr, 32);
+  /* Not more specific than /24, hosts are routed alike. */
+  inet_pton (AF_INET, "10.0.0.0", &addr);
+  srccache_add_route (cache, AF_INET, &addr, 8);
+
+  inet_pton (AF_INET, "192.168.1.5", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_true);
+  assert_that (network, is_equal_to (0xc0a801));
+  inet_pton (AF_INET, "192.168.1.200", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_false);
+  inet_pton (AF_INET, "192.168.2.7", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_false);
+  inet_pton (AF_INET, "192.168.2.8", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_true);
+  inet_pton (AF_INET, "10.1.2.3", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_true);
+
+  /* Policy routing. */
+  cache->per_host = TRUE;
+  inet_pton (AF_INET, "192.168.1.5", &addr);
+  assert_that (srccache_network_v4 (cache, &addr, &network), is_false);
+
+  srccache_free (cache);
+}
+
+Ensure (srccache, hosts_of_more_specific_v6_routes_are_not_cached)
+{
+  srccache_t *cache;
+  struct in6_addr addr;
+  guint64 network;
+
+  cache = srccache_new ();
+  cache->routes_loaded = TRUE;
+  inet_pton (AF_INET6, "2001:db8::", &addr);
+  srccache_add_route (cache, AF_INET6, &addr, 120);
+  inet_pton (AF_INET6, "2001:db8:0:1:ab00::", &addr);
+  srccache_add_route (cache, AF_INET6, &addr, 72);
+
+  inet_pton (AF_INET6, "2001:db8::5", &addr);
+  assert_that (srccache_network_v6 (cache, &addr, &network), is_false);
+  inet_pton (AF_INET6, "2001:db8::1:5", &addr);
+  assert_that (srccache_network_v6 (cache, &addr, &network), is_true);
+  inet_pton (AF_INET6, "2001:db8:0:1:abcd::1", &addr);
+  assert_that (srccache_network_v6 (cache, &addr, &network), is_false);
+  inet_pton (AF_INET6, "2001:db8:0:1:ac00::1", &addr);
+  assert_that (srccache_network_v6 (cache, &addr, &network), is_true);
+  assert_that (memcmp (&network, addr.s6_addr, sizeof (network)),
+               is_equal_to (0));
+
+  srccache_free (cache);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, srccache, v4_lookups_are_cached_per_24);
+  add_test_with_context (suite, srccache, v6_entries_are_keyed_per_64);
+  add_test_with_context (suite, srccache,
+                         hosts_of_more_specific_v4_routes_are_not_cached);
+  add_test_with_context (suite, srccache,
+                         hosts_of_more_specific_v6_routes_are_not_cached);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -73,6 +73,31 @@ in_cksum (uint16_t *addr, int len)
   return answer;
 }
 
+/**
+ * @brief Update a checksum after a 16 bit word of the data changed.
+ *
+ * Incremental update as described in RFC 1624, eqn. 3:
+ * HC' = ~(~HC + ~m + m'). All values must be in the same byte order.
+ *
+ * @param[in]  cksum     Checksum of the data before the change.
+ * @param[in]  old_word  Old value of the changed word.
+ * @param[in]  new_word  New value of the changed word.
+ *
+ * @return Checksum of the changed data.
+ */
+uint16_t
+in_cksum_update (uint16_t cksum, uint16_t old_word, uint16_t new_word)
+{
+  uint32_t sum;
+
+  sum = (uint16_t) ~cksum;
+  sum += (uint16_t) ~old_word;
+  sum += new_word;
+  sum = (sum >> 16) + (sum & 0xffff);
+  sum += (sum >> 16);
+  return ~sum;
+}
+
 /**
  * @brief Get the source mac address of the given interface
  * or of the first non lo interface.
@@ -591,6 +616,9 @@ set_all_needed_sockets (scanner_t *scanner, alive_test_t alive_test)
  *
  * The original hashtables are not changed during or after the count operation.
  *
+ * @deprecated Boreas keeps its hosts in a hosts_set_t and does not use this
+ * anymore. It is only kept for users of libgvm_boreas.
+ *
  * @param A Base Hashtable.
  * @param B Hashtable to be subtracted from A.
  *
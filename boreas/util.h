@@ -14,6 +14,9 @@
 uint16_t
 in_cksum (uint16_t *addr, int len);
 
+uint16_t
+in_cksum_update (uint16_t, uint16_t, uint16_t);
+
 int
 get_source_mac_addr (char *, uint8_t *);
 
@@ -36,6 +39,7 @@ wait_until_so_sndbuf_empty (int, int);
 
 /* Misc hashtable functions. */
 
+/* Deprecated, not used by Boreas anymore. */
 int
 count_difference (GHashTable *, GHashTable *);
 
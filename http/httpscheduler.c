@@ -0,0 +1,662 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file httpscheduler.c
+ * @brief Concurrent HTTP(S) requests driven by one gvm_http_multi_t.
+ *
+ * Submitted requests are queued per host, given as host and port of the URL.
+ * At most max_per_host requests of a host are added to the multi handle at a
+ * time, the others wait in the queue of the host. When a transfer is done its
+ * handle is removed, and either queued again for a retry or the completion
+ * callback is called. Then the next waiting request of the host is started.
+ *
+ * A transfer error or a 502, 503 or 504 status is retried up to the
+ * configured number of retries. The retry waits with exponential back-off,
+ * so that a struggling server is not hammered with retries. Every attempt is
+ * limited by the timeout.
+ *
+ * Completion callbacks are only called from gvm_http_scheduler_perform(), also
+ * for requests which could not be started, so that submitting a request from
+ * a callback never calls back into the caller. A callback may free the
+ * scheduler, the perform function then returns without touching it again.
+ */
+
+#include "httpscheduler.h"
+
+#include "httpstats.h"
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib logging domain.
+ */
+#define G_LOG_DOMAIN "libgvm util"
+
+/**
+ * @brief Requests of one host.
+ */
+struct http_host
+{
+  GQueue waiting; ///< Requests waiting for a free slot.
+  int active;     ///< Number of requests in the multi handle.
+};
+
+/**
+ * @brief A submitted request.
+ */
+struct http_request
+{
+  gvm_http_t *http;                        ///< Handle, reused for retries.
+  struct gvm_http_response_stream stream;  ///< Received data.
+  gchar *payload;                          ///< Copy of the payload.
+  gvm_http_headers_t *headers;             ///< Copy of the headers.
+  struct http_host *host;                  ///< Host of the request.
+  int attempts;                            ///< Number of started attempts.
+  gint64 retry_at;                         ///< Monotonic time of the retry.
+  gvm_http_done_func_t done;               ///< Completion callback.
+  gpointer user_data;                      ///< Data for the callback.
+};
+
+/**
+ * @brief Scheduler of concurrent requests.
+ */
+struct gvm_http_scheduler
+{
+  gvm_http_multi_t *multi; ///< Multi handle performing the transfers.
+  GHashTable *hosts;       ///< "host:port" -> struct http_host.
+  GHashTable *active;      ///< Requests in the multi handle.
+  GQueue delayed;          ///< Requests waiting for a retry, by retry_at.
+  GQueue failed;           ///< Requests which could not be started.
+  guint pending;           ///< Submitted requests not done yet.
+  int max_per_host;        ///< Maximum active requests per host.
+  long timeout_ms;         ///< Timeout of an attempt.
+  int retries;             ///< Retries after a failed attempt.
+  gboolean in_callback;    ///< Whether a completion callback is running.
+  gboolean freed;          ///< Whether a callback freed the scheduler.
+};
+
+static void
+scheduler_destroy (gvm_http_scheduler_t *);
+
+/**
+ * @brief Gets the host and port of a URL to queue its requests by.
+ *
+ * @param url The URL.
+ *
+ * @return "host:port", or NULL if the URL is invalid. Must be freed.
+ */
+static gchar *
+request_host (const gchar *url)
+{
+  CURLU *curl_url_handle = curl_url ();
+  char *host = NULL, *port = NULL;
+  gchar *key = NULL;
+
+  if (curl_url_handle
+      && curl_url_set (curl_url_handle, CURLUPART_URL, url, 0) == CURLUE_OK
+      && curl_url_get (curl_url_handle, CURLUPART_HOST, &host, 0) == CURLUE_OK)
+    {
+      curl_url_get (curl_url_handle, CURLUPART_PORT, &port,
+                    CURLU_DEFAULT_PORT);
+      key = g_strdup_printf ("%s:%s", host, port ? port : "");
+    }
+
+  curl_free (host);
+  curl_free (port);
+  curl_url_cleanup (curl_url_handle);
+  return key;
+}
+
+/**
+ * @brief Copies custom headers, so they live as long as the request.
+ *
+ * @param headers The headers to copy. Can be NULL.
+ *
+ * @return The copy. Must be freed with `gvm_http_headers_free()`.
+ */
+static gvm_http_headers_t *
+request_headers_copy (gvm_http_headers_t *headers)
+{
+  gvm_http_headers_t *copy = gvm_http_headers_new ();
+
+  if (headers)
+    for (struct curl_slist *h = headers->custom_headers; h; h = h->next)
+      gvm_http_add_header (copy, h->data);
+
+  return copy;
+}
+
+/**
+ * @brief Frees a request and its handle.
+ *
+ * @param request The request, not in the multi handle anymore.
+ */
+static void
+request_free (struct http_request *request)
+{
+  gvm_http_free (request->http);
+  g_free (request->stream.data);
+  g_free (request->payload);
+  gvm_http_headers_free (request->headers);
+  g_free (request);
+}
+
+/**
+ * @brief Frees a host and its waiting requests.
+ *
+ * @param data The host.
+ */
+static void
+http_host_free (gpointer data)
+{
+  struct http_host *host = data;
+  struct http_request *request;
+
+  while ((request = g_queue_pop_head (&host->waiting)))
+    request_free (request);
+  g_free (host);
+}
+
+/**
+ * @brief Calls the completion callback of a request and frees it.
+ *
+ * @param scheduler The scheduler.
+ * @param request   The request, not in the multi handle anymore.
+ * @param result    Result of the last attempt.
+ *
+ * @return FALSE if the callback freed the scheduler, which is gone then.
+ */
+static gboolean
+request_finish (gvm_http_scheduler_t *scheduler, struct http_request *request,
+                CURLcode result)
+{
+  gvm_http_response_t response = {0};
+
+  if (result != CURLE_OK)
+    {
+      response.http_status = -1;
+      response.data =
+        g_strdup_printf ("{\"error\": \"CURL request failed: %s\"}",
+                         curl_easy_strerror (result));
+    }
+  else
+    {
+      curl_easy_getinfo (request->http->handler, CURLINFO_RESPONSE_CODE,
+                         &response.http_status);
+      if (request->stream.length > 0)
+        {
+          response.size = request->stream.length;
+          response.data = request->stream.data;
+          request->stream.data = NULL;
+        }
+      else
+        response.data = g_strdup ("{\"error\": \"Empty response\"}");
+    }
+
+  scheduler->pending--;
+  if (request->done)
+    {
+      scheduler->in_callback = TRUE;
+      request->done (&response, request->user_data);
+      scheduler->in_callback = FALSE;
+    }
+
+  g_free (response.data);
+  request_free (request);
+
+  if (scheduler->freed)
+    {
+      scheduler_destroy (scheduler);
+      return FALSE;
+    }
+  return TRUE;
+}
+
+/**
+ * @brief Checks whether a finished attempt of a request is retried.
+ *
+ * @param scheduler The scheduler.
+ * @param request   The request.
+ * @param result    Result of the attempt.
+ *
+ * @return TRUE if the request is to be retried.
+ */
+static gboolean
+request_retry (gvm_http_scheduler_t *scheduler, struct http_request *request,
+               CURLcode result)
+{
+  long status = 0;
+
+  if (request->attempts > scheduler->retries)
+    return FALSE;
+  if (result != CURLE_OK)
+    return TRUE;
+
+  curl_easy_getinfo (request->http->handler, CURLINFO_RESPONSE_CODE, &status);
+  return status == 502 || status == 503 || status == 504;
+}
+
+/**
+ * @brief Compares the retry times of two requests.
+ *
+ * @param a          First request.
+ * @param b          Second request.
+ * @param user_data  Unused.
+ *
+ * @return Negative, zero or positive like strcmp().
+ */
+static gint
+request_compare_retry_at (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const struct http_request *request_a = a, *request_b = b;
+
+  (void) user_data;
+  return (request_a->retry_at > request_b->retry_at)
+         - (request_a->retry_at < request_b->retry_at);
+}
+
+/**
+ * @brief Gets the back-off before retrying a request.
+ *
+ * The delay doubles with every failed attempt, up to
+ * GVM_HTTP_SCHEDULER_MAX_RETRY_DELAY. Up to half of the delay is added at
+ * random, so that requests which failed together are not retried together.
+ *
+ * @param attempts Number of failed attempts.
+ *
+ * @return Delay in microseconds.
+ */
+static gint64
+request_retry_delay (int attempts)
+{
+  gint64 delay = GVM_HTTP_SCHEDULER_RETRY_DELAY;
+
+  while (--attempts > 0 && delay < GVM_HTTP_SCHEDULER_MAX_RETRY_DELAY)
+    delay *= 2;
+  delay = MIN (delay, GVM_HTTP_SCHEDULER_MAX_RETRY_DELAY) * 1000;
+
+  return delay + g_random_int_range (0, delay / 2 + 1);
+}
+
+/**
+ * @brief Queues a request for a retry after a back-off.
+ *
+ * @param scheduler The scheduler.
+ * @param request   The request, not in the multi handle anymore.
+ */
+static void
+request_delay (gvm_http_scheduler_t *scheduler, struct http_request *request)
+{
+  request->retry_at =
+    g_get_monotonic_time () + request_retry_delay (request->attempts);
+  g_queue_insert_sorted (&scheduler->delayed, request,
+                         request_compare_retry_at, NULL);
+}
+
+/**
+ * @brief Starts waiting requests of a host while it has free slots.
+ *
+ * Requests which cannot be added to the multi handle are finished by the
+ * next gvm_http_scheduler_perform(), not here, as this is also called from
+ * gvm_http_scheduler_submit().
+ *
+ * @param scheduler The scheduler.
+ * @param host      The host.
+ */
+static void
+host_start_waiting (gvm_http_scheduler_t *scheduler, struct http_host *host)
+{
+  while (host->active < scheduler->max_per_host)
+    {
+      struct http_request *request = g_queue_pop_head (&host->waiting);
+
+      if (request == NULL)
+        return;
+
+      request->attempts++;
+      if (gvm_http_multi_add_handler (scheduler->multi, request->http)
+          != GVM_HTTP_OK)
+        {
+          g_warning ("%s: Failed to add request to multi handle", __func__);
+          g_queue_push_tail (&scheduler->failed, request);
+          continue;
+        }
+      host->active++;
+      g_hash_table_add (scheduler->active, request);
+    }
+}
+
+/**
+ * @brief Queues the requests whose back-off is over on their hosts.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return Milliseconds until the next retry is due, -1 if there is none.
+ */
+static int
+scheduler_start_delayed (gvm_http_scheduler_t *scheduler)
+{
+  struct http_request *request;
+  gint64 now = g_get_monotonic_time ();
+
+  while ((request = g_queue_peek_head (&scheduler->delayed)))
+    {
+      if (request->retry_at > now)
+        return (request->retry_at - now + 999) / 1000;
+
+      g_queue_pop_head (&scheduler->delayed);
+      g_queue_push_tail (&request->host->waiting, request);
+      host_start_waiting (scheduler, request->host);
+    }
+
+  return -1;
+}
+
+/**
+ * @brief Finishes the requests which could not be started.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return FALSE if a callback freed the scheduler, which is gone then.
+ */
+static gboolean
+scheduler_finish_failed (gvm_http_scheduler_t *scheduler)
+{
+  struct http_request *request;
+
+  while ((request = g_queue_pop_head (&scheduler->failed)))
+    if (!request_finish (scheduler, request, CURLE_FAILED_INIT))
+      return FALSE;
+
+  return TRUE;
+}
+
+/**
+ * @brief Creates a request scheduler.
+ *
+ * @param max_per_host  Maximum number of concurrent requests per host,
+ *                      GVM_HTTP_SCHEDULER_MAX_PER_HOST if not positive.
+ * @param timeout_ms    Timeout of each attempt in milliseconds,
+ *                      GVM_HTTP_SCHEDULER_TIMEOUT if not positive.
+ * @param retries       Number of retries after a failed attempt.
+ *
+ * @return The scheduler, NULL on error. Must be freed with
+ *         `gvm_http_scheduler_free()`.
+ */
+gvm_http_scheduler_t *
+gvm_http_scheduler_new (int max_per_host, long timeout_ms, int retries)
+{
+  gvm_http_scheduler_t *scheduler;
+  gvm_http_multi_t *multi = gvm_http_multi_new ();
+
+  if (!multi->handler)
+    {
+      g_warning ("%s: Failed to initialize curl multi-handle", __func__);
+      gvm_http_headers_free (multi->headers);
+      g_free (multi);
+      return NULL;
+    }
+
+  scheduler = g_malloc0 (sizeof (gvm_http_scheduler_t));
+  scheduler->multi = multi;
+  scheduler->hosts =
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, http_host_free);
+  scheduler->active = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_queue_init (&scheduler->delayed);
+  g_queue_init (&scheduler->failed);
+  scheduler->max_per_host =
+    max_per_host > 0 ? max_per_host : GVM_HTTP_SCHEDULER_MAX_PER_HOST;
+  scheduler->timeout_ms = timeout_ms > 0 ? timeout_ms
+                                         : GVM_HTTP_SCHEDULER_TIMEOUT;
+  scheduler->retries = MAX (retries, 0);
+
+  return scheduler;
+}
+
+/**
+ * @brief Frees a request scheduler and its requests.
+ *
+ * @param scheduler The scheduler.
+ */
+static void
+scheduler_destroy (gvm_http_scheduler_t *scheduler)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  g_hash_table_iter_init (&iter, scheduler->active);
+  while (g_hash_table_iter_next (&iter, &value, NULL))
+    {
+      struct http_request *request = value;
+
+      curl_multi_remove_handle (scheduler->multi->handler,
+                                request->http->handler);
+      request_free (request);
+    }
+  while ((value = g_queue_pop_head (&scheduler->delayed)))
+    request_free (value);
+  while ((value = g_queue_pop_head (&scheduler->failed)))
+    request_free (value);
+  g_hash_table_destroy (scheduler->active);
+  g_hash_table_destroy (scheduler->hosts);
+  gvm_http_multi_free (scheduler->multi);
+  g_free (scheduler);
+}
+
+/**
+ * @brief Frees a request scheduler.
+ *
+ * Requests not done yet are dropped without calling their callbacks. When
+ * called from a completion callback, the scheduler is freed as soon as the
+ * callback returns.
+ *
+ * @param scheduler The scheduler. Safe to pass NULL.
+ */
+void
+gvm_http_scheduler_free (gvm_http_scheduler_t *scheduler)
+{
+  if (!scheduler)
+    return;
+
+  if (scheduler->in_callback)
+    {
+      scheduler->freed = TRUE;
+      return;
+    }
+  scheduler_destroy (scheduler);
+}
+
+/**
+ * @brief Submits a request.
+ *
+ * The request is started as soon as its host has a free slot, transfers are
+ * performed by `gvm_http_scheduler_perform()` or `gvm_http_scheduler_run()`.
+ *
+ * @param scheduler     The scheduler.
+ * @param url           The URL to send the request to.
+ * @param method        HTTP method to use (e.g., GET, POST, PUT, DELETE).
+ * @param payload       Optional request payload, copied.
+ * @param headers       Optional custom headers, copied.
+ * @param ca_cert       Optional CA certificate for server verification.
+ * @param client_cert   Optional client certificate for mutual TLS.
+ * @param client_key    Optional client private key for mutual TLS.
+ * @param done          Optional function called when the request is done.
+ *                      It is called from `gvm_http_scheduler_perform()`,
+ *                      never from this function, also if the request could
+ *                      not be started. It may submit further requests or
+ *                      free the scheduler.
+ * @param user_data     Data passed to done.
+ *
+ * @return TRUE if the request was submitted, FALSE on error.
+ */
+gboolean
+gvm_http_scheduler_submit (gvm_http_scheduler_t *scheduler, const gchar *url,
+                           gvm_http_method_t method, const gchar *payload,
+                           gvm_http_headers_t *headers, const gchar *ca_cert,
+                           const gchar *client_cert, const gchar *client_key,
+                           gvm_http_done_func_t done, gpointer user_data)
+{
+  struct http_request *request;
+  struct http_host *host;
+  gchar *host_key;
+
+  if (!scheduler || !url)
+    return FALSE;
+
+  host_key = request_host (url);
+  if (!host_key)
+    {
+      g_warning ("%s: Invalid URL %s", __func__, url);
+      return FALSE;
+    }
+
+  request = g_malloc0 (sizeof (struct http_request));
+  request->payload = g_strdup (payload);
+  request->headers = request_headers_copy (headers);
+  request->http = gvm_http_new (url, method, request->payload,
+                                request->headers, ca_cert, client_cert,
+                                client_key, &request->stream);
+  if (!request->http)
+    {
+      g_free (host_key);
+      request_free (request);
+      return FALSE;
+    }
+  curl_easy_setopt (request->http->handler, CURLOPT_PRIVATE, request);
+  curl_easy_setopt (request->http->handler, CURLOPT_TIMEOUT_MS,
+                    scheduler->timeout_ms);
+  request->done = done;
+  request->user_data = user_data;
+
+  host = g_hash_table_lookup (scheduler->hosts, host_key);
+  if (host)
+    g_free (host_key);
+  else
+    {
+      host = g_malloc0 (sizeof (struct http_host));
+      g_queue_init (&host->waiting);
+      g_hash_table_insert (scheduler->hosts, host_key, host);
+    }
+  request->host = host;
+
+  scheduler->pending++;
+  g_queue_push_tail (&host->waiting, request);
+  host_start_waiting (scheduler, host);
+
+  return TRUE;
+}
+
+/**
+ * @brief Performs the transfers and waits for activity once.
+ *
+ * Callbacks of finished requests are called from this function. They must
+ * not call it or `gvm_http_scheduler_run()` again.
+ *
+ * @param scheduler The scheduler.
+ * @param wait_ms   Maximum time to wait for activity in milliseconds.
+ *
+ * @return Number of requests not done yet, 0 if a callback freed the
+ *         scheduler, -1 on error.
+ */
+int
+gvm_http_scheduler_perform (gvm_http_scheduler_t *scheduler, int wait_ms)
+{
+  int running = 0, queued, next_retry_ms;
+  CURLMsg *msg;
+
+  if (!scheduler)
+    return -1;
+
+  scheduler_start_delayed (scheduler);
+  if (!scheduler_finish_failed (scheduler))
+    return 0;
+  if (gvm_http_multi_perform (scheduler->multi, &running) != GVM_HTTP_OK)
+    return -1;
+
+  while ((msg = curl_multi_info_read (scheduler->multi->handler, &queued)))
+    {
+      struct http_request *request = NULL;
+      CURL *easy_handle = msg->easy_handle;
+      CURLcode result = msg->data.result;
+
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      curl_easy_getinfo (easy_handle, CURLINFO_PRIVATE, (char **) &request);
+      gvm_http_stats_record (easy_handle, result);
+      curl_multi_remove_handle (scheduler->multi->handler, easy_handle);
+      g_hash_table_remove (scheduler->active, request);
+      request->host->active--;
+
+      if (request_retry (scheduler, request, result))
+        {
+          g_debug ("%s: Retrying request, attempt %d failed", __func__,
+                   request->attempts);
+          gvm_http_response_stream_reset (&request->stream);
+          request_delay (scheduler, request);
+          host_start_waiting (scheduler, request->host);
+        }
+      else
+        {
+          struct http_host *host = request->host;
+
+          if (!request_finish (scheduler, request, result))
+            return 0;
+          host_start_waiting (scheduler, host);
+        }
+    }
+
+  /* Wake up in time for the next retry. */
+  next_retry_ms = scheduler_start_delayed (scheduler);
+  if (!scheduler_finish_failed (scheduler))
+    return 0;
+  if (next_retry_ms >= 0 && next_retry_ms < wait_ms)
+    wait_ms = MAX (next_retry_ms, 1);
+
+  if (scheduler->pending > 0 && wait_ms > 0)
+    {
+      CURLMcode poll_result = curl_multi_poll (scheduler->multi->handler, NULL,
+                                               0, wait_ms, NULL);
+      if (poll_result != CURLM_OK)
+        {
+          g_warning ("%s: error on curl_multi_poll(): %d", __func__,
+                     poll_result);
+          return -1;
+        }
+    }
+
+  return scheduler->pending;
+}
+
+/**
+ * @brief Performs the transfers until all requests are done.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return 0 when all requests are done, -1 on error.
+ */
+int
+gvm_http_scheduler_run (gvm_http_scheduler_t *scheduler)
+{
+  int pending;
+
+  while ((pending = gvm_http_scheduler_perform (scheduler, 1000)) > 0)
+    ;
+
+  return pending;
+}
+
+/**
+ * @brief Gets the number of submitted requests not done yet.
+ *
+ * @param scheduler The scheduler.
+ *
+ * @return Number of requests not done yet.
+ */
+guint
+gvm_http_scheduler_pending (gvm_http_scheduler_t *scheduler)
+{
+  return scheduler ? scheduler->pending : 0;
+}
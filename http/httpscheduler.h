@@ -0,0 +1,79 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file httpscheduler.h
+ * @brief Concurrent HTTP(S) requests driven by one gvm_http_multi_t.
+ *
+ * Many requests, e.g. to dozens of openvasd instances and agent controllers,
+ * are submitted with a completion callback and performed concurrently from a
+ * single curl_multi_poll() loop. The number of requests running at the same
+ * time per host is limited, every attempt has a timeout and failed attempts
+ * are retried after a back-off.
+ */
+
+#ifndef HTTPSCHEDULER_H
+#define HTTPSCHEDULER_H
+
+#include "httputils.h"
+
+#include <glib.h>
+
+/**
+ * @brief Default number of concurrent requests per host.
+ */
+#define GVM_HTTP_SCHEDULER_MAX_PER_HOST 4
+
+/**
+ * @brief Default timeout of a request attempt in milliseconds.
+ */
+#define GVM_HTTP_SCHEDULER_TIMEOUT 30000
+
+/**
+ * @brief Back-off before the first retry of a failed attempt in milliseconds.
+ */
+#define GVM_HTTP_SCHEDULER_RETRY_DELAY 100
+
+/**
+ * @brief Maximum back-off before a retry in milliseconds.
+ */
+#define GVM_HTTP_SCHEDULER_MAX_RETRY_DELAY 5000
+
+/**
+ * @brief Function called when a request is done.
+ *
+ * The response has no `http` handle. Its status is -1 if all attempts
+ * failed. It is freed after the call, the function can take over the data
+ * by setting it to NULL. The function is called from
+ * `gvm_http_scheduler_perform()` only. It may submit requests and free the
+ * scheduler, but must not perform it.
+ */
+typedef void (*gvm_http_done_func_t) (gvm_http_response_t *, gpointer);
+
+typedef struct gvm_http_scheduler gvm_http_scheduler_t;
+
+gvm_http_scheduler_t *
+gvm_http_scheduler_new (int max_per_host, long timeout_ms, int retries);
+
+void
+gvm_http_scheduler_free (gvm_http_scheduler_t *scheduler);
+
+gboolean
+gvm_http_scheduler_submit (gvm_http_scheduler_t *scheduler, const gchar *url,
+                           gvm_http_method_t method, const gchar *payload,
+                           gvm_http_headers_t *headers, const gchar *ca_cert,
+                           const gchar *client_cert, const gchar *client_key,
+                           gvm_http_done_func_t done, gpointer user_data);
+
+int
+gvm_http_scheduler_perform (gvm_http_scheduler_t *scheduler, int wait_ms);
+
+int
+gvm_http_scheduler_run (gvm_http_scheduler_t *scheduler);
+
+guint
+gvm_http_scheduler_pending (gvm_http_scheduler_t *scheduler);
+
+#endif // HTTPSCHEDULER_H
@@ -0,0 +1,279 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "httpscheduler.c"
+
+#include <cgreen/cgreen.h>
+
+Describe (gvm_http_scheduler);
+
+BeforeEach (gvm_http_scheduler)
+{
+}
+
+AfterEach (gvm_http_scheduler)
+{
+}
+
+/* Nothing listens on port 1, so every attempt fails at once. */
+#define REFUSED_URL "http://127.0.0.1:1/"
+
+struct done_result
+{
+  int calls;
+  long status;
+  gchar *data;
+};
+
+static void
+collect_done (gvm_http_response_t *response, gpointer user_data)
+{
+  struct done_result *result = user_data;
+
+  result->calls++;
+  result->status = response->http_status;
+  g_free (result->data);
+  result->data = response->data;
+  response->data = NULL;
+}
+
+Ensure (gvm_http_scheduler, request_host_includes_default_port)
+{
+  gchar *host;
+
+  host = request_host ("https://localhost:8443/scans");
+  assert_that (host, is_equal_to_string ("localhost:8443"));
+  g_free (host);
+
+  host = request_host ("http://example.org/health/alive");
+  assert_that (host, is_equal_to_string ("example.org:80"));
+  g_free (host);
+
+  assert_that (request_host ("not a url"), is_null);
+}
+
+Ensure (gvm_http_scheduler, submit_limits_requests_per_host)
+{
+  gvm_http_scheduler_t *scheduler;
+  struct http_host *host;
+  struct done_result result = {0};
+
+  scheduler = gvm_http_scheduler_new (1, 5000, 0);
+  for (int i = 0; i < 3; i++)
+    assert_that (gvm_http_scheduler_submit (scheduler, REFUSED_URL, GET, NULL,
+                                            NULL, NULL, NULL, NULL,
+                                            collect_done, &result),
+                 is_true);
+  assert_that (gvm_http_scheduler_submit (scheduler, "http://127.0.0.2:1/",
+                                          GET, NULL, NULL, NULL, NULL, NULL,
+                                          collect_done, &result),
+               is_true);
+
+  assert_that (gvm_http_scheduler_pending (scheduler), is_equal_to (4));
+  assert_that (g_hash_table_size (scheduler->active), is_equal_to (2));
+  host = g_hash_table_lookup (scheduler->hosts, "127.0.0.1:1");
+  assert_that (host, is_not_null);
+  assert_that (host->active, is_equal_to (1));
+  assert_that (g_queue_get_length (&host->waiting), is_equal_to (2));
+
+  /* Pending requests are dropped without calling the callback. */
+  gvm_http_scheduler_free (scheduler);
+  assert_that (result.calls, is_equal_to (0));
+}
+
+Ensure (gvm_http_scheduler, run_calls_callbacks_after_retries)
+{
+  gvm_http_scheduler_t *scheduler;
+  struct done_result results[3] = {{0}};
+  gvm_http_headers_t *headers;
+
+  headers = gvm_http_headers_new ();
+  gvm_http_add_header (headers, "Content-Type: application/json");
+  scheduler = gvm_http_scheduler_new (2, 5000, 2);
+  for (int i = 0; i < 3; i++)
+    gvm_http_scheduler_submit (scheduler, REFUSED_URL, POST, "{}", headers,
+                               NULL, NULL, NULL, collect_done, &results[i]);
+  /* The scheduler has its own copy of the headers. */
+  gvm_http_headers_free (headers);
+
+  assert_that (gvm_http_scheduler_run (scheduler), is_equal_to (0));
+  assert_that (gvm_http_scheduler_pending (scheduler), is_equal_to (0));
+  for (int i = 0; i < 3; i++)
+    {
+      assert_that (results[i].calls, is_equal_to (1));
+      assert_that (results[i].status, is_equal_to (-1));
+      assert_that (results[i].data, contains_string ("CURL request failed"));
+      g_free (results[i].data);
+    }
+
+  gvm_http_scheduler_free (scheduler);
+}
+
+Ensure (gvm_http_scheduler, retries_back_off_exponentially)
+{
+  gvm_http_scheduler_t *scheduler;
+  struct done_result result = {0};
+  gint64 start;
+
+  scheduler = gvm_http_scheduler_new (1, 5000, 2);
+  gvm_http_scheduler_submit (scheduler, REFUSED_URL, GET, NULL, NULL, NULL,
+                             NULL, NULL, collect_done, &result);
+
+  start = g_get_monotonic_time ();
+  assert_that (gvm_http_scheduler_run (scheduler), is_equal_to (0));
+  /* The second attempt waits for the delay, the third for twice the delay. */
+  assert_that (g_get_monotonic_time () - start,
+               is_greater_than (3 * GVM_HTTP_SCHEDULER_RETRY_DELAY * 1000 - 1));
+  assert_that (result.calls, is_equal_to (1));
+  assert_that (result.status, is_equal_to (-1));
+  g_free (result.data);
+
+  gvm_http_scheduler_free (scheduler);
+}
+
+static gvm_http_scheduler_t *follow_up_scheduler;
+
+static void
+submit_follow_up (gvm_http_response_t *response, gpointer user_data)
+{
+  struct done_result *result = user_data;
+
+  collect_done (response, user_data);
+  if (result->calls < 3)
+    gvm_http_scheduler_submit (follow_up_scheduler, REFUSED_URL, GET, NULL,
+                               NULL, NULL, NULL, NULL, submit_follow_up,
+                               result);
+}
+
+Ensure (gvm_http_scheduler, callback_can_submit_requests)
+{
+  struct done_result result = {0};
+
+  follow_up_scheduler = gvm_http_scheduler_new (0, 0, -1);
+  assert_that (follow_up_scheduler->max_per_host,
+               is_equal_to (GVM_HTTP_SCHEDULER_MAX_PER_HOST));
+  assert_that (follow_up_scheduler->timeout_ms,
+               is_equal_to (GVM_HTTP_SCHEDULER_TIMEOUT));
+  assert_that (follow_up_scheduler->retries, is_equal_to (0));
+
+  gvm_http_scheduler_submit (follow_up_scheduler, REFUSED_URL, GET, NULL,
+                             NULL, NULL, NULL, NULL, submit_follow_up,
+                             &result);
+  while (gvm_http_scheduler_perform (follow_up_scheduler, 100) > 0)
+    ;
+  assert_that (result.calls, is_equal_to (3));
+  assert_that (result.status, is_equal_to (-1));
+
+  g_free (result.data);
+  gvm_http_scheduler_free (follow_up_scheduler);
+}
+
+Ensure (gvm_http_scheduler, failed_start_is_finished_by_perform)
+{
+  gvm_http_scheduler_t *scheduler;
+  struct http_host *host;
+  struct http_request *request;
+  struct done_result result = {0};
+
+  scheduler = gvm_http_scheduler_new (1, 5000, 0);
+  for (int i = 0; i < 2; i++)
+    gvm_http_scheduler_submit (scheduler, REFUSED_URL, GET, NULL, NULL, NULL,
+                               NULL, NULL, collect_done, &result);
+  host = g_hash_table_lookup (scheduler->hosts, "127.0.0.1:1");
+  request = g_queue_peek_head (&host->waiting);
+
+  /* A handle already in the multi handle cannot be added again. */
+  curl_multi_add_handle (scheduler->multi->handler, request->http->handler);
+  scheduler->max_per_host = 2;
+  host_start_waiting (scheduler, host);
+  curl_multi_remove_handle (scheduler->multi->handler, request->http->handler);
+
+  assert_that (result.calls, is_equal_to (0));
+  assert_that (g_queue_get_length (&scheduler->failed), is_equal_to (1));
+
+  assert_that (gvm_http_scheduler_run (scheduler), is_equal_to (0));
+  assert_that (result.calls, is_equal_to (2));
+  assert_that (result.status, is_equal_to (-1));
+  g_free (result.data);
+
+  gvm_http_scheduler_free (scheduler);
+}
+
+static void
+free_scheduler (gvm_http_response_t *response, gpointer user_data)
+{
+  struct done_result *result = user_data;
+
+  collect_done (response, user_data);
+  if (result->calls == 1)
+    gvm_http_scheduler_free (follow_up_scheduler);
+}
+
+Ensure (gvm_http_scheduler, callback_can_free_scheduler)
+{
+  struct done_result result = {0};
+
+  follow_up_scheduler = gvm_http_scheduler_new (2, 5000, 0);
+  for (int i = 0; i < 2; i++)
+    gvm_http_scheduler_submit (follow_up_scheduler, REFUSED_URL, GET, NULL,
+                               NULL, NULL, NULL, NULL, free_scheduler,
+                               &result);
+
+  /* The other request is dropped with the scheduler. */
+  assert_that (gvm_http_scheduler_run (follow_up_scheduler), is_equal_to (0));
+  assert_that (result.calls, is_equal_to (1));
+  assert_that (result.status, is_equal_to (-1));
+  g_free (result.data);
+}
+
+Ensure (gvm_http_scheduler, functions_handle_null_safely)
+{
+  gvm_http_scheduler_t *scheduler;
+
+  assert_that (gvm_http_scheduler_submit (NULL, REFUSED_URL, GET, NULL, NULL,
+                                          NULL, NULL, NULL, NULL, NULL),
+               is_false);
+  assert_that (gvm_http_scheduler_perform (NULL, 0), is_equal_to (-1));
+  assert_that (gvm_http_scheduler_run (NULL), is_equal_to (-1));
+  assert_that (gvm_http_scheduler_pending (NULL), is_equal_to (0));
+  gvm_http_scheduler_free (NULL);
+
+  scheduler = gvm_http_scheduler_new (1, 1000, 0);
+  assert_that (gvm_http_scheduler_submit (scheduler, "not a url", GET, NULL,
+                                          NULL, NULL, NULL, NULL, NULL, NULL),
+               is_false);
+  assert_that (gvm_http_scheduler_pending (scheduler), is_equal_to (0));
+  gvm_http_scheduler_free (scheduler);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, gvm_http_scheduler,
+                         request_host_includes_default_port);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         submit_limits_requests_per_host);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         run_calls_callbacks_after_retries);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         retries_back_off_exponentially);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         callback_can_submit_requests);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         failed_start_is_finished_by_perform);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         callback_can_free_scheduler);
+  add_test_with_context (suite, gvm_http_scheduler,
+                         functions_handle_null_safely);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
@@ -0,0 +1,286 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file httpstats.c
+ * @brief Timing and transfer statistics of HTTP(S) requests.
+ *
+ * Every request performed by the HTTP utilities is recorded when it is done.
+ * The phase times are derived from the cumulative times libcurl reports since
+ * the start of the request. Times of phases skipped because a connection was
+ * reused, or because TLS is not used, are recorded as 0.
+ *
+ * IDs in the path, e.g. of scans or agents, are replaced by "{id}", so that
+ * the requests to an endpoint are aggregated independently of the resource.
+ */
+
+#include "httpstats.h"
+
+#include <string.h>
+
+#undef G_LOG_DOMAIN
+/**
+ * @brief GLib logging domain.
+ */
+#define G_LOG_DOMAIN "libgvm util"
+
+G_LOCK_DEFINE_STATIC (http_stats);
+
+/**
+ * @brief Statistics per endpoint path.
+ */
+static GHashTable *http_stats = NULL;
+
+/**
+ * @brief Checks whether a path segment is an ID.
+ *
+ * @param segment The segment.
+ *
+ * @return TRUE if the segment is a number or a UUID, FALSE otherwise.
+ */
+static gboolean
+path_segment_is_id (const gchar *segment)
+{
+  size_t len = strlen (segment);
+
+  if (len == 0)
+    return FALSE;
+  if (strspn (segment, "0123456789") == len)
+    return TRUE;
+  return len == 36 && strspn (segment, "0123456789abcdefABCDEF-") == len
+         && segment[8] == '-' && segment[13] == '-' && segment[18] == '-'
+         && segment[23] == '-';
+}
+
+/**
+ * @brief Gets the endpoint path of a URL.
+ *
+ * @param url The URL.
+ *
+ * @return The path without query, with IDs replaced by "{id}". Must be freed.
+ */
+static gchar *
+http_stats_path (const gchar *url)
+{
+  CURLU *curl_url_handle = curl_url ();
+  char *path = NULL;
+  gchar **segments, *endpoint;
+
+  if (curl_url_handle == NULL || url == NULL
+      || curl_url_set (curl_url_handle, CURLUPART_URL, url, 0) != CURLUE_OK
+      || curl_url_get (curl_url_handle, CURLUPART_PATH, &path, 0)
+           != CURLUE_OK)
+    {
+      curl_url_cleanup (curl_url_handle);
+      return g_strdup ("*");
+    }
+
+  segments = g_strsplit (path, "/", -1);
+  for (int i = 0; segments[i]; i++)
+    if (path_segment_is_id (segments[i]))
+      {
+        g_free (segments[i]);
+        segments[i] = g_strdup ("{id}");
+      }
+  endpoint = g_strjoinv ("/", segments);
+
+  g_strfreev (segments);
+  curl_free (path);
+  curl_url_cleanup (curl_url_handle);
+  return endpoint;
+}
+
+/**
+ * @brief Adds a value to a histogram.
+ *
+ * @param histogram The histogram.
+ * @param value     Time in microseconds, negative values are taken as 0.
+ */
+static void
+histogram_add (gvm_http_histogram_t *histogram, curl_off_t value)
+{
+  guint64 us = value > 0 ? (guint64) value : 0;
+  int bucket = 0;
+
+  while (us >> bucket && bucket < GVM_HTTP_HISTOGRAM_BUCKETS - 1)
+    bucket++;
+
+  histogram->count++;
+  histogram->sum += us;
+  histogram->max = MAX (histogram->max, us);
+  histogram->buckets[bucket]++;
+}
+
+/**
+ * @brief Records a finished request.
+ *
+ * Called for all requests of the HTTP utilities, callers driving their own
+ * curl handles can record them as well.
+ *
+ * @param handler The curl easy handle of the request.
+ * @param result  Result of the request.
+ */
+void
+gvm_http_stats_record (CURL *handler, CURLcode result)
+{
+  curl_off_t dns = 0, connect = 0, tls = 0, start = 0, total = 0;
+  curl_off_t sent = 0, received = 0;
+  curl_off_t times[GVM_HTTP_PHASE_LAST];
+  gvm_http_stats_t *stats;
+  char *url = NULL;
+  gchar *path;
+
+  if (handler == NULL)
+    return;
+
+  curl_easy_getinfo (handler, CURLINFO_EFFECTIVE_URL, &url);
+  curl_easy_getinfo (handler, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+  curl_easy_getinfo (handler, CURLINFO_CONNECT_TIME_T, &connect);
+  curl_easy_getinfo (handler, CURLINFO_APPCONNECT_TIME_T, &tls);
+  curl_easy_getinfo (handler, CURLINFO_STARTTRANSFER_TIME_T, &start);
+  curl_easy_getinfo (handler, CURLINFO_TOTAL_TIME_T, &total);
+  curl_easy_getinfo (handler, CURLINFO_SIZE_UPLOAD_T, &sent);
+  curl_easy_getinfo (handler, CURLINFO_SIZE_DOWNLOAD_T, &received);
+
+  // The times are cumulative, a later one is 0 if the phase did not happen
+  connect = MAX (connect, dns);
+  tls = tls ? MAX (tls, connect) : connect;
+  times[GVM_HTTP_PHASE_DNS] = dns;
+  times[GVM_HTTP_PHASE_CONNECT] = connect - dns;
+  times[GVM_HTTP_PHASE_TLS] = tls - connect;
+  times[GVM_HTTP_PHASE_WAIT] = start ? start - tls : 0;
+  times[GVM_HTTP_PHASE_TRANSFER] = start ? total - start : 0;
+  times[GVM_HTTP_PHASE_TOTAL] = total;
+
+  path = http_stats_path (url);
+
+  G_LOCK (http_stats);
+  if (http_stats == NULL)
+    http_stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                        g_free);
+  stats = g_hash_table_lookup (http_stats, path);
+  if (stats == NULL)
+    {
+      // Keep a slot for "*"
+      if (g_hash_table_size (http_stats) >= GVM_HTTP_STATS_MAX_PATHS - 1)
+        {
+          g_free (path);
+          path = g_strdup ("*");
+          stats = g_hash_table_lookup (http_stats, path);
+        }
+      if (stats == NULL)
+        {
+          stats = g_malloc0 (sizeof (gvm_http_stats_t));
+          g_hash_table_insert (http_stats, path, stats);
+          path = NULL;
+        }
+    }
+
+  stats->requests++;
+  if (result != CURLE_OK)
+    stats->errors++;
+  stats->bytes_sent += MAX (sent, 0);
+  stats->bytes_received += MAX (received, 0);
+  for (int phase = 0; phase < GVM_HTTP_PHASE_LAST; phase++)
+    histogram_add (&stats->phases[phase], times[phase]);
+  G_UNLOCK (http_stats);
+
+  g_free (path);
+}
+
+/**
+ * @brief Gets the statistics of an endpoint.
+ *
+ * @param path       The endpoint path, e.g. "/scans/{id}/status".
+ * @param[out] stats Copy of the statistics.
+ *
+ * @return TRUE if requests to the endpoint were recorded, FALSE otherwise.
+ */
+gboolean
+gvm_http_stats_get (const gchar *path, gvm_http_stats_t *stats)
+{
+  gvm_http_stats_t *found = NULL;
+
+  if (path == NULL || stats == NULL)
+    return FALSE;
+
+  G_LOCK (http_stats);
+  if (http_stats)
+    found = g_hash_table_lookup (http_stats, path);
+  if (found)
+    *stats = *found;
+  G_UNLOCK (http_stats);
+
+  return found != NULL;
+}
+
+/**
+ * @brief Gets the endpoints requests were recorded for.
+ *
+ * @return Sorted list of the paths. Must be freed with
+ *         g_slist_free_full (list, g_free).
+ */
+GSList *
+gvm_http_stats_paths (void)
+{
+  GSList *paths = NULL;
+  GHashTableIter iter;
+  gpointer path;
+
+  G_LOCK (http_stats);
+  if (http_stats)
+    {
+      g_hash_table_iter_init (&iter, http_stats);
+      while (g_hash_table_iter_next (&iter, &path, NULL))
+        paths = g_slist_prepend (paths, g_strdup (path));
+    }
+  G_UNLOCK (http_stats);
+
+  return g_slist_sort (paths, (GCompareFunc) g_strcmp0);
+}
+
+/**
+ * @brief Drops all recorded statistics.
+ */
+void
+gvm_http_stats_reset (void)
+{
+  G_LOCK (http_stats);
+  if (http_stats)
+    g_hash_table_remove_all (http_stats);
+  G_UNLOCK (http_stats);
+}
+
+/**
+ * @brief Estimates a percentile of a histogram.
+ *
+ * @param histogram   The histogram.
+ * @param percentile  The percentile, between 0 and 100.
+ *
+ * @return Upper bound of the bucket holding the percentile in microseconds,
+ *         at most the largest value. 0 if the histogram is empty.
+ */
+guint64
+gvm_http_histogram_percentile (const gvm_http_histogram_t *histogram,
+                               double percentile)
+{
+  guint64 rank, seen = 0;
+
+  if (histogram == NULL || histogram->count == 0)
+    return 0;
+
+  percentile = CLAMP (percentile, 0, 100);
+  rank = MAX ((guint64) (histogram->count * percentile / 100), 1);
+  for (int bucket = 0; bucket < GVM_HTTP_HISTOGRAM_BUCKETS; bucket++)
+    {
+      seen += histogram->buckets[bucket];
+      if (seen >= rank)
+        return bucket ? MIN ((G_GUINT64_CONSTANT (1) << bucket) - 1,
+                             histogram->max)
+                      : 0;
+    }
+
+  return histogram->max;
+}
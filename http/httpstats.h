@@ -0,0 +1,91 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file httpstats.h
+ * @brief Timing and transfer statistics of HTTP(S) requests.
+ *
+ * The time spent in each phase of a request, as reported by libcurl, and the
+ * bytes transferred are aggregated per endpoint path of the URL. Phase times
+ * are kept in histograms, so that e.g. the cost of the TLS handshake can be
+ * told apart from the processing time of the server.
+ */
+
+#ifndef HTTPSTATS_H
+#define HTTPSTATS_H
+
+#include <curl/curl.h>
+#include <glib.h>
+
+/**
+ * @brief Number of histogram buckets.
+ *
+ * Bucket 0 counts times of 0 us, bucket i times of 2^(i-1) to 2^i - 1 us.
+ * The last bucket also counts all longer times.
+ */
+#define GVM_HTTP_HISTOGRAM_BUCKETS 28
+
+/**
+ * @brief Maximum number of endpoints statistics are kept for.
+ *
+ * Requests to further endpoints are counted as endpoint "*".
+ */
+#define GVM_HTTP_STATS_MAX_PATHS 256
+
+/**
+ * @brief Phases of a request.
+ */
+typedef enum
+{
+  GVM_HTTP_PHASE_DNS,      ///< Name lookup (CURLINFO_NAMELOOKUP_TIME_T).
+  GVM_HTTP_PHASE_CONNECT,  ///< TCP connect (CURLINFO_CONNECT_TIME_T).
+  GVM_HTTP_PHASE_TLS,      ///< TLS handshake (CURLINFO_APPCONNECT_TIME_T).
+  GVM_HTTP_PHASE_WAIT,     ///< Until the first byte of the response
+                           ///< (CURLINFO_STARTTRANSFER_TIME_T).
+  GVM_HTTP_PHASE_TRANSFER, ///< Receiving the rest of the response.
+  GVM_HTTP_PHASE_TOTAL,    ///< Whole request (CURLINFO_TOTAL_TIME_T).
+  GVM_HTTP_PHASE_LAST
+} gvm_http_phase_t;
+
+/**
+ * @brief Histogram of times in microseconds.
+ */
+typedef struct
+{
+  guint64 count;                               ///< Number of values.
+  guint64 sum;                                 ///< Sum of all values.
+  guint64 max;                                 ///< Largest value.
+  guint64 buckets[GVM_HTTP_HISTOGRAM_BUCKETS]; ///< Values per bucket.
+} gvm_http_histogram_t;
+
+/**
+ * @brief Statistics of the requests to one endpoint.
+ */
+typedef struct
+{
+  guint64 requests;       ///< Number of requests.
+  guint64 errors;         ///< Requests failing without HTTP response.
+  guint64 bytes_sent;     ///< Bytes of request bodies.
+  guint64 bytes_received; ///< Bytes of response bodies.
+  gvm_http_histogram_t phases[GVM_HTTP_PHASE_LAST]; ///< Time per phase.
+} gvm_http_stats_t;
+
+void
+gvm_http_stats_record (CURL *handler, CURLcode result);
+
+gboolean
+gvm_http_stats_get (const gchar *path, gvm_http_stats_t *stats);
+
+GSList *
+gvm_http_stats_paths (void);
+
+void
+gvm_http_stats_reset (void);
+
+guint64
+gvm_http_histogram_percentile (const gvm_http_histogram_t *histogram,
+                               double percentile);
+
+#endif // HTTPSTATS_H
@@ -0,0 +1,180 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "httpstats.c"
+
+#include <cgreen/cgreen.h>
+
+Describe (gvm_http_stats);
+
+BeforeEach (gvm_http_stats)
+{
+  gvm_http_stats_reset ();
+}
+
+AfterEach (gvm_http_stats)
+{
+}
+
+/* Nothing listens on port 1, so every request fails at once. */
+static void
+perform_refused (const gchar *path)
+{
+  CURL *curl = curl_easy_init ();
+  gchar *url = g_strdup_printf ("http://127.0.0.1:1%s", path);
+
+  curl_easy_setopt (curl, CURLOPT_URL, url);
+  gvm_http_stats_record (curl, curl_easy_perform (curl));
+
+  curl_easy_cleanup (curl);
+  g_free (url);
+}
+
+Ensure (gvm_http_stats, path_replaces_ids)
+{
+  gchar *path;
+
+  path = http_stats_path (
+    "https://localhost:3000/scans/9c6ba6a4-5d29-4a44-8d2c-c2e4e5b8ad9f/status");
+  assert_that (path, is_equal_to_string ("/scans/{id}/status"));
+  g_free (path);
+
+  path = http_stats_path ("https://localhost/scans/42/results?range=0-99");
+  assert_that (path, is_equal_to_string ("/scans/{id}/results"));
+  g_free (path);
+
+  path = http_stats_path ("https://localhost/vts");
+  assert_that (path, is_equal_to_string ("/vts"));
+  g_free (path);
+
+  path = http_stats_path ("not a url");
+  assert_that (path, is_equal_to_string ("*"));
+  g_free (path);
+
+  assert_that (path_segment_is_id ("9c6ba6a4-5d29-4a44-8d2c-c2e4e5b8ad9f"),
+               is_true);
+  assert_that (path_segment_is_id ("scans"), is_false);
+  assert_that (path_segment_is_id (""), is_false);
+}
+
+Ensure (gvm_http_stats, histogram_counts_powers_of_two)
+{
+  gvm_http_histogram_t histogram = {0};
+
+  histogram_add (&histogram, 0);
+  histogram_add (&histogram, 1);
+  histogram_add (&histogram, 3);
+  histogram_add (&histogram, 4);
+  histogram_add (&histogram, -5);
+  histogram_add (&histogram, G_MAXINT64);
+
+  assert_that (histogram.count, is_equal_to (6));
+  assert_that (histogram.buckets[0], is_equal_to (2));
+  assert_that (histogram.buckets[1], is_equal_to (1));
+  assert_that (histogram.buckets[2], is_equal_to (1));
+  assert_that (histogram.buckets[3], is_equal_to (1));
+  assert_that (histogram.buckets[GVM_HTTP_HISTOGRAM_BUCKETS - 1],
+               is_equal_to (1));
+}
+
+Ensure (gvm_http_stats, percentile_returns_bucket_upper_bound)
+{
+  gvm_http_histogram_t histogram = {0};
+
+  assert_that (gvm_http_histogram_percentile (&histogram, 50), is_equal_to (0));
+  assert_that (gvm_http_histogram_percentile (NULL, 50), is_equal_to (0));
+
+  for (int i = 0; i < 90; i++)
+    histogram_add (&histogram, 100);
+  for (int i = 0; i < 10; i++)
+    histogram_add (&histogram, 5000);
+
+  assert_that (gvm_http_histogram_percentile (&histogram, 50),
+               is_equal_to (127));
+  assert_that (gvm_http_histogram_percentile (&histogram, 90),
+               is_equal_to (127));
+  assert_that (gvm_http_histogram_percentile (&histogram, 99),
+               is_equal_to (5000));
+  assert_that (gvm_http_histogram_percentile (&histogram, 0),
+               is_equal_to (127));
+}
+
+Ensure (gvm_http_stats, record_aggregates_per_endpoint)
+{
+  gvm_http_stats_t stats;
+  GSList *paths;
+
+  perform_refused ("/scans/1/status");
+  perform_refused ("/scans/2/status");
+  perform_refused ("/vts");
+
+  assert_that (gvm_http_stats_get ("/scans/{id}/status", &stats), is_true);
+  assert_that (stats.requests, is_equal_to (2));
+  assert_that (stats.errors, is_equal_to (2));
+  assert_that (stats.bytes_received, is_equal_to (0));
+  for (int phase = 0; phase < GVM_HTTP_PHASE_LAST; phase++)
+    assert_that (stats.phases[phase].count, is_equal_to (2));
+  assert_that (stats.phases[GVM_HTTP_PHASE_TLS].max, is_equal_to (0));
+
+  paths = gvm_http_stats_paths ();
+  assert_that (g_slist_length (paths), is_equal_to (2));
+  assert_that (paths->data, is_equal_to_string ("/scans/{id}/status"));
+  assert_that (paths->next->data, is_equal_to_string ("/vts"));
+  g_slist_free_full (paths, g_free);
+
+  gvm_http_stats_reset ();
+  assert_that (gvm_http_stats_get ("/vts", &stats), is_false);
+  assert_that (gvm_http_stats_paths (), is_null);
+}
+
+Ensure (gvm_http_stats, record_limits_number_of_endpoints)
+{
+  gvm_http_stats_t stats;
+
+  for (int i = 0; i < GVM_HTTP_STATS_MAX_PATHS + 2; i++)
+    {
+      gchar *path = g_strdup_printf ("/endpoint%d", i);
+
+      perform_refused (path);
+      g_free (path);
+    }
+
+  assert_that (gvm_http_stats_get ("/endpoint0", &stats), is_true);
+  assert_that (gvm_http_stats_get ("*", &stats), is_true);
+  assert_that (stats.requests, is_equal_to (3));
+  assert_that (g_hash_table_size (http_stats),
+               is_equal_to (GVM_HTTP_STATS_MAX_PATHS));
+}
+
+Ensure (gvm_http_stats, functions_handle_null_safely)
+{
+  gvm_http_stats_t stats;
+
+  gvm_http_stats_record (NULL, CURLE_OK);
+  assert_that (gvm_http_stats_get (NULL, &stats), is_false);
+  assert_that (gvm_http_stats_get ("/vts", NULL), is_false);
+}
+
+int
+main (int argc, char **argv)
+{
+  TestSuite *suite;
+
+  suite = create_test_suite ();
+
+  add_test_with_context (suite, gvm_http_stats, path_replaces_ids);
+  add_test_with_context (suite, gvm_http_stats, histogram_counts_powers_of_two);
+  add_test_with_context (suite, gvm_http_stats,
+                         percentile_returns_bucket_upper_bound);
+  add_test_with_context (suite, gvm_http_stats, record_aggregates_per_endpoint);
+  add_test_with_context (suite, gvm_http_stats,
+                         record_limits_number_of_endpoints);
+  add_test_with_context (suite, gvm_http_stats, functions_handle_null_safely);
+
+  if (argc > 1)
+    return run_single_test (suite, argv[1], create_text_reporter ());
+
+  return run_test_suite (suite, create_text_reporter ());
+}
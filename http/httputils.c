@@ -14,17 +14,37 @@
  * - Custom HTTP methods, headers, and payloads.
  * - SSL/TLS configuration (CA certificates, client certs, private keys).
  * - Response buffering through a write callback.
+ * - Compressed transfers (gzip, zstd, br responses and gzip request bodies).
+ * - Timing and transfer statistics per endpoint (see httpstats.h).
  * - Encapsulation of libcurl handles in domain-specific types (e.g., gvm_http_t).
  */
 
 #include "httputils.h"
 
+#include "../util/compressutils.h"
+#include "httpstats.h"
+
+#include <malloc.h> /* for malloc_usable_size */
+
 #undef G_LOG_DOMAIN
 /**
  * @brief GLib logging domain.
  */
 #define G_LOG_DOMAIN "libgvm util"
 
+/**
+ * @brief Initial size of a response data buffer.
+ */
+#define RESPONSE_BUFFER_MIN 4096
+
+/**
+ * @brief Largest buffer allocated up front for an announced Content-Length.
+ */
+#define RESPONSE_PREALLOC_MAX (256 * 1024 * 1024)
+
+static void
+orphaned_shares_free (void);
+
 /**
  * @brief Allocate gvm http multi handler
  *
@@ -36,6 +56,55 @@ gvm_http_multi_t_new (void)
   return (gvm_http_multi_t *) g_malloc0 (sizeof (struct gvm_http_multi));
 }
 
+/**
+ * @brief Makes room for data in a response stream.
+ *
+ * The buffer grows geometrically, so that appending many chunks costs linear
+ * time. Its size is taken from the allocator, which g_malloc() is the system
+ * one for, so that buffers set from outside can be grown as well.
+ *
+ * @param stream The response stream.
+ * @param needed Number of bytes the buffer must hold, including the NUL.
+ *
+ * @return TRUE on success, FALSE if the buffer could not be grown.
+ */
+static gboolean
+response_stream_reserve (gvm_http_response_stream_t stream, size_t needed)
+{
+  size_t allocated = stream->data ? malloc_usable_size (stream->data) : 0;
+  gchar *temp_ptr;
+
+  if (needed <= allocated)
+    return TRUE;
+
+  allocated = MAX (allocated * 2, RESPONSE_BUFFER_MIN);
+  while (allocated < needed)
+    allocated *= 2;
+  temp_ptr = g_try_realloc (stream->data, allocated);
+  if (!temp_ptr)
+    return FALSE;
+
+  stream->data = temp_ptr;
+  return TRUE;
+}
+
+/**
+ * @brief Moves the data out of a response stream.
+ *
+ * @param stream The response stream, left empty.
+ *
+ * @return The data, NUL terminated, or NULL if there is none.
+ */
+static gchar *
+response_stream_steal (gvm_http_response_stream_t stream)
+{
+  gchar *data = stream->data;
+
+  stream->data = NULL;
+  stream->length = 0;
+  return data;
+}
+
 /**
  * @brief Callback function to store the response.
  *
@@ -52,12 +121,10 @@ store_response_data (void *ptr, size_t size, size_t nmemb, void *userdata)
 {
   gvm_http_response_stream_t stream = userdata;
   size_t new_len = stream->length + size * nmemb;
-  gchar *temp_ptr = g_realloc (stream->data, new_len + 1);
 
-  if (!temp_ptr)
+  if (!response_stream_reserve (stream, new_len + 1))
     return 0;
 
-  stream->data = temp_ptr;
   memcpy (stream->data + stream->length, ptr, size * nmemb);
   stream->data [new_len] = '\0';
   stream->length = new_len;
@@ -65,6 +132,40 @@ store_response_data (void *ptr, size_t size, size_t nmemb, void *userdata)
   return size * nmemb;
 }
 
+/**
+ * @brief Callback function to preallocate the response for its Content-Length.
+ *
+ * @param buffer Pointer to the header line, not NUL terminated.
+ * @param size Always 1.
+ * @param nitems Length of the header line.
+ * @param userdata Pointer to the response stream.
+ *
+ * @return The number of bytes actually handled.
+ */
+static size_t
+store_response_header (char *buffer, size_t size, size_t nitems,
+                       void *userdata)
+{
+  static const char name[] = "Content-Length:";
+  gvm_http_response_stream_t stream = userdata;
+  size_t len = size * nitems;
+
+  if (stream && len > sizeof (name) - 1 && len < 64
+      && g_ascii_strncasecmp (buffer, name, sizeof (name) - 1) == 0)
+    {
+      gchar value[64];
+      guint64 content_length;
+
+      memcpy (value, buffer + sizeof (name) - 1, len - sizeof (name) + 1);
+      value[len - sizeof (name) + 1] = '\0';
+      content_length = g_ascii_strtoull (g_strstrip (value), NULL, 10);
+      if (content_length > 0 && content_length <= RESPONSE_PREALLOC_MAX)
+        response_stream_reserve (stream, stream->length + content_length + 1);
+    }
+
+  return len;
+}
+
 /**
  * @brief Allocates and initializes a gvm_http_t structure with a given CURL handle.
  *
@@ -96,52 +197,24 @@ gvm_http_free (gvm_http_t *http)
   if (http->handler)
     curl_easy_cleanup (http->handler);
   g_free (http);
+  // The handle may have been the last one using the share of a freed client
+  orphaned_shares_free ();
 }
 
 /**
- * @brief Initializes and configures a gvm_http_t object for an HTTP(S) request.
- *
- * This function creates and configures a gvm_http_t structure, encapsulating
- * a libcurl easy handle. It sets the target URL, HTTP method, optional headers,
- * payload, and SSL/TLS credentials (CA certificate, client certificate, and private key).
- * It also registers a write callback to store the server's response into a
- * provided response stream buffer.
+ * @brief Sets the SSL/TLS options of a CURL handle.
  *
- * Note: The returned object must be cleaned up by the caller using
- * `gvm_http_free()` to free all associated resources. The request is not
- * executed by this function — only configured.
- *
- * @param url           The full request URL.
- * @param method        The HTTP method to use (GET, POST, etc.).
- * @param payload       Optional request body for POST or PUT.
- * @param headers       Optional custom headers (gvm_http_headers_t).
+ * @param curl          The CURL easy handle.
  * @param ca_cert       Optional CA certificate for server verification.
  * @param client_cert   Optional client certificate for mutual TLS.
  * @param client_key    Optional client private key for mutual TLS.
- * @param res           Response stream used as the write target during the request.
  *
- * @return A configured gvm_http_t object on success, or NULL on failure.
+ * @return 0 on success, -1 if a certificate or key could not be set.
  */
-gvm_http_t *
-gvm_http_new (const gchar *url, gvm_http_method_t method,
-               const gchar *payload, gvm_http_headers_t *headers,
-               const gchar *ca_cert, const gchar *client_cert,
-               const gchar *client_key, gvm_http_response_stream_t res)
+static int
+http_set_tls (CURL *curl, const gchar *ca_cert, const gchar *client_cert,
+              const gchar *client_key)
 {
-  CURL *curl = curl_easy_init ();
-  if (!curl) return NULL;
-
-  // Set URL
-  curl_easy_setopt (curl, CURLOPT_URL, url);
-  curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, store_response_data);
-  curl_easy_setopt (curl, CURLOPT_WRITEDATA, (void *)res);
-
-  // Set HTTP headers if provided
-  if (headers && headers->custom_headers)
-    {
-      curl_easy_setopt (curl, CURLOPT_HTTPHEADER, headers->custom_headers);
-    }
-
   // Handle SSL CA Certificate
   if (ca_cert)
     {
@@ -151,8 +224,7 @@ gvm_http_new (const gchar *url, gvm_http_method_t method,
       if (curl_easy_setopt (curl, CURLOPT_CAINFO_BLOB, &ca_blob) != CURLE_OK)
         {
           g_warning("%s: Failed to set CA certificate", __func__);
-          curl_easy_cleanup (curl);
-          return NULL;
+          return -1;
         }
     }
   else
@@ -173,19 +245,35 @@ gvm_http_new (const gchar *url, gvm_http_method_t method,
       if (curl_easy_setopt (curl, CURLOPT_SSLCERT_BLOB, &cert_blob) != CURLE_OK)
         {
           g_warning ("%s: Failed to set client certificate", __func__);
-          curl_easy_cleanup (curl);
-          return NULL;
+          return -1;
         }
 
       if (curl_easy_setopt (curl, CURLOPT_SSLKEY_BLOB, &key_blob) != CURLE_OK)
         {
           g_warning ("%s: Failed to set client private key", __func__);
-          curl_easy_cleanup (curl);
-          return NULL;
+          return -1;
        }
     }
 
-  // Handle HTTP Method
+  return 0;
+}
+
+/**
+ * @brief Sets the HTTP method and the payload of a CURL handle.
+ *
+ * A method set by a previous request on the same handle is reset first.
+ *
+ * @param curl     The CURL easy handle.
+ * @param method   The HTTP method to use (GET, POST, etc.).
+ * @param payload  Optional request body for POST, PUT or PATCH.
+ */
+static void
+http_set_method (CURL *curl, gvm_http_method_t method, const gchar *payload)
+{
+  // Back to a plain GET without body
+  curl_easy_setopt (curl, CURLOPT_HTTPGET, 1L);
+  curl_easy_setopt (curl, CURLOPT_CUSTOMREQUEST, NULL);
+
   switch (method) {
       case POST:
           if (payload && payload[0] != '\0')
@@ -218,9 +306,66 @@ gvm_http_new (const gchar *url, gvm_http_method_t method,
           break;
       case GET:
       default:
-          curl_easy_setopt (curl, CURLOPT_HTTPGET, 1L);
           break;
   }
+}
+
+/**
+ * @brief Initializes and configures a gvm_http_t object for an HTTP(S) request.
+ *
+ * This function creates and configures a gvm_http_t structure, encapsulating
+ * a libcurl easy handle. It sets the target URL, HTTP method, optional headers,
+ * payload, and SSL/TLS credentials (CA certificate, client certificate, and private key).
+ * It also registers a write callback to store the server's response into a
+ * provided response stream buffer.
+ *
+ * Note: The returned object must be cleaned up by the caller using
+ * `gvm_http_free()` to free all associated resources. The request is not
+ * executed by this function — only configured.
+ *
+ * @param url           The full request URL.
+ * @param method        The HTTP method to use (GET, POST, etc.).
+ * @param payload       Optional request body for POST or PUT.
+ * @param headers       Optional custom headers (gvm_http_headers_t).
+ * @param ca_cert       Optional CA certificate for server verification.
+ * @param client_cert   Optional client certificate for mutual TLS.
+ * @param client_key    Optional client private key for mutual TLS.
+ * @param res           Response stream used as the write target during the request.
+ *
+ * @return A configured gvm_http_t object on success, or NULL on failure.
+ */
+gvm_http_t *
+gvm_http_new (const gchar *url, gvm_http_method_t method,
+               const gchar *payload, gvm_http_headers_t *headers,
+               const gchar *ca_cert, const gchar *client_cert,
+               const gchar *client_key, gvm_http_response_stream_t res)
+{
+  CURL *curl = curl_easy_init ();
+  if (!curl) return NULL;
+
+  // Set URL
+  curl_easy_setopt (curl, CURLOPT_URL, url);
+  curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, store_response_data);
+  curl_easy_setopt (curl, CURLOPT_WRITEDATA, (void *)res);
+  curl_easy_setopt (curl, CURLOPT_HEADERFUNCTION, store_response_header);
+  curl_easy_setopt (curl, CURLOPT_HEADERDATA, (void *)res);
+  // Offer all encodings libcurl can decode, e.g. gzip, zstd and br
+  curl_easy_setopt (curl, CURLOPT_ACCEPT_ENCODING, "");
+
+  // Set HTTP headers if provided
+  if (headers && headers->custom_headers)
+    {
+      curl_easy_setopt (curl, CURLOPT_HTTPHEADER, headers->custom_headers);
+    }
+
+  if (http_set_tls (curl, ca_cert, client_cert, client_key))
+    {
+      curl_easy_cleanup (curl);
+      return NULL;
+    }
+
+  // Handle HTTP Method
+  http_set_method (curl, method, payload);
 
   return gvm_http_t_new (curl);
 }
@@ -236,7 +381,7 @@ gvm_http_response_stream_new (void)
   gvm_http_response_stream_t s;
   s = g_malloc0 (sizeof (struct gvm_http_response_stream));
   s->length = 0;
-  s->data = g_malloc0 (s->length + 1);
+  s->data = g_malloc0 (1);
   s->multi_handler = gvm_http_multi_t_new ();
   return s;
 }
@@ -258,6 +403,48 @@ gvm_http_response_stream_free (gvm_http_response_stream_t s)
   g_free (s);
 }
 
+/**
+ * @brief Performs a configured request and fills in the response.
+ *
+ * The received data is moved from the stream into the response without
+ * copying it. An external stream is left empty but usable.
+ *
+ * @param curl           The CURL easy handle to perform.
+ * @param response       Response stream the handle writes to.
+ * @param internal       Whether the stream is freed after the request.
+ * @param http_response  Response to set the status and the data of.
+ */
+static void
+http_perform (CURL *curl, gvm_http_response_stream_t response,
+              gboolean internal, gvm_http_response_t *http_response)
+{
+  CURLcode result = curl_easy_perform (curl);
+  gvm_http_stats_record (curl, result);
+  if (result != CURLE_OK)
+    {
+      g_warning ("%s: Error performing CURL request: %s", __func__, curl_easy_strerror (result));
+      http_response->http_status = -1;
+      http_response->data = g_strdup_printf (
+        "{\"error\": \"CURL request failed: %s\"}",
+        curl_easy_strerror (result)
+      );
+    }
+  else if (response->data)
+    {
+      curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, &http_response->http_status);
+      http_response->size = response->length;
+      http_response->data = response_stream_steal (response);
+    }
+  else
+    {
+      curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, &http_response->http_status);
+      http_response->data = g_strdup ("{\"error\": \"Empty response\"}");
+    }
+
+  if (!internal)
+    gvm_http_response_stream_reset (response);
+}
+
 /**
  * @brief Sends a synchronous HTTP(S) request and captures the response.
  *
@@ -270,7 +457,8 @@ gvm_http_response_stream_free (gvm_http_response_stream_t s)
  *
  * If no response stream is provided, an internal one will be allocated and
  * automatically cleaned up. If a stream is provided, the caller is responsible
- * for its cleanup.
+ * for its cleanup. The received data is moved from the stream into the
+ * response, the stream is left empty.
  *
  * @param url           The URL to send the request to.
  * @param method        HTTP method to use (e.g., GET, POST, PUT, DELETE).
@@ -316,29 +504,8 @@ gvm_http_request (const gchar *url, gvm_http_method_t method,
 
   http_response->http = http;
 
-  CURLcode result = curl_easy_perform (http->handler);
-  if (result == CURLE_OK)
-    {
-      curl_easy_getinfo (http->handler, CURLINFO_RESPONSE_CODE, &http_response->http_status);
-    }
-  else
-    {
-      g_warning ("%s: Error performing CURL request: %s", __func__, curl_easy_strerror (result));
-      http_response->http_status = -1;
-      http_response->data = g_strdup_printf (
-        "{\"error\": \"CURL request failed: %s\"}",
-        curl_easy_strerror (result)
-      );
-    }
-
-  if (response && response->data)
-    {
-      http_response->data = g_strdup (response->data);
-    }
-  else
-    {
-      http_response->data = g_strdup ("{\"error\": \"Empty response\"}");
-    }
+  http_perform (http->handler, response, internal_stream_allocated,
+                http_response);
 
   if (internal_stream_allocated)
     {
@@ -539,8 +706,10 @@ gvm_http_multi_free (gvm_http_multi_t *multi)
       if (msg->msg == CURLMSG_DONE)
         {
           void *easy_handle = msg->easy_handle;
+          gvm_http_stats_record (easy_handle, msg->data.result);
           curl_multi_remove_handle (multi->handler, easy_handle);
           curl_easy_cleanup (easy_handle);
+          orphaned_shares_free ();
         }
       else
         {
@@ -573,7 +742,402 @@ gvm_http_response_stream_reset (gvm_http_response_stream_t s)
     {
       g_free (s->data);
       s->length = 0;
-      s->data = g_malloc0 (s->length + 1);
+      s->data = g_malloc0 (1);
+    }
+}
+
+
+/**
+ * @brief Share handle of a client with the locks of the shared data.
+ *
+ * Kept apart from the client, as handles attached to the client may still use
+ * it after the client was freed.
+ */
+struct http_share
+{
+  CURLSH *handler;                   ///< Shared DNS, TLS and connection data.
+  GMutex locks[CURL_LOCK_DATA_LAST]; ///< Locks for the shared data.
+};
+
+/**
+ * @brief Long-lived HTTP(S) client.
+ *
+ * Reuses one easy handle, and with it the connection cache, for all requests.
+ * DNS cache, TLS sessions and connections are kept in a share handle, which
+ * further handles can be attached to with gvm_http_client_attach().
+ */
+struct gvm_http_client
+{
+  CURL *handler;              ///< Easy handle used for all requests.
+  struct http_share *share;   ///< Shared DNS, TLS and connection data.
+  size_t compress_min;        ///< Minimum payload size to compress.
+};
+
+/**
+ * @brief Shares of freed clients, still used by attached handles.
+ */
+static GSList *orphaned_shares;
+
+G_LOCK_DEFINE_STATIC (orphaned_shares);
+
+/**
+ * @brief Lock callback of the share handle.
+ */
+static void
+client_share_lock (CURL *handle, curl_lock_data data, curl_lock_access access,
+                   void *userptr)
+{
+  struct http_share *share = userptr;
+
+  (void) handle;
+  (void) access;
+  g_mutex_lock (&share->locks[data]);
+}
+
+/**
+ * @brief Unlock callback of the share handle.
+ */
+static void
+client_share_unlock (CURL *handle, curl_lock_data data, void *userptr)
+{
+  struct http_share *share = userptr;
+
+  (void) handle;
+  g_mutex_unlock (&share->locks[data]);
+}
+
+/**
+ * @brief Creates the share handle of a client.
+ *
+ * @return The share, or NULL if libcurl could not create a share handle.
+ */
+static struct http_share *
+http_share_new (void)
+{
+  struct http_share *share;
+  CURLSH *handler = curl_share_init ();
+
+  if (!handler)
+    return NULL;
+
+  share = g_malloc0 (sizeof (struct http_share));
+  share->handler = handler;
+  for (int i = 0; i < CURL_LOCK_DATA_LAST; i++)
+    g_mutex_init (&share->locks[i]);
+
+  curl_share_setopt (handler, CURLSHOPT_LOCKFUNC, client_share_lock);
+  curl_share_setopt (handler, CURLSHOPT_UNLOCKFUNC, client_share_unlock);
+  curl_share_setopt (handler, CURLSHOPT_USERDATA, share);
+  curl_share_setopt (handler, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt (handler, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  // libcurl does not support using shared connections from concurrent
+  // threads, see gvm_http_client_new()
+  curl_share_setopt (handler, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+
+  return share;
+}
+
+/**
+ * @brief Frees a share handle if no handle is attached to it anymore.
+ *
+ * @param share The share.
+ *
+ * @return TRUE if the share was freed, FALSE if it is still in use.
+ */
+static gboolean
+http_share_free (struct http_share *share)
+{
+  if (curl_share_cleanup (share->handler) != CURLSHE_OK)
+    return FALSE;
+
+  for (int i = 0; i < CURL_LOCK_DATA_LAST; i++)
+    g_mutex_clear (&share->locks[i]);
+  g_free (share);
+  return TRUE;
+}
+
+/**
+ * @brief Frees the shares of freed clients which are not in use anymore.
+ */
+static void
+orphaned_shares_free (void)
+{
+  GSList *item, *next;
+
+  if (g_atomic_pointer_get (&orphaned_shares) == NULL)
+    return;
+
+  G_LOCK (orphaned_shares);
+  for (item = orphaned_shares; item; item = next)
+    {
+      next = item->next;
+      if (http_share_free (item->data))
+        g_atomic_pointer_set (&orphaned_shares,
+                              g_slist_delete_link (orphaned_shares, item));
+    }
+  G_UNLOCK (orphaned_shares);
+}
+
+/**
+ * @brief Creates a long-lived HTTP(S) client.
+ *
+ * The SSL/TLS credentials are set once for all requests of the client.
+ * Connections are kept alive and reused, HTTP/2 is negotiated over TLS.
+ *
+ * libcurl does not support shared connections in concurrent threads, so the
+ * client and the handles attached to it must not be used by more than one
+ * thread at a time.
+ *
+ * @param ca_cert       Optional CA certificate for server verification.
+ * @param client_cert   Optional client certificate for mutual TLS.
+ * @param client_key    Optional client private key for mutual TLS.
+ *
+ * @return A new client on success, or NULL on failure. Must be freed with
+ *         `gvm_http_client_free()`.
+ */
+gvm_http_client_t *
+gvm_http_client_new (const gchar *ca_cert, const gchar *client_cert,
+                     const gchar *client_key)
+{
+  gvm_http_client_t *client;
+  CURL *curl = curl_easy_init ();
+  if (!curl) return NULL;
+
+  if (http_set_tls (curl, ca_cert, client_cert, client_key))
+    {
+      curl_easy_cleanup (curl);
+      return NULL;
+    }
+  // Prefer HTTP/2 over TLS, which is multiplexed over one connection
+  if (ca_cert)
+    curl_easy_setopt (curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  curl_easy_setopt (curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, store_response_data);
+  curl_easy_setopt (curl, CURLOPT_HEADERFUNCTION, store_response_header);
+  curl_easy_setopt (curl, CURLOPT_ACCEPT_ENCODING, "");
+
+  client = g_malloc0 (sizeof (struct gvm_http_client));
+  client->handler = curl;
+  client->share = http_share_new ();
+  if (client->share)
+    curl_easy_setopt (curl, CURLOPT_SHARE, client->share->handler);
+  else
+    g_debug ("%s: No share handle. Connection state is not shared.", __func__);
+
+  return client;
+}
+
+/**
+ * @brief Frees a client and closes its connections.
+ *
+ * If handles attached with `gvm_http_client_attach()` still use the shared
+ * data, the share is kept until they are freed. It is freed by a later call
+ * of this function or of `gvm_http_free()`.
+ *
+ * @param client The client to free. Safe to pass NULL.
+ */
+void
+gvm_http_client_free (gvm_http_client_t *client)
+{
+  if (!client)
+    return;
+
+  curl_easy_cleanup (client->handler);
+  orphaned_shares_free ();
+  if (client->share && !http_share_free (client->share))
+    {
+      g_debug ("%s: Share handle still in use, freeing it later", __func__);
+      G_LOCK (orphaned_shares);
+      g_atomic_pointer_set (&orphaned_shares,
+                            g_slist_prepend (orphaned_shares, client->share));
+      G_UNLOCK (orphaned_shares);
     }
+  g_free (client);
 }
 
+/**
+ * @brief Lets a handle share DNS cache, TLS sessions and connections with a
+ *        client.
+ *
+ * The handle must be used in the same thread as the client.
+ *
+ * @param client The client.
+ * @param http   The handle, e.g. from `gvm_http_new()`. May be freed after
+ *               the client.
+ *
+ * @return TRUE if the handle was attached, FALSE otherwise.
+ */
+gboolean
+gvm_http_client_attach (gvm_http_client_t *client, gvm_http_t *http)
+{
+  if (!client || !client->share || !http || !http->handler)
+    return FALSE;
+
+  return curl_easy_setopt (http->handler, CURLOPT_SHARE,
+                           client->share->handler)
+         == CURLE_OK;
+}
+
+/**
+ * @brief Enables compression of large request payloads of a client.
+ *
+ * Payloads of POST, PUT and PATCH requests of at least min_size bytes are
+ * sent gzip compressed, with a "Content-Encoding: gzip" header. The server
+ * must support compressed request bodies.
+ *
+ * @param client    The client.
+ * @param min_size  Minimum payload size in bytes, 0 to disable compression.
+ */
+void
+gvm_http_client_set_compression (gvm_http_client_t *client, size_t min_size)
+{
+  if (client)
+    client->compress_min = min_size;
+}
+
+/**
+ * @brief Compresses a payload if the client is set up to.
+ *
+ * @param client        The client.
+ * @param method        HTTP method of the request.
+ * @param payload       The request payload. Can be NULL.
+ * @param headers       Custom headers of the request. Can be NULL.
+ * @param[out] size     Size of the compressed payload.
+ * @param[out] encoded  Headers with the content encoding added.
+ *
+ * @return The compressed payload, or NULL if it is sent as is. Must be freed.
+ */
+static gchar *
+client_compress_payload (gvm_http_client_t *client, gvm_http_method_t method,
+                         const gchar *payload, gvm_http_headers_t *headers,
+                         unsigned long *size, gvm_http_headers_t **encoded)
+{
+  size_t length;
+  gchar *compressed;
+
+  if (client->compress_min == 0 || payload == NULL
+      || (method != POST && method != PUT && method != PATCH))
+    return NULL;
+
+  length = strlen (payload);
+  if (length < client->compress_min)
+    return NULL;
+
+  compressed = gvm_compress_gzipheader (payload, length, size);
+  if (compressed == NULL || *size >= length)
+    {
+      // Not worth it, e.g. already compressed data
+      g_free (compressed);
+      return NULL;
+    }
+
+  *encoded = gvm_http_headers_new ();
+  if (headers)
+    for (struct curl_slist *h = headers->custom_headers; h; h = h->next)
+      gvm_http_add_header (*encoded, h->data);
+  gvm_http_add_header (*encoded, "Content-Encoding: gzip");
+
+  return compressed;
+}
+
+/**
+ * @brief Sends a synchronous HTTP(S) request over a client.
+ *
+ * Like `gvm_http_request()`, but an open connection of the client to the same
+ * host is reused instead of connecting and handshaking again.
+ *
+ * @param client    The client to send the request with.
+ * @param url       The URL to send the request to.
+ * @param method    HTTP method to use (e.g., GET, POST, PUT, DELETE).
+ * @param payload   Optional request payload for methods like POST or PUT.
+ * @param headers   Optional custom headers (`gvm_http_headers_t`).
+ * @param response  Optional response stream buffer; if NULL, one will be created.
+ *
+ * @return A pointer to a `gvm_http_response_t` containing the response data and
+ *         status. Its `http` member is NULL, the headers can be read with
+ *         `gvm_http_client_header()` until the next request. Must be freed
+ *         with `gvm_http_response_cleanup()`.
+ */
+gvm_http_response_t *
+gvm_http_client_request (gvm_http_client_t *client, const gchar *url,
+                         gvm_http_method_t method, const gchar *payload,
+                         gvm_http_headers_t *headers,
+                         gvm_http_response_stream_t response)
+{
+  gvm_http_response_t *http_response = g_malloc0 (sizeof (gvm_http_response_t));
+  gboolean internal_stream_allocated = FALSE;
+  gvm_http_headers_t *encoded = NULL;
+  unsigned long compressed_size = 0;
+  gchar *compressed;
+
+  if (!client || !url)
+    {
+      http_response->http_status = -1;
+      http_response->data = g_strdup ("{\"error\": \"Invalid HTTP client\"}");
+      return http_response;
+    }
+
+  if (response == NULL)
+    {
+      response = g_malloc0 (sizeof (struct gvm_http_response_stream));
+      internal_stream_allocated = TRUE;
+    }
+
+  compressed = client_compress_payload (client, method, payload, headers,
+                                        &compressed_size, &encoded);
+  if (encoded)
+    headers = encoded;
+
+  curl_easy_setopt (client->handler, CURLOPT_URL, url);
+  curl_easy_setopt (client->handler, CURLOPT_WRITEDATA, (void *)response);
+  curl_easy_setopt (client->handler, CURLOPT_HEADERDATA, (void *)response);
+  curl_easy_setopt (client->handler, CURLOPT_HTTPHEADER,
+                    headers ? headers->custom_headers : NULL);
+  http_set_method (client->handler, method, payload);
+  if (compressed)
+    {
+      curl_easy_setopt (client->handler, CURLOPT_POSTFIELDS, compressed);
+      curl_easy_setopt (client->handler, CURLOPT_POSTFIELDSIZE,
+                        (long) compressed_size);
+    }
+
+  http_perform (client->handler, response, internal_stream_allocated,
+                http_response);
+
+  // Do not keep pointers to the caller's data in the handle
+  curl_easy_setopt (client->handler, CURLOPT_POSTFIELDS, NULL);
+  curl_easy_setopt (client->handler, CURLOPT_HTTPHEADER, NULL);
+  g_free (compressed);
+  gvm_http_headers_free (encoded);
+
+  if (internal_stream_allocated)
+    {
+      gvm_http_response_stream_free (response);
+    }
+
+  return http_response;
+}
+
+/**
+ * @brief Gets a header of the last response received by a client.
+ *
+ * @param client The client.
+ * @param name   Name of the header.
+ *
+ * @return Value of the header, or NULL if there is none. Must be freed with
+ *         g_free().
+ */
+gchar *
+gvm_http_client_header (gvm_http_client_t *client, const gchar *name)
+{
+  struct curl_header *header;
+
+  if (!client || !name)
+    return NULL;
+
+  if (curl_easy_header (client->handler, name, 0, CURLH_HEADER, -1, &header)
+      != CURLHE_OK)
+    return NULL;
+
+  return g_strdup (header->value);
+}
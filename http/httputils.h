@@ -23,6 +23,7 @@
  * - `gvm_http_headers_t`: stores custom headers for use in requests
  * - `gvm_http_response_stream_t`: used internally for accumulating response data during transfers
  * - `gvm_http_multi_t`: manages multiple concurrent transfers using libcurl's multi interface
+ * - `gvm_http_client_t`: reuses one handle and its connections for many requests
  */
 
 #ifndef HTTPUTILS_H
@@ -103,6 +104,11 @@ typedef struct {
   gvm_http_t *http; ///< The HTTP request (easy handle wrapper).
 } gvm_http_response_t;
 
+/**
+ * @brief Long-lived HTTP(S) client reusing its connections.
+ */
+typedef struct gvm_http_client gvm_http_client_t;
+
 void
 gvm_http_free (gvm_http_t *http);
 
@@ -154,4 +160,26 @@ gvm_http_response_stream_free (gvm_http_response_stream_t s);
 void
 gvm_http_response_stream_reset (gvm_http_response_stream_t s);
 
+gvm_http_client_t *
+gvm_http_client_new (const gchar *ca_cert, const gchar *client_cert,
+                     const gchar *client_key);
+
+void
+gvm_http_client_free (gvm_http_client_t *client);
+
+gboolean
+gvm_http_client_attach (gvm_http_client_t *client, gvm_http_t *http);
+
+void
+gvm_http_client_set_compression (gvm_http_client_t *client, size_t min_size);
+
+gvm_http_response_t *
+gvm_http_client_request (gvm_http_client_t *client, const gchar *url,
+                         gvm_http_method_t method, const gchar *payload,
+                         gvm_http_headers_t *headers,
+                         gvm_http_response_stream_t response);
+
+gchar *
+gvm_http_client_header (gvm_http_client_t *client, const gchar *name);
+
 #endif //HTTPUTILS_H
@@ -156,6 +156,185 @@ Ensure (gvm_http, response_stream_reset_frees_and_resets_data) {
   gvm_http_response_stream_free (stream);
 }
 
+Ensure (gvm_http, store_response_data_grows_buffer_geometrically) {
+  gvm_http_response_stream_t stream = gvm_http_response_stream_new ();
+  gchar chunk[1000];
+  int reallocs = 0;
+
+  memset (chunk, 'x', sizeof (chunk));
+  for (int i = 0; i < 1000; i++)
+    {
+      size_t allocated = malloc_usable_size (stream->data);
+
+      assert_that (store_response_data (chunk, 1, sizeof (chunk), stream),
+                   is_equal_to (sizeof (chunk)));
+      if (malloc_usable_size (stream->data) != allocated)
+        reallocs++;
+    }
+
+  assert_that (stream->length, is_equal_to (1000 * sizeof (chunk)));
+  assert_that (stream->data[stream->length], is_equal_to ('\0'));
+  assert_that (malloc_usable_size (stream->data),
+               is_greater_than (stream->length));
+  assert_that (reallocs, is_less_than (12));
+
+  gvm_http_response_stream_free (stream);
+}
+
+Ensure (gvm_http, store_response_data_appends_to_external_data) {
+  gvm_http_response_stream_t stream = gvm_http_response_stream_new ();
+
+  g_free (stream->data);
+  stream->data = g_strdup ("mock");
+  stream->length = strlen (stream->data);
+
+  store_response_data (" response", 1, 9, stream);
+  assert_that (stream->data, is_equal_to_string ("mock response"));
+  assert_that (stream->length, is_equal_to (13));
+
+  gvm_http_response_stream_free (stream);
+}
+
+Ensure (gvm_http, content_length_header_preallocates_buffer) {
+  gvm_http_response_stream_t stream = gvm_http_response_stream_new ();
+  char header[] = "content-length: 1000000\r\n";
+  char other[] = "Content-Type: application/json\r\n";
+  char huge[] = "Content-Length: 99999999999\r\n";
+
+  assert_that (store_response_header (other, 1, strlen (other), stream),
+               is_equal_to (strlen (other)));
+  assert_that (malloc_usable_size (stream->data),
+               is_less_than (RESPONSE_BUFFER_MIN));
+  assert_that (store_response_header (huge, 1, strlen (huge), stream),
+               is_equal_to (strlen (huge)));
+  assert_that (malloc_usable_size (stream->data),
+               is_less_than (RESPONSE_BUFFER_MIN));
+
+  assert_that (store_response_header (header, 1, strlen (header), stream),
+               is_equal_to (strlen (header)));
+  assert_that (malloc_usable_size (stream->data), is_greater_than (1000000));
+  size_t allocated = malloc_usable_size (stream->data);
+  gchar *data = stream->data;
+  gchar chunk[1000] = {0};
+  for (int i = 0; i < 1000; i++)
+    store_response_data (chunk, 1, sizeof (chunk), stream);
+  assert_that (malloc_usable_size (stream->data), is_equal_to (allocated));
+  assert_that (stream->data, is_equal_to (data));
+
+  gvm_http_response_stream_free (stream);
+}
+
+Ensure (gvm_http, response_stream_steal_leaves_stream_empty) {
+  gvm_http_response_stream_t stream = gvm_http_response_stream_new ();
+
+  store_response_data ("{}", 1, 2, stream);
+  gchar *data = stream->data;
+  gchar *stolen = response_stream_steal (stream);
+
+  assert_that (stolen, is_equal_to (data));
+  assert_that (stolen, is_equal_to_string ("{}"));
+  assert_that (stream->data, is_null);
+  assert_that (stream->length, is_equal_to (0));
+
+  store_response_data ("[]", 1, 2, stream);
+  assert_that (stream->data, is_equal_to_string ("[]"));
+
+  g_free (stolen);
+  gvm_http_response_stream_free (stream);
+}
+
+Ensure (gvm_http, client_new_shares_connection_state) {
+  gvm_http_client_t *client = gvm_http_client_new (NULL, NULL, NULL);
+  assert_that (client, is_not_null);
+  assert_that (client->handler, is_not_null);
+  assert_that (client->share, is_not_null);
+
+  CURL *curl = curl_easy_init ();
+  gvm_http_t *http = gvm_http_t_new (curl);
+  assert_that (gvm_http_client_attach (client, http), is_true);
+  assert_that (gvm_http_client_attach (client, NULL), is_false);
+  assert_that (gvm_http_client_attach (NULL, http), is_false);
+
+  gvm_http_free (http);
+  gvm_http_client_free (client);
+}
+
+Ensure (gvm_http, client_free_keeps_share_of_attached_handles) {
+  gvm_http_client_t *client = gvm_http_client_new (NULL, NULL, NULL);
+  gvm_http_t *http = gvm_http_t_new (curl_easy_init ());
+
+  assert_that (gvm_http_client_attach (client, http), is_true);
+  gvm_http_client_free (client);
+  assert_that (g_slist_length (orphaned_shares), is_equal_to (1));
+
+  gvm_http_free (http);
+  assert_that (orphaned_shares, is_null);
+}
+
+Ensure (gvm_http, client_functions_handle_null_safely) {
+  gvm_http_response_t *response =
+    gvm_http_client_request (NULL, "http://localhost", GET, NULL, NULL, NULL);
+  assert_that (response, is_not_null);
+  assert_that (response->http_status, is_equal_to (-1));
+  assert_that (response->http, is_null);
+  gvm_http_response_cleanup (response);
+  g_free (response);
+
+  assert_that (gvm_http_client_header (NULL, "etag"), is_null);
+  gvm_http_client_free (NULL);
+}
+
+Ensure (gvm_http, client_compresses_large_payloads) {
+  gvm_http_client_t *client = gvm_http_client_new (NULL, NULL, NULL);
+  gvm_http_headers_t *headers = gvm_http_headers_new ();
+  gvm_http_headers_t *encoded = NULL;
+  unsigned long size = 0;
+  GString *payload = g_string_new ("[");
+  gchar *compressed;
+
+  for (int i = 0; i < 200; i++)
+    g_string_append_printf (payload, "{\"oid\": \"1.3.6.1.4.1.25623.1.0.%d\"},",
+                            i);
+  g_string_append (payload, "{}]");
+  gvm_http_add_header (headers, "Content-Type: application/json");
+
+  // Disabled by default
+  compressed = client_compress_payload (client, POST, payload->str, headers,
+                                        &size, &encoded);
+  assert_that (compressed, is_null);
+  assert_that (encoded, is_null);
+
+  gvm_http_client_set_compression (client, 1024);
+  compressed = client_compress_payload (client, GET, payload->str, headers,
+                                        &size, &encoded);
+  assert_that (compressed, is_null);
+  compressed = client_compress_payload (client, POST, "{}", headers,
+                                        &size, &encoded);
+  assert_that (compressed, is_null);
+  assert_that (encoded, is_null);
+
+  compressed = client_compress_payload (client, POST, payload->str, headers,
+                                        &size, &encoded);
+  assert_that (compressed, is_not_null);
+  assert_that (size, is_less_than (payload->len / 4));
+  assert_that ((unsigned char) compressed[0], is_equal_to (0x1f));
+  assert_that ((unsigned char) compressed[1], is_equal_to (0x8b));
+  assert_that (encoded, is_not_null);
+  assert_that (encoded->custom_headers->data,
+               is_equal_to_string ("Content-Type: application/json"));
+  assert_that (encoded->custom_headers->next->data,
+               is_equal_to_string ("Content-Encoding: gzip"));
+  // The caller's headers are left alone
+  assert_that (headers->custom_headers->next, is_null);
+
+  g_free (compressed);
+  gvm_http_headers_free (encoded);
+  gvm_http_headers_free (headers);
+  g_string_free (payload, TRUE);
+  gvm_http_client_free (client);
+  gvm_http_client_set_compression (NULL, 1);
+}
+
 int main (int argc, char **argv) {
   TestSuite *suite = create_test_suite ();
 
@@ -175,6 +354,15 @@ int main (int argc, char **argv) {
   add_test_with_context (suite, gvm_http, http_free_handles_null_safely);
   add_test_with_context (suite, gvm_http, http_free_frees_allocated_struct);
   add_test_with_context (suite, gvm_http, response_stream_reset_frees_and_resets_data);
+  add_test_with_context (suite, gvm_http, store_response_data_grows_buffer_geometrically);
+  add_test_with_context (suite, gvm_http, store_response_data_appends_to_external_data);
+  add_test_with_context (suite, gvm_http, content_length_header_preallocates_buffer);
+  add_test_with_context (suite, gvm_http, response_stream_steal_leaves_stream_empty);
+  add_test_with_context (suite, gvm_http, client_new_shares_connection_state);
+  add_test_with_context (suite, gvm_http,
+                         client_free_keeps_share_of_attached_handles);
+  add_test_with_context (suite, gvm_http, client_functions_handle_null_safely);
+  add_test_with_context (suite, gvm_http, client_compresses_large_payloads);
 
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
@@ -14,6 +14,7 @@
 #include "../base/networking.h"
 #include "../http/httputils.h"
 #include "../util/json.h"
+#include "../util/vtparser.h"
 
 #include <cjson/cJSON.h>
 #include <netinet/in.h>
@@ -43,10 +44,74 @@ struct openvasd_connector
   gchar *host;     /**< server hostname. */
   gchar *scan_id;  /**< Scan ID. */
   int port;        /**< server port. */
+  int compress_min; /**< Minimum payload size to send gzip compressed. */
   gchar *protocol; /**< server protocol (http or https). */
   gvm_http_response_stream_t stream_resp; /** For response */
+  gvm_http_client_t *http_client; /**< Reused for all requests. */
+  struct openvasd_vt_push *vt_push; /**< Parser of a pushed VT stream. */
+  int status_wait; /**< Seconds the server may hold a status request. */
+  struct openvasd_status_cache *status_cache; /**< Last scan status. */
 };
 
+/**
+ * @brief Number of string members of a result.
+ */
+#define RESULT_BATCH_COLUMNS (DETAIL_SOURCE_DESCRIPTION + 1)
+
+/**
+ * @brief Results stored as one array per member.
+ *
+ * All strings are kept in one string chunk. Short members that repeat over
+ * many results, like hosts, OIDs and ports, are stored only once.
+ */
+struct openvasd_result_batch
+{
+  guint count;                                 /**< Number of results. */
+  guint allocated;                             /**< Allocated results. */
+  unsigned long *ids;                          /**< Result IDs. */
+  const gchar **columns[RESULT_BATCH_COLUMNS]; /**< String members. */
+  GStringChunk *strings;                       /**< Storage of all strings. */
+};
+
+/**
+ * @brief Struct holding the state of a VT stream parsed while received.
+ */
+struct openvasd_vt_push
+{
+  gvm_json_push_parser_t parser; /**< Parser of the VT array. */
+  openvasd_vt_func_t vt_func;    /**< Called for each parsed VT. */
+  gpointer user_data;            /**< Data passed to vt_func. */
+};
+
+/**
+ * @brief Struct holding the last scan status received with an ETag.
+ */
+struct openvasd_status_cache
+{
+  gchar *scan_id;                      /**< Scan the status is of. */
+  gchar *etag;                         /**< ETag of the status. */
+  gchar *body;                         /**< The status as received. */
+  gboolean parsed;                     /**< Whether status is set. */
+  struct openvasd_scan_status status;  /**< The parsed status. */
+};
+
+/**
+ * @brief Free a scan status cache.
+ *
+ * @param cache The cache.
+ */
+static void
+openvasd_status_cache_free (struct openvasd_status_cache *cache)
+{
+  if (cache == NULL)
+    return;
+
+  g_free (cache->scan_id);
+  g_free (cache->etag);
+  g_free (cache->body);
+  g_free (cache);
+}
+
 /**
  * @brief Struct holding options for openvasd parameters.
  */
@@ -100,6 +165,86 @@ struct openvasd_vt_single
   GHashTable *vt_values;
 };
 
+/**
+ * @brief Parse a VT of a pushed VT stream and pass it on.
+ *
+ * @param parser     Json pull parser reading the VT object.
+ * @param event      Json pull event.
+ * @param user_data  The VT stream state.
+ */
+static void
+openvasd_vt_push_element (gvm_json_pull_parser_t *parser,
+                          gvm_json_pull_event_t *event, gpointer user_data)
+{
+  struct openvasd_vt_push *push = user_data;
+  nvti_t *nvt = NULL;
+
+  if (parse_vt_json (parser, event, &nvt) == 0)
+    push->vt_func (nvt, push->user_data);
+}
+
+/**
+ * @brief Write callback feeding the received VT stream to its parser.
+ *
+ * @param ptr       Pointer to the delivered data.
+ * @param size      Size of each data element.
+ * @param nmemb     Number of data elements.
+ * @param userdata  The VT stream state.
+ *
+ * @return The number of bytes handled, 0 to abort the transfer on error.
+ */
+static size_t
+openvasd_vt_push_write (void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+  struct openvasd_vt_push *push = userdata;
+
+  if (gvm_json_push_parser_feed (&push->parser, ptr, size * nmemb))
+    {
+      g_warning ("%s: Error parsing VT stream: %s", __func__,
+                 push->parser.error_message);
+      return 0;
+    }
+
+  return size * nmemb;
+}
+
+/**
+ * @brief Create the state of a VT stream parsed while received.
+ *
+ * @param vt_func    Function called for each VT.
+ * @param user_data  Data passed to vt_func.
+ *
+ * @return The VT stream state.
+ */
+static struct openvasd_vt_push *
+openvasd_vt_push_new (openvasd_vt_func_t vt_func, gpointer user_data)
+{
+  struct openvasd_vt_push *push;
+
+  push = g_malloc0 (sizeof (struct openvasd_vt_push));
+  gvm_json_push_parser_init (&push->parser, 0, openvasd_vt_push_element,
+                             push);
+  push->vt_func = vt_func;
+  push->user_data = user_data;
+
+  return push;
+}
+
+/**
+ * @brief Free the state of a VT stream parsed while received.
+ *
+ * @param push  The VT stream state.
+ */
+static void
+openvasd_vt_push_free (struct openvasd_vt_push *push)
+{
+  if (push == NULL)
+    return;
+
+  gvm_json_push_parser_cleanup (&push->parser);
+  g_free (push);
+}
+
 /** @brief Initialize an openvasd connector.
  *
  *  @return An openvasd connector struct. It must be freed
@@ -135,7 +280,7 @@ openvasd_connector_builder (openvasd_connector_t conn, openvasd_conn_opt_t opt,
   if (conn == NULL)
     conn = openvasd_connector_new ();
 
-  if (opt < OPENVASD_CA_CERT || opt > OPENVASD_PORT)
+  if (opt < OPENVASD_CA_CERT || opt > OPENVASD_STATUS_WAIT)
     return OPENVASD_INVALID_OPT;
 
   if (val == NULL)
@@ -145,12 +290,15 @@ openvasd_connector_builder (openvasd_connector_t conn, openvasd_conn_opt_t opt,
     {
     case OPENVASD_CA_CERT:
       conn->ca_cert = g_strdup ((char *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case OPENVASD_CERT:
       conn->cert = g_strdup ((char *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case OPENVASD_KEY:
       conn->key = g_strdup ((char *) val);
+      g_clear_pointer (&conn->http_client, gvm_http_client_free);
       break;
     case OPENVASD_API_KEY:
       conn->apikey = g_strdup ((char *) val);
@@ -167,6 +315,17 @@ openvasd_connector_builder (openvasd_connector_t conn, openvasd_conn_opt_t opt,
     case OPENVASD_SCAN_ID:
       conn->scan_id = g_strdup ((const gchar *) val);
       break;
+    case OPENVASD_COMPRESS_MIN:
+      if (*((int *) val) < 0)
+        return OPENVASD_INVALID_VALUE;
+      conn->compress_min = *((int *) val);
+      gvm_http_client_set_compression (conn->http_client, conn->compress_min);
+      break;
+    case OPENVASD_STATUS_WAIT:
+      if (*((int *) val) < 0)
+        return OPENVASD_INVALID_VALUE;
+      conn->status_wait = *((int *) val);
+      break;
     case OPENVASD_PORT:
     default:
       conn->port = *((int *) val);
@@ -198,6 +357,9 @@ openvasd_connector_free (openvasd_connector_t conn)
   g_free (conn->host);
   g_free (conn->scan_id);
   gvm_http_response_stream_free (conn->stream_resp);
+  gvm_http_client_free (conn->http_client);
+  openvasd_vt_push_free (conn->vt_push);
+  openvasd_status_cache_free (conn->status_cache);
   g_free (conn);
   conn = NULL;
 
@@ -248,6 +410,26 @@ init_customheader (const gchar *apikey, gboolean contenttype)
   return headers;
 }
 
+/**
+ * @brief Get the HTTP client of a connector, creating it on first use.
+ *
+ * @param conn Connector struct with the data necessary for the connection
+ *
+ * @return The HTTP client, NULL if it could not be created.
+ */
+static gvm_http_client_t *
+openvasd_http_client (openvasd_connector_t conn)
+{
+  if (!conn->http_client)
+    {
+      conn->http_client =
+        gvm_http_client_new (conn->ca_cert, conn->cert, conn->key);
+      gvm_http_client_set_compression (conn->http_client, conn->compress_min);
+    }
+
+  return conn->http_client;
+}
+
 /**
  * @brief Sends an HTTP(S) request to the OpenVAS daemon using
  *        the specified parameters.
@@ -257,15 +439,16 @@ init_customheader (const gchar *apikey, gboolean contenttype)
  * @param method The HTTP method (GET, POST, etc.).
  * @param path The resource path (e.g., `/vts`).
  * @param data The request payload (if applicable).
- * @param custom_headers Additional request headers.
+ * @param custom_headers Additional request headers, NULL terminated, or NULL.
  * @param header_name The header key to extract from the response.
  *
  * @return `openvasd_resp_t` containing response status, body, and header value.
  */
 static openvasd_resp_t
-openvasd_send_request (openvasd_connector_t conn, gvm_http_method_t method,
-                       const gchar *path, const gchar *data,
-                       const gchar *header_name)
+openvasd_send_request_full (openvasd_connector_t conn,
+                            gvm_http_method_t method, const gchar *path,
+                            const gchar *data, const gchar **custom_headers,
+                            const gchar *header_name)
 {
   openvasd_resp_t response = g_malloc0 (sizeof (struct openvasd_response));
   response->code = RESP_CODE_ERR;
@@ -287,13 +470,16 @@ openvasd_send_request (openvasd_connector_t conn, gvm_http_method_t method,
       conn->stream_resp = g_malloc0 (sizeof (struct gvm_http_response_stream));
     }
 
-  gvm_http_headers_t *custom_headers =
+  gvm_http_headers_t *headers =
     init_customheader (conn->apikey, data ? TRUE : FALSE);
+  for (int i = 0; custom_headers && custom_headers[i]; i++)
+    if (!gvm_http_add_header (headers, custom_headers[i]))
+      g_warning ("%s: Not possible to set %s", __func__, custom_headers[i]);
 
-  // Send request
-  gvm_http_response_t *http_response =
-    gvm_http_request (url, method, data, custom_headers, conn->ca_cert,
-                      conn->cert, conn->key, conn->stream_resp);
+  // Send request over the connection kept by the client
+  gvm_http_client_t *client = openvasd_http_client (conn);
+  gvm_http_response_t *http_response = gvm_http_client_request (
+    client, url, method, data, headers, conn->stream_resp);
 
   // Check for request errors
   if (http_response->http_status == -1)
@@ -301,36 +487,53 @@ openvasd_send_request (openvasd_connector_t conn, gvm_http_method_t method,
       g_warning ("%s: Error performing CURL request", __func__);
       response->body = g_strdup ("{\"error\": \"Error sending request\"}");
       gvm_http_response_cleanup (http_response);
+      g_free (http_response);
       g_free (url);
-      gvm_http_headers_free (custom_headers);
+      gvm_http_headers_free (headers);
       return response;
     }
 
-  // Populate response struct
+  // Populate response struct, taking over the body
   response->code = (int) http_response->http_status;
-  response->body = g_strdup (
-    http_response->data ? http_response->data : "{\"error\": \"No response\"}");
+  response->body = http_response->data
+                     ? http_response->data
+                     : g_strdup ("{\"error\": \"No response\"}");
+  http_response->data = NULL;
 
   // Extract specific header if requested
   if (header_name)
-    {
-      struct curl_header *hname;
-      if (curl_easy_header (http_response->http->handler, header_name, 0,
-                            CURLH_HEADER, -1, &hname)
-          == CURLHE_OK)
-        {
-          response->header = g_strdup (hname->value);
-        }
-    }
+    response->header = gvm_http_client_header (client, header_name);
 
   // Cleanup
   gvm_http_response_cleanup (http_response);
+  g_free (http_response);
   g_free (url);
-  gvm_http_headers_free (custom_headers);
+  gvm_http_headers_free (headers);
 
   return response;
 }
 
+/**
+ * @brief Sends an HTTP(S) request to the OpenVAS daemon.
+ *
+ * @param conn The `openvasd_connector_t` containing server and certificate
+ * details.
+ * @param method The HTTP method (GET, POST, etc.).
+ * @param path The resource path (e.g., `/vts`).
+ * @param data The request payload (if applicable).
+ * @param header_name The header key to extract from the response.
+ *
+ * @return `openvasd_resp_t` containing response status, body, and header value.
+ */
+static openvasd_resp_t
+openvasd_send_request (openvasd_connector_t conn, gvm_http_method_t method,
+                       const gchar *path, const gchar *data,
+                       const gchar *header_name)
+{
+  return openvasd_send_request_full (conn, method, path, data, NULL,
+                                     header_name);
+}
+
 /**
  * @brief Request HEAD
  *
@@ -350,19 +553,17 @@ openvasd_get_version (openvasd_connector_t conn)
 }
 
 /**
- * @brief Initialized an curl multiperform handler which allows fetch feed
- * metadata chunk by chunk.
+ * @brief Start fetching the feed metadata with a curl multiperform handler.
  *
  * @param conn Connector struct with the data necessary for the connection
- * @param mhnd The curl multiperform handler. It the caller doesn't provide
- * it initialized, it will be initialized. The caller has to free it with
- * gvm_http_multi_free().
- * @param resp The stringstream struct for the write callback function.
+ * @param push VT stream state to feed the data to, NULL to collect it in the
+ * response stream of the connector.
  *
  * @return The response.
  */
-openvasd_resp_t
-openvasd_get_vt_stream_init (openvasd_connector_t conn)
+static openvasd_resp_t
+openvasd_vt_stream_start (openvasd_connector_t conn,
+                          struct openvasd_vt_push *push)
 {
   GString *path;
   openvasd_resp_t response = NULL;
@@ -411,6 +612,19 @@ openvasd_get_vt_stream_init (openvasd_connector_t conn)
       return response;
     }
 
+  // Reuse the DNS cache and TLS session of the other requests
+  gvm_http_client_attach (openvasd_http_client (conn), http);
+
+  if (push)
+    {
+      curl_easy_setopt (http->handler, CURLOPT_WRITEFUNCTION,
+                        openvasd_vt_push_write);
+      curl_easy_setopt (http->handler, CURLOPT_WRITEDATA, push);
+      // Nothing is buffered, not even for the Content-Length
+      curl_easy_setopt (http->handler, CURLOPT_HEADERFUNCTION, NULL);
+      curl_easy_setopt (http->handler, CURLOPT_HEADERDATA, NULL);
+    }
+
   gvm_http_multi_result_t multi_add_result =
     gvm_http_multi_add_handler (multi_handle, http);
   if (multi_add_result != GVM_HTTP_OK)
@@ -434,6 +648,61 @@ openvasd_get_vt_stream_init (openvasd_connector_t conn)
   return response;
 }
 
+/**
+ * @brief Initialized an curl multiperform handler which allows fetch feed
+ * metadata chunk by chunk.
+ *
+ * The data is collected in the response stream of the connector, see
+ * openvasd_vt_stream_str().
+ *
+ * @param conn Connector struct with the data necessary for the connection
+ *
+ * @return The response.
+ */
+openvasd_resp_t
+openvasd_get_vt_stream_init (openvasd_connector_t conn)
+{
+  return openvasd_vt_stream_start (conn, NULL);
+}
+
+/**
+ * @brief Initialized an curl multiperform handler which fetches the feed
+ * metadata and parses it while it is received.
+ *
+ * Each VT is passed to vt_func as soon as it is complete, so only one VT is
+ * kept in memory. The transfer is run with openvasd_get_vt_stream().
+ *
+ * @param conn      Connector struct with the data necessary for the connection
+ * @param vt_func   Function called for each VT. It takes over the VT, which
+ *                  must be freed with nvti_free().
+ * @param user_data Data passed to vt_func.
+ *
+ * @return The response.
+ */
+openvasd_resp_t
+openvasd_get_vt_stream_push_init (openvasd_connector_t conn,
+                                  openvasd_vt_func_t vt_func,
+                                  gpointer user_data)
+{
+  openvasd_resp_t response;
+
+  if (conn == NULL || vt_func == NULL)
+    {
+      response = g_malloc0 (sizeof (struct openvasd_response));
+      response->code = RESP_CODE_ERR;
+      response->body = g_strdup ("{\"error\": \"Missing VT function\"}");
+      return response;
+    }
+
+  openvasd_vt_push_free (conn->vt_push);
+  conn->vt_push = openvasd_vt_push_new (vt_func, user_data);
+  response = openvasd_vt_stream_start (conn, conn->vt_push);
+  if (response->code != RESP_CODE_OK)
+    g_clear_pointer (&conn->vt_push, openvasd_vt_push_free);
+
+  return response;
+}
+
 void
 openvasd_reset_vt_stream (openvasd_connector_t conn)
 {
@@ -477,6 +746,18 @@ openvasd_get_vt_stream (openvasd_connector_t conn)
 
   gvm_http_multi_result_t mc = gvm_http_multi_perform (multi, &running);
 
+  // All VTs pushed, check the end of the feed
+  if (running == 0 && conn->vt_push)
+    {
+      int ret = gvm_json_push_parser_finish (&conn->vt_push->parser);
+
+      if (ret)
+        g_warning ("%s: Error parsing VT stream: %s", __func__,
+                   conn->vt_push->parser.error_message);
+      g_clear_pointer (&conn->vt_push, openvasd_vt_push_free);
+      return ret;
+    }
+
   if (mc == GVM_HTTP_OK && running)
     {
       /* wait for activity, timeout, or "nothing" */
@@ -512,9 +793,6 @@ openvasd_get_vts (openvasd_connector_t conn)
 
   g_string_free (path, TRUE);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-
   openvasd_reset_vt_stream (conn);
   return response;
 }
@@ -547,10 +825,12 @@ openvasd_start_scan (openvasd_connector_t conn, gchar *data)
     }
 
   // Get the Scan ID
-  parser = cJSON_Parse (openvasd_vt_stream_str (conn));
+  parser = cJSON_Parse (response->body);
   if (!parser)
     {
       const gchar *error_ptr = cJSON_GetErrorPtr ();
+      gchar *body = response->body;
+
       g_warning ("%s: Error parsing json string to get the scan ID", __func__);
       if (error_ptr != NULL)
         {
@@ -562,6 +842,8 @@ openvasd_start_scan (openvasd_connector_t conn, gchar *data)
           response->body = g_strdup (
             "{\"error\": \"Parsing json string to get the scan ID\"}");
         }
+      // The error points into the old body
+      g_free (body);
       response->code = RESP_CODE_ERR;
       cJSON_Delete (parser);
       openvasd_reset_vt_stream (conn);
@@ -604,7 +886,6 @@ openvasd_start_scan (openvasd_connector_t conn, gchar *data)
     }
 
   cJSON_Delete (parser);
-  response->body = g_strdup (openvasd_vt_stream_str (conn));
   openvasd_reset_vt_stream (conn);
   return response;
 }
@@ -637,9 +918,6 @@ openvasd_stop_scan (openvasd_connector_t conn)
 
   g_string_free (path, TRUE);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-
   openvasd_reset_vt_stream (conn);
   return response;
 }
@@ -675,10 +953,9 @@ openvasd_get_scan_results (openvasd_connector_t conn, long first, long last)
   response = openvasd_send_request (conn, GET, path->str, NULL, NULL);
   g_string_free (path, TRUE);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       g_warning ("%s: Not possible to get scan results", __func__);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get scan results\"}");
@@ -801,6 +1078,7 @@ parse_results (const gchar *body, GSList **results)
   cJSON *result_obj = NULL;
   const gchar *err = NULL;
   openvasd_result_t result = NULL;
+  GSList *parsed = NULL;
   int ret = -1;
 
   parser = cJSON_Parse (body);
@@ -859,11 +1137,13 @@ parse_results (const gchar *body, GSList **results)
       detail_source_type, detail_source_name, detail_source_description);
 
     g_free (port);
-    *results = g_slist_append (*results, result);
+    // Prepend and reverse at the end, appending each would be quadratic
+    parsed = g_slist_prepend (parsed, result);
     ret = 200;
   }
 
 res_cleanup:
+  *results = g_slist_concat (*results, g_slist_reverse (parsed));
   if (err != NULL)
     {
       g_warning ("%s: Unable to parse scan results. Reason: %s", __func__, err);
@@ -891,11 +1171,421 @@ openvasd_parsed_results (openvasd_connector_t conn, unsigned long first,
   return ret;
 }
 
-openvasd_resp_t
-openvasd_get_scan_status (openvasd_connector_t conn)
+/**
+ * @brief Create an empty result batch.
+ *
+ * @return The batch. Must be freed with openvasd_result_batch_free().
+ */
+openvasd_result_batch_t
+openvasd_result_batch_new (void)
+{
+  openvasd_result_batch_t batch;
+
+  batch = g_malloc0 (sizeof (struct openvasd_result_batch));
+  batch->strings = g_string_chunk_new (64 * 1024);
+
+  return batch;
+}
+
+/**
+ * @brief Free a result batch and all its strings.
+ *
+ * @param batch The batch. Safe to pass NULL.
+ */
+void
+openvasd_result_batch_free (openvasd_result_batch_t batch)
+{
+  if (batch == NULL)
+    return;
+
+  g_free (batch->ids);
+  for (int column = 0; column < RESULT_BATCH_COLUMNS; column++)
+    g_free (batch->columns[column]);
+  g_string_chunk_free (batch->strings);
+  g_free (batch);
+}
+
+/**
+ * @brief Get the number of results in a batch.
+ *
+ * @param batch The batch.
+ *
+ * @return Number of results.
+ */
+guint
+openvasd_result_batch_len (openvasd_result_batch_t batch)
+{
+  return batch ? batch->count : 0;
+}
+
+/**
+ * @brief Get a string member of a result in a batch.
+ *
+ * @param batch   The batch.
+ * @param index   Index of the result.
+ * @param member  The member.
+ *
+ * @return The value, NULL if missing. Valid as long as the batch.
+ */
+const gchar *
+openvasd_result_batch_str (openvasd_result_batch_t batch, guint index,
+                           openvasd_result_member_string_t member)
+{
+  if (batch == NULL || index >= batch->count || (int) member < 0
+      || member >= RESULT_BATCH_COLUMNS)
+    return NULL;
+
+  return batch->columns[member][index];
+}
+
+/**
+ * @brief Get an integer member of a result in a batch.
+ *
+ * @param batch   The batch.
+ * @param index   Index of the result.
+ * @param member  The member.
+ *
+ * @return The value, -1 if the result or member does not exist.
+ */
+long
+openvasd_result_batch_int (openvasd_result_batch_t batch, guint index,
+                           openvasd_result_member_int_t member)
 {
+  if (batch == NULL || index >= batch->count || member != ID)
+    return -1;
+
+  return batch->ids[index];
+}
+
+/**
+ * @brief State of a result while it is read.
+ */
+struct result_batch_row
+{
+  unsigned long id;                           /**< Result ID. */
+  int port;                                   /**< Port number. */
+  const gchar *protocol;                      /**< Protocol of the port. */
+  const gchar *columns[RESULT_BATCH_COLUMNS]; /**< String members. */
+};
+
+/**
+ * @brief Get the key of an object member in a JSON path.
+ *
+ * @param path  The path.
+ * @param n     Position in the path, 0 is the root container.
+ *
+ * @return The key, NULL if there is none.
+ */
+static const gchar *
+json_path_key (GQueue *path, guint n)
+{
+  gvm_json_path_elem_t *elem = g_queue_peek_nth (path, n);
+
+  return elem ? elem->key : NULL;
+}
+
+/**
+ * @brief Store a string value of a result member.
+ *
+ * @param batch  The batch.
+ * @param row    The result being read.
+ * @param path   Path of the value.
+ * @param value  The value.
+ */
+static void
+result_batch_row_set_str (openvasd_result_batch_t batch,
+                          struct result_batch_row *row, GQueue *path,
+                          const gchar *value)
+{
+  static const struct
+  {
+    const gchar *key;
+    int column;
+  } members[] = {{"type", TYPE},
+                 {"ip_address", IP_ADDRESS},
+                 {"hostname", HOSTNAME},
+                 {"oid", OID},
+                 {"message", MESSAGE}},
+    detail[] = {{"name", DETAIL_NAME}, {"value", DETAIL_VALUE}},
+    source[] = {{"type", DETAIL_SOURCE_TYPE},
+                {"name", DETAIL_SOURCE_NAME},
+                {"description", DETAIL_SOURCE_DESCRIPTION}};
+  const gchar *key = json_path_key (path, path->length - 1);
+  int column = -1;
+
+  if (path->length == 2 && g_strcmp0 (key, "protocol") == 0)
+    {
+      row->protocol = g_string_chunk_insert_const (batch->strings, value);
+      return;
+    }
+  if (path->length == 2)
+    for (size_t i = 0; i < G_N_ELEMENTS (members); i++)
+      if (g_strcmp0 (key, members[i].key) == 0)
+        column = members[i].column;
+  if (path->length == 3 && !g_strcmp0 (json_path_key (path, 1), "detail"))
+    for (size_t i = 0; i < G_N_ELEMENTS (detail); i++)
+      if (g_strcmp0 (key, detail[i].key) == 0)
+        column = detail[i].column;
+  if (path->length == 4 && !g_strcmp0 (json_path_key (path, 1), "detail")
+      && !g_strcmp0 (json_path_key (path, 2), "source"))
+    for (size_t i = 0; i < G_N_ELEMENTS (source); i++)
+      if (g_strcmp0 (key, source[i].key) == 0)
+        column = source[i].column;
+
+  if (column < 0)
+    return;
+  // Messages and detail values are long and mostly unique
+  if (column == MESSAGE || column == DETAIL_VALUE)
+    row->columns[column] = g_string_chunk_insert (batch->strings, value);
+  else
+    row->columns[column] = g_string_chunk_insert_const (batch->strings, value);
+}
+
+/**
+ * @brief Add a completely read result to a batch.
+ *
+ * The port is built like in openvasd_result_new().
+ *
+ * @param batch  The batch.
+ * @param row    The result.
+ */
+static void
+result_batch_add_row (openvasd_result_batch_t batch,
+                      struct result_batch_row *row)
+{
+  gchar port[64];
+
+  if (batch->count == batch->allocated)
+    {
+      batch->allocated = batch->allocated ? batch->allocated * 2 : 256;
+      batch->ids = g_renew (unsigned long, batch->ids, batch->allocated);
+      for (int column = 0; column < RESULT_BATCH_COLUMNS; column++)
+        batch->columns[column] =
+          g_renew (const gchar *, batch->columns[column], batch->allocated);
+    }
+
+  if (!g_strcmp0 (row->columns[TYPE], "host_detail"))
+    g_strlcpy (port, "general/Host_Details", sizeof (port));
+  else if (row->port == 0 && row->protocol)
+    g_snprintf (port, sizeof (port), "general/%s", row->protocol);
+  else if (row->protocol)
+    g_snprintf (port, sizeof (port), "%d/%s", row->port, row->protocol);
+  else
+    g_strlcpy (port, "general/tcp", sizeof (port));
+  row->columns[PORT] = g_string_chunk_insert_const (batch->strings, port);
+
+  batch->ids[batch->count] = row->id;
+  for (int column = 0; column < RESULT_BATCH_COLUMNS; column++)
+    batch->columns[column][batch->count] = row->columns[column];
+  batch->count++;
+}
+
+/**
+ * @brief Read scan results into a batch.
+ *
+ * The results are read one by one with a JSON pull parser, without building
+ * a cJSON tree of the whole document. Results already in the batch are kept.
+ *
+ * @param batch   The batch to add the results to.
+ * @param stream  Stream with the JSON array of results, e.g. from fmemopen()
+ *                on a response body.
+ *
+ * @return Number of results read, -1 on error. Results read before an error
+ *         are kept.
+ */
+int
+openvasd_result_batch_read (openvasd_result_batch_t batch, FILE *stream)
+{
+  gvm_json_pull_parser_t parser;
+  gvm_json_pull_event_t event;
+  struct result_batch_row row;
+  guint first = batch ? batch->count : 0;
+  gboolean in_row = FALSE;
+  int ret = -1;
+
+  if (batch == NULL || stream == NULL)
+    return -1;
+
+  gvm_json_pull_parser_init (&parser, stream);
+  gvm_json_pull_event_init (&event);
+
+  gvm_json_pull_parser_next (&parser, &event);
+  if (event.type != GVM_JSON_PULL_EVENT_ARRAY_START)
+    goto cleanup;
+
+  while (ret == -1)
+    {
+      gvm_json_pull_parser_next (&parser, &event);
+      switch (event.type)
+        {
+        case GVM_JSON_PULL_EVENT_OBJECT_START:
+          if (event.path->length == 1)
+            {
+              memset (&row, 0, sizeof (row));
+              in_row = TRUE;
+            }
+          break;
+        case GVM_JSON_PULL_EVENT_OBJECT_END:
+          if (event.path->length == 1)
+            {
+              result_batch_add_row (batch, &row);
+              in_row = FALSE;
+            }
+          break;
+        case GVM_JSON_PULL_EVENT_ARRAY_START:
+          if (!in_row)
+            goto cleanup;
+          break;
+        case GVM_JSON_PULL_EVENT_ARRAY_END:
+          if (!in_row)
+            ret = batch->count - first;
+          break;
+        case GVM_JSON_PULL_EVENT_STRING:
+          if (!in_row)
+            goto cleanup;
+          result_batch_row_set_str (batch, &row, event.path,
+                                    event.value->valuestring);
+          break;
+        case GVM_JSON_PULL_EVENT_NUMBER:
+          if (!in_row)
+            goto cleanup;
+          if (event.path->length == 2
+              && !g_strcmp0 (json_path_key (event.path, 1), "id"))
+            row.id = event.value->valuedouble;
+          else if (event.path->length == 2
+                   && !g_strcmp0 (json_path_key (event.path, 1), "port"))
+            row.port = event.value->valueint;
+          break;
+        case GVM_JSON_PULL_EVENT_BOOLEAN:
+        case GVM_JSON_PULL_EVENT_NULL:
+          if (!in_row)
+            goto cleanup;
+          break;
+        case GVM_JSON_PULL_EVENT_ERROR:
+          g_warning ("%s: Unable to parse scan results. Reason: %s", __func__,
+                     event.error_message);
+          goto cleanup;
+        default:
+          goto cleanup;
+        }
+    }
+
+cleanup:
+  gvm_json_pull_event_cleanup (&event);
+  gvm_json_pull_parser_cleanup (&parser);
+
+  return ret;
+}
+
+/**
+ * @brief Get scan results into a batch.
+ *
+ * Like openvasd_parsed_results(), but the results are read from the body as
+ * it is, into the arrays of the batch.
+ *
+ * @param conn   Connector struct with the data necessary for the connection
+ * @param first  First result to get.
+ * @param last   Last result to get.
+ * @param batch  The batch to add the results to.
+ *
+ * @return 200 on success, the HTTP response code if the request failed, -1
+ *         if the results could not be read.
+ */
+int
+openvasd_parsed_results_batch (openvasd_connector_t conn, unsigned long first,
+                               unsigned long last,
+                               openvasd_result_batch_t batch)
+{
+  openvasd_resp_t resp;
+  FILE *stream;
+  int ret = -1;
+
+  resp = openvasd_get_scan_results (conn, first, last);
+  if (resp->code != 200)
+    ret = resp->code;
+  else if ((stream = fmemopen (resp->body, strlen (resp->body), "r")))
+    {
+      if (openvasd_result_batch_read (batch, stream) >= 0)
+        ret = 200;
+      fclose (stream);
+    }
+
+  openvasd_response_cleanup (resp);
+
+  return ret;
+}
+
+/**
+ * @brief Get the cached status of the scan of a connector.
+ *
+ * @param conn Connector struct with the data necessary for the connection
+ *
+ * @return The cache, NULL if there is no status of the scan cached.
+ */
+static struct openvasd_status_cache *
+openvasd_status_cache (openvasd_connector_t conn)
+{
+  if (conn->status_cache
+      && g_strcmp0 (conn->status_cache->scan_id, conn->scan_id) == 0)
+    return conn->status_cache;
+  return NULL;
+}
+
+/**
+ * @brief Keep the parsed status of the cached body of a scan.
+ *
+ * Only a status which parsed completely is reused when the server answers
+ * with 304. Otherwise the cache is dropped, so that the next request fetches
+ * and parses the status again.
+ *
+ * @param conn         Connector struct with the data necessary for the
+ *                     connection
+ * @param status_info  The status parsed from the cached body.
+ */
+static void
+openvasd_status_cache_set_parsed (openvasd_connector_t conn,
+                                  openvasd_scan_status_t status_info)
+{
+  struct openvasd_status_cache *cache = openvasd_status_cache (conn);
+
+  if (cache == NULL)
+    return;
+
+  if (status_info->status == OPENVASD_SCAN_STATUS_ERROR
+      || status_info->progress < 0)
+    {
+      g_clear_pointer (&conn->status_cache, openvasd_status_cache_free);
+      return;
+    }
+
+  cache->status = *status_info;
+  cache->parsed = TRUE;
+}
+
+/**
+ * @brief Get the status of a scan, revalidating the cached status.
+ *
+ * If a status of the scan was received with an ETag before, the request is
+ * conditional. When the status did not change, the server answers with 304
+ * and no body, and the cached body is returned instead. With a status wait
+ * set, the server is asked to hold the request until the status changes, for
+ * at most that many seconds.
+ *
+ * @param conn               Connector struct with the data necessary for the
+ *                           connection
+ * @param[out] not_modified  Set to TRUE if the cached status was returned.
+ *
+ * @return Response containing the status like openvasd_get_scan_status().
+ */
+static openvasd_resp_t
+get_scan_status (openvasd_connector_t conn, gboolean *not_modified)
+{
+  struct openvasd_status_cache *cache;
   openvasd_resp_t response;
   GString *path = NULL;
+  gchar *headers[3] = {NULL, NULL, NULL};
+
+  *not_modified = FALSE;
 
   path = g_string_new ("/scans");
   if (conn->scan_id != NULL && conn->scan_id[0] != '\0')
@@ -914,108 +1604,155 @@ openvasd_get_scan_status (openvasd_connector_t conn)
       return response;
     }
 
-  response = openvasd_send_request (conn, GET, path->str, NULL, NULL);
+  cache = openvasd_status_cache (conn);
+  if (cache)
+    {
+      headers[0] = g_strdup_printf ("If-None-Match: %s", cache->etag);
+      if (conn->status_wait > 0)
+        headers[1] = g_strdup_printf ("Prefer: wait=%d", conn->status_wait);
+    }
+
+  response = openvasd_send_request_full (conn, GET, path->str, NULL,
+                                         (const gchar **) headers, "ETag");
   g_string_free (path, TRUE);
+  g_free (headers[0]);
+  g_free (headers[1]);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get scan status\"}");
       g_warning ("%s: Not possible to get scan status", __func__);
     }
+  else if (response->code == 304 && cache)
+    {
+      g_free (response->body);
+      response->body = g_strdup (cache->body);
+      response->code = 200;
+      *not_modified = TRUE;
+    }
+  else if (response->code == 200 && response->header)
+    {
+      if (conn->status_cache == NULL)
+        conn->status_cache = g_malloc0 (sizeof (struct openvasd_status_cache));
+      cache = conn->status_cache;
+      g_free (cache->scan_id);
+      cache->scan_id = g_strdup (conn->scan_id);
+      g_free (cache->etag);
+      cache->etag = g_strdup (response->header);
+      g_free (cache->body);
+      cache->body = g_strdup (response->body);
+      cache->parsed = FALSE;
+    }
+  else
+    g_clear_pointer (&conn->status_cache, openvasd_status_cache_free);
 
   openvasd_reset_vt_stream (conn);
   return response;
 }
 
-/** @brief Get the value from an object or error.
+/**
+ * @brief Get the status of a scan.
+ *
+ * The request is conditional if the status was received with an ETag before,
+ * see get_scan_status().
  *
- *  @return 0 on success, -1 on error.
+ * @param conn Connector struct with the data necessary for the connection
+ *
+ * @return Response containing the status. The body is the same as in the last
+ *         response if the status did not change.
  */
-static int
-get_member_value_or_fail (cJSON *reader, const gchar *member)
+openvasd_resp_t
+openvasd_get_scan_status (openvasd_connector_t conn)
 {
-  int ret;
+  gboolean not_modified;
 
-  if (gvm_json_obj_check_int (reader, member, &ret))
-    return -1;
-
-  return ret;
+  return get_scan_status (conn, &not_modified);
 }
 
+/**
+ * @brief Calculate the progress of a scan from its status.
+ *
+ * Only the counters in "host_info" are read, with the pull parser, so that no
+ * tree of the whole status is built.
+ *
+ * @param body The status as received from openvasd.
+ *
+ * @return The progress between 0 and 100, -1 on error.
+ */
 static int
-openvasd_get_scan_progress_ext (openvasd_connector_t conn,
-                                openvasd_resp_t response)
-{
-  cJSON *parser;
-  cJSON *reader = NULL;
-  const gchar *err = NULL;
-  int all = 0, excluded = 0, dead = 0, alive = 0, queued = 0, finished = 0;
+parse_progress (const gchar *body)
+{
+  gvm_json_pull_parser_t parser;
+  gvm_json_pull_event_t event;
+  int all = -1, excluded = -1, dead = -1, alive = -1, queued = -1;
+  int finished = -1;
+  const gchar *counters[] = {"all",   "excluded", "dead",
+                             "alive", "queued",   "finished"};
+  int *values[] = {&all, &excluded, &dead, &alive, &queued, &finished};
   int running_hosts_progress_sum = 0;
-
-  openvasd_resp_t resp;
+  gboolean host_info = FALSE, started = FALSE;
+  FILE *stream;
   int progress = -1;
 
-  if (!response && !conn)
+  stream = fmemopen ((void *) body, strlen (body), "r");
+  if (stream == NULL)
     return -1;
 
-  if (response == NULL)
-    resp = openvasd_get_scan_status (conn);
-  else
-    resp = response;
+  gvm_json_pull_parser_init (&parser, stream);
+  gvm_json_pull_event_init (&event);
 
-  if (resp->code == 404)
-    return -2;
-  else if (resp->code != 200)
-    return -1;
+  gvm_json_pull_parser_next (&parser, &event);
+  if (event.type != GVM_JSON_PULL_EVENT_OBJECT_START)
+    goto cleanup;
 
-  parser = cJSON_Parse (resp->body);
-  if (!parser)
+  while (event.type != GVM_JSON_PULL_EVENT_EOF)
     {
-      err = cJSON_GetErrorPtr ();
-      goto cleanup;
-    }
+      gvm_json_pull_parser_next (&parser, &event);
+      if (event.type == GVM_JSON_PULL_EVENT_ERROR)
+        {
+          g_warning ("%s: Unable to parse scan status. Reason: %s", __func__,
+                     event.error_message);
+          goto cleanup;
+        }
+      if (event.path->length == 0
+          || g_strcmp0 (json_path_key (event.path, 0), "host_info"))
+        continue;
 
-  reader = cJSON_GetObjectItem (parser, "host_info");
-  if (reader == NULL)
-    {
-      goto cleanup;
+      if (event.path->length == 1)
+        {
+          if (event.type != GVM_JSON_PULL_EVENT_OBJECT_END)
+            {
+              host_info = TRUE;
+              started = event.type == GVM_JSON_PULL_EVENT_OBJECT_START;
+            }
+        }
+      else if (event.type != GVM_JSON_PULL_EVENT_NUMBER)
+        continue;
+      // read progress of single running hosts
+      else if (event.path->length == 3
+               && !g_strcmp0 (json_path_key (event.path, 1), "scanning"))
+        running_hosts_progress_sum += event.value->valuedouble;
+      // read general hosts count
+      else if (event.path->length == 2)
+        for (guint i = 0; i < G_N_ELEMENTS (counters); i++)
+          if (!g_strcmp0 (json_path_key (event.path, 1), counters[i]))
+            *values[i] = event.value->valueint;
     }
-  if (!cJSON_IsObject (reader))
+
+  if (!host_info)
+    goto cleanup;
+  if (!started)
     {
       // Scan still not started. No information.
       progress = 0;
       goto cleanup;
     }
 
-  // read general hosts count
-  all = get_member_value_or_fail (reader, "all");
-  excluded = get_member_value_or_fail (reader, "excluded");
-  dead = get_member_value_or_fail (reader, "dead");
-  alive = get_member_value_or_fail (reader, "alive");
-  queued = get_member_value_or_fail (reader, "queued");
-  finished = get_member_value_or_fail (reader, "finished");
-
-  // read progress of single running hosts
-  cJSON *scanning;
-  scanning = cJSON_GetObjectItem (reader, "scanning");
-  if (scanning != NULL && cJSON_IsObject (scanning))
-    {
-      cJSON *host = scanning->child;
-      while (host)
-        {
-          running_hosts_progress_sum += cJSON_GetNumberValue (host);
-          host = host->next;
-        }
-    }
-
   if (all < 0 || excluded < 0 || dead < 0 || alive < 0 || queued < 0
       || finished < 0)
-    {
-      goto cleanup;
-    }
+    goto cleanup;
 
   if ((all + finished - dead) > 0)
     progress = (running_hosts_progress_sum + 100 * (alive + finished))
@@ -1024,9 +1761,37 @@ openvasd_get_scan_progress_ext (openvasd_connector_t conn,
     progress = 100;
 
 cleanup:
-  if (err != NULL)
-    g_warning ("%s: Unable to parse scan status. Reason: %s", __func__, err);
-  cJSON_Delete (parser);
+  gvm_json_pull_event_cleanup (&event);
+  gvm_json_pull_parser_cleanup (&parser);
+  fclose (stream);
+
+  return progress;
+}
+
+static int
+openvasd_get_scan_progress_ext (openvasd_connector_t conn,
+                                openvasd_resp_t response)
+{
+  openvasd_resp_t resp;
+  int progress;
+
+  if (!response && !conn)
+    return -1;
+
+  if (response == NULL)
+    resp = openvasd_get_scan_status (conn);
+  else
+    resp = response;
+
+  if (resp->code == 404)
+    progress = -2;
+  else if (resp->code != 200)
+    progress = -1;
+  else
+    progress = parse_progress (resp->body);
+
+  if (response == NULL)
+    openvasd_response_cleanup (resp);
 
   return progress;
 }
@@ -1102,8 +1867,20 @@ openvasd_parsed_scan_status (openvasd_connector_t conn)
   int progress = -1;
   openvasd_status_t status_code = OPENVASD_SCAN_STATUS_ERROR;
   openvasd_scan_status_t status_info = NULL;
+  struct openvasd_status_cache *cache;
+  gboolean not_modified;
 
-  resp = openvasd_get_scan_status (conn);
+  resp = get_scan_status (conn, &not_modified);
+
+  // The status did not change since it was parsed last
+  cache = openvasd_status_cache (conn);
+  if (not_modified && cache->parsed)
+    {
+      openvasd_response_cleanup (resp);
+      status_info = g_malloc0 (sizeof (struct openvasd_scan_status));
+      *status_info = cache->status;
+      return status_info;
+    }
 
   status_info = g_malloc0 (sizeof (struct openvasd_scan_status));
   if (resp->code != 200 || parse_status (resp->body, status_info) == -1)
@@ -1111,6 +1888,7 @@ openvasd_parsed_scan_status (openvasd_connector_t conn)
       status_info->status = status_code;
       status_info->response_code = resp->code;
       openvasd_response_cleanup (resp);
+      g_clear_pointer (&conn->status_cache, openvasd_status_cache_free);
       return status_info;
     }
 
@@ -1118,6 +1896,8 @@ openvasd_parsed_scan_status (openvasd_connector_t conn)
   openvasd_response_cleanup (resp);
   status_info->progress = progress;
 
+  openvasd_status_cache_set_parsed (conn, status_info);
+
   return status_info;
 }
 
@@ -1148,10 +1928,9 @@ openvasd_delete_scan (openvasd_connector_t conn)
 
   g_string_free (path, TRUE);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to delete scan.\"}");
       g_warning ("%s: Not possible to delete scan", __func__);
@@ -1168,10 +1947,9 @@ openvasd_get_health_alive (openvasd_connector_t conn)
 
   response = openvasd_send_request (conn, GET, "/health/alive", NULL, NULL);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get health information.\"}");
       g_warning ("%s: Not possible to get health information", __func__);
@@ -1189,10 +1967,9 @@ openvasd_get_health_ready (openvasd_connector_t conn)
   response =
     openvasd_send_request (conn, GET, "/health/ready", NULL, "feed-version");
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get health information.\"}");
       g_warning ("%s: Not possible to get health information", __func__);
@@ -1209,10 +1986,9 @@ openvasd_get_health_started (openvasd_connector_t conn)
 
   response = openvasd_send_request (conn, GET, "/health/started", NULL, NULL);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get health information.\"}");
       g_warning ("%s: Not possible to get health information", __func__);
@@ -1248,10 +2024,9 @@ openvasd_get_performance (openvasd_connector_t conn,
   response = openvasd_send_request (conn, GET, query, NULL, NULL);
   g_free (query);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body = g_strdup (
         "{\"error\": \"Not possible to get performance information.\"}");
       g_warning ("%s: Not possible to get performance information", __func__);
@@ -1308,10 +2083,9 @@ openvasd_get_scan_preferences (openvasd_connector_t conn)
   response =
     openvasd_send_request (conn, GET, "/scans/preferences", NULL, NULL);
 
-  if (response->code != RESP_CODE_ERR)
-    response->body = g_strdup (openvasd_vt_stream_str (conn));
-  else
+  if (response->code == RESP_CODE_ERR)
     {
+      g_free (response->body);
       response->body =
         g_strdup ("{\"error\": \"Not possible to get scans preferences.\"}");
       g_warning ("%s: Not possible to get scans_preferences", __func__);
@@ -1527,94 +2301,117 @@ prefs_cleanup:
 
 // Scan config builder
 static void
-add_port_to_scan_json (gpointer range, gpointer p_array)
+add_port_to_scan_json (gpointer range, gpointer writer)
 {
   range_t *ports = range;
 
-  cJSON *port = cJSON_CreateObject ();
+  gvm_json_writer_object_start (writer, NULL);
   if (ports->type == 1)
-    cJSON_AddStringToObject (port, "protocol", "udp");
+    gvm_json_writer_string (writer, "protocol", "udp");
   else
-    cJSON_AddStringToObject (port, "protocol", "tcp");
+    gvm_json_writer_string (writer, "protocol", "tcp");
 
-  cJSON *ranges_array = cJSON_CreateArray ();
-  cJSON *range_obj = cJSON_CreateObject ();
-  cJSON_AddNumberToObject (range_obj, "start", ports->start);
+  gvm_json_writer_array_start (writer, "range");
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_int (writer, "start", ports->start);
 
   if (ports->end > ports->start && ports->end < 65535)
-    cJSON_AddNumberToObject (range_obj, "end", ports->end);
+    gvm_json_writer_int (writer, "end", ports->end);
   else
-    cJSON_AddNumberToObject (range_obj, "end", ports->start);
-  cJSON_AddItemToArray (ranges_array, range_obj);
-  cJSON_AddItemToObject (port, "range", ranges_array);
-  cJSON_AddItemToArray ((cJSON *) p_array, port);
+    gvm_json_writer_int (writer, "end", ports->start);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_object_end (writer);
 }
 
 static void
-add_credential_to_scan_json (gpointer credentials, gpointer cred_array)
+add_credential_to_scan_json (gpointer credentials, gpointer writer)
 {
   GHashTableIter auth_data_iter;
   gchar *auth_data_name, *auth_data_value;
-  cJSON *cred_obj = NULL;
 
   openvasd_credential_t *cred = credentials;
 
-  cred_obj = cJSON_CreateObject ();
-  cJSON_AddStringToObject (cred_obj, "service", cred->service);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_string (writer, "service", cred->service);
 
   if (cred->port)
     {
-      cJSON_AddNumberToObject (cred_obj, "port", atoi (cred->port));
+      gvm_json_writer_int (writer, "port", atoi (cred->port));
     }
 
-  cJSON *cred_type_obj = cJSON_CreateObject ();
-  g_hash_table_iter_init (&auth_data_iter, cred->auth_data);
-  while (g_hash_table_iter_next (&auth_data_iter, (gpointer *) &auth_data_name,
-                                 (gpointer *) &auth_data_value))
-    cJSON_AddStringToObject (cred_type_obj, auth_data_name, auth_data_value);
-  cJSON_AddItemToObject (cred_obj, cred->type, cred_type_obj);
+  if (cred->type)
+    {
+      gvm_json_writer_object_start (writer, cred->type);
+      g_hash_table_iter_init (&auth_data_iter, cred->auth_data);
+      while (g_hash_table_iter_next (&auth_data_iter,
+                                     (gpointer *) &auth_data_name,
+                                     (gpointer *) &auth_data_value))
+        gvm_json_writer_string (writer, auth_data_name, auth_data_value);
+      gvm_json_writer_object_end (writer);
+    }
 
-  cJSON_AddItemToArray ((cJSON *) cred_array, cred_obj);
+  gvm_json_writer_object_end (writer);
 }
 
 static void
 add_scan_preferences_to_scan_json (gpointer key, gpointer val,
-                                   gpointer scan_prefs_array)
+                                   gpointer writer)
 {
-  cJSON *pref_obj = cJSON_CreateObject ();
-  cJSON_AddStringToObject (pref_obj, "id", key);
-  cJSON_AddStringToObject (pref_obj, "value", val);
-  cJSON_AddItemToArray (scan_prefs_array, pref_obj);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_string (writer, "id", key);
+  gvm_json_writer_string (writer, "value", val);
+  gvm_json_writer_object_end (writer);
 }
 
 static void
-add_vts_to_scan_json (gpointer single_vt, gpointer vts_array)
+add_vts_to_scan_json (gpointer single_vt, gpointer writer)
 {
   GHashTableIter vt_data_iter;
   gchar *vt_param_id, *vt_param_value;
 
   openvasd_vt_single_t *vt = single_vt;
 
-  cJSON *vt_obj = cJSON_CreateObject ();
+  gvm_json_writer_object_start (writer, NULL);
 
-  cJSON_AddStringToObject (vt_obj, "oid", vt->vt_id);
+  gvm_json_writer_string (writer, "oid", vt->vt_id);
 
   if (g_hash_table_size (vt->vt_values))
     {
-      cJSON *params_array = cJSON_CreateArray ();
+      gvm_json_writer_array_start (writer, "parameters");
 
       g_hash_table_iter_init (&vt_data_iter, vt->vt_values);
       while (g_hash_table_iter_next (&vt_data_iter, (gpointer *) &vt_param_id,
                                      (gpointer *) &vt_param_value))
         {
-          cJSON *param_obj = cJSON_CreateObject ();
-          cJSON_AddNumberToObject (param_obj, "id", atoi (vt_param_id));
-          cJSON_AddStringToObject (param_obj, "value", vt_param_value);
-          cJSON_AddItemToArray (params_array, param_obj);
+          gvm_json_writer_object_start (writer, NULL);
+          gvm_json_writer_int (writer, "id", atoi (vt_param_id));
+          gvm_json_writer_string (writer, "value", vt_param_value);
+          gvm_json_writer_object_end (writer);
         }
-      cJSON_AddItemToObject (vt_obj, "parameters", params_array);
+      gvm_json_writer_array_end (writer);
     }
-  cJSON_AddItemToArray (vts_array, vt_obj);
+  gvm_json_writer_object_end (writer);
+}
+
+/**
+ * @brief Write a comma separated list of hosts as JSON array.
+ *
+ * @param writer  JSON writer.
+ * @param key     Key of the array.
+ * @param hosts   The hosts.
+ */
+static void
+add_hosts_to_scan_json (gvm_json_writer_t *writer, const gchar *key,
+                        const gchar *hosts)
+{
+  gchar **hosts_list = g_strsplit (hosts, ",", 0);
+
+  gvm_json_writer_array_start (writer, key);
+  for (int i = 0; hosts_list[i] != NULL; i++)
+    gvm_json_writer_string (writer, NULL, hosts_list[i]);
+  gvm_json_writer_array_end (writer);
+  g_strfreev (hosts_list);
 }
 
 /**
@@ -1623,6 +2420,9 @@ add_vts_to_scan_json (gpointer single_vt, gpointer vts_array)
  * JSON result consists of scan_id, message type, host ip,
  * hostname, port, together with proto, OID, result message and uri.
  *
+ * The JSON text is written directly into a string as formatted by
+ * cJSON_Print, without building a tree of the scan config first.
+ *
  * @param target      target
  * @param scan_preferences Scan preferences to be added to the scan config
  * @param vts VTS collection to be added to the scan config.
@@ -1633,126 +2433,83 @@ char *
 openvasd_build_scan_config_json (openvasd_target_t *target,
                                  GHashTable *scan_preferences, GSList *vts)
 {
-  cJSON *scan_obj = NULL;
-  cJSON *target_obj = NULL;
-  cJSON *hosts_array = NULL;
-  cJSON *exclude_hosts_array = NULL;
-  cJSON *finished_hosts_array = NULL;
-  gchar *json_str = NULL;
+  gvm_json_writer_t *writer;
+  GString *json_str;
 
   /* Build the message in json format to be published. */
-  scan_obj = cJSON_CreateObject ();
+  json_str = g_string_sized_new (256 + 128 * g_slist_length (vts));
+  writer = gvm_json_writer_new (json_str, TRUE);
+  gvm_json_writer_object_start (writer, NULL);
 
   if (target->scan_id && target->scan_id[0] != '\0')
-    cJSON_AddStringToObject (scan_obj, "scan_id", target->scan_id);
+    gvm_json_writer_string (writer, "scan_id", target->scan_id);
 
   // begin target
-  target_obj = cJSON_CreateObject ();
+  gvm_json_writer_object_start (writer, "target");
 
   // hosts
-  hosts_array = cJSON_CreateArray ();
-  gchar **hosts_list = g_strsplit (target->hosts, ",", 0);
-  for (int i = 0; hosts_list[i] != NULL; i++)
-    {
-      cJSON *host_item = NULL;
-      host_item = cJSON_CreateString (hosts_list[i]);
-      cJSON_AddItemToArray (hosts_array, host_item);
-    }
-  g_strfreev (hosts_list);
-  cJSON_AddItemToObject (target_obj, "hosts", hosts_array);
+  add_hosts_to_scan_json (writer, "hosts", target->hosts);
 
   // exclude hosts
   if (target->exclude_hosts && target->exclude_hosts[0] != '\0')
-    {
-      exclude_hosts_array = cJSON_CreateArray ();
-      gchar **exclude_hosts_list = g_strsplit (target->exclude_hosts, ",", 0);
-      for (int i = 0; exclude_hosts_list[i] != NULL; i++)
-        {
-          cJSON *exclude_host_item = NULL;
-          exclude_host_item = cJSON_CreateString (exclude_hosts_list[i]);
-          cJSON_AddItemToArray (exclude_hosts_array, exclude_host_item);
-        }
-      g_strfreev (exclude_hosts_list);
-      cJSON_AddItemToObject (target_obj, "excluded_hosts", exclude_hosts_array);
-    }
+    add_hosts_to_scan_json (writer, "excluded_hosts", target->exclude_hosts);
 
   // finished hosts
   if (target->finished_hosts && target->finished_hosts[0] != '\0')
-    {
-      finished_hosts_array = cJSON_CreateArray ();
-      gchar **finished_hosts_list = g_strsplit (target->finished_hosts, ",", 0);
-      for (int i = 0; finished_hosts_list[i] != NULL; i++)
-        {
-          cJSON *finished_host_item = NULL;
-          finished_host_item = cJSON_CreateString (finished_hosts_list[i]);
-          cJSON_AddItemToArray (finished_hosts_array, finished_host_item);
-        }
-      g_strfreev (hosts_list);
-      cJSON_AddItemToObject (target_obj, "finished_hosts",
-                             finished_hosts_array);
-    }
+    add_hosts_to_scan_json (writer, "finished_hosts", target->finished_hosts);
 
   // ports
   if (target->ports && target->ports[0] != '\0')
     {
-      cJSON *ports_array = cJSON_CreateArray ();
       array_t *ports = port_range_ranges (target->ports);
-      g_ptr_array_foreach (ports, add_port_to_scan_json, ports_array);
+      gvm_json_writer_array_start (writer, "ports");
+      g_ptr_array_foreach (ports, add_port_to_scan_json, writer);
+      gvm_json_writer_array_end (writer);
       array_free (ports);
-      cJSON_AddItemToObject (target_obj, "ports", ports_array);
     }
 
   // credentials
-  cJSON *credentials = cJSON_CreateArray ();
-  g_slist_foreach (target->credentials, add_credential_to_scan_json,
-                   credentials);
-  cJSON_AddItemToObject (target_obj, "credentials", credentials);
+  gvm_json_writer_array_start (writer, "credentials");
+  g_slist_foreach (target->credentials, add_credential_to_scan_json, writer);
+  gvm_json_writer_array_end (writer);
 
   // reverse lookup
-  if (target->reverse_lookup_unify)
-    cJSON_AddBoolToObject (target_obj, "reverse_lookup_unify", cJSON_True);
-  else
-    cJSON_AddBoolToObject (target_obj, "reverse_lookup_unify", cJSON_False);
-
-  if (target->reverse_lookup_only)
-    cJSON_AddBoolToObject (target_obj, "reverse_lookup_only", cJSON_True);
-  else
-    cJSON_AddBoolToObject (target_obj, "reverse_lookup_only", cJSON_False);
+  gvm_json_writer_bool (writer, "reverse_lookup_unify",
+                        target->reverse_lookup_unify);
+  gvm_json_writer_bool (writer, "reverse_lookup_only",
+                        target->reverse_lookup_only);
 
   // alive test methods
-  cJSON *alive_test_methods = cJSON_CreateArray ();
+  gvm_json_writer_array_start (writer, "alive_test_methods");
   if (target->arp)
-    cJSON_AddItemToArray (alive_test_methods, cJSON_CreateString ("arp"));
+    gvm_json_writer_string (writer, NULL, "arp");
   if (target->tcp_ack)
-    cJSON_AddItemToArray (alive_test_methods, cJSON_CreateString ("tcp_ack"));
+    gvm_json_writer_string (writer, NULL, "tcp_ack");
   if (target->tcp_syn)
-    cJSON_AddItemToArray (alive_test_methods, cJSON_CreateString ("tcp_syn"));
+    gvm_json_writer_string (writer, NULL, "tcp_syn");
   if (target->consider_alive)
-    cJSON_AddItemToArray (alive_test_methods,
-                          cJSON_CreateString ("consider_alive"));
+    gvm_json_writer_string (writer, NULL, "consider_alive");
   if (target->icmp)
-    cJSON_AddItemToArray (alive_test_methods, cJSON_CreateString ("icmp"));
-  cJSON_AddItemToObject (target_obj, "alive_test_methods", alive_test_methods);
+    gvm_json_writer_string (writer, NULL, "icmp");
+  gvm_json_writer_array_end (writer);
 
-  cJSON_AddItemToObject (scan_obj, "target", target_obj);
+  gvm_json_writer_object_end (writer);
 
   // Begin Scan Preferences
-  cJSON *scan_prefs_array = cJSON_CreateArray ();
+  gvm_json_writer_array_start (writer, "scan_preferences");
   g_hash_table_foreach (scan_preferences, add_scan_preferences_to_scan_json,
-                        scan_prefs_array);
-  cJSON_AddItemToObject (scan_obj, "scan_preferences", scan_prefs_array);
+                        writer);
+  gvm_json_writer_array_end (writer);
 
   // Begin VTs
-  cJSON *vts_array = cJSON_CreateArray ();
-  g_slist_foreach (vts, add_vts_to_scan_json, vts_array);
-  cJSON_AddItemToObject (scan_obj, "vts", vts_array);
+  gvm_json_writer_array_start (writer, "vts");
+  g_slist_foreach (vts, add_vts_to_scan_json, writer);
+  gvm_json_writer_array_end (writer);
 
-  json_str = cJSON_Print (scan_obj);
-  cJSON_Delete (scan_obj);
-  if (json_str == NULL)
-    g_warning ("%s: Error while creating JSON.", __func__);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_free (writer);
 
-  return json_str;
+  return g_string_free (json_str, FALSE);
 }
 
 /**
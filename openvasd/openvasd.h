@@ -56,6 +56,8 @@ enum OPENVASD_CONNECTOR_OPTS
   OPENVASD_HOST,
   OPENVASD_SCAN_ID,
   OPENVASD_PORT,
+  OPENVASD_COMPRESS_MIN, /**< Minimum payload size to send compressed. */
+  OPENVASD_STATUS_WAIT,  /**< Seconds to wait for a scan status change. */
 };
 
 enum OPENVASD_RESULT_MEMBER_STRING
@@ -127,6 +129,8 @@ typedef enum OPENVASD_ERROR openvasd_error_t;
 
 typedef struct openvasd_result *openvasd_result_t;
 
+typedef struct openvasd_result_batch *openvasd_result_batch_t;
+
 typedef struct openvasd_connector *openvasd_connector_t;
 
 typedef struct openvasd_scan_status *openvasd_scan_status_t;
@@ -175,6 +179,25 @@ int
 openvasd_parsed_results (openvasd_connector_t, unsigned long, unsigned long,
                          GSList **);
 
+openvasd_result_batch_t openvasd_result_batch_new (void);
+
+void openvasd_result_batch_free (openvasd_result_batch_t);
+
+guint openvasd_result_batch_len (openvasd_result_batch_t);
+
+const gchar *openvasd_result_batch_str (openvasd_result_batch_t, guint,
+                                        openvasd_result_member_string_t);
+
+long openvasd_result_batch_int (openvasd_result_batch_t, guint,
+                                openvasd_result_member_int_t);
+
+int
+openvasd_result_batch_read (openvasd_result_batch_t, FILE *);
+
+int
+openvasd_parsed_results_batch (openvasd_connector_t, unsigned long,
+                               unsigned long, openvasd_result_batch_t);
+
 openvasd_resp_t openvasd_get_scan_status (openvasd_connector_t);
 
 openvasd_scan_status_t openvasd_parsed_scan_status (openvasd_connector_t);
@@ -273,6 +296,15 @@ openvasd_build_scan_config_json (openvasd_target_t *, GHashTable *, GSList *);
 /* VT stream */
 openvasd_resp_t openvasd_get_vt_stream_init (openvasd_connector_t);
 
+/**
+ * @brief Function called with each VT of a parsed VT stream.
+ */
+typedef void (*openvasd_vt_func_t) (nvti_t *, gpointer);
+
+openvasd_resp_t openvasd_get_vt_stream_push_init (openvasd_connector_t,
+                                                  openvasd_vt_func_t,
+                                                  gpointer);
+
 int openvasd_get_vt_stream (openvasd_connector_t);
 
 void openvasd_reset_vt_stream (openvasd_connector_t);
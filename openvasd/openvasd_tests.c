@@ -99,6 +99,128 @@ Ensure (openvasd, parse_results_handles_details)
     g_slist_free_full (results, (GDestroyNotify) openvasd_result_free);
 }
 
+Ensure (openvasd, result_batch_matches_parse_results)
+{
+  const gchar *str;
+  GSList *results = NULL, *item;
+  openvasd_result_batch_t batch;
+  FILE *stream;
+  guint i;
+
+  str =
+    "[ {"
+    "  \"id\": 16,"
+    "  \"type\": \"host_detail\","
+    "  \"ip_address\": \"192.168.0.101\","
+    "  \"hostname\": \"g\","
+    "  \"oid\": \"1.3.6.1.4.1.25623.1.0.103997\","
+    "  \"message\": \"Detected\","
+    "  \"detail\": {"
+    "    \"name\": \"MAC\","
+    "    \"value\": \"00:1A:2B:3C:4D:5E\","
+    "    \"source\": {"
+    "      \"type\": \"nvt\","
+    "      \"name\": \"1.3.6.1.4.1.25623.1.0.103585\","
+    "      \"description\": \"Nmap MAC Scan\""
+    "    }"
+    "  }"
+    "}, {"
+    "  \"id\": 17,"
+    "  \"type\": \"alarm\","
+    "  \"ip_address\": \"192.168.0.101\","
+    "  \"port\": 443,"
+    "  \"protocol\": \"tcp\","
+    "  \"oid\": \"1.3.6.1.4.1.25623.1.0.103997\","
+    "  \"message\": \"Vulnerable\","
+    "  \"extra\": [\"ignored\", {\"name\": \"ignored\"}]"
+    "}, {"
+    "  \"id\": 18,"
+    "  \"type\": \"log\","
+    "  \"ip_address\": \"192.168.0.102\","
+    "  \"protocol\": \"udp\""
+    "}, {"
+    "  \"id\": 19,"
+    "  \"type\": \"error\""
+    "} ]";
+
+  parse_results (str, &results);
+  batch = openvasd_result_batch_new ();
+  stream = fmemopen ((void *) str, strlen (str), "r");
+  assert_that (openvasd_result_batch_read (batch, stream), is_equal_to (4));
+  fclose (stream);
+
+  assert_that (openvasd_result_batch_len (batch),
+               is_equal_to (g_slist_length (results)));
+  for (item = results, i = 0; item; item = item->next, i++)
+    {
+      openvasd_result_t result = item->data;
+
+      assert_that (openvasd_result_batch_int (batch, i, ID),
+                   is_equal_to (result->id));
+      for (int member = TYPE; member <= DETAIL_SOURCE_DESCRIPTION; member++)
+        {
+          const gchar *value = openvasd_result_batch_str (batch, i, member);
+          const gchar *expected =
+            openvasd_get_result_member_str (result, member);
+
+          if (expected)
+            assert_that (value, is_equal_to_string (expected));
+          else
+            assert_that (value, is_null);
+        }
+    }
+  assert_that (openvasd_result_batch_str (batch, 1, PORT),
+               is_equal_to_string ("443/tcp"));
+  assert_that (openvasd_result_batch_str (batch, 2, PORT),
+               is_equal_to_string ("general/udp"));
+  // Repeated short strings are stored once
+  assert_that (openvasd_result_batch_str (batch, 0, OID),
+               is_equal_to (openvasd_result_batch_str (batch, 1, OID)));
+
+  assert_that (openvasd_result_batch_str (batch, 4, TYPE), is_null);
+  assert_that (openvasd_result_batch_int (batch, 4, ID), is_equal_to (-1));
+
+  g_slist_free_full (results, (GDestroyNotify) openvasd_result_free);
+  openvasd_result_batch_free (batch);
+}
+
+Ensure (openvasd, result_batch_read_rejects_invalid_results)
+{
+  openvasd_result_batch_t batch;
+  const gchar *str;
+  FILE *stream;
+
+  batch = openvasd_result_batch_new ();
+
+  str = "{\"error\": \"no results\"}";
+  stream = fmemopen ((void *) str, strlen (str), "r");
+  assert_that (openvasd_result_batch_read (batch, stream), is_equal_to (-1));
+  fclose (stream);
+
+  str = "[{\"id\": 1}, 2]";
+  stream = fmemopen ((void *) str, strlen (str), "r");
+  assert_that (openvasd_result_batch_read (batch, stream), is_equal_to (-1));
+  fclose (stream);
+  // Results read before the error are kept
+  assert_that (openvasd_result_batch_len (batch), is_equal_to (1));
+
+  str = "[{\"id\": 2}, {\"id\": ";
+  stream = fmemopen ((void *) str, strlen (str), "r");
+  assert_that (openvasd_result_batch_read (batch, stream), is_equal_to (-1));
+  fclose (stream);
+  assert_that (openvasd_result_batch_len (batch), is_equal_to (2));
+
+  str = "[]";
+  stream = fmemopen ((void *) str, strlen (str), "r");
+  assert_that (openvasd_result_batch_read (batch, stream), is_equal_to (0));
+  fclose (stream);
+
+  assert_that (openvasd_result_batch_read (NULL, stream), is_equal_to (-1));
+  assert_that (openvasd_result_batch_len (NULL), is_equal_to (0));
+  openvasd_result_batch_free (batch);
+  openvasd_result_batch_free (NULL);
+}
+
 /* parse_status */
 
 Ensure (openvasd, parse_status_start_end_time)
@@ -134,6 +256,103 @@ Ensure (openvasd, parse_status_start_end_time)
   g_free (openvasd_scan_status);
 }
 
+Ensure (openvasd, parse_progress_reads_host_info)
+{
+  const gchar *str;
+
+  str = "{"
+        "  \"status\":\"running\","
+        "  \"host_info\":{"
+        "    \"all\":3,"
+        "    \"excluded\":0,"
+        "    \"dead\":1,"
+        "    \"alive\":1,"
+        "    \"queued\":0,"
+        "    \"finished\":1,"
+        "    \"scanning\":{\"192.168.0.1\":40,\"192.168.0.2\":20},"
+        "    \"remaining_vts_per_host\":{\"192.168.0.1\":12}"
+        "  },"
+        "  \"end_time\":null"
+        "}";
+  // (60 + 100 * (1 + 1)) / (3 + 1 - 1)
+  assert_that (parse_progress (str), is_equal_to (86));
+
+  str = "{\"host_info\":{\"all\":0,\"excluded\":0,\"dead\":0,"
+        "\"alive\":0,\"queued\":0,\"finished\":0}}";
+  assert_that (parse_progress (str), is_equal_to (100));
+
+  // Scan still not started
+  assert_that (parse_progress ("{\"status\":\"stored\",\"host_info\":null}"),
+               is_equal_to (0));
+
+  // Missing counter
+  str = "{\"host_info\":{\"all\":1,\"excluded\":0,\"dead\":0,"
+        "\"alive\":0,\"queued\":1}}";
+  assert_that (parse_progress (str), is_equal_to (-1));
+
+  assert_that (parse_progress ("{\"status\":\"running\"}"), is_equal_to (-1));
+  assert_that (parse_progress ("[]"), is_equal_to (-1));
+  assert_that (parse_progress ("{\"host_info\":{\"all\":"), is_equal_to (-1));
+}
+
+Ensure (openvasd, build_scan_config_json_prints_like_cjson)
+{
+  openvasd_target_t *target;
+  openvasd_credential_t *credential;
+  openvasd_vt_single_t *vt;
+  GHashTable *scan_preferences;
+  GSList *vts = NULL;
+  cJSON *parsed;
+  gchar *json, *printed;
+
+  target = openvasd_target_new ("scan-1", "192.168.0.1,192.168.0.2",
+                                "T:22,80-82,U:161", "192.168.0.3", 1, 0);
+  openvasd_target_set_finished_hosts (target, "192.168.0.4");
+  openvasd_target_add_alive_test_methods (target, TRUE, FALSE, TRUE, FALSE,
+                                          FALSE);
+  credential = openvasd_credential_new ("up", "ssh", "22");
+  openvasd_credential_set_auth_data (credential, "username", "admin");
+  openvasd_credential_set_auth_data (credential, "password", "\"p\\w\"\n");
+  openvasd_target_add_credential (target, credential);
+
+  scan_preferences = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                            g_free);
+  g_hash_table_insert (scan_preferences, g_strdup ("max_checks"),
+                       g_strdup ("4"));
+
+  vt = openvasd_vt_single_new ("1.3.6.1.4.1.25623.1.0.100315");
+  vts = g_slist_append (vts, vt);
+  vt = openvasd_vt_single_new ("1.3.6.1.4.1.25623.1.0.10330");
+  openvasd_vt_single_add_value (vt, "1", "yes");
+  openvasd_vt_single_add_value (vt, "2", "");
+  vts = g_slist_append (vts, vt);
+
+  json = openvasd_build_scan_config_json (target, scan_preferences, vts);
+  parsed = cJSON_Parse (json);
+  assert_that (parsed, is_not_null);
+  printed = cJSON_Print (parsed);
+  assert_that (json, is_equal_to_string (printed));
+  assert_that (cJSON_GetArraySize (cJSON_GetObjectItem (
+                 cJSON_GetObjectItem (parsed, "target"), "ports")),
+               is_equal_to (3));
+  g_free (json);
+  cJSON_free (printed);
+  cJSON_Delete (parsed);
+
+  // Empty collections
+  json = openvasd_build_scan_config_json (target, scan_preferences, NULL);
+  parsed = cJSON_Parse (json);
+  printed = cJSON_Print (parsed);
+  assert_that (json, is_equal_to_string (printed));
+  g_free (json);
+  cJSON_free (printed);
+  cJSON_Delete (parsed);
+
+  g_slist_free_full (vts, (GDestroyNotify) openvasd_vt_single_free);
+  g_hash_table_destroy (scan_preferences);
+  openvasd_target_free (target);
+}
+
 Ensure (openvasd, openvasd_connector_builder_all_valid_fields)
 {
   openvasd_connector_t conn = openvasd_connector_new();
@@ -204,6 +423,86 @@ Ensure (openvasd, openvasd_connector_builder_invalid_protocol)
   g_free(conn);
 }
 
+Ensure (openvasd, openvasd_connector_builder_compress_min)
+{
+  openvasd_connector_t conn = openvasd_connector_new ();
+  int compress_min = 4096, negative = -1;
+
+  assert_that (openvasd_connector_builder (conn, OPENVASD_COMPRESS_MIN,
+                                           &compress_min),
+               is_equal_to (OPENVASD_OK));
+  assert_that (conn->compress_min, is_equal_to (4096));
+  assert_that (openvasd_connector_builder (conn, OPENVASD_COMPRESS_MIN,
+                                           &negative),
+               is_equal_to (OPENVASD_INVALID_VALUE));
+  assert_that (conn->compress_min, is_equal_to (4096));
+
+  openvasd_connector_free (conn);
+}
+
+Ensure (openvasd, openvasd_connector_builder_status_wait)
+{
+  openvasd_connector_t conn = openvasd_connector_new ();
+  int wait = 30, negative = -1;
+
+  assert_that (openvasd_connector_builder (conn, OPENVASD_STATUS_WAIT, &wait),
+               is_equal_to (OPENVASD_OK));
+  assert_that (conn->status_wait, is_equal_to (30));
+  assert_that (openvasd_connector_builder (conn, OPENVASD_STATUS_WAIT,
+                                           &negative),
+               is_equal_to (OPENVASD_INVALID_VALUE));
+  assert_that (conn->status_wait, is_equal_to (30));
+
+  openvasd_connector_free (conn);
+}
+
+Ensure (openvasd, status_cache_is_per_scan)
+{
+  openvasd_connector_t conn = openvasd_connector_new ();
+
+  openvasd_connector_builder (conn, OPENVASD_SCAN_ID, "scan-1");
+  assert_that (openvasd_status_cache (conn), is_null);
+
+  conn->status_cache = g_malloc0 (sizeof (struct openvasd_status_cache));
+  conn->status_cache->scan_id = g_strdup ("scan-1");
+  conn->status_cache->etag = g_strdup ("\"1\"");
+  conn->status_cache->body = g_strdup ("{}");
+  assert_that (openvasd_status_cache (conn),
+               is_equal_to (conn->status_cache));
+
+  g_free (conn->scan_id);
+  conn->scan_id = g_strdup ("scan-2");
+  assert_that (openvasd_status_cache (conn), is_null);
+
+  openvasd_connector_free (conn);
+}
+
+Ensure (openvasd, status_cache_keeps_only_parsed_status)
+{
+  openvasd_connector_t conn = openvasd_connector_new ();
+  struct openvasd_scan_status status_info = {0};
+
+  openvasd_connector_builder (conn, OPENVASD_SCAN_ID, "scan-1");
+  conn->status_cache = g_malloc0 (sizeof (struct openvasd_status_cache));
+  conn->status_cache->scan_id = g_strdup ("scan-1");
+  conn->status_cache->etag = g_strdup ("\"1\"");
+  conn->status_cache->body = g_strdup ("{\"status\": \"running\"}");
+
+  status_info.status = OPENVASD_SCAN_STATUS_RUNNING;
+  status_info.progress = 42;
+  openvasd_status_cache_set_parsed (conn, &status_info);
+  assert_that (conn->status_cache, is_not_null);
+  assert_that (conn->status_cache->parsed, is_true);
+  assert_that (conn->status_cache->status.progress, is_equal_to (42));
+
+  /* A status which did not parse is not reused for a 304. */
+  status_info.status = OPENVASD_SCAN_STATUS_ERROR;
+  openvasd_status_cache_set_parsed (conn, &status_info);
+  assert_that (conn->status_cache, is_null);
+
+  openvasd_connector_free (conn);
+}
+
 Ensure (openvasd, openvasd_connector_free)
 {
   openvasd_connector_t conn = openvasd_connector_new ();
@@ -230,6 +529,70 @@ Ensure (openvasd, openvasd_connector_free_null_connector)
   assert_that(result, is_equal_to (OPENVASD_OK));
 }
 
+/* openvasd_get_vt_stream_push_init */
+
+#define PUSH_VT(oid)                                                     \
+  "{\"oid\": \"" oid "\", \"name\": \"Test VT\", \"family\": \"F\", " \
+  "\"category\": \"gather_info\", \"tag\": {\"summary\": \"x\"}}"
+
+static void
+collect_vt (nvti_t *nvt, gpointer user_data)
+{
+  g_ptr_array_add (user_data, nvt);
+}
+
+Ensure (openvasd, vt_push_parses_vts_while_received)
+{
+  const char *feed = "[" PUSH_VT ("1.2.3") ", " PUSH_VT ("1.2.4") "]";
+  GPtrArray *vts = g_ptr_array_new_with_free_func ((GDestroyNotify) nvti_free);
+  struct openvasd_vt_push *push = openvasd_vt_push_new (collect_vt, vts);
+  size_t len = strlen (feed);
+
+  for (size_t i = 0; i < len; i += 7)
+    {
+      size_t n = MIN (7, len - i);
+      assert_that (openvasd_vt_push_write ((char *) feed + i, 1, n, push),
+                   is_equal_to (n));
+    }
+  assert_that (gvm_json_push_parser_finish (&push->parser), is_equal_to (0));
+
+  assert_that (vts->len, is_equal_to (2));
+  assert_that (nvti_oid (g_ptr_array_index (vts, 0)),
+               is_equal_to_string ("1.2.3"));
+  assert_that (nvti_oid (g_ptr_array_index (vts, 1)),
+               is_equal_to_string ("1.2.4"));
+  assert_that (nvti_family (g_ptr_array_index (vts, 1)),
+               is_equal_to_string ("F"));
+
+  openvasd_vt_push_free (push);
+  g_ptr_array_free (vts, TRUE);
+}
+
+Ensure (openvasd, vt_push_aborts_transfer_on_invalid_feed)
+{
+  GPtrArray *vts = g_ptr_array_new ();
+  struct openvasd_vt_push *push = openvasd_vt_push_new (collect_vt, vts);
+
+  assert_that (openvasd_vt_push_write ("{\"oid\"", 1, 6, push),
+               is_equal_to (0));
+  assert_that (vts->len, is_equal_to (0));
+
+  openvasd_vt_push_free (push);
+  g_ptr_array_free (vts, TRUE);
+}
+
+Ensure (openvasd, vt_push_init_requires_vt_func)
+{
+  openvasd_connector_t conn = openvasd_connector_new ();
+  openvasd_resp_t resp = openvasd_get_vt_stream_push_init (conn, NULL, NULL);
+
+  assert_that (resp->code, is_equal_to (RESP_CODE_ERR));
+  assert_that (conn->vt_push, is_null);
+
+  openvasd_response_cleanup (resp);
+  openvasd_connector_free (conn);
+}
+
 /* Test suite. */
 int
 main (int argc, char **argv)
@@ -240,6 +603,13 @@ main (int argc, char **argv)
 
   add_test_with_context (suite, openvasd, parse_results_handles_details);
   add_test_with_context (suite, openvasd, parse_status_start_end_time);
+  add_test_with_context (suite, openvasd, parse_progress_reads_host_info);
+  add_test_with_context (suite, openvasd,
+                         build_scan_config_json_prints_like_cjson);
+  add_test_with_context (suite, openvasd,
+                         result_batch_matches_parse_results);
+  add_test_with_context (suite, openvasd,
+                         result_batch_read_rejects_invalid_results);
 
   add_test_with_context (suite, openvasd,
                          openvasd_connector_builder_all_valid_fields);
@@ -249,6 +619,13 @@ main (int argc, char **argv)
                          openvasd_connector_builder_invalid_protocol);
   add_test_with_context (suite, openvasd,
                          openvasd_connector_free);
+  add_test_with_context (suite, openvasd,
+                         openvasd_connector_builder_compress_min);
+  add_test_with_context (suite, openvasd,
+                         openvasd_connector_builder_status_wait);
+  add_test_with_context (suite, openvasd, status_cache_is_per_scan);
+  add_test_with_context (suite, openvasd,
+                         status_cache_keeps_only_parsed_status);
   add_test_with_context (suite, openvasd,
                          openvasd_connector_builder_invalid_protocol);
 
@@ -257,6 +634,11 @@ main (int argc, char **argv)
   add_test_with_context (suite, openvasd,
                          openvasd_delete_scan_works_with_missing_id);
 
+  add_test_with_context (suite, openvasd, vt_push_parses_vts_while_received);
+  add_test_with_context (suite, openvasd,
+                         vt_push_aborts_transfer_on_invalid_feed);
+  add_test_with_context (suite, openvasd, vt_push_init_requires_vt_func);
+
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
 
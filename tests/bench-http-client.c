@@ -0,0 +1,149 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone benchmark of the request latency of the HTTP client.
+ *
+ * Sends the same GET request many times, once with a new handle and
+ * connection per request (gvm_http_request) and once over a long-lived
+ * client (gvm_http_client_request), and reports the latency of both.
+ *
+ * By default the requests go to the health endpoint of the embedded test
+ * server. Another server can be given as URL, e.g. the health endpoint of an
+ * openvasd.
+ *
+ * Usage: bench-http-client [requests [url]]
+ */
+
+#include "../http/httputils.h"
+#include "test-server.h"
+
+#include <stdio.h>  /* for printf */
+#include <stdlib.h> /* for strtoul */
+#include <time.h>
+
+/**
+ * @brief Get the monotonic time.
+ *
+ * @return Time in microseconds.
+ */
+static double
+now_us (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Compare two latencies for qsort().
+ */
+static int
+compare_double (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Print the latencies of a run.
+ *
+ * @param name       Name of the run.
+ * @param latencies  Latency of every request in microseconds.
+ * @param count      Number of requests.
+ * @param failed     Number of failed requests.
+ */
+static void
+report (const char *name, double *latencies, unsigned long count,
+        unsigned long failed)
+{
+  double total = 0;
+
+  for (unsigned long i = 0; i < count; i++)
+    total += latencies[i];
+  qsort (latencies, count, sizeof (double), compare_double);
+
+  printf ("%-10s %8lu requests, %lu failed, mean %8.1f us, p50 %8.1f us, "
+          "p99 %8.1f us\n",
+          name, count, failed, total / count, latencies[count / 2],
+          latencies[count * 99 / 100]);
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned long count = 2000, failed;
+  gvm_http_client_t *client;
+  test_server_opts_t opts = {0};
+  test_server_t *server = NULL;
+  double *latencies;
+  gchar *url;
+
+  if (argc > 1)
+    count = strtoul (argv[1], NULL, 10);
+  if (count == 0)
+    {
+      fprintf (stderr, "Usage: %s [requests [url]]\n", argv[0]);
+      return 1;
+    }
+  if (argc > 2)
+    url = g_strdup (argv[2]);
+  else if ((server = test_server_start (&opts)) != NULL)
+    url = g_strdup_printf ("http://127.0.0.1:%d/health/alive",
+                           test_server_port (server));
+  else
+    {
+      fprintf (stderr, "Could not start the server\n");
+      return 1;
+    }
+  latencies = g_malloc0 (count * sizeof (double));
+  curl_global_init (CURL_GLOBAL_DEFAULT);
+  printf ("%s\n", url);
+
+  /* A new handle and connection per request. */
+  failed = 0;
+  for (unsigned long i = 0; i < count; i++)
+    {
+      gvm_http_response_t *response;
+      double start = now_us ();
+
+      response = gvm_http_request (url, GET, NULL, NULL, NULL, NULL, NULL,
+                                   NULL);
+      latencies[i] = now_us () - start;
+      if (response->http_status != 200)
+        failed++;
+      gvm_http_response_cleanup (response);
+      g_free (response);
+    }
+  report ("request", latencies, count, failed);
+
+  /* One client reusing its connection. */
+  failed = 0;
+  client = gvm_http_client_new (NULL, NULL, NULL);
+  for (unsigned long i = 0; i < count; i++)
+    {
+      gvm_http_response_t *response;
+      double start = now_us ();
+
+      response = gvm_http_client_request (client, url, GET, NULL, NULL, NULL);
+      latencies[i] = now_us () - start;
+      if (response->http_status != 200)
+        failed++;
+      gvm_http_response_cleanup (response);
+      g_free (response);
+    }
+  gvm_http_client_free (client);
+  report ("client", latencies, count, failed);
+
+  test_server_stop (server);
+  curl_global_cleanup ();
+  g_free (latencies);
+  g_free (url);
+
+  return 0;
+}
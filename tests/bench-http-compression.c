@@ -0,0 +1,157 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone benchmark of compressed transfers over a slow link.
+ *
+ * The embedded test server limits the bandwidth of every connection. It sends
+ * its VT feed, gzip compressed if the client accepts it, and receives a scan
+ * config like JSON payload. The benchmark reports wall-clock time and bytes
+ * on the link of the download without and with negotiated compression, and
+ * of the upload without and with compressed payload.
+ *
+ * Usage: bench-http-compression [kbytes_per_second [vts]]
+ */
+
+#include "../http/httputils.h"
+#include "test-server.h"
+
+#include <stdio.h>  /* for printf */
+#include <stdlib.h> /* for strtoul */
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Get the monotonic time.
+ *
+ * @return Time in seconds.
+ */
+static double
+now_s (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Build a JSON object like a scan config sent to openvasd.
+ *
+ * @param count Number of VTs.
+ *
+ * @return The scan config. Must be freed.
+ */
+static gchar *
+scan_config_new (unsigned long count)
+{
+  GString *json = g_string_new ("{\"target\": {\"hosts\": [\"192.168.0.0/24\"],"
+                                " \"ports\": [{\"range\": [{\"start\": 1, "
+                                "\"end\": 65535}]}]}, \"vts\": [");
+
+  for (unsigned long i = 0; i < count; i++)
+    g_string_append_printf (
+      json,
+      "%s{\"oid\": \"1.3.6.1.4.1.25623.1.0.%lu\", "
+      "\"parameters\": [{\"id\": 1, \"value\": \"yes\"}]}",
+      i ? ", " : "", 100000 + i);
+  g_string_append (json, "]}");
+
+  return g_string_free (json, FALSE);
+}
+
+/**
+ * @brief Send one request and print time and bytes on the link.
+ *
+ * @param name     Name of the run.
+ * @param server   The test server.
+ * @param client   Client to send the request with.
+ * @param url      URL of the request.
+ * @param method   HTTP method.
+ * @param payload  Request payload, or NULL.
+ * @param headers  Additional request headers, or NULL.
+ */
+static void
+run (const char *name, test_server_t *server, gvm_http_client_t *client,
+     const gchar *url, gvm_http_method_t method, const gchar *payload,
+     gvm_http_headers_t *headers)
+{
+  gvm_http_response_t *response;
+  double start;
+  guint64 bytes;
+
+  bytes = test_server_link_bytes (server);
+  start = now_s ();
+  response =
+    gvm_http_client_request (client, url, method, payload, headers, NULL);
+  bytes = test_server_link_bytes (server) - bytes;
+
+  printf ("%-16s status %3ld, %9zu bytes received, %10" G_GUINT64_FORMAT
+          " bytes on link, %7.3f s\n",
+          name, response->http_status, response->size, bytes,
+          now_s () - start);
+  gvm_http_response_cleanup (response);
+  g_free (response);
+}
+
+int
+main (int argc, char **argv)
+{
+  test_server_opts_t opts = {0};
+  unsigned long rate = 1024, count = 5000;
+  gvm_http_client_t *client;
+  gvm_http_headers_t *identity;
+  test_server_t *server;
+  gchar *url, *scan_config;
+
+  if (argc > 1)
+    rate = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    count = strtoul (argv[2], NULL, 10);
+  if (rate == 0 || count == 0)
+    {
+      fprintf (stderr, "Usage: %s [kbytes_per_second [vts]]\n", argv[0]);
+      return 1;
+    }
+  opts.link_rate = rate * 1024;
+  opts.vts = count;
+  opts.gzip = TRUE;
+
+  scan_config = scan_config_new (count);
+  if ((server = test_server_start (&opts)) == NULL)
+    {
+      fprintf (stderr, "Could not start the server\n");
+      return 1;
+    }
+  curl_global_init (CURL_GLOBAL_DEFAULT);
+  printf ("http://127.0.0.1:%d, %lu KiB/s, scan config %zu bytes\n",
+          test_server_port (server), rate, strlen (scan_config));
+
+  client = gvm_http_client_new (NULL, NULL, NULL);
+  /* Replaces the Accept-Encoding header libcurl would send. */
+  identity = gvm_http_headers_new ();
+  gvm_http_add_header (identity, "Accept-Encoding: identity");
+
+  url = g_strdup_printf ("http://127.0.0.1:%d/vts", test_server_port (server));
+  run ("download raw", server, client, url, GET, NULL, identity);
+  run ("download gzip", server, client, url, GET, NULL, NULL);
+  g_free (url);
+
+  url =
+    g_strdup_printf ("http://127.0.0.1:%d/scans", test_server_port (server));
+  run ("upload raw", server, client, url, POST, scan_config, NULL);
+  gvm_http_client_set_compression (client, 1024);
+  run ("upload gzip", server, client, url, POST, scan_config, NULL);
+  g_free (url);
+
+  gvm_http_headers_free (identity);
+  gvm_http_client_free (client);
+  test_server_stop (server);
+  curl_global_cleanup ();
+  g_free (scan_config);
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone benchmark of reading a page of openvasd scan results.
+ *
+ * A page of results like openvasd sends them is read into a list of result
+ * structs via cJSON, as openvasd_parsed_results() does, and into a result
+ * batch with the pull parser, as openvasd_parsed_results_batch() does. The
+ * benchmark reports wall-clock time and the peak resident set size of the
+ * process after each run.
+ *
+ * Usage: bench-openvasd-results [results [runs]]
+ */
+
+#include "../openvasd/openvasd.c"
+
+#include <stdlib.h> /* for strtoul */
+#include <sys/resource.h>
+#include <time.h>
+
+/**
+ * @brief Get the monotonic time.
+ *
+ * @return Time in seconds.
+ */
+static double
+now_s (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Get the peak resident set size of the process.
+ *
+ * @return Size in KiB.
+ */
+static long
+peak_rss_kb (void)
+{
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief Build a JSON array like a page of scan results of openvasd.
+ *
+ * Every tenth result is a host detail, the others are alarms and logs.
+ *
+ * @param count Number of results.
+ *
+ * @return The page.
+ */
+static GString *
+page_new (unsigned long count)
+{
+  GString *json = g_string_new ("[");
+
+  for (unsigned long i = 0; i < count; i++)
+    {
+      if (i % 10 == 0)
+        g_string_append_printf (
+          json,
+          "%s{\"id\": %lu, \"type\": \"host_detail\", \"ip_address\": "
+          "\"192.168.%lu.%lu\", \"hostname\": \"host%lu.example.org\", "
+          "\"oid\": \"1.3.6.1.4.1.25623.1.0.103997\", \"message\": "
+          "\"<host><detail><name>MAC</name><value>00:1A:2B:3C:4D:%02lX"
+          "</value></detail></host>\", \"detail\": {\"name\": \"MAC\", "
+          "\"value\": \"00:1A:2B:3C:4D:%02lX\", \"source\": {\"type\": "
+          "\"nvt\", \"name\": \"1.3.6.1.4.1.25623.1.0.103585\", "
+          "\"description\": \"Nmap MAC Scan\"}}}",
+          i ? ", " : "", i, i / 256 % 256, i % 256, i % 256, i % 256,
+          i % 256);
+      else
+        g_string_append_printf (
+          json,
+          "%s{\"id\": %lu, \"type\": \"%s\", \"ip_address\": "
+          "\"192.168.%lu.%lu\", \"hostname\": \"host%lu.example.org\", "
+          "\"oid\": \"1.3.6.1.4.1.25623.1.0.%lu\", \"port\": %lu, "
+          "\"protocol\": \"tcp\", \"message\": \"Installed version: "
+          "2.4.%lu\\nFixed version: 2.4.99\\nInstallation path / port: "
+          "/\\n\"}",
+          i ? ", " : "", i, i % 2 ? "alarm" : "log", i / 256 % 256, i % 256,
+          i % 256, 100000 + i % 5000, 1 + i % 1024, i % 99);
+    }
+  g_string_append (json, "]");
+
+  return json;
+}
+
+/**
+ * @brief Read the page into a list of result structs.
+ *
+ * @param page The page.
+ *
+ * @return Number of results read.
+ */
+static guint
+read_list (GString *page)
+{
+  GSList *results = NULL;
+  guint count;
+
+  parse_results (page->str, &results);
+  count = g_slist_length (results);
+  g_slist_free_full (results, (GDestroyNotify) openvasd_result_free);
+
+  return count;
+}
+
+/**
+ * @brief Read the page into a result batch.
+ *
+ * @param page The page.
+ *
+ * @return Number of results read.
+ */
+static guint
+read_batch (GString *page)
+{
+  openvasd_result_batch_t batch = openvasd_result_batch_new ();
+  FILE *stream;
+  guint count;
+
+  stream = fmemopen (page->str, page->len, "r");
+  openvasd_result_batch_read (batch, stream);
+  fclose (stream);
+  count = openvasd_result_batch_len (batch);
+  openvasd_result_batch_free (batch);
+
+  return count;
+}
+
+/**
+ * @brief Read the page several times and print the time taken.
+ *
+ * @param name  Name of the run.
+ * @param read  Function reading the page.
+ * @param page  The page.
+ * @param runs  Number of runs.
+ */
+static void
+run (const char *name, guint (*read) (GString *), GString *page,
+     unsigned long runs)
+{
+  double start, elapsed;
+  guint count = 0;
+
+  start = now_s ();
+  for (unsigned long i = 0; i < runs; i++)
+    count = read (page);
+  elapsed = (now_s () - start) / runs;
+
+  printf ("%-8s %7u results, %8.3f ms per page, %6.0f ns per result, "
+          "peak RSS %ld KiB\n",
+          name, count, elapsed * 1e3, count ? elapsed * 1e9 / count : 0,
+          peak_rss_kb ());
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned long count = 100000, runs = 5;
+  GString *page;
+
+  if (argc > 1)
+    count = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    runs = strtoul (argv[2], NULL, 10);
+  if (count == 0 || runs == 0)
+    {
+      fprintf (stderr, "Usage: %s [results [runs]]\n", argv[0]);
+      return 1;
+    }
+
+  page = page_new (count);
+  printf ("page of %lu results, %zu bytes, %lu runs\n", count, page->len,
+          runs);
+
+  // The batch runs first, so that its peak RSS is not the one of the list
+  run ("batch", read_batch, page, runs);
+  run ("list", read_list, page, runs);
+
+  g_string_free (page, TRUE);
+
+  return 0;
+}
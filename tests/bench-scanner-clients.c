@@ -0,0 +1,322 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone end-to-end benchmark of the openvasd and agent
+ *        controller clients.
+ *
+ * The clients send their requests over the real HTTP(S) path to the embedded
+ * test server, which stands in for openvasd and the agent controller. Every
+ * operation is run by a number of threads, each with its own connectors.
+ * The benchmark reports the latency of the operations and the throughput in
+ * requests and body bytes per second.
+ *
+ * With a certificate and key file the test server speaks HTTPS. The clients
+ * do not verify it.
+ *
+ * Usage: bench-scanner-clients [requests [items [latency_ms [threads
+ *                              [cert_file key_file]]]]]
+ */
+
+#include "../agent_controller/agent_controller.h"
+#include "../openvasd/openvasd.h"
+#include "test-server.h"
+
+#include <pthread.h>
+#include <stdio.h>  /* for printf */
+#include <stdlib.h> /* for strtoul */
+#include <time.h>
+
+/**
+ * @brief Connectors of one benchmark thread.
+ */
+struct clients
+{
+  openvasd_connector_t openvasd;           /**< openvasd connector. */
+  agent_controller_connector_t controller; /**< Agent controller connector. */
+};
+
+/**
+ * @brief An operation of the clients, returns TRUE on success.
+ */
+typedef gboolean (*operation_func_t) (struct clients *);
+
+/**
+ * @brief State of a benchmark thread.
+ */
+struct bench_thread
+{
+  test_server_t *server;      /**< The test server. */
+  operation_func_t operation; /**< Operation to run. */
+  unsigned long count;        /**< Number of operations. */
+  double *latencies;          /**< Latency of every operation. */
+  unsigned long failed;       /**< Number of failed operations. */
+};
+
+/**
+ * @brief Get the monotonic time.
+ *
+ * @return Time in microseconds.
+ */
+static double
+now_us (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Create the connectors to the test server.
+ *
+ * @param clients  Connectors to fill in.
+ * @param server   The test server.
+ */
+static void
+clients_init (struct clients *clients, test_server_t *server)
+{
+  int port = test_server_port (server);
+
+  clients->openvasd = openvasd_connector_new ();
+  openvasd_connector_builder (clients->openvasd, OPENVASD_PROTOCOL,
+                              test_server_protocol (server));
+  openvasd_connector_builder (clients->openvasd, OPENVASD_HOST, "127.0.0.1");
+  openvasd_connector_builder (clients->openvasd, OPENVASD_PORT, &port);
+  openvasd_connector_builder (clients->openvasd, OPENVASD_SCAN_ID,
+                              "00000001-0000-4000-8000-000000000000");
+
+  clients->controller = agent_controller_connector_new ();
+  agent_controller_connector_builder (clients->controller,
+                                      AGENT_CONTROLLER_PROTOCOL,
+                                      test_server_protocol (server));
+  agent_controller_connector_builder (clients->controller,
+                                      AGENT_CONTROLLER_HOST, "127.0.0.1");
+  agent_controller_connector_builder (clients->controller,
+                                      AGENT_CONTROLLER_PORT, &port);
+}
+
+/**
+ * @brief Free the connectors.
+ *
+ * @param clients The connectors.
+ */
+static void
+clients_cleanup (struct clients *clients)
+{
+  openvasd_connector_free (clients->openvasd);
+  agent_controller_connector_free (clients->controller);
+}
+
+static gboolean
+get_health (struct clients *clients)
+{
+  openvasd_resp_t response = openvasd_get_health_alive (clients->openvasd);
+  gboolean ok = response->code == 200;
+
+  openvasd_response_cleanup (response);
+  return ok;
+}
+
+static gboolean
+get_vts (struct clients *clients)
+{
+  openvasd_resp_t response = openvasd_get_vts (clients->openvasd);
+  gboolean ok = response->code == 200;
+
+  openvasd_response_cleanup (response);
+  return ok;
+}
+
+static gboolean
+get_status (struct clients *clients)
+{
+  openvasd_scan_status_t status =
+    openvasd_parsed_scan_status (clients->openvasd);
+  gboolean ok = status->status == OPENVASD_SCAN_STATUS_RUNNING;
+
+  g_free (status);
+  return ok;
+}
+
+static gboolean
+get_results (struct clients *clients)
+{
+  GSList *results = NULL;
+  gboolean ok;
+
+  ok = openvasd_parsed_results (clients->openvasd, 0, 0, &results) == 200;
+  g_slist_free_full (results, (GDestroyNotify) openvasd_result_free);
+  return ok;
+}
+
+static gboolean
+get_results_batch (struct clients *clients)
+{
+  openvasd_result_batch_t batch = openvasd_result_batch_new ();
+  gboolean ok;
+
+  ok = openvasd_parsed_results_batch (clients->openvasd, 0, 0, batch) == 200;
+  openvasd_result_batch_free (batch);
+  return ok;
+}
+
+static gboolean
+get_agents (struct clients *clients)
+{
+  agent_controller_agent_list_t agents =
+    agent_controller_get_agents (clients->controller);
+
+  agent_controller_agent_list_free (agents);
+  return agents != NULL;
+}
+
+/**
+ * @brief Benchmark thread, runs an operation with its own connectors.
+ *
+ * @param arg The thread state.
+ *
+ * @return NULL.
+ */
+static void *
+bench_thread_run (void *arg)
+{
+  struct bench_thread *thread = arg;
+  struct clients clients;
+
+  clients_init (&clients, thread->server);
+  for (unsigned long i = 0; i < thread->count; i++)
+    {
+      double start = now_us ();
+
+      if (!thread->operation (&clients))
+        thread->failed++;
+      thread->latencies[i] = now_us () - start;
+    }
+  clients_cleanup (&clients);
+
+  return NULL;
+}
+
+/**
+ * @brief Compare two latencies for qsort().
+ */
+static int
+compare_double (const void *a, const void *b)
+{
+  double x = *(const double *) a, y = *(const double *) b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Run an operation in threads and print latency and throughput.
+ *
+ * @param name       Name of the operation.
+ * @param operation  The operation.
+ * @param server     The test server.
+ * @param count      Number of operations per thread.
+ * @param threads    Number of threads.
+ */
+static void
+run (const char *name, operation_func_t operation, test_server_t *server,
+     unsigned long count, unsigned long threads)
+{
+  struct bench_thread *runs =
+    g_malloc0 (threads * sizeof (struct bench_thread));
+  pthread_t *ids = g_malloc0 (threads * sizeof (pthread_t));
+  double *latencies = g_malloc0 (count * threads * sizeof (double));
+  guint64 requests, bytes;
+  unsigned long failed = 0, total = count * threads;
+  double start, elapsed, sum = 0;
+
+  requests = test_server_requests (server);
+  bytes = test_server_bytes_sent (server);
+  start = now_us ();
+  for (unsigned long i = 0; i < threads; i++)
+    {
+      runs[i].server = server;
+      runs[i].operation = operation;
+      runs[i].count = count;
+      runs[i].latencies = latencies + i * count;
+      pthread_create (&ids[i], NULL, bench_thread_run, &runs[i]);
+    }
+  for (unsigned long i = 0; i < threads; i++)
+    {
+      pthread_join (ids[i], NULL);
+      failed += runs[i].failed;
+    }
+  elapsed = (now_us () - start) / 1e6;
+  requests = test_server_requests (server) - requests;
+  bytes = test_server_bytes_sent (server) - bytes;
+
+  for (unsigned long i = 0; i < total; i++)
+    sum += latencies[i];
+  qsort (latencies, total, sizeof (double), compare_double);
+
+  printf ("%-14s %7lu ops, %lu failed, mean %9.1f us, p50 %9.1f us, "
+          "p99 %9.1f us, %8.1f req/s, %7.2f MiB/s\n",
+          name, total, failed, sum / total, latencies[total / 2],
+          latencies[total * 99 / 100], requests / elapsed,
+          bytes / elapsed / (1024 * 1024));
+
+  g_free (latencies);
+  g_free (ids);
+  g_free (runs);
+}
+
+int
+main (int argc, char **argv)
+{
+  test_server_opts_t opts = {0};
+  unsigned long count = 200, items = 1000, threads = 1;
+  test_server_t *server;
+
+  if (argc > 1)
+    count = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    items = strtoul (argv[2], NULL, 10);
+  if (argc > 3)
+    opts.latency_ms = strtoul (argv[3], NULL, 10);
+  if (argc > 4)
+    threads = strtoul (argv[4], NULL, 10);
+  if (argc > 6)
+    {
+      opts.cert = argv[5];
+      opts.key = argv[6];
+    }
+  if (count == 0 || threads == 0 || argc == 6)
+    {
+      fprintf (stderr,
+               "Usage: %s [requests [items [latency_ms [threads "
+               "[cert_file key_file]]]]]\n",
+               argv[0]);
+      return 1;
+    }
+  opts.vts = items;
+  opts.results = items;
+  opts.agents = items;
+
+  if ((server = test_server_start (&opts)) == NULL)
+    {
+      fprintf (stderr, "Could not start the server\n");
+      return 1;
+    }
+  printf ("%s://127.0.0.1:%d, %lu items, %u ms latency, %lu threads\n",
+          test_server_protocol (server), test_server_port (server), items,
+          opts.latency_ms, threads);
+
+  run ("health", get_health, server, count, threads);
+  run ("vts", get_vts, server, count, threads);
+  run ("status", get_status, server, count, threads);
+  run ("results", get_results, server, count, threads);
+  run ("results batch", get_results_batch, server, count, threads);
+  run ("agents", get_agents, server, count, threads);
+
+  test_server_stop (server);
+
+  return 0;
+}
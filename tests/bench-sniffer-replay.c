@@ -0,0 +1,292 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone benchmark for the reply processing of the sniffer.
+ *
+ * Replays captured replies through the same code path as the sniffer thread,
+ * without raw sockets or privileges. By default a capture of synthetic
+ * replies to a /16 of targets is generated first, half of them from hosts
+ * which are no targets and many of them repeated. The throughput of the
+ * replay and the memory used by the host sets are reported.
+ *
+ * Usage: bench-sniffer-replay [replies [targets]]
+ *        bench-sniffer-replay -f capture.pcap hosts
+ *
+ * The capture file must use the Linux cooked header, e.g. from
+ * "tcpdump -i any -w capture.pcap".
+ */
+
+#include "../base/hosts.h"
+#include "../boreas/alivedetection.h"
+#include "../boreas/boreas_io.h"
+#include "../boreas/sniffer.h"
+
+#include <arpa/inet.h>
+#include <glib/gstdio.h> /* for g_unlink */
+#include <limits.h>
+#include <net/ethernet.h>
+#include <net/if_arp.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/tcp.h>
+#include <stdio.h>  /* for printf */
+#include <stdlib.h> /* for strtoul */
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Length of the Linux cooked header. */
+#define SLL_HDR_LEN 16
+
+/**
+ * @brief Get the peak resident set size of the process.
+ *
+ * @return Peak RSS in KiB.
+ */
+static long
+max_rss_kib (void)
+{
+  struct rusage usage;
+
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief Get the nanoseconds elapsed since start.
+ */
+static double
+elapsed_ns (struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Get the n-th address of 10.0.0.0/8 in network byte order.
+ */
+static uint32_t
+nth_addr (unsigned long n)
+{
+  return htonl (0x0a000000 | (n & 0xffffff));
+}
+
+/**
+ * @brief Build a synthetic reply as captured on the "any" device.
+ *
+ * Every fourth reply is an ICMP echo reply, a TCP SYN-ACK, a TCP RST or an
+ * ARP reply.
+ *
+ * @param[out] buf  Buffer of at least SLL_HDR_LEN + 40 bytes.
+ * @param[in]  n    Number of the reply.
+ * @param[in]  src  Source address in network byte order.
+ *
+ * @return Length of the packet.
+ */
+static int
+build_reply (u_char *buf, unsigned long n, uint32_t src)
+{
+  u_char *l3 = buf + SLL_HDR_LEN;
+  uint16_t proto = ETHERTYPE_IP;
+  int len;
+
+  memset (buf, 0, SLL_HDR_LEN + 40);
+  if (n % 4 == 3)
+    {
+      proto = ETHERTYPE_ARP;
+      l3[1] = ARPHRD_ETHER;
+      l3[2] = 0x08;
+      l3[4] = 6;
+      l3[5] = 4;
+      l3[7] = ARPOP_REPLY;
+      memcpy (l3 + 8 + 6, &src, 4);
+      len = 28;
+    }
+  else
+    {
+      uint32_t dst = htonl (0xc0a800fe);
+
+      l3[0] = 0x45;
+      l3[8] = 64;
+      memcpy (l3 + 12, &src, 4);
+      memcpy (l3 + 16, &dst, 4);
+      if (n % 4 == 0)
+        {
+          l3[9] = IPPROTO_ICMP;
+          l3[20] = ICMP_ECHOREPLY;
+          len = 20 + 8;
+        }
+      else
+        {
+          struct tcphdr *tcp = (struct tcphdr *) (l3 + 20);
+
+          l3[9] = IPPROTO_TCP;
+          tcp->th_sport = htons (80);
+          tcp->th_dport = htons (FILTER_PORT);
+          tcp->th_off = 5;
+          tcp->th_flags = n % 4 == 1 ? TH_SYN | TH_ACK : TH_RST;
+          len = 20 + 20;
+        }
+      l3[2] = len >> 8;
+      l3[3] = len & 0xff;
+    }
+  buf[3] = ARPHRD_ETHER;
+  buf[5] = 6;
+  buf[14] = proto >> 8;
+  buf[15] = proto & 0xff;
+
+  return SLL_HDR_LEN + len;
+}
+
+/**
+ * @brief Write a capture of synthetic replies.
+ *
+ * Sources cycle through twice the number of targets, so half of the replies
+ * come from hosts which are no targets.
+ *
+ * @param replies  Number of replies.
+ * @param targets  Number of targets.
+ *
+ * @return Path of the file, NULL on error.
+ */
+static gchar *
+write_capture (unsigned long replies, unsigned long targets)
+{
+  pcap_t *dead;
+  pcap_dumper_t *dumper;
+  gchar *path;
+  int fd;
+
+  fd = g_file_open_tmp ("bench-sniffer-XXXXXX.pcap", &path, NULL);
+  if (fd < 0)
+    return NULL;
+  close (fd);
+  dead = pcap_open_dead (DLT_LINUX_SLL, 65535);
+  dumper = pcap_dump_open (dead, path);
+  if (dumper == NULL)
+    {
+      fprintf (stderr, "pcap_dump_open: %s\n", pcap_geterr (dead));
+      pcap_close (dead);
+      g_free (path);
+      return NULL;
+    }
+  for (unsigned long i = 0; i < replies; i++)
+    {
+      u_char buf[SLL_HDR_LEN + 40];
+      struct pcap_pkthdr header = {0};
+
+      header.ts.tv_sec = i / 1000000;
+      header.ts.tv_usec = i % 1000000;
+      header.caplen = header.len =
+        build_reply (buf, i, nth_addr (i % (2 * targets)));
+      pcap_dump ((u_char *) dumper, &header, buf);
+    }
+  pcap_dump_close (dumper);
+  pcap_close (dead);
+
+  return path;
+}
+
+int
+main (int argc, char **argv)
+{
+  scanner_t bench_scanner = {0};
+  hosts_data_t hosts_data = {0};
+  struct timespec start;
+  unsigned long replies = 1000000, targets = 65536;
+  const char *hosts_str = NULL;
+  gchar *path = NULL;
+  long rss_start, rss_sets, rss_replay;
+  double replay_ns;
+  int processed;
+  gchar *json;
+
+  if (argc == 4 && strcmp (argv[1], "-f") == 0)
+    {
+      path = g_strdup (argv[2]);
+      hosts_str = argv[3];
+    }
+  else
+    {
+      if (argc > 1)
+        replies = strtoul (argv[1], NULL, 10);
+      if (argc > 2)
+        targets = strtoul (argv[2], NULL, 10);
+      if (replies == 0 || targets == 0 || targets > 0x800000)
+        {
+          fprintf (stderr,
+                   "Usage: %s [replies [targets]]\n"
+                   "       %s -f capture.pcap hosts\n",
+                   argv[0], argv[0]);
+          return 1;
+        }
+      path = write_capture (replies, targets);
+      if (path == NULL)
+        return 1;
+    }
+
+  rss_start = max_rss_kib ();
+  hosts_data.alivehosts = hosts_set_new ();
+  hosts_data.targethosts = hosts_set_new ();
+  if (hosts_str)
+    {
+      gvm_hosts_t *hosts = gvm_hosts_new (hosts_str);
+      gvm_host_t *host;
+
+      if (hosts == NULL)
+        {
+          fprintf (stderr, "Invalid hosts: %s\n", hosts_str);
+          return 1;
+        }
+      while ((host = gvm_hosts_next (hosts)))
+        hosts_set_add_host (hosts_data.targethosts, host);
+      gvm_hosts_free (hosts);
+    }
+  else
+    for (unsigned long i = 0; i < targets; i++)
+      {
+        struct in_addr addr = {.s_addr = nth_addr (i)};
+
+        hosts_set_add_addr4 (hosts_data.targethosts, &addr);
+      }
+  rss_sets = max_rss_kib ();
+
+  bench_scanner.hosts_data = &hosts_data;
+  bench_scanner.stats = alive_stats_new ();
+  init_scan_restrictions (&bench_scanner, INT_MAX);
+
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  processed = sniffer_replay_file (&bench_scanner, path);
+  replay_ns = elapsed_ns (&start);
+  rss_replay = max_rss_kib ();
+  if (processed < 0)
+    return 1;
+
+  printf ("replies      %d\n", processed);
+  printf ("targets      %u\n", hosts_set_size (hosts_data.targethosts));
+  printf ("alive hosts  %u\n", hosts_set_size (hosts_data.alivehosts));
+  printf ("replay       %8.1f ms  %6.1f ns/reply  %.2f Mreplies/s\n",
+          replay_ns / 1e6, processed ? replay_ns / processed : 0,
+          replay_ns > 0 ? processed * 1e3 / replay_ns : 0);
+  printf ("peak RSS     %ld KiB (target set +%ld KiB, replay +%ld KiB)\n",
+          rss_replay, rss_sets - rss_start, rss_replay - rss_sets);
+  json = alive_stats_to_json (bench_scanner.stats);
+  printf ("stats        %s\n", json);
+  g_free (json);
+
+  if (!hosts_str)
+    g_unlink (path);
+  g_free (path);
+  alive_stats_free (bench_scanner.stats);
+  hosts_set_free (hosts_data.alivehosts);
+  hosts_set_free (hosts_data.targethosts);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Stand-alone microbenchmark for building TCP ping packets.
+ *
+ * Compares building every IPv4 TCP ping from scratch, including a full
+ * checksum over the pseudo header, with patching the per destination
+ * template used by the alive detection. No packets are sent.
+ *
+ * Usage: bench-tcp-ping [iterations]
+ */
+
+#include "../boreas/ping.c"
+
+#include <stdio.h> /* for printf */
+
+/**
+ * @brief Build an IPv4 TCP ping the way it was done before templates.
+ */
+static void
+build_tcp_v4_full (u_char *packet, struct in_addr *src, struct in_addr *dst,
+                   uint16_t port)
+{
+  struct ip *ip = (struct ip *) packet;
+  struct tcphdr *tcp = (struct tcphdr *) (packet + sizeof (struct ip));
+  struct pseudohdr pseudoheader;
+
+  memset (packet, 0, sizeof (struct ip) + sizeof (struct tcphdr));
+  ip->ip_hl = 5;
+  ip->ip_v = 4;
+  ip->ip_p = IPPROTO_TCP;
+  ip->ip_id = rand ();
+  ip->ip_ttl = 0x40;
+  ip->ip_src = *src;
+  ip->ip_dst = *dst;
+
+  tcp->th_sport = htons (FILTER_PORT);
+  tcp->th_flags = TH_SYN;
+  tcp->th_dport = htons (port);
+  tcp->th_seq = rand ();
+  tcp->th_off = 5;
+  tcp->th_win = 2048;
+
+  memset (&pseudoheader, 0, 12 + sizeof (struct tcphdr));
+  pseudoheader.saddr.s_addr = src->s_addr;
+  pseudoheader.daddr.s_addr = dst->s_addr;
+  pseudoheader.protocol = IPPROTO_TCP;
+  pseudoheader.length = htons (sizeof (struct tcphdr));
+  memcpy ((char *) &pseudoheader.tcpheader, (char *) tcp,
+          sizeof (struct tcphdr));
+  tcp->th_sum = in_cksum ((unsigned short *) &pseudoheader,
+                          12 + sizeof (struct tcphdr));
+}
+
+/**
+ * @brief Get the nanoseconds elapsed since start.
+ */
+static double
+elapsed_ns (struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct tcp_v4_template template;
+  u_char packet[sizeof (struct ip) + sizeof (struct tcphdr)];
+  struct in_addr src, dst;
+  struct timespec start;
+  unsigned long iterations = 10000000;
+  volatile uint16_t sink = 0;
+  double full_ns, template_ns;
+
+  if (argc > 1)
+    iterations = strtoul (argv[1], NULL, 10);
+  if (iterations == 0)
+    iterations = 1;
+
+  inet_pton (AF_INET, "192.168.0.1", &src);
+  inet_pton (AF_INET, "10.0.0.1", &dst);
+
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < iterations; i++)
+    {
+      build_tcp_v4_full (packet, &src, &dst, i & 0xffff);
+      sink ^= ((struct tcphdr *) (packet + sizeof (struct ip)))->th_sum;
+    }
+  full_ns = elapsed_ns (&start);
+
+  clock_gettime (CLOCK_MONOTONIC, &start);
+  for (unsigned long i = 0; i < iterations; i++)
+    {
+      /* A new template per 1000 ports, like a destination with many ports. */
+      if (i % 1000 == 0)
+        tcp_v4_template_init (&template, &src, &dst, TH_SYN);
+      tcp_v4_template_set_port (&template, i & 0xffff);
+      sink ^=
+        ((struct tcphdr *) (template.packet + sizeof (struct ip)))->th_sum;
+    }
+  template_ns = elapsed_ns (&start);
+
+  printf ("full build:     %8.2f ns/packet\n", full_ns / iterations);
+  printf ("template patch: %8.2f ns/packet\n", template_ns / iterations);
+  printf ("speedup:        %8.2fx\n", full_ns / template_ns);
+
+  return sink == 0xdead ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Run the stand-in of openvasd and the agent controller.
+ *
+ * Serves until interrupted, so that clients can be pointed at it by hand.
+ *
+ * Usage: test-server [items [latency_ms [cert_file key_file]]]
+ */
+
+#include "test-server.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>  /* for printf */
+#include <stdlib.h> /* for strtoul */
+#include <unistd.h>
+
+int
+main (int argc, char **argv)
+{
+  test_server_opts_t opts = {0};
+  unsigned long items = 1000;
+  test_server_t *server;
+  sigset_t signals;
+  int signal;
+
+  if (argc > 1)
+    items = strtoul (argv[1], NULL, 10);
+  if (argc > 2)
+    opts.latency_ms = strtoul (argv[2], NULL, 10);
+  if (argc > 4)
+    {
+      opts.cert = argv[3];
+      opts.key = argv[4];
+    }
+  if (argc == 4 || argc > 5)
+    {
+      fprintf (stderr, "Usage: %s [items [latency_ms [cert_file key_file]]]\n",
+               argv[0]);
+      return 1;
+    }
+  opts.vts = items;
+  opts.results = items;
+  opts.agents = items;
+
+  sigemptyset (&signals);
+  sigaddset (&signals, SIGINT);
+  sigaddset (&signals, SIGTERM);
+  pthread_sigmask (SIG_BLOCK, &signals, NULL);
+
+  if ((server = test_server_start (&opts)) == NULL)
+    {
+      fprintf (stderr, "Could not start the server\n");
+      return 1;
+    }
+  printf ("%s://127.0.0.1:%d\n", test_server_protocol (server),
+          test_server_port (server));
+  fflush (stdout);
+
+  sigwait (&signals, &signal);
+
+  printf ("%" G_GUINT64_FORMAT " requests, %" G_GUINT64_FORMAT " bytes\n",
+          test_server_requests (server), test_server_bytes_sent (server));
+  test_server_stop (server);
+
+  return 0;
+}
@@ -0,0 +1,733 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Embedded stand-in of openvasd and the agent controller.
+ *
+ * A small HTTP/1.1 server on localhost that answers the requests of the
+ * openvasd and agent controller clients with canned payloads. The number of
+ * VTs, results and agents in the payloads and the latency of every response
+ * are configurable. Connections are kept alive and each is served by its own
+ * thread. With a certificate and key the server speaks HTTPS.
+ *
+ * The status of a scan carries an ETag, conditional requests for it are
+ * answered with 304. Request bodies are read and dropped.
+ *
+ * The bandwidth of every connection can be limited to simulate a slow link,
+ * and the VT feed can be sent gzip compressed.
+ */
+
+#include "test-server.h"
+
+#include "../util/compressutils.h"
+#include "../util/serverutils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdlib.h> /* for strtoul */
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief ETag of the status of every scan.
+ */
+#define STATUS_ETAG "\"1\""
+
+/**
+ * @brief Bytes sent at once over a connection with a limited bandwidth.
+ */
+#define LINK_CHUNK 4096
+
+/**
+ * @brief The test server.
+ */
+struct test_server
+{
+  test_server_opts_t opts; /**< Options. */
+  int lsoc;                /**< Listening socket. */
+  int port;                /**< Port on localhost. */
+  pthread_t thread;        /**< Thread accepting connections. */
+  GString *vts;            /**< Body of /vts. */
+  gchar *vts_gzip;         /**< Compressed body of /vts or NULL. */
+  gsize vts_gzip_len;      /**< Length of the compressed body of /vts. */
+  GString *results;        /**< Body of /scans/{id}/results. */
+  GString *status;         /**< Body of /scans/{id}/status. */
+  GString *agents;         /**< Body of /api/v1/admin/agents. */
+  GMutex lock;             /**< Lock of the members below. */
+  GCond done;              /**< Signalled when a connection is closed. */
+  GSList *connections;     /**< Open connections. */
+  guint scans;             /**< Number of created scans. */
+  guint64 requests;        /**< Number of answered requests. */
+  guint64 bytes_sent;      /**< Bytes of all answered bodies. */
+  guint64 link_bytes;      /**< Bytes read and written on all connections. */
+};
+
+/**
+ * @brief A connection to the test server.
+ */
+struct test_connection
+{
+  test_server_t *server;                        /**< The server. */
+  int soc;                                      /**< Connected socket. */
+  gnutls_session_t session;                     /**< TLS session or NULL. */
+  gnutls_certificate_credentials_t credentials; /**< TLS credentials. */
+};
+
+/**
+ * @brief A response of the test server.
+ */
+struct test_response
+{
+  int code;             /**< HTTP status code. */
+  const gchar *reason;  /**< Reason phrase. */
+  const gchar *body;    /**< Body. */
+  gsize length;         /**< Length of the body. */
+  const gchar *headers; /**< Additional header lines. */
+};
+
+/**
+ * @brief Build a JSON array like the VT feed of openvasd.
+ *
+ * @param count Number of VTs.
+ *
+ * @return The feed.
+ */
+static GString *
+vts_new (guint count)
+{
+  GString *json = g_string_new ("[");
+
+  for (guint i = 0; i < count; i++)
+    g_string_append_printf (
+      json,
+      "%s{\"oid\": \"1.3.6.1.4.1.25623.1.0.%u\", \"name\": \"Test VT %u\", "
+      "\"filename\": \"gb_test_%u.nasl\", \"tag\": {\"cvss_base_vector\": "
+      "\"AV:N/AC:L/Au:N/C:P/I:N/A:N\", \"summary\": \"The host is affected "
+      "by a vulnerability.\", \"solution_type\": \"VendorFix\"}, "
+      "\"dependencies\": [\"gb_test_detect.nasl\"], \"required_ports\": "
+      "[\"Services/www\", 80], \"category\": \"gather_info\", \"family\": "
+      "\"Web application abuses\"}",
+      i ? ", " : "", 100000 + i, i, i);
+  g_string_append (json, "]");
+
+  return json;
+}
+
+/**
+ * @brief Build a JSON array like a page of scan results of openvasd.
+ *
+ * @param count Number of results.
+ *
+ * @return The page.
+ */
+static GString *
+results_new (guint count)
+{
+  GString *json = g_string_new ("[");
+
+  for (guint i = 0; i < count; i++)
+    g_string_append_printf (
+      json,
+      "%s{\"id\": %u, \"type\": \"%s\", \"ip_address\": \"192.168.%u.%u\", "
+      "\"hostname\": \"host%u.example.org\", \"oid\": "
+      "\"1.3.6.1.4.1.25623.1.0.%u\", \"port\": %u, \"protocol\": \"tcp\", "
+      "\"message\": \"Installed version: 2.4.%u\\nFixed version: 2.4.99\\n\"}",
+      i ? ", " : "", i, i % 2 ? "alarm" : "log", i / 256 % 256, i % 256,
+      i % 256, 100000 + i % 5000, 1 + i % 1024, i % 99);
+  g_string_append (json, "]");
+
+  return json;
+}
+
+/**
+ * @brief Build a JSON array like the agent list of the agent controller.
+ *
+ * @param count Number of agents.
+ *
+ * @return The agent list.
+ */
+static GString *
+agents_new (guint count)
+{
+  GString *json = g_string_new ("[");
+
+  for (guint i = 0; i < count; i++)
+    g_string_append_printf (
+      json,
+      "%s{\"agentid\": \"agent-%u\", \"hostname\": \"host%u.example.org\", "
+      "\"authorized\": %s, \"min_interval\": 300, \"heartbeat_interval\": "
+      "600, \"connection_status\": \"active\", \"last_update\": "
+      "\"2025-01-01T12:00:00.000Z\", \"ip_addresses\": [\"192.168.%u.%u\"], "
+      "\"config\": {\"schedule\": {\"schedule\": \"@every 12h\"}, "
+      "\"control-server\": {\"base_url\": \"https://controller.example.org\", "
+      "\"agent_id\": \"agent-%u\", \"token\": \"token-%u\", "
+      "\"server_cert_hash\": \"sha256:0123456789abcdef\"}}}",
+      i ? ", " : "", i, i, i % 2 ? "true" : "false", i / 256 % 256, i % 256,
+      i, i);
+  g_string_append (json, "]");
+
+  return json;
+}
+
+/**
+ * @brief Build a JSON object like the status of a running scan of openvasd.
+ *
+ * @return The status.
+ */
+static GString *
+status_new (void)
+{
+  return g_string_new (
+    "{\"start_time\": 1737642308, \"end_time\": null, \"status\": "
+    "\"running\", \"host_info\": {\"all\": 4, \"excluded\": 0, \"dead\": 0, "
+    "\"alive\": 1, \"queued\": 1, \"finished\": 1, \"scanning\": "
+    "{\"192.168.0.2\": 40, \"192.168.0.3\": 60}, \"remaining_vts_per_host\": "
+    "{\"192.168.0.2\": 1200, \"192.168.0.3\": 800}}}");
+}
+
+/**
+ * @brief Count bytes on a connection and wait as long as they take on it.
+ *
+ * @param server The server.
+ * @param len    Number of bytes read or written.
+ */
+static void
+link_transfer (test_server_t *server, size_t len)
+{
+  g_mutex_lock (&server->lock);
+  server->link_bytes += len;
+  g_mutex_unlock (&server->lock);
+
+  if (server->opts.link_rate)
+    g_usleep (len * G_USEC_PER_SEC / server->opts.link_rate);
+}
+
+/**
+ * @brief Read from a connection.
+ *
+ * @return Number of bytes read, 0 on EOF, negative on error.
+ */
+static ssize_t
+connection_read (struct test_connection *connection, char *buf, size_t len)
+{
+  ssize_t n;
+
+  if (connection->server->opts.link_rate)
+    len = MIN (len, LINK_CHUNK);
+
+  if (connection->session == NULL)
+    n = read (connection->soc, buf, len);
+  else
+    do
+      n = gnutls_record_recv (connection->session, buf, len);
+    while (n == GNUTLS_E_AGAIN || n == GNUTLS_E_INTERRUPTED);
+
+  if (n > 0)
+    link_transfer (connection->server, n);
+
+  return n;
+}
+
+/**
+ * @brief Write all data to a connection.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int
+connection_write (struct test_connection *connection, const char *data,
+                  size_t len)
+{
+  while (len > 0)
+    {
+      size_t chunk = len;
+      ssize_t n;
+
+      if (connection->server->opts.link_rate)
+        chunk = MIN (chunk, LINK_CHUNK);
+      if (connection->session)
+        n = gnutls_record_send (connection->session, data, chunk);
+      else
+        n = write (connection->soc, data, chunk);
+      if (n == GNUTLS_E_AGAIN || n == GNUTLS_E_INTERRUPTED)
+        continue;
+      if (n <= 0)
+        return -1;
+      link_transfer (connection->server, n);
+      data += n;
+      len -= n;
+    }
+  return 0;
+}
+
+/**
+ * @brief Find the response to a request.
+ *
+ * @param server         The server.
+ * @param method         Method of the request.
+ * @param path           Path of the request, without query.
+ * @param if_none_match  Value of the If-None-Match header or NULL.
+ * @param accept_gzip    Whether the client accepts gzip encoded bodies.
+ * @param[out] response  The response. The body of a new scan is stored in
+ *                       scan_id.
+ * @param[out] scan_id   Buffer for the body of a new scan.
+ */
+static void
+test_server_route (test_server_t *server, const gchar *method,
+                   const gchar *path, const gchar *if_none_match,
+                   gboolean accept_gzip, struct test_response *response,
+                   gchar scan_id[64])
+{
+  gchar **segments = g_strsplit (path, "/", -1);
+  guint count = g_strv_length (segments);
+  gboolean get = !strcmp (method, "GET");
+
+  memset (response, 0, sizeof (*response));
+  response->code = 404;
+  response->reason = "Not Found";
+  response->body = "{\"error\": \"Not found\"}";
+
+  if (get && !strcmp (path, "/vts") && accept_gzip && server->vts_gzip)
+    {
+      response->code = 200;
+      response->body = server->vts_gzip;
+      response->length = server->vts_gzip_len;
+      response->headers = "Content-Encoding: gzip\r\n";
+    }
+  else if (get && !strcmp (path, "/vts"))
+    {
+      response->code = 200;
+      response->body = server->vts->str;
+      response->length = server->vts->len;
+    }
+  else if (get && count == 3 && !strcmp (segments[1], "health"))
+    {
+      response->code = 200;
+      response->body = "";
+      response->headers = "feed-version: test\r\n";
+    }
+  else if (get && !strcmp (path, "/scans/preferences"))
+    {
+      response->code = 200;
+      response->body = "[]";
+    }
+  else if (!strcmp (method, "POST") && !strcmp (path, "/scans"))
+    {
+      g_mutex_lock (&server->lock);
+      g_snprintf (scan_id, 64, "\"%08x-0000-4000-8000-000000000000\"",
+                  ++server->scans);
+      g_mutex_unlock (&server->lock);
+      response->code = 201;
+      response->reason = "Created";
+      response->body = scan_id;
+    }
+  else if (count == 3 && !strcmp (segments[1], "scans")
+           && (!strcmp (method, "POST") || !strcmp (method, "DELETE")))
+    {
+      response->code = 204;
+      response->reason = "No Content";
+      response->body = "";
+    }
+  else if (get && count == 4 && !strcmp (segments[1], "scans")
+           && !strcmp (segments[3], "status"))
+    {
+      response->headers = "ETag: " STATUS_ETAG "\r\n";
+      if (!g_strcmp0 (if_none_match, STATUS_ETAG))
+        {
+          response->code = 304;
+          response->reason = "Not Modified";
+          response->body = "";
+        }
+      else
+        {
+          response->code = 200;
+          response->body = server->status->str;
+          response->length = server->status->len;
+        }
+    }
+  else if (get && count == 4 && !strcmp (segments[1], "scans")
+           && !strcmp (segments[3], "results"))
+    {
+      response->code = 200;
+      response->body = server->results->str;
+      response->length = server->results->len;
+    }
+  else if (!strcmp (path, "/api/v1/admin/agents"))
+    {
+      response->code = 200;
+      response->body = get ? server->agents->str : "";
+      response->length = get ? server->agents->len : 0;
+    }
+  else if (!strcmp (method, "POST")
+           && !strcmp (path, "/api/v1/admin/agents/delete"))
+    {
+      response->code = 200;
+      response->body = "";
+    }
+
+  if (response->code == 200)
+    response->reason = "OK";
+  if (response->length == 0)
+    response->length = strlen (response->body);
+  g_strfreev (segments);
+}
+
+/**
+ * @brief Answer all requests on one connection until it is closed.
+ *
+ * @param connection The connection.
+ */
+static void
+serve_connection (struct test_connection *connection)
+{
+  test_server_t *server = connection->server;
+  GString *request = g_string_new (NULL);
+  char buf[16384];
+  ssize_t n;
+
+  while (TRUE)
+    {
+      struct test_response response;
+      gchar *lower, *header, *if_none_match = NULL;
+      gchar method[16], path[1024], scan_id[64];
+      const char *header_end;
+      unsigned long content_length = 0;
+      gboolean accept_gzip = FALSE;
+      gsize header_length;
+
+      while ((header_end = strstr (request->str, "\r\n\r\n")) == NULL)
+        {
+          if ((n = connection_read (connection, buf, sizeof (buf))) <= 0)
+            goto out;
+          g_string_append_len (request, buf, n);
+        }
+      header_length = header_end + 4 - request->str;
+
+      if (sscanf (request->str, "%15s %1023[^? ]", method, path) != 2)
+        goto out;
+      lower = g_ascii_strdown (request->str, header_length);
+      if ((header = strstr (lower, "\r\ncontent-length:")) != NULL)
+        content_length =
+          strtoul (header + strlen ("\r\ncontent-length:"), NULL, 10);
+      if ((header = strstr (lower, "\r\nif-none-match:")) != NULL)
+        {
+          header = request->str + (header - lower)
+                   + strlen ("\r\nif-none-match:");
+          if_none_match =
+            g_strstrip (g_strndup (header, strcspn (header, "\r\n")));
+        }
+      if ((header = strstr (lower, "\r\naccept-encoding:")) != NULL)
+        {
+          header += strlen ("\r\naccept-encoding:");
+          accept_gzip =
+            g_strstr_len (header, strcspn (header, "\r\n"), "gzip") != NULL;
+        }
+      g_free (lower);
+
+      while (request->len < header_length + content_length)
+        {
+          if ((n = connection_read (connection, buf, sizeof (buf))) <= 0)
+            {
+              g_free (if_none_match);
+              goto out;
+            }
+          g_string_append_len (request, buf, n);
+        }
+      g_string_erase (request, 0, header_length + content_length);
+
+      test_server_route (server, method, path, if_none_match, accept_gzip,
+                         &response, scan_id);
+      g_free (if_none_match);
+
+      if (server->opts.latency_ms)
+        g_usleep (server->opts.latency_ms * 1000);
+
+      header = g_strdup_printf ("HTTP/1.1 %d %s\r\n"
+                                "Content-Type: application/json\r\n"
+                                "%s"
+                                "Content-Length: %zu\r\n\r\n",
+                                response.code, response.reason,
+                                response.headers ? response.headers : "",
+                                response.length);
+      if (connection_write (connection, header, strlen (header))
+          || connection_write (connection, response.body, response.length))
+        {
+          g_free (header);
+          goto out;
+        }
+      g_free (header);
+
+      g_mutex_lock (&server->lock);
+      server->requests++;
+      server->bytes_sent += response.length;
+      g_mutex_unlock (&server->lock);
+    }
+
+out:
+  g_string_free (request, TRUE);
+}
+
+/**
+ * @brief Connection thread, serves a connection and frees it.
+ *
+ * @param arg The connection.
+ *
+ * @return NULL.
+ */
+static void *
+connection_thread (void *arg)
+{
+  struct test_connection *connection = arg;
+  test_server_t *server = connection->server;
+
+  if (connection->session == NULL
+      || gvm_server_attach (connection->soc, &connection->session) == 0)
+    serve_connection (connection);
+
+  if (connection->session)
+    {
+      gnutls_deinit (connection->session);
+      gnutls_certificate_free_credentials (connection->credentials);
+    }
+
+  g_mutex_lock (&server->lock);
+  server->connections = g_slist_remove (server->connections, connection);
+  close (connection->soc);
+  g_cond_signal (&server->done);
+  g_mutex_unlock (&server->lock);
+  g_free (connection);
+
+  return NULL;
+}
+
+/**
+ * @brief Server thread, starts a thread for each accepted connection.
+ *
+ * @param arg The server.
+ *
+ * @return NULL.
+ */
+static void *
+server_thread (void *arg)
+{
+  test_server_t *server = arg;
+  int soc;
+
+  while ((soc = accept (server->lsoc, NULL, NULL)) >= 0)
+    {
+      struct test_connection *connection;
+      pthread_t thread;
+
+      connection = g_malloc0 (sizeof (struct test_connection));
+      connection->server = server;
+      connection->soc = soc;
+      if (server->opts.cert
+          && gvm_server_new (GNUTLS_SERVER, NULL, (gchar *) server->opts.cert,
+                             (gchar *) server->opts.key, &connection->session,
+                             &connection->credentials))
+        {
+          g_warning ("%s: Could not set up TLS", __func__);
+          close (soc);
+          g_free (connection);
+          continue;
+        }
+
+      g_mutex_lock (&server->lock);
+      server->connections = g_slist_prepend (server->connections, connection);
+      g_mutex_unlock (&server->lock);
+      if (pthread_create (&thread, NULL, connection_thread, connection) == 0)
+        pthread_detach (thread);
+      else
+        connection_thread (connection);
+    }
+
+  return NULL;
+}
+
+/**
+ * @brief Start the test server on a free port of localhost.
+ *
+ * @param opts Options of the server.
+ *
+ * @return The server, NULL on error. Must be stopped with test_server_stop.
+ */
+test_server_t *
+test_server_start (const test_server_opts_t *opts)
+{
+  test_server_t *server;
+  struct sockaddr_in addr;
+  socklen_t addrlen = sizeof (addr);
+
+  if (opts == NULL || (opts->cert == NULL) != (opts->key == NULL))
+    return NULL;
+
+  server = g_malloc0 (sizeof (test_server_t));
+  server->opts = *opts;
+  g_mutex_init (&server->lock);
+  g_cond_init (&server->done);
+
+  server->lsoc = socket (AF_INET, SOCK_STREAM, 0);
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+  if (server->lsoc < 0
+      || bind (server->lsoc, (struct sockaddr *) &addr, sizeof (addr)) < 0
+      || listen (server->lsoc, 128) < 0
+      || getsockname (server->lsoc, (struct sockaddr *) &addr, &addrlen) < 0)
+    {
+      if (server->lsoc >= 0)
+        close (server->lsoc);
+      g_mutex_clear (&server->lock);
+      g_cond_clear (&server->done);
+      g_free (server);
+      return NULL;
+    }
+  server->port = ntohs (addr.sin_port);
+
+  server->vts = vts_new (opts->vts);
+  if (opts->gzip)
+    {
+      unsigned long len;
+
+      server->vts_gzip =
+        gvm_compress_gzipheader (server->vts->str, server->vts->len, &len);
+      server->vts_gzip_len = len;
+    }
+  server->results = results_new (opts->results);
+  server->agents = agents_new (opts->agents);
+  server->status = status_new ();
+
+  if (pthread_create (&server->thread, NULL, server_thread, server) != 0)
+    {
+      close (server->lsoc);
+      server->lsoc = -1;
+      test_server_stop (server);
+      return NULL;
+    }
+
+  return server;
+}
+
+/**
+ * @brief Stop the test server, closing all connections, and free it.
+ *
+ * @param server The server.
+ */
+void
+test_server_stop (test_server_t *server)
+{
+  if (server == NULL)
+    return;
+
+  if (server->lsoc >= 0)
+    {
+      shutdown (server->lsoc, SHUT_RDWR);
+      close (server->lsoc);
+      pthread_join (server->thread, NULL);
+    }
+
+  g_mutex_lock (&server->lock);
+  for (GSList *item = server->connections; item; item = item->next)
+    shutdown (((struct test_connection *) item->data)->soc, SHUT_RDWR);
+  while (server->connections)
+    g_cond_wait (&server->done, &server->lock);
+  g_mutex_unlock (&server->lock);
+
+  g_mutex_clear (&server->lock);
+  g_cond_clear (&server->done);
+  g_string_free (server->vts, TRUE);
+  g_free (server->vts_gzip);
+  g_string_free (server->results, TRUE);
+  g_string_free (server->agents, TRUE);
+  g_string_free (server->status, TRUE);
+  g_free (server);
+}
+
+/**
+ * @brief Get the port of the test server on localhost.
+ *
+ * @param server The server.
+ *
+ * @return The port.
+ */
+int
+test_server_port (test_server_t *server)
+{
+  return server->port;
+}
+
+/**
+ * @brief Get the protocol of the test server.
+ *
+ * @param server The server.
+ *
+ * @return "https" if the server has a certificate, else "http".
+ */
+const gchar *
+test_server_protocol (test_server_t *server)
+{
+  return server->opts.cert ? "https" : "http";
+}
+
+/**
+ * @brief Get the number of requests the test server answered.
+ *
+ * @param server The server.
+ *
+ * @return Number of requests.
+ */
+guint64
+test_server_requests (test_server_t *server)
+{
+  guint64 requests;
+
+  g_mutex_lock (&server->lock);
+  requests = server->requests;
+  g_mutex_unlock (&server->lock);
+
+  return requests;
+}
+
+/**
+ * @brief Get the number of body bytes the test server sent.
+ *
+ * @param server The server.
+ *
+ * @return Number of bytes.
+ */
+guint64
+test_server_bytes_sent (test_server_t *server)
+{
+  guint64 bytes;
+
+  g_mutex_lock (&server->lock);
+  bytes = server->bytes_sent;
+  g_mutex_unlock (&server->lock);
+
+  return bytes;
+}
+
+/**
+ * @brief Get the number of bytes read and written on all connections.
+ *
+ * These include the headers, unlike test_server_bytes_sent.
+ *
+ * @param server The server.
+ *
+ * @return Number of bytes.
+ */
+guint64
+test_server_link_bytes (test_server_t *server)
+{
+  guint64 bytes;
+
+  g_mutex_lock (&server->lock);
+  bytes = server->link_bytes;
+  g_mutex_unlock (&server->lock);
+
+  return bytes;
+}
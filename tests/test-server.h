@@ -0,0 +1,54 @@
+/* SPDX-FileCopyrightText: 2025 Greenbone AG
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/**
+ * @file
+ * @brief Embedded stand-in of openvasd and the agent controller.
+ */
+
+#ifndef _GVM_TEST_SERVER_H
+#define _GVM_TEST_SERVER_H
+
+#include <glib.h>
+
+/**
+ * @brief Options of the test server.
+ */
+typedef struct
+{
+  guint vts;         /**< Number of VTs served at /vts. */
+  guint results;     /**< Number of results of a scan. */
+  guint agents;      /**< Number of agents of the agent controller. */
+  guint latency_ms;  /**< Time to wait before each response. */
+  guint link_rate;   /**< Bytes per second of a connection, 0 for no limit. */
+  gboolean gzip;     /**< Send /vts gzip compressed if the client accepts it. */
+  const gchar *cert; /**< Server certificate file, NULL for HTTP. */
+  const gchar *key;  /**< Server key file, NULL for HTTP. */
+} test_server_opts_t;
+
+typedef struct test_server test_server_t;
+
+test_server_t *
+test_server_start (const test_server_opts_t *);
+
+void
+test_server_stop (test_server_t *);
+
+int
+test_server_port (test_server_t *);
+
+const gchar *
+test_server_protocol (test_server_t *);
+
+guint64
+test_server_requests (test_server_t *);
+
+guint64
+test_server_bytes_sent (test_server_t *);
+
+guint64
+test_server_link_bytes (test_server_t *);
+
+#endif /* not _GVM_TEST_SERVER_H */
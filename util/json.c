@@ -6,21 +6,18 @@
 #include "json.h"
 
 /**
- * @brief Escapes a string according to the JSON or JSONPath standard
+ * @brief Appends a string escaped according to the JSON or JSONPath standard
  *
+ * @param[in]  escaped        The string to append to
  * @param[in]  string         The string to escape
  * @param[in]  single_quote   Whether to escape single quotes
- *
- * @return The escaped string
  */
-gchar *
-gvm_json_string_escape (const char *string, gboolean single_quote)
+static void
+json_string_append_escaped (GString *escaped, const char *string,
+                            gboolean single_quote)
 {
   gchar *point;
-  if (string == NULL)
-    return NULL;
 
-  GString *escaped = g_string_sized_new (strlen (string));
   for (point = (char *) string; *point != 0; point++)
     {
       unsigned char character = *point;
@@ -60,6 +57,24 @@ gvm_json_string_escape (const char *string, gboolean single_quote)
             }
         }
     }
+}
+
+/**
+ * @brief Escapes a string according to the JSON or JSONPath standard
+ *
+ * @param[in]  string         The string to escape
+ * @param[in]  single_quote   Whether to escape single quotes
+ *
+ * @return The escaped string
+ */
+gchar *
+gvm_json_string_escape (const char *string, gboolean single_quote)
+{
+  if (string == NULL)
+    return NULL;
+
+  GString *escaped = g_string_sized_new (strlen (string));
+  json_string_append_escaped (escaped, string, single_quote);
   return g_string_free (escaped, FALSE);
 }
 
@@ -172,3 +187,228 @@ gvm_json_obj_str (cJSON *obj, const gchar *key)
 
   return 0;
 }
+
+/**
+ * @brief Container the JSON writer is in.
+ */
+typedef struct
+{
+  gboolean object; ///< Whether the container is an object or an array
+  guint count;     ///< Number of values written into the container
+} json_writer_level_t;
+
+/**
+ * @brief Writer of JSON text into a string.
+ */
+struct gvm_json_writer
+{
+  GString *output;  ///< String the text is appended to
+  gboolean format;  ///< Whether to format the text like cJSON_Print
+  GArray *levels;   ///< Containers the writer is in, innermost last
+};
+
+/**
+ * @brief Create a JSON writer.
+ *
+ * Values are written in the order the functions are called, without building
+ * a tree. The text is formatted like cJSON_Print or, if not formatted, like
+ * cJSON_PrintUnformatted would print the same values.
+ *
+ * @param[in]  output  String to append the text to.
+ * @param[in]  format  Whether to format the text.
+ *
+ * @return The writer. Must be freed with gvm_json_writer_free.
+ */
+gvm_json_writer_t *
+gvm_json_writer_new (GString *output, gboolean format)
+{
+  gvm_json_writer_t *writer = g_malloc0 (sizeof (gvm_json_writer_t));
+
+  writer->output = output;
+  writer->format = format;
+  writer->levels = g_array_new (FALSE, FALSE, sizeof (json_writer_level_t));
+
+  return writer;
+}
+
+/**
+ * @brief Free a JSON writer. The output string is not freed.
+ *
+ * @param[in]  writer  The writer.
+ */
+void
+gvm_json_writer_free (gvm_json_writer_t *writer)
+{
+  if (writer == NULL)
+    return;
+
+  g_array_free (writer->levels, TRUE);
+  g_free (writer);
+}
+
+/**
+ * @brief Append tabs for the indentation of a member.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  depth   Indentation depth.
+ */
+static void
+json_writer_indent (gvm_json_writer_t *writer, guint depth)
+{
+  for (guint i = 0; i < depth; i++)
+    g_string_append_c (writer->output, '\t');
+}
+
+/**
+ * @brief Write what comes before a value.
+ *
+ * That is the separator from the previous value and, in objects, the key.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the value if in an object.
+ */
+static void
+json_writer_value_start (gvm_json_writer_t *writer, const gchar *key)
+{
+  json_writer_level_t *level;
+
+  if (writer->levels->len == 0)
+    return;
+
+  level = &g_array_index (writer->levels, json_writer_level_t,
+                          writer->levels->len - 1);
+  if (level->count++)
+    g_string_append (writer->output,
+                     writer->format ? (level->object ? ",\n" : ", ") : ",");
+  if (level->object)
+    {
+      if (writer->format)
+        json_writer_indent (writer, writer->levels->len);
+      g_string_append_c (writer->output, '"');
+      json_string_append_escaped (writer->output, key ? key : "", FALSE);
+      g_string_append (writer->output, writer->format ? "\":\t" : "\":");
+    }
+}
+
+/**
+ * @brief Start writing an object.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the object if in an object, else ignored.
+ */
+void
+gvm_json_writer_object_start (gvm_json_writer_t *writer, const gchar *key)
+{
+  json_writer_level_t level = {TRUE, 0};
+
+  json_writer_value_start (writer, key);
+  g_string_append (writer->output, writer->format ? "{\n" : "{");
+  g_array_append_val (writer->levels, level);
+}
+
+/**
+ * @brief End writing an object.
+ *
+ * @param[in]  writer  The writer.
+ */
+void
+gvm_json_writer_object_end (gvm_json_writer_t *writer)
+{
+  json_writer_level_t *level;
+
+  if (writer->levels->len == 0)
+    return;
+
+  level = &g_array_index (writer->levels, json_writer_level_t,
+                          writer->levels->len - 1);
+  if (writer->format)
+    {
+      if (level->count)
+        g_string_append_c (writer->output, '\n');
+      json_writer_indent (writer, writer->levels->len - 1);
+    }
+  g_string_append_c (writer->output, '}');
+  g_array_set_size (writer->levels, writer->levels->len - 1);
+}
+
+/**
+ * @brief Start writing an array.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the array if in an object, else ignored.
+ */
+void
+gvm_json_writer_array_start (gvm_json_writer_t *writer, const gchar *key)
+{
+  json_writer_level_t level = {FALSE, 0};
+
+  json_writer_value_start (writer, key);
+  g_string_append_c (writer->output, '[');
+  g_array_append_val (writer->levels, level);
+}
+
+/**
+ * @brief End writing an array.
+ *
+ * @param[in]  writer  The writer.
+ */
+void
+gvm_json_writer_array_end (gvm_json_writer_t *writer)
+{
+  if (writer->levels->len == 0)
+    return;
+
+  g_string_append_c (writer->output, ']');
+  g_array_set_size (writer->levels, writer->levels->len - 1);
+}
+
+/**
+ * @brief Write a string.
+ *
+ * Like cJSON_AddStringToObject, nothing is written if the string is NULL.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the string if in an object, else ignored.
+ * @param[in]  value   The string.
+ */
+void
+gvm_json_writer_string (gvm_json_writer_t *writer, const gchar *key,
+                        const gchar *value)
+{
+  if (value == NULL)
+    return;
+
+  json_writer_value_start (writer, key);
+  g_string_append_c (writer->output, '"');
+  json_string_append_escaped (writer->output, value, FALSE);
+  g_string_append_c (writer->output, '"');
+}
+
+/**
+ * @brief Write an integer.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the integer if in an object, else ignored.
+ * @param[in]  value   The integer.
+ */
+void
+gvm_json_writer_int (gvm_json_writer_t *writer, const gchar *key, int value)
+{
+  json_writer_value_start (writer, key);
+  g_string_append_printf (writer->output, "%d", value);
+}
+
+/**
+ * @brief Write a boolean.
+ *
+ * @param[in]  writer  The writer.
+ * @param[in]  key     Key of the boolean if in an object, else ignored.
+ * @param[in]  value   The boolean.
+ */
+void
+gvm_json_writer_bool (gvm_json_writer_t *writer, const gchar *key,
+                      gboolean value)
+{
+  json_writer_value_start (writer, key);
+  g_string_append (writer->output, value ? "true" : "false");
+}
@@ -29,4 +29,36 @@ gvm_json_obj_check_str (cJSON *, const gchar *, gchar **);
 gchar *
 gvm_json_obj_str (cJSON *, const gchar *);
 
+/**
+ * @brief A writer of JSON text.
+ */
+typedef struct gvm_json_writer gvm_json_writer_t;
+
+gvm_json_writer_t *
+gvm_json_writer_new (GString *, gboolean);
+
+void
+gvm_json_writer_free (gvm_json_writer_t *);
+
+void
+gvm_json_writer_object_start (gvm_json_writer_t *, const gchar *);
+
+void
+gvm_json_writer_object_end (gvm_json_writer_t *);
+
+void
+gvm_json_writer_array_start (gvm_json_writer_t *, const gchar *);
+
+void
+gvm_json_writer_array_end (gvm_json_writer_t *);
+
+void
+gvm_json_writer_string (gvm_json_writer_t *, const gchar *, const gchar *);
+
+void
+gvm_json_writer_int (gvm_json_writer_t *, const gchar *, int);
+
+void
+gvm_json_writer_bool (gvm_json_writer_t *, const gchar *, gboolean);
+
 #endif /* _GVM_JSON_H */
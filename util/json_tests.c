@@ -214,6 +214,95 @@ Ensure (json, gvm_json_obj_check_int_0_and_val_when_has)
   cJSON_Delete (json);
 }
 
+/* gvm_json_writer */
+
+Ensure (json, gvm_json_writer_prints_like_cjson)
+{
+  cJSON *root, *array, *object;
+  GString *output;
+  gvm_json_writer_t *writer;
+  gchar *printed;
+
+  root = cJSON_CreateObject ();
+  cJSON_AddStringToObject (root, "name", "a \"quoted\"\tname\x01");
+  cJSON_AddStringToObject (root, "missing", NULL);
+  array = cJSON_CreateArray ();
+  cJSON_AddItemToObject (root, "list", array);
+  object = cJSON_CreateObject ();
+  cJSON_AddNumberToObject (object, "id", -3);
+  cJSON_AddBoolToObject (object, "on", cJSON_True);
+  cJSON_AddItemToArray (array, object);
+  cJSON_AddItemToArray (array, cJSON_CreateObject ());
+  cJSON_AddItemToArray (array, cJSON_CreateString ("x"));
+  cJSON_AddItemToArray (array, cJSON_CreateArray ());
+  cJSON_AddItemToObject (root, "empty", cJSON_CreateObject ());
+  cJSON_AddBoolToObject (root, "off", cJSON_False);
+
+  output = g_string_new (NULL);
+  writer = gvm_json_writer_new (output, TRUE);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_string (writer, "name", "a \"quoted\"\tname\x01");
+  gvm_json_writer_string (writer, "missing", NULL);
+  gvm_json_writer_array_start (writer, "list");
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_int (writer, "id", -3);
+  gvm_json_writer_bool (writer, "on", TRUE);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_string (writer, NULL, "x");
+  gvm_json_writer_array_start (writer, NULL);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_object_start (writer, "empty");
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_bool (writer, "off", FALSE);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_free (writer);
+
+  printed = cJSON_Print (root);
+  assert_that (output->str, is_equal_to_string (printed));
+  cJSON_free (printed);
+
+  // Unformatted
+  g_string_truncate (output, 0);
+  writer = gvm_json_writer_new (output, FALSE);
+  gvm_json_writer_array_start (writer, NULL);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_int (writer, "id", -3);
+  gvm_json_writer_bool (writer, "on", TRUE);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_object_start (writer, NULL);
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_string (writer, NULL, "x");
+  gvm_json_writer_array_start (writer, NULL);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_free (writer);
+
+  printed = cJSON_PrintUnformatted (array);
+  assert_that (output->str, is_equal_to_string (printed));
+  cJSON_free (printed);
+
+  g_string_free (output, TRUE);
+  cJSON_Delete (root);
+}
+
+Ensure (json, gvm_json_writer_ignores_unbalanced_ends)
+{
+  GString *output = g_string_new (NULL);
+  gvm_json_writer_t *writer = gvm_json_writer_new (output, TRUE);
+
+  gvm_json_writer_object_end (writer);
+  gvm_json_writer_array_end (writer);
+  gvm_json_writer_int (writer, NULL, 1);
+  assert_that (output->str, is_equal_to_string ("1"));
+
+  gvm_json_writer_free (writer);
+  gvm_json_writer_free (NULL);
+  g_string_free (output, TRUE);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -245,6 +334,9 @@ main (int argc, char **argv)
   add_test_with_context (suite, json,
                          gvm_json_obj_check_str_0_and_val_when_has);
 
+  add_test_with_context (suite, json, gvm_json_writer_prints_like_cjson);
+  add_test_with_context (suite, json, gvm_json_writer_ignores_unbalanced_ends);
+
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
   return run_test_suite (suite, create_text_reporter ());
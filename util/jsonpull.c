@@ -905,3 +905,253 @@ gvm_json_path_to_string (GQueue *path)
   g_queue_foreach (path, (GFunc) gvm_json_path_string_add_elem, path_string);
   return g_string_free (path_string, FALSE);
 }
+
+/**
+ * @brief Initializes a JSON push parser.
+ *
+ * @param[in]  parser         The parser data structure to initialize
+ * @param[in]  element_limit  Maximum size of an element of the root array
+ * @param[in]  element_func   Function to call for each element
+ * @param[in]  user_data      Data to pass to element_func
+ */
+void
+gvm_json_push_parser_init (gvm_json_push_parser_t *parser,
+                           size_t element_limit,
+                           gvm_json_push_element_func_t element_func,
+                           gpointer user_data)
+{
+  assert (parser);
+  assert (element_func);
+  memset (parser, 0, sizeof (gvm_json_push_parser_t));
+
+  if (element_limit <= 0)
+    element_limit = GVM_JSON_PULL_PARSE_BUFFER_LIMIT;
+
+  parser->state = GVM_JSON_PUSH_STATE_ARRAY_START;
+  parser->element = g_string_new ("");
+  parser->element_limit = element_limit;
+  parser->element_func = element_func;
+  parser->user_data = user_data;
+}
+
+/**
+ * @brief Frees the data of a JSON push parser.
+ *
+ * @param[in]  parser   The parser data structure to free the data of
+ */
+void
+gvm_json_push_parser_cleanup (gvm_json_push_parser_t *parser)
+{
+  assert (parser);
+  g_string_free (parser->element, TRUE);
+  g_free (parser->error_message);
+  memset (parser, 0, sizeof (gvm_json_push_parser_t));
+}
+
+/**
+ * @brief Sets the error of a JSON push parser.
+ *
+ * @param[in]  parser   The parser
+ * @param[in]  message  The error message, will be freed with the parser
+ *
+ * @return -1
+ */
+static int
+gvm_json_push_error (gvm_json_push_parser_t *parser, gchar *message)
+{
+  parser->state = GVM_JSON_PUSH_STATE_ERROR;
+  parser->error_message = message;
+  return -1;
+}
+
+/**
+ * @brief Passes the buffered element of a JSON push parser to its function.
+ *
+ * @param[in]  parser   The parser
+ *
+ * @return 0 success, -1 error
+ */
+static int
+gvm_json_push_emit_element (gvm_json_push_parser_t *parser)
+{
+  gvm_json_pull_parser_t element_parser;
+  gvm_json_pull_event_t event;
+  FILE *stream;
+
+  stream = fmemopen (parser->element->str, parser->element->len, "r");
+  if (stream == NULL)
+    return gvm_json_push_error (parser, gvm_json_read_stream_error_str ());
+
+  gvm_json_pull_event_init (&event);
+  gvm_json_pull_parser_init_full (&element_parser, stream,
+                                  parser->element_limit, 0);
+  parser->element_func (&element_parser, &event, parser->user_data);
+  gvm_json_pull_event_cleanup (&event);
+  gvm_json_pull_parser_cleanup (&element_parser);
+  fclose (stream);
+
+  g_string_truncate (parser->element, 0);
+  return 0;
+}
+
+/**
+ * @brief Handles a character inside an element in a JSON push parser.
+ *
+ * @param[in]  parser   The parser
+ * @param[in]  c        The character
+ *
+ * @return 0 success, -1 error
+ */
+static int
+gvm_json_push_element_char (gvm_json_push_parser_t *parser, char c)
+{
+  if (parser->in_string)
+    {
+      if (parser->escape_next_char)
+        parser->escape_next_char = FALSE;
+      else if (c == '\\')
+        parser->escape_next_char = TRUE;
+      else if (c == '"')
+        parser->in_string = FALSE;
+    }
+  else if (parser->depth == 0 && (c == ',' || c == ']'))
+    {
+      // End of a string, number or keyword element
+      parser->state = c == ',' ? GVM_JSON_PUSH_STATE_ELEMENT
+                               : GVM_JSON_PUSH_STATE_EOF;
+      return gvm_json_push_emit_element (parser);
+    }
+  else
+    switch (c)
+      {
+      case '"':
+        parser->in_string = TRUE;
+        break;
+      case '[':
+      case '{':
+        parser->depth++;
+        break;
+      case ']':
+      case '}':
+        parser->depth--;
+        if (parser->depth < 0)
+          return gvm_json_push_error (
+            parser, g_strdup_printf ("unexpected closing bracket '%c'", c));
+        break;
+      }
+
+  if (parser->element->len >= parser->element_limit)
+    return gvm_json_push_error (
+      parser, g_strdup_printf ("element exceeds size limit of %zu bytes",
+                               parser->element_limit));
+  g_string_append_c (parser->element, c);
+
+  if (parser->depth == 0 && !parser->in_string && (c == ']' || c == '}'))
+    {
+      // End of an array or object element
+      parser->state = GVM_JSON_PUSH_STATE_COMMA;
+      return gvm_json_push_emit_element (parser);
+    }
+
+  return 0;
+}
+
+/**
+ * @brief Feeds data into a JSON push parser.
+ *
+ * The root of the document must be an array. The element function is called
+ * for every element of the array completed by the data.
+ *
+ * @param[in]  parser   The parser
+ * @param[in]  data     The data, a part of the JSON document
+ * @param[in]  len      Length of the data
+ *
+ * @return 0 success, -1 error, see error_message of the parser.
+ */
+int
+gvm_json_push_parser_feed (gvm_json_push_parser_t *parser, const char *data,
+                           size_t len)
+{
+  assert (parser);
+
+  for (size_t i = 0; i < len; i++)
+    {
+      char c = data[i];
+
+      if (parser->state == GVM_JSON_PUSH_STATE_ERROR)
+        return -1;
+
+      if (parser->state == GVM_JSON_PUSH_STATE_IN_ELEMENT)
+        {
+          if (gvm_json_push_element_char (parser, c))
+            return -1;
+          continue;
+        }
+
+      if (g_ascii_isspace (c))
+        continue;
+
+      switch (parser->state)
+        {
+        case GVM_JSON_PUSH_STATE_ARRAY_START:
+          if (c != '[')
+            return gvm_json_push_error (parser,
+                                        g_strdup ("expected start of array"));
+          parser->state = GVM_JSON_PUSH_STATE_VALUE;
+          break;
+        case GVM_JSON_PUSH_STATE_VALUE:
+          if (c == ']')
+            {
+              parser->state = GVM_JSON_PUSH_STATE_EOF;
+              break;
+            }
+          /* fallthrough */
+        case GVM_JSON_PUSH_STATE_ELEMENT:
+          if (c == ']' || c == ',' || c == '}')
+            return gvm_json_push_error (parser,
+                                        g_strdup ("unexpected character"));
+          parser->state = GVM_JSON_PUSH_STATE_IN_ELEMENT;
+          parser->depth = 0;
+          parser->in_string = parser->escape_next_char = FALSE;
+          if (gvm_json_push_element_char (parser, c))
+            return -1;
+          break;
+        case GVM_JSON_PUSH_STATE_COMMA:
+          if (c == ',')
+            parser->state = GVM_JSON_PUSH_STATE_ELEMENT;
+          else if (c == ']')
+            parser->state = GVM_JSON_PUSH_STATE_EOF;
+          else
+            return gvm_json_push_error (
+              parser, g_strdup ("expected comma or end of container"));
+          break;
+        case GVM_JSON_PUSH_STATE_EOF:
+          return gvm_json_push_error (
+            parser,
+            g_strdup_printf ("unexpected character at end of file (%d)", c));
+        default:
+          return -1;
+        }
+    }
+
+  return parser->state == GVM_JSON_PUSH_STATE_ERROR ? -1 : 0;
+}
+
+/**
+ * @brief Signals the end of the input to a JSON push parser.
+ *
+ * @param[in]  parser   The parser
+ *
+ * @return 0 if the whole array was parsed, -1 error.
+ */
+int
+gvm_json_push_parser_finish (gvm_json_push_parser_t *parser)
+{
+  assert (parser);
+
+  if (parser->state == GVM_JSON_PUSH_STATE_EOF)
+    return 0;
+  if (parser->state != GVM_JSON_PUSH_STATE_ERROR)
+    return gvm_json_push_error (parser, g_strdup ("unexpected EOF"));
+  return -1;
+}
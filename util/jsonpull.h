@@ -98,6 +98,49 @@ typedef struct
   size_t parse_buffer_limit; ///< Maximum parse buffer size
 } gvm_json_pull_parser_t;
 
+/**
+ * @brief Function called by a JSON push parser for each array element.
+ *
+ * The pull parser reads only the element, as the root of its document. The
+ * parser and the event are cleaned up after the call.
+ */
+typedef void (*gvm_json_push_element_func_t) (gvm_json_pull_parser_t *,
+                                              gvm_json_pull_event_t *,
+                                              gpointer);
+
+/**
+ * @brief State of a JSON push parser
+ */
+typedef enum
+{
+  GVM_JSON_PUSH_STATE_ARRAY_START = 0, ///< Expect start of the root array
+  GVM_JSON_PUSH_STATE_VALUE,           ///< Expect first element or end
+  GVM_JSON_PUSH_STATE_ELEMENT,         ///< Expect element after a comma
+  GVM_JSON_PUSH_STATE_IN_ELEMENT,      ///< Inside an element
+  GVM_JSON_PUSH_STATE_COMMA,           ///< Expect comma or end of array
+  GVM_JSON_PUSH_STATE_EOF,             ///< Expect end of input
+  GVM_JSON_PUSH_STATE_ERROR            ///< An error occurred
+} gvm_json_push_state_t;
+
+/**
+ * @brief A json push parser for arrays
+ *
+ * Data is fed in chunks as it arrives. Each complete element of the root
+ * array is passed to a function, so only one element is kept in memory.
+ */
+typedef struct
+{
+  gvm_json_push_state_t state;  ///< Current state
+  int depth;                    ///< Container depth inside the element
+  gboolean in_string;           ///< Whether inside a string in the element
+  gboolean escape_next_char;    ///< Whether the next char is escaped
+  GString *element;             ///< Buffer for the current element
+  size_t element_limit;         ///< Maximum element size
+  gvm_json_push_element_func_t element_func; ///< Called for each element
+  gpointer user_data;           ///< Data passed to element_func
+  gchar *error_message;         ///< Error message, NULL on success
+} gvm_json_push_parser_t;
+
 gvm_json_path_elem_t *
 gvm_json_pull_path_elem_new (gvm_json_pull_container_type_t, int);
 
@@ -129,4 +172,17 @@ gvm_json_pull_expand_container (gvm_json_pull_parser_t *, gchar **);
 gchar *
 gvm_json_path_to_string (GQueue *path);
 
+void
+gvm_json_push_parser_init (gvm_json_push_parser_t *, size_t,
+                           gvm_json_push_element_func_t, gpointer);
+
+void
+gvm_json_push_parser_cleanup (gvm_json_push_parser_t *);
+
+int
+gvm_json_push_parser_feed (gvm_json_push_parser_t *, const char *, size_t);
+
+int
+gvm_json_push_parser_finish (gvm_json_push_parser_t *);
+
 #endif /* _GVM_JSONPULL_H */
@@ -1107,6 +1107,131 @@ Ensure (jsonpull, fails_for_expand_read_error)
   CLEANUP_JSON_PARSER;
 }
 
+/*
+ * Element function collecting the elements of a JSON push parser as strings.
+ */
+static void
+collect_element (gvm_json_pull_parser_t *parser, gvm_json_pull_event_t *event,
+                 gpointer user_data)
+{
+  GPtrArray *elements = user_data;
+  gchar *error_message = NULL;
+  cJSON *value;
+
+  gvm_json_pull_parser_next (parser, event);
+  if (event->type == GVM_JSON_PULL_EVENT_OBJECT_START
+      || event->type == GVM_JSON_PULL_EVENT_ARRAY_START)
+    value = gvm_json_pull_expand_container (parser, &error_message);
+  else
+    value = cJSON_Duplicate (event->value, TRUE);
+  g_free (error_message);
+
+  g_ptr_array_add (elements, cJSON_PrintUnformatted (value));
+  cJSON_Delete (value);
+}
+
+#define INIT_JSON_PUSH_PARSER                                        \
+  gvm_json_push_parser_t parser;                                     \
+  GPtrArray *elements = g_ptr_array_new_with_free_func (cJSON_free); \
+  gvm_json_push_parser_init (&parser, 100, collect_element, elements);
+
+#define CLEANUP_JSON_PUSH_PARSER          \
+  gvm_json_push_parser_cleanup (&parser); \
+  g_ptr_array_free (elements, TRUE);
+
+Ensure (jsonpull, push_parser_passes_elements_fed_in_pieces)
+{
+  const char *json = " [ {\"a\": [1, \"]}\\\"\"]}, [2], \"x,\" , 3 ,null] ";
+  INIT_JSON_PUSH_PARSER;
+
+  for (size_t i = 0; i < strlen (json); i++)
+    assert_that (gvm_json_push_parser_feed (&parser, json + i, 1),
+                 is_equal_to (0));
+  assert_that (gvm_json_push_parser_finish (&parser), is_equal_to (0));
+
+  assert_that (elements->len, is_equal_to (5));
+  assert_that (g_ptr_array_index (elements, 0),
+               is_equal_to_string ("{\"a\":[1,\"]}\\\"\"]}"));
+  assert_that (g_ptr_array_index (elements, 1), is_equal_to_string ("[2]"));
+  assert_that (g_ptr_array_index (elements, 2), is_equal_to_string ("\"x,\""));
+  assert_that (g_ptr_array_index (elements, 3), is_equal_to_string ("3"));
+  assert_that (g_ptr_array_index (elements, 4), is_equal_to_string ("null"));
+  assert_that (parser.element->len, is_equal_to (0));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_accepts_empty_array)
+{
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, "[ ]\n", 4),
+               is_equal_to (0));
+  assert_that (gvm_json_push_parser_finish (&parser), is_equal_to (0));
+  assert_that (elements->len, is_equal_to (0));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_fails_for_no_array)
+{
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, "{}", 2), is_equal_to (-1));
+  assert_that (parser.error_message,
+               is_equal_to_string ("expected start of array"));
+  assert_that (gvm_json_push_parser_feed (&parser, "[]", 2), is_equal_to (-1));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_fails_for_missing_element)
+{
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, "[1,]", 4),
+               is_equal_to (-1));
+  assert_that (parser.error_message,
+               is_equal_to_string ("unexpected character"));
+  assert_that (elements->len, is_equal_to (1));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_fails_for_content_after_array)
+{
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, "[{}] x", 6),
+               is_equal_to (-1));
+  assert_that (
+    parser.error_message,
+    is_equal_to_string ("unexpected character at end of file (120)"));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_fails_for_eof)
+{
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, "[{\"a\": 1", 8),
+               is_equal_to (0));
+  assert_that (gvm_json_push_parser_finish (&parser), is_equal_to (-1));
+  assert_that (parser.error_message, is_equal_to_string ("unexpected EOF"));
+  assert_that (elements->len, is_equal_to (0));
+  CLEANUP_JSON_PUSH_PARSER;
+}
+
+Ensure (jsonpull, push_parser_fails_for_overlong_element)
+{
+  gchar *json = g_strdup_printf ("[\"%0200d\"]", 0);
+  INIT_JSON_PUSH_PARSER;
+
+  assert_that (gvm_json_push_parser_feed (&parser, json, strlen (json)),
+               is_equal_to (-1));
+  assert_that (parser.error_message,
+               is_equal_to_string ("element exceeds size limit of 100 bytes"));
+  assert_that (parser.element->len, is_equal_to (100));
+  CLEANUP_JSON_PUSH_PARSER;
+  g_free (json);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -1199,6 +1324,18 @@ main (int argc, char **argv)
   add_test_with_context (suite, jsonpull, fails_for_expand_read_error);
   add_test_with_context (suite, jsonpull, fails_for_expand_eof);
 
+  add_test_with_context (suite, jsonpull,
+                         push_parser_passes_elements_fed_in_pieces);
+  add_test_with_context (suite, jsonpull, push_parser_accepts_empty_array);
+  add_test_with_context (suite, jsonpull, push_parser_fails_for_no_array);
+  add_test_with_context (suite, jsonpull,
+                         push_parser_fails_for_missing_element);
+  add_test_with_context (suite, jsonpull,
+                         push_parser_fails_for_content_after_array);
+  add_test_with_context (suite, jsonpull, push_parser_fails_for_eof);
+  add_test_with_context (suite, jsonpull,
+                         push_parser_fails_for_overlong_element);
+
   if (argc > 1)
     return run_single_test (suite, argv[1], create_text_reporter ());
   return run_test_suite (suite, create_text_reporter ());
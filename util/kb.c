@@ -15,6 +15,7 @@
 #include <errno.h> /* for ENOMEM, EINVAL, EPROTO, EALREADY, ECONN... */
 #include <glib.h>  /* for g_log, g_free */
 #include <hiredis/hiredis.h> /* for redisReply, freeReplyObject, redisCommand */
+#include <limits.h>          /* for INT_MAX */
 #include <stdbool.h>         /* for bool, true, false */
 #include <stdio.h>
 #include <stdlib.h> /* for atoi */
@@ -798,6 +799,48 @@ redis_cmd (struct kb_redis *kbr, const char *fmt, ...)
   return rep;
 }
 
+/**
+ * @brief Execute a redis command given as argument vector and get a redis
+ *        reply.
+ *
+ * Unlike redis_cmd() the arguments are not formatted, so the number of
+ * arguments may vary at runtime.
+ *
+ * @param[in] kbr   Subclass of struct kb to connect to.
+ * @param[in] argc  Number of arguments.
+ * @param[in] argv  Arguments, including the command name.
+ *
+ * @return Redis reply on success, NULL otherwise.
+ */
+static redisReply *
+redis_cmd_argv (struct kb_redis *kbr, int argc, const char **argv)
+{
+  redisReply *rep;
+  int retry = 0;
+
+  do
+    {
+      if (get_redis_ctx (kbr) < 0)
+        return NULL;
+
+      rep = redisCommandArgv (kbr->rctx, argc, argv, NULL);
+      if (kbr->rctx->err)
+        {
+          if (rep != NULL)
+            freeReplyObject (rep);
+          rep = NULL;
+
+          redis_lnk_reset ((kb_t) kbr);
+          retry = !retry;
+        }
+      else
+        retry = 0;
+    }
+  while (retry);
+
+  return rep;
+}
+
 /**
  * @brief Get a single KB element.
  *
@@ -918,6 +961,226 @@ redis_pop_str (kb_t kb, const char *name)
   return value;
 }
 
+/**
+ * @brief Push several new entries under a given key with a single LPUSH.
+ *
+ * @param[in] kb     KB handle where to store the items.
+ * @param[in] name   Key to push to.
+ * @param[in] values Values to push.
+ * @param[in] count  Number of values.
+ *
+ * @return 0 on success, non-null on error.
+ */
+static int
+redis_push_str_multi (kb_t kb, const char *name, const char **values,
+                      size_t count)
+{
+  struct kb_redis *kbr;
+  redisReply *rep;
+  const char **argv;
+  int rc = 0;
+
+  if (!values || count > INT_MAX - 2)
+    return -1;
+  if (count == 0)
+    return 0;
+
+  argv = g_malloc ((count + 2) * sizeof (char *));
+  argv[0] = "LPUSH";
+  argv[1] = name;
+  for (size_t i = 0; i < count; i++)
+    {
+      if (!values[i])
+        {
+          g_free (argv);
+          return -1;
+        }
+      argv[i + 2] = values[i];
+    }
+
+  kbr = redis_kb (kb);
+  rep = redis_cmd_argv (kbr, count + 2, argv);
+  if (!rep || rep->type == REDIS_REPLY_ERROR)
+    rc = -1;
+
+  if (rep)
+    freeReplyObject (rep);
+  g_free (argv);
+
+  return rc;
+}
+
+/**
+ * @brief Pops several KB string items with LRANGE and LTRIM in a transaction.
+ *
+ * Fallback for Redis servers older than 6.2, which do not support the count
+ * argument of RPOP. Both commands run inside MULTI/EXEC, so the items are
+ * removed only together with the reply that returns them: if the link breaks
+ * before EXEC, the server discards the transaction and nothing is lost. An
+ * empty list costs a single round trip.
+ *
+ * @param[in]  kbr     Subclass of struct kb to use.
+ * @param[in]  name    Name of the key from where to retrieve.
+ * @param[out] values  Array to store the strings in, in RPOP order.
+ * @param[in]  max     Maximum number of items to pop.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static int
+redis_pop_str_transaction (struct kb_redis *kbr, const char *name,
+                           char **values, size_t max)
+{
+  redisReply *rep = NULL, *range;
+  int count = 0;
+
+  if (get_redis_ctx (kbr) < 0)
+    return -1;
+
+  /* The tail of the list holds the next items RPOP would return. */
+  redisAppendCommand (kbr->rctx, "MULTI");
+  redisAppendCommand (kbr->rctx, "LRANGE %s %d -1", name, -(int) max);
+  redisAppendCommand (kbr->rctx, "LTRIM %s 0 %d", name, -(int) max - 1);
+  redisAppendCommand (kbr->rctx, "EXEC");
+
+  /* Replies to MULTI and the two QUEUED commands, then the one to EXEC. */
+  for (int i = 0; i < 4; i++)
+    {
+      if (rep)
+        freeReplyObject (rep);
+      rep = NULL;
+      if (redisGetReply (kbr->rctx, (void **) &rep) != 0 || !rep)
+        {
+          redis_lnk_reset ((kb_t) kbr);
+          return -1;
+        }
+    }
+
+  /* EXEC replies with an error when a queued command was rejected. */
+  if (rep->type != REDIS_REPLY_ARRAY || rep->elements != 2
+      || rep->element[0]->type != REDIS_REPLY_ARRAY)
+    {
+      freeReplyObject (rep);
+      return -1;
+    }
+
+  range = rep->element[0];
+  for (size_t i = range->elements; i > 0 && (size_t) count < max; i--)
+    if (range->element[i - 1]->type == REDIS_REPLY_STRING)
+      values[count++] = g_strdup (range->element[i - 1]->str);
+  freeReplyObject (rep);
+
+  return count;
+}
+
+/**
+ * @brief Pops several KB string items at once without blocking.
+ *
+ * @param[in]  kbr     Subclass of struct kb to use.
+ * @param[in]  name    Name of the key from where to retrieve.
+ * @param[out] values  Array to store the strings in.
+ * @param[in]  max     Maximum number of items to pop.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static int
+redis_pop_str_count (struct kb_redis *kbr, const char *name, char **values,
+                     size_t max)
+{
+  redisReply *rep;
+  int count = 0;
+
+  rep = redis_cmd (kbr, "RPOP %s %d", name, (int) max);
+  if (!rep)
+    return -1;
+
+  if (rep->type == REDIS_REPLY_ERROR)
+    {
+      freeReplyObject (rep);
+      return redis_pop_str_transaction (kbr, name, values, max);
+    }
+
+  if (rep->type == REDIS_REPLY_ARRAY)
+    {
+      for (size_t i = 0; i < rep->elements && i < max; i++)
+        if (rep->element[i]->type == REDIS_REPLY_STRING)
+          values[count++] = g_strdup (rep->element[i]->str);
+    }
+  freeReplyObject (rep);
+
+  return count;
+}
+
+/**
+ * @brief Pops several KB string items at once, waiting for the first one.
+ *
+ * If the list is empty and a timeout is given, BRPOP waits for the first item
+ * and the others which were pushed with it are taken with a second RPOP.
+ *
+ * @param[in]  kb       KB handle where to fetch the items.
+ * @param[in]  name     Name of the key from where to retrieve.
+ * @param[out] values   Array of at least max elements. Filled with strings to
+ *                      be freed.
+ * @param[in]  max      Maximum number of items to pop.
+ * @param[in]  timeout  Seconds to wait for the first item. 0 to not wait.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static int
+redis_pop_str_multi_timeout (kb_t kb, const char *name, char **values,
+                             size_t max, int timeout)
+{
+  struct kb_redis *kbr;
+  redisReply *rep;
+  int count, more;
+
+  if (!values || max > INT_MAX || timeout < 0)
+    return -1;
+  if (max == 0)
+    return 0;
+
+  kbr = redis_kb (kb);
+  count = redis_pop_str_count (kbr, name, values, max);
+  if (count != 0 || timeout == 0)
+    return count;
+
+  /* Empty. Wait for the first item. Reply is the key and the value. */
+  rep = redis_cmd (kbr, "BRPOP %s %d", name, timeout);
+  if (!rep)
+    return -1;
+  if (rep->type == REDIS_REPLY_ARRAY && rep->elements == 2
+      && rep->element[1]->type == REDIS_REPLY_STRING)
+    values[count++] = g_strdup (rep->element[1]->str);
+  else if (rep->type == REDIS_REPLY_ERROR)
+    count = -1;
+  freeReplyObject (rep);
+
+  if (count <= 0 || max == 1)
+    return count;
+
+  more = redis_pop_str_count (kbr, name, values + 1, max - 1);
+  if (more > 0)
+    count += more;
+
+  return count;
+}
+
+/**
+ * @brief Pops several KB string items at once without blocking.
+ *
+ * @param[in]  kb      KB handle where to fetch the items.
+ * @param[in]  name    Name of the key from where to retrieve.
+ * @param[out] values  Array of at least max elements. Filled with strings to
+ *                     be freed.
+ * @param[in]  max     Maximum number of items to pop.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static int
+redis_pop_str_multi (kb_t kb, const char *name, char **values, size_t max)
+{
+  return redis_pop_str_multi_timeout (kb, name, values, max, 0);
+}
+
 /**
  * @brief Get a single KB integer item.
  *
@@ -1875,6 +2138,9 @@ static const struct kb_operations KBRedisOperations = {
   .kb_save = redis_save,
   .kb_flush = redis_flush_all,
   .kb_direct_conn = redis_direct_conn,
-  .kb_get_kb_index = redis_get_kb_index};
+  .kb_get_kb_index = redis_get_kb_index,
+  .kb_push_str_multi = redis_push_str_multi,
+  .kb_pop_str_multi = redis_pop_str_multi,
+  .kb_pop_str_multi_timeout = redis_pop_str_multi_timeout};
 
 const struct kb_operations *KBDefaultOperations = &KBRedisOperations;
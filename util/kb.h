@@ -216,6 +216,23 @@ struct kb_operations
   int (*kb_lnk_reset) (kb_t);           /**< Reset connection to KB. */
   int (*kb_flush) (kb_t, const char *); /**< Flush redis DB. */
   int (*kb_get_kb_index) (kb_t);        /**< Get kb index. */
+
+  /* Appended to keep the layout of the members above. */
+  /**
+   * Function provided by an implementation to push several values under a
+   * key at once.
+   */
+  int (*kb_push_str_multi) (kb_t, const char *, const char **, size_t);
+  /**
+   * Function provided by an implementation to pop several str under a key at
+   * once.
+   */
+  int (*kb_pop_str_multi) (kb_t, const char *, char **, size_t);
+  /**
+   * Function provided by an implementation to pop several str under a key at
+   * once, waiting for the first one.
+   */
+  int (*kb_pop_str_multi_timeout) (kb_t, const char *, char **, size_t, int);
 };
 
 /**
@@ -434,6 +451,80 @@ kb_item_pop_str (kb_t kb, const char *name)
   return kb->kb_ops->kb_pop_str (kb, name);
 }
 
+/**
+ * @brief Push several new values under a given key.
+ *
+ * The values are pushed in order, as if kb_item_push_str() was called for
+ * every value, but in a single round trip.
+ *
+ * @param[in] kb     KB handle where to store the items.
+ * @param[in] name   Key to push to.
+ * @param[in] values Values to push.
+ * @param[in] count  Number of values.
+ *
+ * @return 0 on success, non-null on error.
+ */
+static inline int
+kb_item_push_str_multi (kb_t kb, const char *name, const char **values,
+                        size_t count)
+{
+  assert (kb);
+  assert (kb->kb_ops);
+  assert (kb->kb_ops->kb_push_str_multi);
+
+  return kb->kb_ops->kb_push_str_multi (kb, name, values, count);
+}
+
+/**
+ * @brief Pop several KB string items.
+ *
+ * The items are returned in the order in which kb_item_pop_str() would have
+ * returned them.
+ *
+ * @param[in]  kb      KB handle where to fetch the items.
+ * @param[in]  name    Name of the elements to retrieve.
+ * @param[out] values  Array of at least max elements. Filled with strings to
+ *                     be freed.
+ * @param[in]  max     Maximum number of items to pop.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static inline int
+kb_item_pop_str_multi (kb_t kb, const char *name, char **values, size_t max)
+{
+  assert (kb);
+  assert (kb->kb_ops);
+  assert (kb->kb_ops->kb_pop_str_multi);
+
+  return kb->kb_ops->kb_pop_str_multi (kb, name, values, max);
+}
+
+/**
+ * @brief Pop several KB string items, waiting for the first one.
+ *
+ * Like kb_item_pop_str_multi(), but if no item is available and timeout is
+ * not 0, block until one is pushed or the timeout expired.
+ *
+ * @param[in]  kb       KB handle where to fetch the items.
+ * @param[in]  name     Name of the elements to retrieve.
+ * @param[out] values   Array of at least max elements. Filled with strings to
+ *                      be freed.
+ * @param[in]  max      Maximum number of items to pop.
+ * @param[in]  timeout  Seconds to wait for the first item. 0 to not wait.
+ *
+ * @return Number of popped items, -1 on error.
+ */
+static inline int
+kb_item_pop_str_multi_timeout (kb_t kb, const char *name, char **values,
+                               size_t max, int timeout)
+{
+  assert (kb);
+  assert (kb->kb_ops);
+  assert (kb->kb_ops->kb_pop_str_multi_timeout);
+
+  return kb->kb_ops->kb_pop_str_multi_timeout (kb, name, values, max, timeout);
+}
+
 /**
  * @brief Count all items stored under a given pattern.
  *